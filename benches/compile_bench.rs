@@ -18,8 +18,10 @@
 
 use criterion::{black_box, criterion_group, criterion_main, Criterion};
 use aether::{Compiler, pipeline::CompileOptions};
+use aether::llvm_backend::OptLevel;
 use std::fs;
 use std::path::PathBuf;
+use std::process::Command;
 use tempfile::TempDir;
 
 /// Create a test source file with specified complexity
@@ -40,7 +42,7 @@ fn create_test_source(num_functions: usize, statements_per_function: usize) -> S
         // Create a chain of operations
         for j in 0..statements_per_function {
             if j == 0 {
-                source.push_str("        (DECLARE_VARIABLE (NAME \"x\") (TYPE INTEGER) (VALUE 0))\n");
+                source.push_str("        (DECLARE_VARIABLE (NAME \"x\") (TYPE INTEGER) (MUTABILITY MUTABLE) (VALUE 0))\n");
             } else if j == statements_per_function - 1 {
                 source.push_str("        (RETURN_VALUE x)\n");
             } else {
@@ -64,6 +66,105 @@ fn create_test_source(num_functions: usize, statements_per_function: usize) -> S
     source
 }
 
+/// Create a compute-bound program whose exit status is `0`
+fn create_runtime_source(iterations: usize) -> String {
+    format!(r#"(DEFINE_MODULE
+  (NAME runtime_benchmark)
+  (INTENT "Loop-heavy program for measuring generated code")
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME checksum)
+      (ACCEPTS_PARAMETER (NAME "n") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME i) (TYPE INTEGER) (MUTABILITY MUTABLE) (VALUE 0))
+        (DECLARE_VARIABLE (NAME acc) (TYPE INTEGER) (MUTABILITY MUTABLE) (VALUE 0))
+        (LOOP_WHILE_CONDITION
+          (PREDICATE_LESS_THAN i n)
+          (ITERATION_BODY
+            (ASSIGN
+              (TARGET_VARIABLE acc)
+              (SOURCE_EXPRESSION (EXPRESSION_ADD (EXPRESSION_MULTIPLY acc 31) i)))
+            (ASSIGN
+              (TARGET_VARIABLE i)
+              (SOURCE_EXPRESSION (EXPRESSION_ADD i 1)))))
+        (RETURN_VALUE acc)))
+    
+    (DEFINE_FUNCTION
+      (NAME main)
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME result) (TYPE INTEGER))
+        (ASSIGN
+          (TARGET_VARIABLE result)
+          (SOURCE_EXPRESSION (CALL_FUNCTION checksum {})))
+        (IF_CONDITION
+          (PREDICATE_EQUALS result 0)
+          (THEN_EXECUTE (RETURN_VALUE 1)))
+        (RETURN_VALUE 0)))
+  ))
+"#, iterations)
+}
+
+/// Create a program that runs one array kernel over integer arrays many times
+///
+/// `kernel` is the loop body over `a`, `b`, `i` and `acc`; the loop itself is
+/// the single-block shape the vectorizer handles.
+fn create_array_kernel_source(kernel: &str, repetitions: usize) -> String {
+    let elements = (1..=256).map(|n| (n % 7).to_string()).collect::<Vec<_>>().join(" ");
+    format!(r#"(DEFINE_MODULE
+  (NAME array_kernel_benchmark)
+  (INTENT "Array loop for measuring vectorized code")
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME kernel)
+      (ACCEPTS_PARAMETER (NAME "a") (TYPE (ARRAY_OF_TYPE INTEGER)))
+      (ACCEPTS_PARAMETER (NAME "b") (TYPE (ARRAY_OF_TYPE INTEGER)))
+      (ACCEPTS_PARAMETER (NAME "n") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME i) (TYPE INTEGER) (MUTABILITY MUTABLE) (VALUE 0))
+        (DECLARE_VARIABLE (NAME acc) (TYPE INTEGER) (MUTABILITY MUTABLE) (VALUE 0))
+        (LOOP_WHILE_CONDITION
+          (PREDICATE_LESS_THAN i n)
+          (ITERATION_BODY
+            {kernel}
+            (ASSIGN
+              (TARGET_VARIABLE i)
+              (SOURCE_EXPRESSION (EXPRESSION_ADD i 1)))))
+        (RETURN_VALUE acc)))
+    
+    (DEFINE_FUNCTION
+      (NAME main)
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME a) (TYPE (ARRAY_OF_TYPE INTEGER)))
+        (ASSIGN
+          (TARGET_VARIABLE a)
+          (SOURCE_EXPRESSION (ARRAY_LITERAL {elements})))
+        (DECLARE_VARIABLE (NAME b) (TYPE (ARRAY_OF_TYPE INTEGER)))
+        (ASSIGN
+          (TARGET_VARIABLE b)
+          (SOURCE_EXPRESSION (ARRAY_LITERAL {elements})))
+        (DECLARE_VARIABLE (NAME rep) (TYPE INTEGER) (MUTABILITY MUTABLE) (VALUE 0))
+        (DECLARE_VARIABLE (NAME total) (TYPE INTEGER) (MUTABILITY MUTABLE) (VALUE 0))
+        (LOOP_WHILE_CONDITION
+          (PREDICATE_LESS_THAN rep {repetitions})
+          (ITERATION_BODY
+            (ASSIGN
+              (TARGET_VARIABLE total)
+              (SOURCE_EXPRESSION (EXPRESSION_ADD total (CALL_FUNCTION kernel a b 256))))
+            (ASSIGN
+              (TARGET_VARIABLE rep)
+              (SOURCE_EXPRESSION (EXPRESSION_ADD rep 1)))))
+        (IF_CONDITION
+          (PREDICATE_EQUALS total 1)
+          (THEN_EXECUTE (RETURN_VALUE 1)))
+        (RETURN_VALUE 0)))
+  ))
+"#, kernel = kernel, elements = elements, repetitions = repetitions)
+}
+
 /// Benchmark compilation of small programs
 fn bench_small_program(c: &mut Criterion) {
     let temp_dir = TempDir::new().unwrap();
@@ -141,6 +242,14 @@ fn bench_parsing(c: &mut Criterion) {
             let _ = parser.parse_module();
         });
     });
+    
+    c.bench_function("streaming_lex_parse_50_functions", |b| {
+        b.iter(|| {
+            let lexer = Lexer::new(black_box(&source), "bench.aether".to_string());
+            let mut parser = Parser::from_lexer(lexer);
+            let _ = parser.parse_module();
+        });
+    });
 }
 
 /// Benchmark semantic analysis phase
@@ -232,6 +341,107 @@ fn bench_optimization(c: &mut Criterion) {
     });
 }
 
+/// Benchmark the generated code at each optimization level
+///
+/// Each level compiles the same program once; only running the executable is timed.
+fn bench_compiled_runtime(c: &mut Criterion) {
+    let temp_dir = TempDir::new().unwrap();
+    let source_path = temp_dir.path().join("runtime.aether");
+    fs::write(&source_path, create_runtime_source(20_000_000)).unwrap();
+    
+    let mut group = c.benchmark_group("compiled_runtime");
+    group.sample_size(10);
+    
+    let configurations = [
+        (OptLevel::O0, false),
+        (OptLevel::O1, false),
+        (OptLevel::O2, false),
+        (OptLevel::O3, false),
+        (OptLevel::Os, false),
+        (OptLevel::Oz, false),
+        // Needs the bitcode runtime from `scripts/build_runtime.sh --lto`
+        (OptLevel::O3, true),
+    ];
+    
+    for (level, lto) in configurations {
+        let name = if lto { format!("{}-lto", level) } else { level.to_string() };
+        let executable = temp_dir.path().join(format!("runtime_{}", name));
+        let compiler = Compiler::new()
+            .opt_level(level)
+            .target_cpu("native".to_string())
+            .lto(lto)
+            .output(executable.clone());
+        if let Err(e) = compiler.compile_files(&[source_path.clone()]) {
+            eprintln!("Skipping {}: {}", name, e);
+            continue;
+        }
+        
+        group.bench_function(name, |b| {
+            b.iter(|| {
+                let status = Command::new(black_box(&executable)).status().unwrap();
+                assert!(status.success());
+            });
+        });
+    }
+    
+    group.finish();
+}
+
+/// Benchmark integer array kernels with and without loop vectorization
+///
+/// -O2 and up run the MIR vectorizer and global value numbering; -O1 keeps
+/// the scalar loops and their redundant loads as the baseline.
+fn bench_array_kernels(c: &mut Criterion) {
+    let kernels = [
+        ("dot_product", "(ASSIGN
+              (TARGET_VARIABLE acc)
+              (SOURCE_EXPRESSION (EXPRESSION_ADD acc (EXPRESSION_MULTIPLY (GET_ARRAY_ELEMENT a i) (GET_ARRAY_ELEMENT b i)))))"),
+        ("saxpy", "(SET_ARRAY_ELEMENT b i (EXPRESSION_ADD (EXPRESSION_MULTIPLY 3 (GET_ARRAY_ELEMENT a i)) (GET_ARRAY_ELEMENT b i)))"),
+        ("sum", "(ASSIGN
+              (TARGET_VARIABLE acc)
+              (SOURCE_EXPRESSION (EXPRESSION_ADD acc (GET_ARRAY_ELEMENT a i))))"),
+        ("redundant_loads", "(IF_CONDITION (PREDICATE_GREATER_THAN (GET_ARRAY_ELEMENT a i) 3)
+              (THEN_EXECUTE
+                (ASSIGN
+                  (TARGET_VARIABLE acc)
+                  (SOURCE_EXPRESSION (EXPRESSION_ADD acc (GET_ARRAY_ELEMENT b i))))))
+            (ASSIGN
+              (TARGET_VARIABLE acc)
+              (SOURCE_EXPRESSION (EXPRESSION_ADD acc (EXPRESSION_MULTIPLY (GET_ARRAY_ELEMENT a i) (GET_ARRAY_ELEMENT b i)))))"),
+    ];
+    let temp_dir = TempDir::new().unwrap();
+    
+    let mut group = c.benchmark_group("array_kernels");
+    group.sample_size(10);
+    
+    for (kernel_name, kernel) in kernels {
+        let source_path = temp_dir.path().join(format!("{}.aether", kernel_name));
+        fs::write(&source_path, create_array_kernel_source(kernel, 200_000)).unwrap();
+        
+        for level in [OptLevel::O1, OptLevel::O2, OptLevel::O3] {
+            let name = format!("{}/{}", kernel_name, level);
+            let executable = temp_dir.path().join(format!("{}_{}", kernel_name, level));
+            let compiler = Compiler::new()
+                .opt_level(level)
+                .target_cpu("native".to_string())
+                .output(executable.clone());
+            if let Err(e) = compiler.compile_files(&[source_path.clone()]) {
+                eprintln!("Skipping {}: {}", name, e);
+                continue;
+            }
+            
+            group.bench_function(name, |b| {
+                b.iter(|| {
+                    let status = Command::new(black_box(&executable)).status().unwrap();
+                    assert!(status.success());
+                });
+            });
+        }
+    }
+    
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_small_program,
@@ -241,6 +451,8 @@ criterion_group!(
     bench_parsing,
     bench_semantic_analysis,
     bench_mir_generation,
-    bench_optimization
+    bench_optimization,
+    bench_compiled_runtime,
+    bench_array_kernels
 );
 criterion_main!(benches);
\ No newline at end of file
@@ -12,11 +12,55 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use criterion::{black_box, criterion_group, criterion_main, Criterion, BenchmarkId};
+use criterion::{black_box, criterion_group, criterion_main, BatchSize, Criterion, BenchmarkId};
 use aether::lexer::Lexer;
 use aether::parser::Parser;
 use aether::semantic::SemanticAnalyzer;
+use aether::symbols::{ScopeKind, Symbol, SymbolKind, SymbolTable};
+use aether::types::Type;
+use aether::ast::PrimitiveType;
+use aether::error::SourceLocation;
+use aether::ast::arena::AstArena;
+use aether::mir::{self, Builder, Constant, ConstantValue, Operand, Place, Rvalue, SourceInfo, Statement, SwitchTargets, Terminator};
+use aether::optimizations::{OptimizationManager, OptimizationPass};
+use aether::optimizations::gvn::GlobalValueNumberingPass;
+use std::alloc::{GlobalAlloc, Layout, System};
 use std::fs;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+/// System allocator wrapper that tracks live and peak heap bytes
+struct PeakAllocator;
+
+static LIVE_BYTES: AtomicUsize = AtomicUsize::new(0);
+static PEAK_BYTES: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for PeakAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        let ptr = System.alloc(layout);
+        if !ptr.is_null() {
+            let live = LIVE_BYTES.fetch_add(layout.size(), Ordering::Relaxed) + layout.size();
+            PEAK_BYTES.fetch_max(live, Ordering::Relaxed);
+        }
+        ptr
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout);
+        LIVE_BYTES.fetch_sub(layout.size(), Ordering::Relaxed);
+    }
+}
+
+#[global_allocator]
+static GLOBAL: PeakAllocator = PeakAllocator;
+
+/// Run `f` and return its result with the peak heap growth it caused
+fn measure_peak<T>(f: impl FnOnce() -> T) -> (T, usize) {
+    let baseline = LIVE_BYTES.load(Ordering::Relaxed);
+    PEAK_BYTES.store(baseline, Ordering::Relaxed);
+    let result = f();
+    let peak = PEAK_BYTES.load(Ordering::Relaxed).saturating_sub(baseline);
+    (result, peak)
+}
 
 /// Load test fixture
 fn load_fixture(filename: &str) -> String {
@@ -192,6 +236,143 @@ fn bench_semantic_analysis(c: &mut Criterion) {
     group.finish();
 }
 
+/// Benchmark scoped symbol lookup in deeply nested generated scopes
+fn bench_symbol_lookup(c: &mut Criterion) {
+    let mut group = c.benchmark_group("symbol_lookup");
+    
+    let symbol = |name: &str| Symbol::new(
+        name.to_string(),
+        Type::primitive(PrimitiveType::Integer),
+        SymbolKind::Variable,
+        true,
+        true,
+        SourceLocation::unknown(),
+    );
+    
+    // 16 imported modules with 32 exports each
+    let imports: Vec<(String, std::collections::HashMap<String, Symbol>)> = (0..16)
+        .map(|module| {
+            let exports = (0..32)
+                .map(|i| {
+                    let name = format!("m{}_f{}", module, i);
+                    (name.clone(), symbol(&name))
+                })
+                .collect();
+            (format!("module_{}", module), exports)
+        })
+        .collect();
+    
+    for depth in [8, 64, 256].iter() {
+        // Four locals per nesting level
+        let locals: Vec<Vec<Symbol>> = (0..*depth)
+            .map(|level| (0..4).map(|i| symbol(&format!("v{}_{}", level, i))).collect())
+            .collect();
+        
+        group.bench_with_input(BenchmarkId::new("nested_scopes", depth), &locals, |b, locals| {
+            b.iter(|| {
+                let mut table = SymbolTable::new();
+                for (module, exports) in &imports {
+                    table.add_import(module.clone(), exports.clone());
+                }
+                
+                // At every level resolve the outermost local, an import
+                // and an undefined name, as a body checker would
+                for level in locals {
+                    table.enter_scope(ScopeKind::Block);
+                    for local in level {
+                        table.add_symbol(local.clone()).unwrap();
+                    }
+                    black_box(table.lookup_symbol("v0_0"));
+                    black_box(table.lookup_symbol("m15_f31"));
+                    black_box(table.lookup_symbol("undefined"));
+                }
+                for _ in locals {
+                    table.exit_scope().unwrap();
+                }
+                black_box(table)
+            })
+        });
+    }
+    
+    group.finish();
+}
+
+/// Build a MIR function with a chain of `blocks` blocks, each carrying a
+/// live increment, a dead temporary and a branch to a shared exit
+fn generate_large_mir_function(blocks: usize) -> mir::Function {
+    let int = || Type::primitive(PrimitiveType::Integer);
+    let info = || SourceInfo { span: SourceLocation::unknown(), scope: 0 };
+    let place = |local| Place { local, projection: vec![] };
+    let constant = |value| Operand::Constant(Constant { ty: int(), value: ConstantValue::Integer(value) });
+    
+    let mut builder = Builder::new();
+    builder.start_function("large".to_string(), vec![("n".to_string(), int())], int());
+    let counter = builder.new_local(int(), true);
+    let chain: Vec<_> = (0..blocks).map(|_| builder.new_block()).collect();
+    let exit = builder.new_block();
+    
+    builder.set_terminator(Terminator::Goto { target: chain[0] });
+    for (i, &block) in chain.iter().enumerate() {
+        builder.switch_to_block(block);
+        let dead = builder.new_local(int(), false);
+        builder.push_statement(Statement::Assign {
+            place: place(dead),
+            rvalue: Rvalue::BinaryOp { op: mir::BinOp::Mul, left: constant(i as i128), right: constant(3) },
+            source_info: info(),
+        });
+        builder.push_statement(Statement::Assign {
+            place: place(counter),
+            rvalue: Rvalue::BinaryOp { op: mir::BinOp::Add, left: Operand::Copy(place(counter)), right: constant(1) },
+            source_info: info(),
+        });
+        let next = chain.get(i + 1).copied().unwrap_or(exit);
+        builder.set_terminator(Terminator::SwitchInt {
+            discriminant: Operand::Copy(place(counter)),
+            switch_ty: int(),
+            targets: SwitchTargets { values: vec![0], targets: vec![exit], otherwise: next, weights: vec![] },
+        });
+    }
+    builder.switch_to_block(exit);
+    builder.set_terminator(Terminator::Return);
+    
+    builder.finish_function()
+}
+
+/// Benchmark the MIR optimization pipeline on large functions
+fn bench_optimization(c: &mut Criterion) {
+    let mut group = c.benchmark_group("optimization");
+    
+    for blocks in [256, 1024, 4096].iter() {
+        let function = generate_large_mir_function(*blocks);
+        
+        group.bench_with_input(BenchmarkId::new("default_pipeline", blocks), &function, |b, function| {
+            b.iter_batched(
+                || function.clone(),
+                |mut function| {
+                    let mut manager = OptimizationManager::create_default_pipeline();
+                    manager.optimize_function(&mut function).unwrap();
+                    black_box(function)
+                },
+                BatchSize::LargeInput,
+            )
+        });
+        
+        // Compile-time cost of value numbering and lazy code motion alone
+        group.bench_with_input(BenchmarkId::new("global_value_numbering", blocks), &function, |b, function| {
+            b.iter_batched(
+                || function.clone(),
+                |mut function| {
+                    GlobalValueNumberingPass::new().run_on_function(&mut function).unwrap();
+                    black_box(function)
+                },
+                BatchSize::LargeInput,
+            )
+        });
+    }
+    
+    group.finish();
+}
+
 /// Benchmark complete compilation pipeline
 fn bench_complete_pipeline(c: &mut Criterion) {
     let mut group = c.benchmark_group("complete_pipeline");
@@ -248,6 +429,27 @@ fn bench_complete_pipeline(c: &mut Criterion) {
 fn bench_memory_usage(c: &mut Criterion) {
     let mut group = c.benchmark_group("memory_usage");
     
+    // Report peak heap usage of the boxed AST versus the arena AST
+    for size in [100, 500].iter() {
+        let source = generate_large_module(*size);
+        let (program, boxed_peak) = measure_peak(|| {
+            let mut lexer = Lexer::new(&source, "benchmark.aether".to_string());
+            let tokens = lexer.tokenize().unwrap();
+            let mut parser = Parser::new(tokens);
+            parser.parse_program().unwrap()
+        });
+        let (arena, arena_peak) = measure_peak(|| AstArena::from_program(&program));
+        drop(program);
+        println!(
+            "memory_usage/peak_{}: boxed AST (lex+parse) {} bytes, arena {} bytes ({} nodes, {} resident)",
+            size,
+            boxed_peak,
+            arena_peak,
+            arena.node_count(),
+            arena.heap_bytes()
+        );
+    }
+
     // Benchmark AST creation and manipulation
     group.bench_function("ast_creation", |b| {
         b.iter(|| {
@@ -259,6 +461,17 @@ fn bench_memory_usage(c: &mut Criterion) {
         })
     });
     
+    // Benchmark flattening into the arena AST
+    group.bench_function("arena_ast_creation", |b| {
+        let source = generate_large_module(100);
+        let mut lexer = Lexer::new(&source, "benchmark.aether".to_string());
+        let tokens = lexer.tokenize().unwrap();
+        let mut parser = Parser::new(tokens);
+        let program = parser.parse_program().unwrap();
+
+        b.iter(|| black_box(AstArena::from_program(black_box(&program))))
+    });
+
     // Benchmark symbol table operations
     group.bench_function("symbol_table_operations", |b| {
         let source = generate_large_module(100);
@@ -324,6 +537,8 @@ criterion_group!(
     bench_lexer,
     bench_parser,
     bench_semantic_analysis,
+    bench_symbol_lookup,
+    bench_optimization,
     bench_complete_pipeline,
     bench_memory_usage,
     bench_error_handling
@@ -0,0 +1,175 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//! Contract check runtime support
+//!
+//! Programs with runtime contract checks register their contract names at
+//! startup. Sampled checks ask `aether_contract_sample` whether to run on
+//! each call, and every check that runs records its time. Per-contract calls,
+//! checks and nanoseconds are written to `$AETHER_CONTRACT_STATS_FILE`
+//! (default `aether.contracts`) when the process exits. Failed checks are
+//! reported by `aether_contract_fail`.
+
+use std::ffi::{c_char, CStr};
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::OnceLock;
+use std::time::Instant;
+
+struct ContractCounters {
+    names: Vec<String>,
+    /// Times a sampled check was reached
+    calls: Vec<AtomicU64>,
+    /// Times a check ran
+    checks: Vec<AtomicU64>,
+    nanos: Vec<AtomicU64>,
+}
+
+impl ContractCounters {
+    fn new(names: &str) -> Self {
+        let names: Vec<String> = names.lines().map(str::to_string).collect();
+        let counters = || names.iter().map(|_| AtomicU64::new(0)).collect();
+        Self { calls: counters(), checks: counters(), nanos: counters(), names }
+    }
+}
+
+static COUNTERS: OnceLock<ContractCounters> = OnceLock::new();
+
+static EPOCH: OnceLock<Instant> = OnceLock::new();
+
+/// Allocate counters for one contract per line of `names` and write them out at exit
+#[no_mangle]
+pub unsafe extern "C" fn aether_contract_init(names: *const c_char) {
+    if names.is_null() {
+        return;
+    }
+    
+    let counters = ContractCounters::new(&CStr::from_ptr(names).to_string_lossy());
+    if COUNTERS.set(counters).is_ok() {
+        libc::atexit(write_stats);
+    }
+}
+
+/// Whether a sampled check should run on this call: the first of every `one_in`
+///
+/// Returns 1 or 0, the compiler's representation of a `BOOLEAN`.
+#[no_mangle]
+pub extern "C" fn aether_contract_sample(contract: i32, one_in: u32) -> i32 {
+    match COUNTERS.get().and_then(|counters| counters.calls.get(contract as usize)) {
+        Some(calls) => sample(calls, one_in) as i32,
+        None => 1,
+    }
+}
+
+fn sample(calls: &AtomicU64, one_in: u32) -> bool {
+    calls.fetch_add(1, Ordering::Relaxed) % one_in.max(1) as u64 == 0
+}
+
+/// Start timing a check; pass the result to `aether_contract_end`
+///
+/// Only the low 32 bits of the nanosecond clock are returned, so the value
+/// fits a compiled `INTEGER`. Checks run for far less than the four seconds
+/// it takes to wrap.
+#[no_mangle]
+pub extern "C" fn aether_contract_begin() -> u32 {
+    EPOCH.get_or_init(Instant::now).elapsed().as_nanos() as u32
+}
+
+/// Record that a check started at `start` has finished
+#[no_mangle]
+pub extern "C" fn aether_contract_end(contract: i32, start: u32) {
+    let elapsed = aether_contract_begin().wrapping_sub(start);
+    if let Some(counters) = COUNTERS.get() {
+        let contract = contract as usize;
+        if let (Some(checks), Some(nanos)) = (counters.checks.get(contract), counters.nanos.get(contract)) {
+            checks.fetch_add(1, Ordering::Relaxed);
+            nanos.fetch_add(elapsed as u64, Ordering::Relaxed);
+        }
+    }
+}
+
+/// Report a failed check; a fatal failure writes the statistics and aborts
+#[no_mangle]
+pub unsafe extern "C" fn aether_contract_fail(message: *const c_char, fatal: i32) {
+    let message = if message.is_null() {
+        "contract violated".into()
+    } else {
+        CStr::from_ptr(message).to_string_lossy()
+    };
+    if fatal == 0 {
+        eprintln!("aether: warning: {}", message);
+        return;
+    }
+    
+    eprintln!("aether: {}", message);
+    write_stats();
+    std::process::abort();
+}
+
+/// One `name calls checks nanoseconds` line per contract
+///
+/// Checks that always run are never sampled, so their calls are their checks.
+fn write_table(counters: &ContractCounters, out: &mut impl Write) -> std::io::Result<()> {
+    for (index, name) in counters.names.iter().enumerate() {
+        let checks = counters.checks[index].load(Ordering::Relaxed);
+        let calls = counters.calls[index].load(Ordering::Relaxed).max(checks);
+        writeln!(out, "{} {} {} {}", name, calls, checks, counters.nanos[index].load(Ordering::Relaxed))?;
+    }
+    out.flush()
+}
+
+extern "C" fn write_stats() {
+    let counters = match COUNTERS.get() {
+        Some(counters) => counters,
+        None => return,
+    };
+    let path = std::env::var("AETHER_CONTRACT_STATS_FILE").unwrap_or_else(|_| "aether.contracts".to_string());
+    let file = match File::create(&path) {
+        Ok(file) => file,
+        Err(e) => {
+            eprintln!("aether: failed to write contract statistics {}: {}", path, e);
+            return;
+        }
+    };
+    
+    let _ = write_table(counters, &mut BufWriter::new(file));
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    
+    #[test]
+    fn test_sampling_and_table() {
+        // Before initialization every check runs
+        assert_eq!(aether_contract_sample(0, 10), 1);
+        assert_eq!(aether_contract_sample(0, 10), 1);
+        
+        let counters = ContractCounters::new("abs::precondition_1\nabs::postcondition_1");
+        let sampled: Vec<bool> = (0..5).map(|_| sample(&counters.calls[1], 2)).collect();
+        assert_eq!(sampled, vec![true, false, true, false, true]);
+        counters.checks[0].store(4, Ordering::Relaxed);
+        counters.nanos[0].store(120, Ordering::Relaxed);
+        counters.checks[1].store(3, Ordering::Relaxed);
+        
+        let mut table = Vec::new();
+        write_table(&counters, &mut table).unwrap();
+        assert_eq!(
+            String::from_utf8(table).unwrap(),
+            "abs::precondition_1 4 4 120\nabs::postcondition_1 5 3 0\n"
+        );
+    }
+}
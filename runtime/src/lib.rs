@@ -145,6 +145,8 @@ pub mod time;
 pub mod concurrency;
 pub mod ffi;
 pub mod ffi_structs;
+pub mod profile;
+pub mod contracts;
 
 /// Array structure with length prefix
 /// Memory layout: [length: i32][elements...]
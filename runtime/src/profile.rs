@@ -0,0 +1,105 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//! Profile counter runtime support
+//!
+//! Programs compiled with `--profile-generate` register their counter names
+//! at startup and bump counters as they run. The counts are written to
+//! `$AETHER_PROFILE_FILE` (default `aether.profraw`) when the process exits.
+//! `CFG:` lines of the table carry the compiler's CFG checksums and are
+//! written back unchanged.
+
+use std::ffi::{c_char, CStr};
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::OnceLock;
+
+struct ProfileCounters {
+    names: Vec<String>,
+    counts: Vec<AtomicU64>,
+}
+
+impl ProfileCounters {
+    fn new(names: &str) -> Self {
+        let names: Vec<String> = names.lines().map(str::to_string).collect();
+        let counts = names.iter().map(|_| AtomicU64::new(0)).collect();
+        Self { names, counts }
+    }
+}
+
+static COUNTERS: OnceLock<ProfileCounters> = OnceLock::new();
+
+/// Allocate one counter per line of `names` and write them out at exit
+#[no_mangle]
+pub unsafe extern "C" fn aether_profile_init(names: *const c_char) {
+    if names.is_null() {
+        return;
+    }
+    
+    let counters = ProfileCounters::new(&CStr::from_ptr(names).to_string_lossy());
+    if COUNTERS.set(counters).is_ok() {
+        libc::atexit(write_profile);
+    }
+}
+
+/// Bump a counter; does nothing before `aether_profile_init`
+#[no_mangle]
+pub extern "C" fn aether_profile_count(counter: i32) {
+    if let Some(counter) = COUNTERS.get().and_then(|counters| counters.counts.get(counter as usize)) {
+        counter.fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+extern "C" fn write_profile() {
+    let counters = match COUNTERS.get() {
+        Some(counters) => counters,
+        None => return,
+    };
+    let path = std::env::var("AETHER_PROFILE_FILE").unwrap_or_else(|_| "aether.profraw".to_string());
+    let file = match File::create(&path) {
+        Ok(file) => file,
+        Err(e) => {
+            eprintln!("aether: failed to write profile {}: {}", path, e);
+            return;
+        }
+    };
+    
+    let mut out = BufWriter::new(file);
+    for (name, count) in counters.names.iter().zip(&counters.counts) {
+        let _ = if name.starts_with("CFG:") {
+            writeln!(out, "{}", name)
+        } else {
+            writeln!(out, "{}:{}", name, count.load(Ordering::Relaxed))
+        };
+    }
+    let _ = out.flush();
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    
+    #[test]
+    fn test_counter_table() {
+        // Counting before initialization is a no-op
+        aether_profile_count(0);
+        assert!(COUNTERS.get().is_none());
+        
+        let counters = ProfileCounters::new("FUNC:main\nBLOCK:main:0");
+        assert_eq!(counters.names, vec!["FUNC:main", "BLOCK:main:0"]);
+        assert_eq!(counters.counts.len(), 2);
+    }
+}
@@ -28,4 +28,13 @@ rustc --crate-type staticlib \
       -o target/runtime/libaether_runtime.a \
       src/runtime/mod.rs
 
-echo "Runtime library built at target/runtime/libaether_runtime.a"
\ No newline at end of file
+echo "Runtime library built at target/runtime/libaether_runtime.a"
+
+# With --lto, also build the runtime crate as a bitcode archive for
+# `aether compile --lto`. Rust's LLVM must match the clang/lld used to link.
+if [ "$1" = "--lto" ]; then
+    echo "Building bitcode runtime for ThinLTO..."
+    (cd runtime && RUSTFLAGS="-C linker-plugin-lto" \
+        cargo build --release --lib --target-dir target/lto)
+    echo "LTO runtime built at runtime/target/lto/release/libaether_runtime.a"
+fi
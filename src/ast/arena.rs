@@ -0,0 +1,1427 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Arena-allocated AST with compact node IDs
+//!
+//! Nodes live in typed vectors owned by an [`AstArena`]. Children are referred
+//! to by `u32` IDs, variable-length children are ranges into shared side
+//! tables, identifiers and string literals are interned [`Symbol`]s, and each
+//! node carries a 16-byte [`Span`] instead of a `SourceLocation` with an owned
+//! file name. Traversals walk contiguous memory instead of chasing boxes.
+
+use super::{
+    AssignmentTarget, Block, CastFailureBehavior, Expression, Function, FunctionReference,
+    Module, Mutability, OwnershipKind, Pattern, PointerOp, PrimitiveType, Program, Statement,
+    TypeDefinition, TypeSpecifier,
+};
+use crate::error::SourceLocation;
+use std::collections::HashMap;
+use std::marker::PhantomData;
+use std::mem::size_of;
+
+macro_rules! node_id {
+    ($(#[$meta:meta])* $name:ident) => {
+        $(#[$meta])*
+        #[derive(Debug, Clone, Copy, Default, PartialEq, Eq, Hash, PartialOrd, Ord)]
+        pub struct $name(pub u32);
+
+        impl $name {
+            #[inline]
+            pub fn index(self) -> usize {
+                self.0 as usize
+            }
+        }
+    };
+}
+
+node_id!(
+    /// Interned identifier or string literal
+    Symbol
+);
+node_id!(
+    /// Index into [`AstArena::exprs`]
+    ExprId
+);
+node_id!(
+    /// Index into [`AstArena::stmts`]
+    StmtId
+);
+node_id!(
+    /// Index into [`AstArena::types`]
+    TypeNodeId
+);
+node_id!(
+    /// Index into [`AstArena::patterns`]
+    PatternId
+);
+node_id!(
+    /// Index into [`AstArena::functions`]
+    FunctionId
+);
+node_id!(
+    /// Index into [`AstArena::modules`]
+    ModuleId
+);
+
+/// String interner mapping identifiers to dense [`Symbol`]s
+#[derive(Debug, Clone, Default)]
+pub struct Interner {
+    map: HashMap<Box<str>, Symbol>,
+    strings: Vec<Box<str>>,
+}
+
+impl Interner {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Intern a string, returning the existing symbol if already present
+    pub fn intern(&mut self, name: &str) -> Symbol {
+        if let Some(&symbol) = self.map.get(name) {
+            return symbol;
+        }
+        let symbol = Symbol(self.strings.len() as u32);
+        let owned: Box<str> = name.into();
+        self.strings.push(owned.clone());
+        self.map.insert(owned, symbol);
+        symbol
+    }
+
+    /// Look up a string without interning it
+    pub fn get(&self, name: &str) -> Option<Symbol> {
+        self.map.get(name).copied()
+    }
+
+    /// Resolve a symbol back to its string
+    pub fn resolve(&self, symbol: Symbol) -> &str {
+        &self.strings[symbol.index()]
+    }
+
+    pub fn len(&self) -> usize {
+        self.strings.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.strings.is_empty()
+    }
+
+    /// Approximate heap bytes held by the interner
+    pub fn heap_bytes(&self) -> usize {
+        let text: usize = self.strings.iter().map(|s| s.len()).sum();
+        // Each string is stored twice (table and map key)
+        text * 2
+            + self.strings.capacity() * size_of::<Box<str>>()
+            + self.map.capacity() * (size_of::<Box<str>>() + size_of::<Symbol>())
+    }
+}
+
+/// Compact source span: interned file name plus offset/line/column
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq, Hash)]
+pub struct Span {
+    pub file: Symbol,
+    pub offset: u32,
+    pub line: u32,
+    pub column: u32,
+}
+
+impl Span {
+    pub fn from_location(location: &SourceLocation, interner: &mut Interner) -> Self {
+        Self {
+            file: interner.intern(&location.file),
+            offset: location.offset as u32,
+            line: location.line as u32,
+            column: location.column as u32,
+        }
+    }
+
+    /// Expand back into a `SourceLocation` for diagnostics
+    pub fn to_location(&self, interner: &Interner) -> SourceLocation {
+        SourceLocation::new(
+            interner.resolve(self.file).to_string(),
+            self.line as usize,
+            self.column as usize,
+            self.offset as usize,
+        )
+    }
+}
+
+/// Range of entries in one of the arena's side tables
+#[derive(Debug)]
+pub struct IdList<T> {
+    start: u32,
+    len: u32,
+    _marker: PhantomData<T>,
+}
+
+impl<T> Clone for IdList<T> {
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+
+impl<T> Copy for IdList<T> {}
+
+impl<T> Default for IdList<T> {
+    fn default() -> Self {
+        Self { start: 0, len: 0, _marker: PhantomData }
+    }
+}
+
+impl<T> IdList<T> {
+    pub fn len(&self) -> usize {
+        self.len as usize
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    fn range(&self) -> std::ops::Range<usize> {
+        self.start as usize..(self.start + self.len) as usize
+    }
+}
+
+/// Binary operators (including two-operand accesses)
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum BinaryOp {
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    IntegerDivide,
+    Modulo,
+    Equals,
+    NotEquals,
+    LessThan,
+    LessThanOrEqual,
+    GreaterThan,
+    GreaterThanOrEqual,
+    StringEquals,
+    StringContains,
+    StringCharAt,
+    ArrayAccess,
+    MapAccess,
+    PointerAdd,
+    PointerSubtract,
+    VectorExtract,
+}
+
+/// Unary operators
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum UnaryOp {
+    Negate,
+    Not,
+    StringLength,
+    ArrayLength,
+    AddressOf,
+    Dereference,
+}
+
+/// Variadic operators
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum NaryOp {
+    And,
+    Or,
+    Concat,
+    /// Vector literal, one operand per lane
+    Vector,
+}
+
+/// Call target
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum Callee {
+    Local(Symbol),
+    Qualified { module: Symbol, name: Symbol },
+    External(Symbol),
+}
+
+/// Expression node payload
+#[derive(Debug, Clone, Copy)]
+pub enum ExprKind {
+    Integer(i64),
+    Float(f64),
+    Str(Symbol),
+    Char(char),
+    Bool(bool),
+    Null,
+    Variable(Symbol),
+    EnumMember { enum_type: Symbol, variant: Symbol },
+    Binary { op: BinaryOp, lhs: ExprId, rhs: ExprId },
+    Unary { op: UnaryOp, operand: ExprId },
+    Nary { op: NaryOp, operands: IdList<ExprId> },
+    Substring { string: ExprId, start: ExprId, length: ExprId },
+    Cast { value: ExprId, target: TypeNodeId, or_default: bool },
+    Call { callee: Callee, args: IdList<(Symbol, ExprId)>, variadic: IdList<ExprId> },
+    FieldAccess { instance: ExprId, field: Symbol },
+    StructConstruct { type_name: Symbol, fields: IdList<(Symbol, ExprId)> },
+    ArrayLiteral { element_type: TypeNodeId, elements: IdList<ExprId> },
+    /// Entries are stored as consecutive key/value pairs
+    MapLiteral { key_type: TypeNodeId, value_type: TypeNodeId, entries: IdList<ExprId> },
+    Match { value: ExprId, arms: IdList<MatchArm> },
+    EnumVariant { enum_name: Symbol, variant: Symbol, value: Option<ExprId> },
+    VectorSplat { value: ExprId, lanes: u32 },
+    VectorLoad { array: ExprId, index: ExprId, lanes: u32 },
+    VectorStore { array: ExprId, index: ExprId, value: ExprId },
+    VectorShuffle { left: ExprId, right: ExprId, mask: IdList<u32> },
+    VectorSelect { mask: ExprId, if_true: ExprId, if_false: ExprId },
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct ExprNode {
+    pub kind: ExprKind,
+    pub span: Span,
+}
+
+/// Match arm in the side table
+#[derive(Debug, Clone, Copy)]
+pub struct MatchArm {
+    pub pattern: PatternId,
+    pub body: ExprId,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub enum PatternKind {
+    EnumVariant {
+        enum_name: Option<Symbol>,
+        variant: Symbol,
+        binding: Option<Symbol>,
+        nested: Option<PatternId>,
+    },
+    Literal(ExprId),
+    Wildcard { binding: Option<Symbol> },
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct PatternNode {
+    pub kind: PatternKind,
+    pub span: Span,
+}
+
+/// Type specifier node payload
+#[derive(Debug, Clone, Copy)]
+pub enum TypeKind {
+    Primitive(PrimitiveType),
+    Named(Symbol),
+    Generic { base: Symbol, args: IdList<TypeNodeId> },
+    Parameter(Symbol),
+    Array { element: TypeNodeId, size: Option<ExprId> },
+    Map { key: TypeNodeId, value: TypeNodeId },
+    Vector { element: TypeNodeId, lanes: u32 },
+    Pointer { target: TypeNodeId, is_mutable: bool },
+    Function { params: IdList<TypeNodeId>, ret: TypeNodeId },
+    Owned { base: TypeNodeId, ownership: OwnershipKind },
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct TypeNode {
+    pub kind: TypeKind,
+    pub span: Span,
+}
+
+/// Assignment target
+#[derive(Debug, Clone, Copy)]
+pub enum AssignTarget {
+    Variable(Symbol),
+    ArrayElement { array: ExprId, index: ExprId },
+    StructField { instance: ExprId, field: Symbol },
+    MapValue { map: ExprId, key: ExprId },
+    Dereference(ExprId),
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct ElseIfNode {
+    pub condition: ExprId,
+    pub body: IdList<StmtId>,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct CatchNode {
+    pub exception_type: TypeNodeId,
+    pub binding: Option<Symbol>,
+    pub body: IdList<StmtId>,
+}
+
+/// Statement node payload
+#[derive(Debug, Clone, Copy)]
+pub enum StmtKind {
+    Let { name: Symbol, ty: TypeNodeId, mutable: bool, init: Option<ExprId> },
+    Assign { target: AssignTarget, value: ExprId },
+    /// Expression statements and call statements
+    Expr(ExprId),
+    Return(Option<ExprId>),
+    If {
+        condition: ExprId,
+        then_body: IdList<StmtId>,
+        else_ifs: IdList<ElseIfNode>,
+        else_body: Option<IdList<StmtId>>,
+    },
+    While { condition: ExprId, body: IdList<StmtId>, label: Option<Symbol> },
+    ForEach {
+        collection: ExprId,
+        element: Symbol,
+        element_type: TypeNodeId,
+        index: Option<Symbol>,
+        body: IdList<StmtId>,
+        label: Option<Symbol>,
+    },
+    FixedIteration {
+        counter: Symbol,
+        from: ExprId,
+        to: ExprId,
+        step: Option<ExprId>,
+        inclusive: bool,
+        body: IdList<StmtId>,
+        label: Option<Symbol>,
+    },
+    Break(Option<Symbol>),
+    Continue(Option<Symbol>),
+    Try {
+        body: IdList<StmtId>,
+        catches: IdList<CatchNode>,
+        finally: Option<IdList<StmtId>>,
+    },
+    Throw(ExprId),
+    /// Resource acquisitions stay on the boxed AST; only the body is flattened
+    ResourceScope { scope_id: Symbol, body: IdList<StmtId> },
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct StmtNode {
+    pub kind: StmtKind,
+    pub span: Span,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct ParamNode {
+    pub name: Symbol,
+    pub ty: TypeNodeId,
+    pub span: Span,
+}
+
+/// Function node. Metadata other than contracts stays on the boxed AST.
+#[derive(Debug, Clone, Copy)]
+pub struct FunctionNode {
+    pub name: Symbol,
+    pub params: IdList<ParamNode>,
+    pub return_type: TypeNodeId,
+    pub body: IdList<StmtId>,
+    pub preconditions: IdList<ExprId>,
+    pub postconditions: IdList<ExprId>,
+    pub span: Span,
+}
+
+/// Struct field or enum variant
+#[derive(Debug, Clone, Copy)]
+pub struct MemberNode {
+    pub name: Symbol,
+    pub ty: Option<TypeNodeId>,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub enum TypeDefKind {
+    Struct { fields: IdList<MemberNode> },
+    Enum { variants: IdList<MemberNode> },
+    Alias { target: TypeNodeId },
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct TypeDefNode {
+    pub name: Symbol,
+    pub kind: TypeDefKind,
+    pub span: Span,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct ConstantNode {
+    pub name: Symbol,
+    pub ty: TypeNodeId,
+    pub value: ExprId,
+    pub span: Span,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct ModuleNode {
+    pub name: Symbol,
+    pub imports: IdList<Symbol>,
+    pub type_definitions: IdList<TypeDefNode>,
+    pub constants: IdList<ConstantNode>,
+    pub functions: IdList<FunctionId>,
+    pub span: Span,
+}
+
+/// Owner of every node of a flattened program
+#[derive(Debug, Default)]
+pub struct AstArena {
+    pub interner: Interner,
+    pub modules: Vec<ModuleNode>,
+    pub functions: Vec<FunctionNode>,
+    pub stmts: Vec<StmtNode>,
+    pub exprs: Vec<ExprNode>,
+    pub types: Vec<TypeNode>,
+    pub patterns: Vec<PatternNode>,
+
+    // Side tables addressed by `IdList` ranges
+    expr_lists: Vec<ExprId>,
+    stmt_lists: Vec<StmtId>,
+    type_lists: Vec<TypeNodeId>,
+    symbol_lists: Vec<Symbol>,
+    function_lists: Vec<FunctionId>,
+    named_exprs: Vec<(Symbol, ExprId)>,
+    lane_lists: Vec<u32>,
+    match_arms: Vec<MatchArm>,
+    else_ifs: Vec<ElseIfNode>,
+    catches: Vec<CatchNode>,
+    params: Vec<ParamNode>,
+    members: Vec<MemberNode>,
+    type_defs: Vec<TypeDefNode>,
+    constants: Vec<ConstantNode>,
+}
+
+fn push_list<T>(table: &mut Vec<T>, items: Vec<T>) -> IdList<T> {
+    let start = table.len() as u32;
+    let len = items.len() as u32;
+    table.extend(items);
+    IdList { start, len, _marker: PhantomData }
+}
+
+impl AstArena {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Flatten a whole program into a new arena
+    pub fn from_program(program: &Program) -> Self {
+        let mut arena = Self::new();
+        for module in &program.modules {
+            arena.alloc_module(module);
+        }
+        arena
+    }
+
+    pub fn module(&self, id: ModuleId) -> &ModuleNode {
+        &self.modules[id.index()]
+    }
+
+    pub fn function(&self, id: FunctionId) -> &FunctionNode {
+        &self.functions[id.index()]
+    }
+
+    pub fn stmt(&self, id: StmtId) -> &StmtNode {
+        &self.stmts[id.index()]
+    }
+
+    pub fn expr(&self, id: ExprId) -> &ExprNode {
+        &self.exprs[id.index()]
+    }
+
+    pub fn type_node(&self, id: TypeNodeId) -> &TypeNode {
+        &self.types[id.index()]
+    }
+
+    pub fn pattern(&self, id: PatternId) -> &PatternNode {
+        &self.patterns[id.index()]
+    }
+
+    pub fn name(&self, symbol: Symbol) -> &str {
+        self.interner.resolve(symbol)
+    }
+
+    pub fn expr_list(&self, list: IdList<ExprId>) -> &[ExprId] {
+        &self.expr_lists[list.range()]
+    }
+
+    pub fn stmt_list(&self, list: IdList<StmtId>) -> &[StmtId] {
+        &self.stmt_lists[list.range()]
+    }
+
+    pub fn type_list(&self, list: IdList<TypeNodeId>) -> &[TypeNodeId] {
+        &self.type_lists[list.range()]
+    }
+
+    pub fn symbol_list(&self, list: IdList<Symbol>) -> &[Symbol] {
+        &self.symbol_lists[list.range()]
+    }
+
+    pub fn function_list(&self, list: IdList<FunctionId>) -> &[FunctionId] {
+        &self.function_lists[list.range()]
+    }
+
+    pub fn named_expr_list(&self, list: IdList<(Symbol, ExprId)>) -> &[(Symbol, ExprId)] {
+        &self.named_exprs[list.range()]
+    }
+
+    pub fn lane_list(&self, list: IdList<u32>) -> &[u32] {
+        &self.lane_lists[list.range()]
+    }
+
+    pub fn match_arm_list(&self, list: IdList<MatchArm>) -> &[MatchArm] {
+        &self.match_arms[list.range()]
+    }
+
+    pub fn else_if_list(&self, list: IdList<ElseIfNode>) -> &[ElseIfNode] {
+        &self.else_ifs[list.range()]
+    }
+
+    pub fn catch_list(&self, list: IdList<CatchNode>) -> &[CatchNode] {
+        &self.catches[list.range()]
+    }
+
+    pub fn param_list(&self, list: IdList<ParamNode>) -> &[ParamNode] {
+        &self.params[list.range()]
+    }
+
+    pub fn member_list(&self, list: IdList<MemberNode>) -> &[MemberNode] {
+        &self.members[list.range()]
+    }
+
+    pub fn type_def_list(&self, list: IdList<TypeDefNode>) -> &[TypeDefNode] {
+        &self.type_defs[list.range()]
+    }
+
+    pub fn constant_list(&self, list: IdList<ConstantNode>) -> &[ConstantNode] {
+        &self.constants[list.range()]
+    }
+
+    /// Total number of nodes across all typed vectors
+    pub fn node_count(&self) -> usize {
+        self.modules.len()
+            + self.functions.len()
+            + self.stmts.len()
+            + self.exprs.len()
+            + self.types.len()
+            + self.patterns.len()
+    }
+
+    /// Approximate heap bytes held by the arena
+    pub fn heap_bytes(&self) -> usize {
+        fn bytes<T>(v: &Vec<T>) -> usize {
+            v.capacity() * size_of::<T>()
+        }
+        self.interner.heap_bytes()
+            + bytes(&self.modules)
+            + bytes(&self.functions)
+            + bytes(&self.stmts)
+            + bytes(&self.exprs)
+            + bytes(&self.types)
+            + bytes(&self.patterns)
+            + bytes(&self.expr_lists)
+            + bytes(&self.stmt_lists)
+            + bytes(&self.type_lists)
+            + bytes(&self.symbol_lists)
+            + bytes(&self.function_lists)
+            + bytes(&self.named_exprs)
+            + bytes(&self.lane_lists)
+            + bytes(&self.match_arms)
+            + bytes(&self.else_ifs)
+            + bytes(&self.catches)
+            + bytes(&self.params)
+            + bytes(&self.members)
+            + bytes(&self.type_defs)
+            + bytes(&self.constants)
+    }
+
+    fn span(&mut self, location: &SourceLocation) -> Span {
+        Span::from_location(location, &mut self.interner)
+    }
+
+    fn sym(&mut self, name: &str) -> Symbol {
+        self.interner.intern(name)
+    }
+
+    /// Flatten one module, returning its ID
+    pub fn alloc_module(&mut self, module: &Module) -> ModuleId {
+        let functions: Vec<FunctionId> = module
+            .function_definitions
+            .iter()
+            .map(|function| self.alloc_function(function))
+            .collect();
+        self.alloc_module_with_functions(module, functions)
+    }
+
+    /// Flatten one module whose functions are already in the arena, in order
+    ///
+    /// The parser allocates each function as it finishes it.
+    pub fn alloc_module_with_functions(&mut self, module: &Module, functions: Vec<FunctionId>) -> ModuleId {
+        let span = self.span(&module.source_location);
+        let name = self.sym(&module.name.name);
+
+        let imports: Vec<Symbol> = module
+            .imports
+            .iter()
+            .map(|import| self.sym(&import.module_name.name))
+            .collect();
+        let imports = push_list(&mut self.symbol_lists, imports);
+
+        let type_defs: Vec<TypeDefNode> = module
+            .type_definitions
+            .iter()
+            .map(|def| self.alloc_type_definition(def))
+            .collect();
+        let type_definitions = push_list(&mut self.type_defs, type_defs);
+
+        let constants: Vec<ConstantNode> = module
+            .constant_declarations
+            .iter()
+            .map(|constant| ConstantNode {
+                name: self.sym(&constant.name.name),
+                ty: self.alloc_type(&constant.type_spec),
+                value: self.alloc_expr(&constant.value),
+                span: self.span(&constant.source_location),
+            })
+            .collect();
+        let constants = push_list(&mut self.constants, constants);
+
+        let functions = push_list(&mut self.function_lists, functions);
+
+        let id = ModuleId(self.modules.len() as u32);
+        self.modules.push(ModuleNode {
+            name,
+            imports,
+            type_definitions,
+            constants,
+            functions,
+            span,
+        });
+        id
+    }
+
+    fn alloc_type_definition(&mut self, def: &TypeDefinition) -> TypeDefNode {
+        match def {
+            TypeDefinition::Structured { name, fields, source_location, .. } => {
+                let members: Vec<MemberNode> = fields
+                    .iter()
+                    .map(|field| MemberNode {
+                        name: self.sym(&field.name.name),
+                        ty: Some(self.alloc_type(&field.field_type)),
+                    })
+                    .collect();
+                TypeDefNode {
+                    name: self.sym(&name.name),
+                    kind: TypeDefKind::Struct { fields: push_list(&mut self.members, members) },
+                    span: self.span(source_location),
+                }
+            }
+            TypeDefinition::Enumeration { name, variants, source_location, .. } => {
+                let members: Vec<MemberNode> = variants
+                    .iter()
+                    .map(|variant| MemberNode {
+                        name: self.sym(&variant.name.name),
+                        ty: variant.associated_type.as_ref().map(|ty| self.alloc_type(ty)),
+                    })
+                    .collect();
+                TypeDefNode {
+                    name: self.sym(&name.name),
+                    kind: TypeDefKind::Enum { variants: push_list(&mut self.members, members) },
+                    span: self.span(source_location),
+                }
+            }
+            TypeDefinition::Alias { new_name, original_type, source_location, .. } => TypeDefNode {
+                name: self.sym(&new_name.name),
+                kind: TypeDefKind::Alias { target: self.alloc_type(original_type) },
+                span: self.span(source_location),
+            },
+        }
+    }
+
+    /// Flatten one function, returning its ID
+    pub fn alloc_function(&mut self, function: &Function) -> FunctionId {
+        let span = self.span(&function.source_location);
+        let name = self.sym(&function.name.name);
+
+        let params: Vec<ParamNode> = function
+            .parameters
+            .iter()
+            .map(|param| ParamNode {
+                name: self.sym(&param.name.name),
+                ty: self.alloc_type(&param.param_type),
+                span: self.span(&param.source_location),
+            })
+            .collect();
+        let params = push_list(&mut self.params, params);
+        let return_type = self.alloc_type(&function.return_type);
+
+        let pre: Vec<ExprId> = function
+            .metadata
+            .preconditions
+            .iter()
+            .map(|c| self.alloc_expr(&c.condition))
+            .collect();
+        let preconditions = push_list(&mut self.expr_lists, pre);
+        let post: Vec<ExprId> = function
+            .metadata
+            .postconditions
+            .iter()
+            .map(|c| self.alloc_expr(&c.condition))
+            .collect();
+        let postconditions = push_list(&mut self.expr_lists, post);
+
+        let body = self.alloc_block(&function.body);
+
+        let id = FunctionId(self.functions.len() as u32);
+        self.functions.push(FunctionNode {
+            name,
+            params,
+            return_type,
+            body,
+            preconditions,
+            postconditions,
+            span,
+        });
+        id
+    }
+
+    fn alloc_block(&mut self, block: &Block) -> IdList<StmtId> {
+        let stmts: Vec<StmtId> = block.statements.iter().map(|s| self.alloc_stmt(s)).collect();
+        push_list(&mut self.stmt_lists, stmts)
+    }
+
+    fn alloc_label(&mut self, label: &Option<super::Identifier>) -> Option<Symbol> {
+        label.as_ref().map(|l| self.sym(&l.name))
+    }
+
+    pub fn alloc_stmt(&mut self, stmt: &Statement) -> StmtId {
+        let (kind, location) = match stmt {
+            Statement::VariableDeclaration {
+                name, type_spec, mutability, initial_value, source_location, ..
+            } => (
+                StmtKind::Let {
+                    name: self.sym(&name.name),
+                    ty: self.alloc_type(type_spec),
+                    mutable: matches!(mutability, Mutability::Mutable),
+                    init: initial_value.as_ref().map(|v| self.alloc_expr(v)),
+                },
+                source_location,
+            ),
+            Statement::Assignment { target, value, source_location } => {
+                let target = match target {
+                    AssignmentTarget::Variable { name } => AssignTarget::Variable(self.sym(&name.name)),
+                    AssignmentTarget::ArrayElement { array, index } => AssignTarget::ArrayElement {
+                        array: self.alloc_expr(array),
+                        index: self.alloc_expr(index),
+                    },
+                    AssignmentTarget::StructField { instance, field_name } => AssignTarget::StructField {
+                        instance: self.alloc_expr(instance),
+                        field: self.sym(&field_name.name),
+                    },
+                    AssignmentTarget::MapValue { map, key } => AssignTarget::MapValue {
+                        map: self.alloc_expr(map),
+                        key: self.alloc_expr(key),
+                    },
+                    AssignmentTarget::Dereference { pointer } => {
+                        AssignTarget::Dereference(self.alloc_expr(pointer))
+                    }
+                };
+                (StmtKind::Assign { target, value: self.alloc_expr(value) }, source_location)
+            }
+            Statement::FunctionCall { call, source_location } => {
+                let call_expr = self.alloc_call(call, source_location);
+                (StmtKind::Expr(call_expr), source_location)
+            }
+            Statement::Return { value, source_location } => (
+                StmtKind::Return(value.as_ref().map(|v| self.alloc_expr(v))),
+                source_location,
+            ),
+            Statement::If { condition, then_block, else_ifs, else_block, source_location } => {
+                let condition = self.alloc_expr(condition);
+                let then_body = self.alloc_block(then_block);
+                let nodes: Vec<ElseIfNode> = else_ifs
+                    .iter()
+                    .map(|else_if| ElseIfNode {
+                        condition: self.alloc_expr(&else_if.condition),
+                        body: self.alloc_block(&else_if.block),
+                    })
+                    .collect();
+                let else_ifs = push_list(&mut self.else_ifs, nodes);
+                let else_body = else_block.as_ref().map(|b| self.alloc_block(b));
+                (StmtKind::If { condition, then_body, else_ifs, else_body }, source_location)
+            }
+            Statement::WhileLoop { condition, body, label, source_location, .. } => (
+                StmtKind::While {
+                    condition: self.alloc_expr(condition),
+                    body: self.alloc_block(body),
+                    label: self.alloc_label(label),
+                },
+                source_location,
+            ),
+            Statement::ForEachLoop {
+                collection, element_binding, element_type, index_binding, body, label, source_location,
+            } => (
+                StmtKind::ForEach {
+                    collection: self.alloc_expr(collection),
+                    element: self.sym(&element_binding.name),
+                    element_type: self.alloc_type(element_type),
+                    index: self.alloc_label(index_binding),
+                    body: self.alloc_block(body),
+                    label: self.alloc_label(label),
+                },
+                source_location,
+            ),
+            Statement::FixedIterationLoop {
+                counter, from_value, to_value, step_value, inclusive, body, label, source_location,
+            } => (
+                StmtKind::FixedIteration {
+                    counter: self.sym(&counter.name),
+                    from: self.alloc_expr(from_value),
+                    to: self.alloc_expr(to_value),
+                    step: step_value.as_ref().map(|s| self.alloc_expr(s)),
+                    inclusive: *inclusive,
+                    body: self.alloc_block(body),
+                    label: self.alloc_label(label),
+                },
+                source_location,
+            ),
+            Statement::Break { target_label, source_location } => {
+                (StmtKind::Break(self.alloc_label(target_label)), source_location)
+            }
+            Statement::Continue { target_label, source_location } => {
+                (StmtKind::Continue(self.alloc_label(target_label)), source_location)
+            }
+            Statement::TryBlock { protected_block, catch_clauses, finally_block, source_location } => {
+                let body = self.alloc_block(protected_block);
+                let nodes: Vec<CatchNode> = catch_clauses
+                    .iter()
+                    .map(|clause| CatchNode {
+                        exception_type: self.alloc_type(&clause.exception_type),
+                        binding: self.alloc_label(&clause.binding_variable),
+                        body: self.alloc_block(&clause.handler_block),
+                    })
+                    .collect();
+                let catches = push_list(&mut self.catches, nodes);
+                let finally = finally_block.as_ref().map(|b| self.alloc_block(b));
+                (StmtKind::Try { body, catches, finally }, source_location)
+            }
+            Statement::Throw { exception, source_location } => {
+                (StmtKind::Throw(self.alloc_expr(exception)), source_location)
+            }
+            Statement::ResourceScope { scope, source_location } => (
+                StmtKind::ResourceScope {
+                    scope_id: self.sym(&scope.scope_id),
+                    body: self.alloc_block(&scope.body),
+                },
+                source_location,
+            ),
+            Statement::Expression { expr, source_location } => {
+                (StmtKind::Expr(self.alloc_expr(expr)), source_location)
+            }
+        };
+        let span = self.span(location);
+        let id = StmtId(self.stmts.len() as u32);
+        self.stmts.push(StmtNode { kind, span });
+        id
+    }
+
+    fn push_expr(&mut self, kind: ExprKind, location: &SourceLocation) -> ExprId {
+        let span = self.span(location);
+        let id = ExprId(self.exprs.len() as u32);
+        self.exprs.push(ExprNode { kind, span });
+        id
+    }
+
+    fn binary(&mut self, op: BinaryOp, lhs: &Expression, rhs: &Expression) -> ExprKind {
+        let lhs = self.alloc_expr(lhs);
+        let rhs = self.alloc_expr(rhs);
+        ExprKind::Binary { op, lhs, rhs }
+    }
+
+    fn unary(&mut self, op: UnaryOp, operand: &Expression) -> ExprKind {
+        ExprKind::Unary { op, operand: self.alloc_expr(operand) }
+    }
+
+    fn nary(&mut self, op: NaryOp, operands: &[Expression]) -> ExprKind {
+        let ids: Vec<ExprId> = operands.iter().map(|e| self.alloc_expr(e)).collect();
+        ExprKind::Nary { op, operands: push_list(&mut self.expr_lists, ids) }
+    }
+
+    fn alloc_call(&mut self, call: &super::FunctionCall, location: &SourceLocation) -> ExprId {
+        let callee = match &call.function_reference {
+            FunctionReference::Local { name } => Callee::Local(self.sym(&name.name)),
+            FunctionReference::Qualified { module, name } => Callee::Qualified {
+                module: self.sym(&module.name),
+                name: self.sym(&name.name),
+            },
+            FunctionReference::External { name } => Callee::External(self.sym(&name.name)),
+        };
+        let args: Vec<(Symbol, ExprId)> = call
+            .arguments
+            .iter()
+            .map(|arg| (self.sym(&arg.parameter_name.name), self.alloc_expr(&arg.value)))
+            .collect();
+        let args = push_list(&mut self.named_exprs, args);
+        let variadic: Vec<ExprId> = call.variadic_arguments.iter().map(|e| self.alloc_expr(e)).collect();
+        let variadic = push_list(&mut self.expr_lists, variadic);
+        self.push_expr(ExprKind::Call { callee, args, variadic }, location)
+    }
+
+    /// Flatten an expression tree, returning the root ID
+    pub fn alloc_expr(&mut self, expr: &Expression) -> ExprId {
+        let (kind, location) = match expr {
+            Expression::IntegerLiteral { value, source_location } => (ExprKind::Integer(*value), source_location),
+            Expression::FloatLiteral { value, source_location } => (ExprKind::Float(*value), source_location),
+            Expression::StringLiteral { value, source_location } => {
+                (ExprKind::Str(self.sym(value)), source_location)
+            }
+            Expression::CharacterLiteral { value, source_location } => (ExprKind::Char(*value), source_location),
+            Expression::BooleanLiteral { value, source_location } => (ExprKind::Bool(*value), source_location),
+            Expression::NullLiteral { source_location } => (ExprKind::Null, source_location),
+            Expression::Variable { name, source_location } => {
+                (ExprKind::Variable(self.sym(&name.name)), source_location)
+            }
+            Expression::EnumMember { enum_type, variant, source_location } => (
+                ExprKind::EnumMember { enum_type: self.sym(&enum_type.name), variant: self.sym(&variant.name) },
+                source_location,
+            ),
+            Expression::Add { left, right, source_location } => (self.binary(BinaryOp::Add, left, right), source_location),
+            Expression::Subtract { left, right, source_location } => {
+                (self.binary(BinaryOp::Subtract, left, right), source_location)
+            }
+            Expression::Multiply { left, right, source_location } => {
+                (self.binary(BinaryOp::Multiply, left, right), source_location)
+            }
+            Expression::Divide { left, right, source_location } => {
+                (self.binary(BinaryOp::Divide, left, right), source_location)
+            }
+            Expression::IntegerDivide { left, right, source_location } => {
+                (self.binary(BinaryOp::IntegerDivide, left, right), source_location)
+            }
+            Expression::Modulo { left, right, source_location } => {
+                (self.binary(BinaryOp::Modulo, left, right), source_location)
+            }
+            Expression::Negate { operand, source_location } => (self.unary(UnaryOp::Negate, operand), source_location),
+            Expression::Equals { left, right, source_location } => {
+                (self.binary(BinaryOp::Equals, left, right), source_location)
+            }
+            Expression::NotEquals { left, right, source_location } => {
+                (self.binary(BinaryOp::NotEquals, left, right), source_location)
+            }
+            Expression::LessThan { left, right, source_location } => {
+                (self.binary(BinaryOp::LessThan, left, right), source_location)
+            }
+            Expression::LessThanOrEqual { left, right, source_location } => {
+                (self.binary(BinaryOp::LessThanOrEqual, left, right), source_location)
+            }
+            Expression::GreaterThan { left, right, source_location } => {
+                (self.binary(BinaryOp::GreaterThan, left, right), source_location)
+            }
+            Expression::GreaterThanOrEqual { left, right, source_location } => {
+                (self.binary(BinaryOp::GreaterThanOrEqual, left, right), source_location)
+            }
+            Expression::LogicalAnd { operands, source_location } => (self.nary(NaryOp::And, operands), source_location),
+            Expression::LogicalOr { operands, source_location } => (self.nary(NaryOp::Or, operands), source_location),
+            Expression::LogicalNot { operand, source_location } => (self.unary(UnaryOp::Not, operand), source_location),
+            Expression::StringConcat { operands, source_location } => {
+                (self.nary(NaryOp::Concat, operands), source_location)
+            }
+            Expression::StringLength { string, source_location } => {
+                (self.unary(UnaryOp::StringLength, string), source_location)
+            }
+            Expression::StringCharAt { string, index, source_location } => {
+                (self.binary(BinaryOp::StringCharAt, string, index), source_location)
+            }
+            Expression::Substring { string, start_index, length, source_location } => {
+                let string = self.alloc_expr(string);
+                let start = self.alloc_expr(start_index);
+                let length = self.alloc_expr(length);
+                (ExprKind::Substring { string, start, length }, source_location)
+            }
+            Expression::StringEquals { left, right, source_location } => {
+                (self.binary(BinaryOp::StringEquals, left, right), source_location)
+            }
+            Expression::StringContains { haystack, needle, source_location } => {
+                (self.binary(BinaryOp::StringContains, haystack, needle), source_location)
+            }
+            Expression::TypeCast { value, target_type, failure_behavior, source_location } => (
+                ExprKind::Cast {
+                    value: self.alloc_expr(value),
+                    target: self.alloc_type(target_type),
+                    or_default: matches!(failure_behavior, CastFailureBehavior::ReturnNullOrDefault),
+                },
+                source_location,
+            ),
+            Expression::FunctionCall { call, source_location } => {
+                return self.alloc_call(call, source_location);
+            }
+            Expression::FieldAccess { instance, field_name, source_location } => (
+                ExprKind::FieldAccess { instance: self.alloc_expr(instance), field: self.sym(&field_name.name) },
+                source_location,
+            ),
+            Expression::ArrayAccess { array, index, source_location } => {
+                (self.binary(BinaryOp::ArrayAccess, array, index), source_location)
+            }
+            Expression::MapAccess { map, key, source_location } => {
+                (self.binary(BinaryOp::MapAccess, map, key), source_location)
+            }
+            Expression::ArrayLength { array, source_location } => {
+                (self.unary(UnaryOp::ArrayLength, array), source_location)
+            }
+            Expression::AddressOf { operand, source_location } => {
+                (self.unary(UnaryOp::AddressOf, operand), source_location)
+            }
+            Expression::Dereference { pointer, source_location } => {
+                (self.unary(UnaryOp::Dereference, pointer), source_location)
+            }
+            Expression::PointerArithmetic { pointer, offset, operation, source_location } => {
+                let op = match operation {
+                    PointerOp::Add => BinaryOp::PointerAdd,
+                    PointerOp::Subtract => BinaryOp::PointerSubtract,
+                };
+                (self.binary(op, pointer, offset), source_location)
+            }
+            Expression::StructConstruct { type_name, field_values, source_location } => {
+                let type_name = self.sym(&type_name.name);
+                let fields: Vec<(Symbol, ExprId)> = field_values
+                    .iter()
+                    .map(|fv| (self.sym(&fv.field_name.name), self.alloc_expr(&fv.value)))
+                    .collect();
+                let fields = push_list(&mut self.named_exprs, fields);
+                (ExprKind::StructConstruct { type_name, fields }, source_location)
+            }
+            Expression::ArrayLiteral { element_type, elements, source_location } => {
+                let element_type = self.alloc_type(element_type);
+                let ids: Vec<ExprId> = elements.iter().map(|e| self.alloc_expr(e)).collect();
+                let elements = push_list(&mut self.expr_lists, ids);
+                (ExprKind::ArrayLiteral { element_type, elements }, source_location)
+            }
+            Expression::MapLiteral { key_type, value_type, entries, source_location } => {
+                let key_type = self.alloc_type(key_type);
+                let value_type = self.alloc_type(value_type);
+                let mut ids = Vec::with_capacity(entries.len() * 2);
+                for entry in entries {
+                    ids.push(self.alloc_expr(&entry.key));
+                    ids.push(self.alloc_expr(&entry.value));
+                }
+                let entries = push_list(&mut self.expr_lists, ids);
+                (ExprKind::MapLiteral { key_type, value_type, entries }, source_location)
+            }
+            Expression::Match { value, cases, source_location } => {
+                let value = self.alloc_expr(value);
+                let arms: Vec<MatchArm> = cases
+                    .iter()
+                    .map(|case| MatchArm {
+                        pattern: self.alloc_pattern(&case.pattern),
+                        body: self.alloc_expr(&case.body),
+                    })
+                    .collect();
+                let arms = push_list(&mut self.match_arms, arms);
+                (ExprKind::Match { value, arms }, source_location)
+            }
+            Expression::EnumVariant { enum_name, variant_name, value, source_location } => (
+                ExprKind::EnumVariant {
+                    enum_name: self.sym(&enum_name.name),
+                    variant: self.sym(&variant_name.name),
+                    value: value.as_ref().map(|v| self.alloc_expr(v)),
+                },
+                source_location,
+            ),
+            Expression::VectorLiteral { elements, source_location } => {
+                let ids: Vec<ExprId> = elements.iter().map(|e| self.alloc_expr(e)).collect();
+                let operands = push_list(&mut self.expr_lists, ids);
+                (ExprKind::Nary { op: NaryOp::Vector, operands }, source_location)
+            }
+            Expression::VectorSplat { value, lanes, source_location } => {
+                (ExprKind::VectorSplat { value: self.alloc_expr(value), lanes: *lanes }, source_location)
+            }
+            Expression::VectorLoad { array, index, lanes, source_location } => (
+                ExprKind::VectorLoad { array: self.alloc_expr(array), index: self.alloc_expr(index), lanes: *lanes },
+                source_location,
+            ),
+            Expression::VectorStore { array, index, value, source_location } => {
+                let array = self.alloc_expr(array);
+                let index = self.alloc_expr(index);
+                let value = self.alloc_expr(value);
+                (ExprKind::VectorStore { array, index, value }, source_location)
+            }
+            Expression::VectorShuffle { left, right, mask, source_location } => {
+                let left = self.alloc_expr(left);
+                let right = self.alloc_expr(right);
+                let mask = push_list(&mut self.lane_lists, mask.clone());
+                (ExprKind::VectorShuffle { left, right, mask }, source_location)
+            }
+            Expression::VectorExtract { vector, lane, source_location } => {
+                (self.binary(BinaryOp::VectorExtract, vector, lane), source_location)
+            }
+            Expression::VectorSelect { mask, if_true, if_false, source_location } => {
+                let mask = self.alloc_expr(mask);
+                let if_true = self.alloc_expr(if_true);
+                let if_false = self.alloc_expr(if_false);
+                (ExprKind::VectorSelect { mask, if_true, if_false }, source_location)
+            }
+        };
+        self.push_expr(kind, location)
+    }
+
+    fn alloc_pattern(&mut self, pattern: &Pattern) -> PatternId {
+        let (kind, location) = match pattern {
+            Pattern::EnumVariant { enum_name, variant_name, binding, nested_pattern, source_location } => (
+                PatternKind::EnumVariant {
+                    enum_name: self.alloc_label(enum_name),
+                    variant: self.sym(&variant_name.name),
+                    binding: self.alloc_label(binding),
+                    nested: nested_pattern.as_ref().map(|p| self.alloc_pattern(p)),
+                },
+                source_location,
+            ),
+            Pattern::Literal { value, source_location } => {
+                (PatternKind::Literal(self.alloc_expr(value)), source_location)
+            }
+            Pattern::Wildcard { binding, source_location } => {
+                (PatternKind::Wildcard { binding: self.alloc_label(binding) }, source_location)
+            }
+        };
+        let span = self.span(location);
+        let id = PatternId(self.patterns.len() as u32);
+        self.patterns.push(PatternNode { kind, span });
+        id
+    }
+
+    /// Flatten a type specifier, returning its ID
+    pub fn alloc_type(&mut self, ty: &TypeSpecifier) -> TypeNodeId {
+        let (kind, location) = match ty {
+            TypeSpecifier::Primitive { type_name, source_location } => {
+                (TypeKind::Primitive(*type_name), source_location)
+            }
+            TypeSpecifier::Named { name, source_location } => (TypeKind::Named(self.sym(&name.name)), source_location),
+            TypeSpecifier::Generic { base_type, type_arguments, source_location } => {
+                let base = self.sym(&base_type.name);
+                let ids: Vec<TypeNodeId> = type_arguments.iter().map(|t| self.alloc_type(t)).collect();
+                let args = push_list(&mut self.type_lists, ids);
+                (TypeKind::Generic { base, args }, source_location)
+            }
+            TypeSpecifier::TypeParameter { name, source_location, .. } => {
+                (TypeKind::Parameter(self.sym(&name.name)), source_location)
+            }
+            TypeSpecifier::Array { element_type, size, source_location } => (
+                TypeKind::Array {
+                    element: self.alloc_type(element_type),
+                    size: size.as_ref().map(|s| self.alloc_expr(s)),
+                },
+                source_location,
+            ),
+            TypeSpecifier::Map { key_type, value_type, source_location } => (
+                TypeKind::Map { key: self.alloc_type(key_type), value: self.alloc_type(value_type) },
+                source_location,
+            ),
+            TypeSpecifier::Vector { element_type, lanes, source_location } => {
+                (TypeKind::Vector { element: self.alloc_type(element_type), lanes: *lanes }, source_location)
+            }
+            TypeSpecifier::Pointer { target_type, is_mutable, source_location } => (
+                TypeKind::Pointer { target: self.alloc_type(target_type), is_mutable: *is_mutable },
+                source_location,
+            ),
+            TypeSpecifier::Function { parameter_types, return_type, source_location } => {
+                let ids: Vec<TypeNodeId> = parameter_types.iter().map(|t| self.alloc_type(t)).collect();
+                let params = push_list(&mut self.type_lists, ids);
+                let ret = self.alloc_type(return_type);
+                (TypeKind::Function { params, ret }, source_location)
+            }
+            TypeSpecifier::Owned { base_type, ownership, source_location } => (
+                TypeKind::Owned { base: self.alloc_type(base_type), ownership: *ownership },
+                source_location,
+            ),
+        };
+        let span = self.span(location);
+        let id = TypeNodeId(self.types.len() as u32);
+        self.types.push(TypeNode { kind, span });
+        id
+    }
+
+    /// Visit every expression reachable from `root` in pre-order
+    pub fn walk_expr<F: FnMut(ExprId, &ExprNode)>(&self, root: ExprId, mut visit: F) {
+        let mut stack = vec![root];
+        while let Some(id) = stack.pop() {
+            let node = self.expr(id);
+            visit(id, node);
+            match node.kind {
+                ExprKind::Binary { lhs, rhs, .. } => {
+                    stack.push(rhs);
+                    stack.push(lhs);
+                }
+                ExprKind::Unary { operand, .. } => stack.push(operand),
+                ExprKind::Nary { operands, .. } => stack.extend(self.expr_list(operands).iter().rev()),
+                ExprKind::Substring { string, start, length } => {
+                    stack.push(length);
+                    stack.push(start);
+                    stack.push(string);
+                }
+                ExprKind::Cast { value, .. } => stack.push(value),
+                ExprKind::Call { args, variadic, .. } => {
+                    stack.extend(self.expr_list(variadic).iter().rev());
+                    stack.extend(self.named_expr_list(args).iter().rev().map(|(_, e)| *e));
+                }
+                ExprKind::FieldAccess { instance, .. } => stack.push(instance),
+                ExprKind::StructConstruct { fields, .. } => {
+                    stack.extend(self.named_expr_list(fields).iter().rev().map(|(_, e)| *e));
+                }
+                ExprKind::ArrayLiteral { elements, .. } => stack.extend(self.expr_list(elements).iter().rev()),
+                ExprKind::MapLiteral { entries, .. } => stack.extend(self.expr_list(entries).iter().rev()),
+                ExprKind::Match { value, arms } => {
+                    stack.extend(self.match_arm_list(arms).iter().rev().map(|arm| arm.body));
+                    stack.push(value);
+                }
+                ExprKind::EnumVariant { value: Some(value), .. } => stack.push(value),
+                ExprKind::VectorSplat { value, .. } => stack.push(value),
+                ExprKind::VectorLoad { array, index, .. } => {
+                    stack.push(index);
+                    stack.push(array);
+                }
+                ExprKind::VectorStore { array, index, value } => {
+                    stack.push(value);
+                    stack.push(index);
+                    stack.push(array);
+                }
+                ExprKind::VectorShuffle { left, right, .. } => {
+                    stack.push(right);
+                    stack.push(left);
+                }
+                ExprKind::VectorSelect { mask, if_true, if_false } => {
+                    stack.push(if_false);
+                    stack.push(if_true);
+                    stack.push(mask);
+                }
+                _ => {}
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ast::{Argument, FunctionCall, FunctionMetadata, Identifier};
+
+    fn loc() -> SourceLocation {
+        SourceLocation::new("test.aether".to_string(), 3, 5, 42)
+    }
+
+    fn ident(name: &str) -> Identifier {
+        Identifier::new(name.to_string(), loc())
+    }
+
+    fn var(name: &str) -> Expression {
+        Expression::Variable { name: ident(name), source_location: loc() }
+    }
+
+    #[test]
+    fn test_interner_deduplicates() {
+        let mut interner = Interner::new();
+        let a = interner.intern("x");
+        let b = interner.intern("y");
+        let c = interner.intern("x");
+        assert_eq!(a, c);
+        assert_ne!(a, b);
+        assert_eq!(interner.resolve(b), "y");
+        assert_eq!(interner.len(), 2);
+        assert_eq!(interner.get("z"), None);
+    }
+
+    #[test]
+    fn test_span_round_trip() {
+        let mut interner = Interner::new();
+        let span = Span::from_location(&loc(), &mut interner);
+        assert_eq!(span.to_location(&interner), loc());
+        assert_eq!(size_of::<Span>(), 16);
+    }
+
+    #[test]
+    fn test_expression_flattening() {
+        let mut arena = AstArena::new();
+        let expr = Expression::Add {
+            left: Box::new(var("x")),
+            right: Box::new(Expression::Multiply {
+                left: Box::new(var("x")),
+                right: Box::new(Expression::IntegerLiteral { value: 2, source_location: loc() }),
+                source_location: loc(),
+            }),
+            source_location: loc(),
+        };
+        let root = arena.alloc_expr(&expr);
+        assert_eq!(arena.exprs.len(), 5);
+
+        let mut order = Vec::new();
+        arena.walk_expr(root, |_, node| order.push(node.kind));
+        assert!(matches!(order[0], ExprKind::Binary { op: BinaryOp::Add, .. }));
+        assert!(matches!(order[1], ExprKind::Variable(_)));
+        assert!(matches!(order[4], ExprKind::Integer(2)));
+
+        // Both uses of `x` share one symbol (plus the interned file name)
+        assert_eq!(arena.interner.len(), 2);
+    }
+
+    #[test]
+    fn test_function_flattening() {
+        let call = FunctionCall {
+            function_reference: FunctionReference::Local { name: ident("helper") },
+            arguments: vec![Argument {
+                parameter_name: ident("value"),
+                value: Box::new(var("n")),
+                source_location: loc(),
+            }],
+            variadic_arguments: vec![],
+        };
+        let function = Function {
+            name: ident("main"),
+            intent: None,
+            generic_parameters: vec![],
+            parameters: vec![],
+            return_type: Box::new(TypeSpecifier::Primitive {
+                type_name: PrimitiveType::Integer,
+                source_location: loc(),
+            }),
+            metadata: FunctionMetadata {
+                preconditions: vec![],
+                postconditions: vec![],
+                invariants: vec![],
+                algorithm_hint: None,
+                performance_expectation: None,
+                complexity_expectation: None,
+                throws_exceptions: vec![],
+                thread_safe: None,
+                may_block: None,
+                contract_checks: None,
+            },
+            body: Block {
+                statements: vec![
+                    Statement::FunctionCall { call, source_location: loc() },
+                    Statement::Return {
+                        value: Some(Box::new(Expression::IntegerLiteral { value: 0, source_location: loc() })),
+                        source_location: loc(),
+                    },
+                ],
+                source_location: loc(),
+            },
+            export_info: None,
+            source_location: loc(),
+        };
+
+        let mut arena = AstArena::new();
+        let id = arena.alloc_function(&function);
+        let node = *arena.function(id);
+        assert_eq!(arena.name(node.name), "main");
+
+        let body = arena.stmt_list(node.body);
+        assert_eq!(body.len(), 2);
+        match arena.stmt(body[0]).kind {
+            StmtKind::Expr(call) => match arena.expr(call).kind {
+                ExprKind::Call { callee: Callee::Local(name), args, .. } => {
+                    assert_eq!(arena.name(name), "helper");
+                    let args = arena.named_expr_list(args);
+                    assert_eq!(arena.name(args[0].0), "value");
+                }
+                other => panic!("expected call, got {:?}", other),
+            },
+            other => panic!("expected expression statement, got {:?}", other),
+        }
+        assert!(matches!(arena.stmt(body[1]).kind, StmtKind::Return(Some(_))));
+        assert!(arena.heap_bytes() > 0);
+    }
+}
@@ -19,6 +19,7 @@
 use crate::error::SourceLocation;
 use serde::{Deserialize, Serialize};
 
+pub mod arena;
 pub mod resource;
 
 /// Visitor trait for AST traversal
@@ -178,6 +179,12 @@ pub enum TypeSpecifier {
         value_type: Box<TypeSpecifier>,
         source_location: SourceLocation,
     },
+    /// Fixed-width SIMD vector (e.g., (VECTOR_OF_TYPE FLOAT 4))
+    Vector {
+        element_type: Box<TypeSpecifier>,
+        lanes: u32,
+        source_location: SourceLocation,
+    },
     Pointer {
         target_type: Box<TypeSpecifier>,
         is_mutable: bool,
@@ -325,6 +332,9 @@ pub struct FunctionMetadata {
     pub throws_exceptions: Vec<Box<TypeSpecifier>>,
     pub thread_safe: Option<bool>,
     pub may_block: Option<bool>,
+    /// Runtime contract checking mode, e.g. `"sampled:100"`; overrides `--contract-checks`
+    #[serde(default)]
+    pub contract_checks: Option<String>,
 }
 
 /// Contract assertion (precondition, postcondition, invariant)
@@ -813,6 +823,50 @@ pub enum Expression {
         entries: Vec<MapEntry>,
         source_location: SourceLocation,
     },
+
+    // SIMD vector operations; arithmetic and comparisons are lane-wise
+    VectorLiteral {
+        elements: Vec<Box<Expression>>,
+        source_location: SourceLocation,
+    },
+    VectorSplat {
+        value: Box<Expression>,
+        lanes: u32,
+        source_location: SourceLocation,
+    },
+    /// Load `lanes` consecutive elements starting at `index`
+    VectorLoad {
+        array: Box<Expression>,
+        index: Box<Expression>,
+        lanes: u32,
+        source_location: SourceLocation,
+    },
+    /// Store every lane of `value` starting at `index`
+    VectorStore {
+        array: Box<Expression>,
+        index: Box<Expression>,
+        value: Box<Expression>,
+        source_location: SourceLocation,
+    },
+    /// Pick lanes from the concatenation of `left` and `right`
+    VectorShuffle {
+        left: Box<Expression>,
+        right: Box<Expression>,
+        mask: Vec<u32>,
+        source_location: SourceLocation,
+    },
+    VectorExtract {
+        vector: Box<Expression>,
+        lane: Box<Expression>,
+        source_location: SourceLocation,
+    },
+    /// Lane-wise `mask ? if_true : if_false`
+    VectorSelect {
+        mask: Box<Expression>,
+        if_true: Box<Expression>,
+        if_false: Box<Expression>,
+        source_location: SourceLocation,
+    },
     
     // Pattern matching
     Match {
@@ -1046,6 +1100,9 @@ impl ASTPrettyPrinter {
             TypeSpecifier::Map { key_type, value_type, .. } => {
                 format!("Map<{}, {}>", self.print_type_specifier(key_type), self.print_type_specifier(value_type))
             }
+            TypeSpecifier::Vector { element_type, lanes, .. } => {
+                format!("Vector<{}, {}>", self.print_type_specifier(element_type), lanes)
+            }
             TypeSpecifier::Pointer { target_type, is_mutable, .. } => {
                 if *is_mutable {
                     format!("*mut {}", self.print_type_specifier(target_type))
@@ -18,8 +18,11 @@
 
 use crate::ast::{ContractAssertion, FunctionMetadata, PerformanceExpectation, ComplexityExpectation, Expression, FailureAction};
 use crate::error::{SemanticError, SourceLocation};
+use crate::mir;
 use crate::types::{Type, TypeChecker};
-use std::collections::HashMap;
+use crate::verification::facts::ProvenFacts;
+use std::collections::{HashMap, HashSet};
+use std::fmt;
 use std::rc::Rc;
 use std::cell::RefCell;
 
@@ -46,10 +49,60 @@ pub struct ContractContext {
 pub struct ContractValidator {
     /// Statistics about contracts processed
     pub stats: ContractStats,
+    /// How generated runtime checks run
+    mode: ContractCheckMode,
+    /// Names of the timed checks, indexed by contract id
+    contract_names: Vec<String>,
+}
+
+/// How runtime contract checks run
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum ContractCheckMode {
+    /// No runtime checks
+    Off,
+    /// Every check, in debug builds only
+    #[default]
+    Debug,
+    /// Every check in every build, timed per contract
+    Full,
+    /// Preconditions on every call; postconditions and invariants on one call in `one_in`
+    Sampled { one_in: u32 },
+}
+
+impl std::str::FromStr for ContractCheckMode {
+    type Err = String;
+    
+    fn from_str(s: &str) -> Result<Self, Self::Err> {
+        match s.split_once(':') {
+            None => match s {
+                "off" => Ok(Self::Off),
+                "debug" => Ok(Self::Debug),
+                "full" => Ok(Self::Full),
+                "sampled" => Ok(Self::Sampled { one_in: 100 }),
+                _ => Err(format!("unknown contract check mode '{}'; expected off, debug, full or sampled[:N]", s)),
+            },
+            Some(("sampled", rate)) => match rate.parse::<u32>() {
+                Ok(one_in) if one_in > 0 => Ok(Self::Sampled { one_in }),
+                _ => Err(format!("invalid sampling rate '{}'; expected a positive integer", rate)),
+            },
+            Some(_) => Err(format!("unknown contract check mode '{}'; expected off, debug, full or sampled[:N]", s)),
+        }
+    }
+}
+
+impl fmt::Display for ContractCheckMode {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::Off => write!(f, "off"),
+            Self::Debug => write!(f, "debug"),
+            Self::Full => write!(f, "full"),
+            Self::Sampled { one_in } => write!(f, "sampled:{}", one_in),
+        }
+    }
 }
 
 /// Statistics about contract validation
-#[derive(Debug, Default)]
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
 pub struct ContractStats {
     pub functions_processed: usize,
     pub preconditions_validated: usize,
@@ -59,6 +112,26 @@ pub struct ContractStats {
     pub complexity_expectations_checked: usize,
     pub contract_errors: usize,
     pub contract_warnings: usize,
+    /// Runtime checks left out because verification proved them
+    pub runtime_checks_removed: usize,
+    /// Runtime checks generated to run on a sample of calls
+    pub runtime_checks_sampled: usize,
+}
+
+impl ContractStats {
+    /// Add the counts gathered by another validator
+    pub fn merge(&mut self, other: &ContractStats) {
+        self.functions_processed += other.functions_processed;
+        self.preconditions_validated += other.preconditions_validated;
+        self.postconditions_validated += other.postconditions_validated;
+        self.invariants_validated += other.invariants_validated;
+        self.performance_expectations_checked += other.performance_expectations_checked;
+        self.complexity_expectations_checked += other.complexity_expectations_checked;
+        self.contract_errors += other.contract_errors;
+        self.contract_warnings += other.contract_warnings;
+        self.runtime_checks_removed += other.runtime_checks_removed;
+        self.runtime_checks_sampled += other.runtime_checks_sampled;
+    }
 }
 
 impl ContractValidator {
@@ -66,9 +139,33 @@ impl ContractValidator {
     pub fn new() -> Self {
         Self {
             stats: ContractStats::default(),
+            mode: ContractCheckMode::default(),
+            contract_names: Vec::new(),
         }
     }
 
+    /// Create a validator generating checks in `mode`
+    pub fn with_mode(mode: ContractCheckMode) -> Self {
+        let mut validator = Self::new();
+        validator.mode = mode;
+        validator
+    }
+
+    /// Set how generated runtime checks run
+    pub fn set_mode(&mut self, mode: ContractCheckMode) {
+        self.mode = mode;
+    }
+
+    /// How generated runtime checks run, unless a function overrides it
+    pub fn mode(&self) -> ContractCheckMode {
+        self.mode
+    }
+
+    /// Names of the timed checks generated so far, one per line, for `aether_contract_init`
+    pub fn contract_table(&self) -> String {
+        self.contract_names.join("\n")
+    }
+
     /// Validate function metadata including contracts
     pub fn validate_function_metadata(
         &mut self,
@@ -159,6 +256,19 @@ impl ContractValidator {
             }
         }
 
+        // Validate the runtime checking mode
+        if let Some(mode) = &metadata.contract_checks {
+            if let Err(reason) = mode.parse::<ContractCheckMode>() {
+                self.stats.contract_errors += 1;
+                result.errors.push(SemanticError::InvalidContract {
+                    contract_type: "CONTRACT_CHECKS".to_string(),
+                    reason,
+                    location: function_location.clone(),
+                });
+                result.is_valid = false;
+            }
+        }
+
         // Validate exception specifications
         for exception_type in &metadata.throws_exceptions {
             if let Err(error) = context.type_checker.borrow().ast_type_to_type(exception_type) {
@@ -373,45 +483,137 @@ impl ContractValidator {
         }
     }
 
-    /// Generate runtime assertion code for debug builds
+    /// Generate runtime assertion code in the function's checking mode
     pub fn generate_runtime_assertions(
-        &self,
+        &mut self,
+        metadata: &FunctionMetadata,
+        function_name: &str,
+    ) -> String {
+        self.render_assertions(metadata, function_name, &ProvenFacts::default()).0
+    }
+
+    /// Generate runtime assertion code, leaving out the conditions `proven` covers
+    ///
+    /// The `i`-th precondition (counting from 1) is named `precondition_<i>`,
+    /// and likewise `postcondition_<i>` and `invariant_<i>`. Each check left
+    /// out is counted in `runtime_checks_removed`.
+    pub fn generate_unproven_assertions(
+        &mut self,
         metadata: &FunctionMetadata,
         function_name: &str,
+        proven: &ProvenFacts,
     ) -> String {
+        let (code, removed) = self.render_assertions(metadata, function_name, proven);
+        self.stats.runtime_checks_removed += removed;
+        code
+    }
+
+    /// Assertion code for the unproven contracts, and the number left out
+    ///
+    /// Preconditions are checked on entry; postconditions and invariants
+    /// before each return. `CONTRACT_CHECKS` metadata overrides the
+    /// validator's mode; an invalid value was reported during validation.
+    fn render_assertions(
+        &mut self,
+        metadata: &FunctionMetadata,
+        function_name: &str,
+        proven: &ProvenFacts,
+    ) -> (String, usize) {
+        let mode = metadata.contract_checks.as_deref()
+            .and_then(|mode| mode.parse().ok())
+            .unwrap_or(self.mode);
         let mut code = String::new();
         
         code.push_str(&format!("// Runtime assertions for function {}\n", function_name));
+        if mode == ContractCheckMode::Off {
+            return (code, 0);
+        }
         
+        let entry = unproven(proven, "precondition", &metadata.preconditions);
+        let mut exit: Vec<(&str, usize, &ContractAssertion)> = unproven(proven, "postcondition", &metadata.postconditions)
+            .into_iter()
+            .map(|(i, assertion)| ("Postcondition", i, assertion))
+            .collect();
+        exit.extend(unproven(proven, "invariant", &metadata.invariants)
+            .into_iter()
+            .map(|(i, assertion)| ("Invariant", i, assertion)));
+        let total = metadata.preconditions.len() + metadata.postconditions.len() + metadata.invariants.len();
+        let removed = total - entry.len() - exit.len();
+
         // Generate precondition checks
-        if !metadata.preconditions.is_empty() {
-            code.push_str("#[cfg(debug_assertions)]\n");
+        if !entry.is_empty() {
+            if mode == ContractCheckMode::Debug {
+                code.push_str("#[cfg(debug_assertions)]\n");
+            }
             code.push_str("{\n");
-            for (i, precondition) in metadata.preconditions.iter().enumerate() {
-                let condition_code = self.expression_to_code(&precondition.condition);
-                let default_message = format!("Precondition {} violated", i + 1);
-                let message = precondition.message.as_deref()
-                    .unwrap_or(&default_message);
-                
-                match precondition.failure_action {
-                    FailureAction::ThrowException => {
-                        code.push_str(&format!("    if !({}) {{ panic!(\"Precondition violation in {}: {}\"); }}\n", 
-                                              condition_code, function_name, message));
-                    }
-                    FailureAction::LogWarning => {
-                        code.push_str(&format!("    if !({}) {{ eprintln!(\"Warning: Precondition violation in {}: {}\"); }}\n", 
-                                              condition_code, function_name, message));
-                    }
-                    FailureAction::AssertFail => {
-                        code.push_str(&format!("    assert!({}, \"Precondition violation in {}: {}\");\n", 
-                                              condition_code, function_name, message));
+            for (i, precondition) in entry {
+                let check = self.check_code("Precondition", i, precondition, function_name);
+                code.push_str(&self.timed(mode, &check, function_name, "precondition", i));
+            }
+            code.push_str("}\n");
+        }
+
+        // Generate postcondition and invariant checks
+        if !exit.is_empty() {
+            code.push_str("// Checked before each return\n");
+            if mode == ContractCheckMode::Debug {
+                code.push_str("#[cfg(debug_assertions)]\n");
+            }
+            code.push_str("{\n");
+            for (kind, i, assertion) in exit {
+                let check = self.check_code(kind, i, assertion, function_name);
+                let timed = self.timed(mode, &check, function_name, &kind.to_lowercase(), i);
+                match mode {
+                    ContractCheckMode::Sampled { one_in } => {
+                        let id = self.contract_names.len() - 1;
+                        code.push_str(&format!("    if aether_contract_sample({}, {}) {{\n", id, one_in));
+                        for line in timed.lines() {
+                            code.push_str(&format!("    {}\n", line));
+                        }
+                        code.push_str("    }\n");
+                        self.stats.runtime_checks_sampled += 1;
                     }
+                    _ => code.push_str(&timed),
                 }
             }
             code.push_str("}\n");
         }
 
-        code
+        (code, removed)
+    }
+
+    /// One indented check of `assertion`, acting on failure as it asks
+    fn check_code(&self, kind: &str, index: usize, assertion: &ContractAssertion, function_name: &str) -> String {
+        let condition_code = self.expression_to_code(&assertion.condition);
+        let default_message = format!("{} {} violated", kind, index + 1);
+        let message = assertion.message.as_deref()
+            .unwrap_or(&default_message);
+        
+        match assertion.failure_action {
+            FailureAction::ThrowException => {
+                format!("    if !({}) {{ panic!(\"{} violation in {}: {}\"); }}\n", 
+                        condition_code, kind, function_name, message)
+            }
+            FailureAction::LogWarning => {
+                format!("    if !({}) {{ eprintln!(\"Warning: {} violation in {}: {}\"); }}\n", 
+                        condition_code, kind, function_name, message)
+            }
+            FailureAction::AssertFail => {
+                format!("    assert!({}, \"{} violation in {}: {}\");\n", 
+                        condition_code, kind, function_name, message)
+            }
+        }
+    }
+
+    /// `check` wrapped in timing calls under a new contract id, outside debug mode
+    fn timed(&mut self, mode: ContractCheckMode, check: &str, function_name: &str, kind: &str, index: usize) -> String {
+        if mode == ContractCheckMode::Debug {
+            return check.to_string();
+        }
+        
+        let id = self.contract_names.len();
+        self.contract_names.push(format!("{}::{}_{}", function_name, kind, index + 1));
+        format!("    let start = aether_contract_begin();\n{}    aether_contract_end({}, start);\n", check, id)
     }
 
     /// Convert expression to code (simplified)
@@ -442,12 +644,105 @@ impl ContractValidator {
         &self.stats
     }
 
+    /// Add statistics gathered by another validator, such as a parallel worker's
+    pub fn merge_stats(&mut self, other: &ContractStats) {
+        self.stats.merge(other);
+    }
+
     /// Reset validation statistics
     pub fn reset_stats(&mut self) {
         self.stats = ContractStats::default();
     }
 }
 
+/// The assertions not proven, numbered from 0, named `<kind>_<i+1>` in `proven`
+fn unproven<'a>(proven: &ProvenFacts, kind: &str, assertions: &'a [ContractAssertion]) -> Vec<(usize, &'a ContractAssertion)> {
+    assertions.iter()
+        .enumerate()
+        .filter(|(i, _)| !proven.is_proven(&format!("{}_{}", kind, i + 1)))
+        .collect()
+}
+
+/// Remove the lowered runtime checks of the conditions in `proven`
+///
+/// A proven check's `Assert` becomes a jump to its target and its timing
+/// calls are dropped; a sampling gate in front of it never fires. Returns the
+/// number of checks removed.
+pub fn remove_proven_checks(function: &mut mir::Function, proven: &ProvenFacts) -> usize {
+    let mut targets = Vec::new();
+    for block in function.basic_blocks.values_mut() {
+        if let mir::Terminator::Assert { message: mir::AssertMessage::Contract { name, .. }, target, .. } = &block.terminator {
+            let condition = name.split_once("::").map_or(name.as_str(), |(_, condition)| condition);
+            if proven.is_proven(condition) {
+                let target = *target;
+                block.terminator = mir::Terminator::Goto { target };
+                targets.push(target);
+            }
+        }
+    }
+    
+    // A timed check ends with `aether_contract_end(id, start)` in its target
+    let mut ids = HashSet::new();
+    let mut starts = HashSet::new();
+    for &target in &targets {
+        let statements = match function.basic_blocks.get_mut(target) {
+            Some(block) => &mut block.statements,
+            None => continue,
+        };
+        if let Some(statement) = statements.iter_mut().find(|statement| runtime_call(statement, "aether_contract_end").is_some()) {
+            if let Some([id, mir::Operand::Copy(start) | mir::Operand::Move(start)]) = runtime_call(statement, "aether_contract_end") {
+                ids.extend(contract_id(id));
+                starts.insert(start.local);
+            }
+            *statement = mir::Statement::Nop;
+        }
+    }
+    
+    for statement in function.basic_blocks.values_mut().flat_map(|block| block.statements.iter_mut()) {
+        let begins_timing = matches!(
+            statement,
+            mir::Statement::Assign { place, .. } if starts.contains(&place.local)
+                && runtime_call(statement, "aether_contract_begin").is_some()
+        );
+        if begins_timing {
+            *statement = mir::Statement::Nop;
+        } else if let mir::Statement::Assign { rvalue, .. } = statement {
+            if matches!(runtime_call_args(rvalue, "aether_contract_sample"), Some([id, _]) if contract_id(id).map_or(false, |id| ids.contains(&id))) {
+                *rvalue = mir::Rvalue::Use(mir::Operand::Constant(mir::Constant {
+                    ty: Type::primitive(crate::ast::PrimitiveType::Boolean),
+                    value: mir::ConstantValue::Bool(false),
+                }));
+            }
+        }
+    }
+    
+    targets.len()
+}
+
+/// Arguments of `statement` if it calls the runtime function `name`
+fn runtime_call<'a>(statement: &'a mir::Statement, name: &str) -> Option<&'a [mir::Operand]> {
+    match statement {
+        mir::Statement::Assign { rvalue, .. } => runtime_call_args(rvalue, name),
+        _ => None,
+    }
+}
+
+fn runtime_call_args<'a>(rvalue: &'a mir::Rvalue, name: &str) -> Option<&'a [mir::Operand]> {
+    match rvalue {
+        mir::Rvalue::Call { func: mir::Operand::Constant(mir::Constant { value: mir::ConstantValue::String(func), .. }), args }
+            if func == name => Some(args),
+        _ => None,
+    }
+}
+
+/// The contract id a runtime call was passed
+fn contract_id(operand: &mir::Operand) -> Option<i128> {
+    match operand {
+        mir::Operand::Constant(mir::Constant { value: mir::ConstantValue::Integer(id), .. }) => Some(*id),
+        _ => None,
+    }
+}
+
 impl Default for ContractValidator {
     fn default() -> Self {
         Self::new()
@@ -561,7 +856,7 @@ mod tests {
 
     #[test]
     fn test_runtime_assertion_generation() {
-        let validator = ContractValidator::new();
+        let mut validator = ContractValidator::new();
         
         let metadata = FunctionMetadata {
             preconditions: vec![ContractAssertion {
@@ -581,6 +876,7 @@ mod tests {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         };
 
         let code = validator.generate_runtime_assertions(&metadata, "test_function");
@@ -588,4 +884,121 @@ mod tests {
         assert!(code.contains("assert!"));
         assert!(code.contains("Test precondition"));
     }
+
+    #[test]
+    fn test_proven_preconditions_are_not_checked() {
+        let mut validator = ContractValidator::new();
+        let precondition = |message: &str| ContractAssertion {
+            condition: Box::new(Expression::BooleanLiteral {
+                value: true,
+                source_location: SourceLocation::unknown(),
+            }),
+            failure_action: FailureAction::AssertFail,
+            message: Some(message.to_string()),
+            source_location: SourceLocation::unknown(),
+        };
+        let metadata = FunctionMetadata {
+            preconditions: vec![precondition("First precondition"), precondition("Second precondition")],
+            postconditions: Vec::new(),
+            invariants: Vec::new(),
+            algorithm_hint: None,
+            performance_expectation: None,
+            complexity_expectation: None,
+            throws_exceptions: Vec::new(),
+            thread_safe: None,
+            may_block: None,
+            contract_checks: None,
+        };
+
+        let mut proven = ProvenFacts::default();
+        proven.mark_proven("precondition_1");
+        let code = validator.generate_unproven_assertions(&metadata, "test_function", &proven);
+        assert!(!code.contains("First precondition"));
+        assert!(code.contains("Second precondition"));
+        assert_eq!(validator.get_stats().runtime_checks_removed, 1);
+
+        proven.mark_proven("precondition_2");
+        let code = validator.generate_unproven_assertions(&metadata, "test_function", &proven);
+        assert!(!code.contains("assert!"));
+        assert_eq!(validator.get_stats().runtime_checks_removed, 3);
+    }
+
+    #[test]
+    fn test_sampled_checks_and_mode_override() {
+        let mut validator = ContractValidator::with_mode("sampled:50".parse().unwrap());
+        let assertion = |message: &str| ContractAssertion {
+            condition: Box::new(Expression::BooleanLiteral {
+                value: true,
+                source_location: SourceLocation::unknown(),
+            }),
+            failure_action: FailureAction::AssertFail,
+            message: Some(message.to_string()),
+            source_location: SourceLocation::unknown(),
+        };
+        let mut metadata = FunctionMetadata {
+            preconditions: vec![assertion("Cheap precondition")],
+            postconditions: vec![assertion("Costly postcondition")],
+            invariants: Vec::new(),
+            algorithm_hint: None,
+            performance_expectation: None,
+            complexity_expectation: None,
+            throws_exceptions: Vec::new(),
+            thread_safe: None,
+            may_block: None,
+            contract_checks: None,
+        };
+
+        let code = validator.generate_runtime_assertions(&metadata, "sort");
+        assert!(!code.contains("cfg(debug_assertions)"));
+        assert!(code.contains("aether_contract_end(0, start)"));
+        assert!(code.contains("if aether_contract_sample(1, 50)"));
+        assert_eq!(validator.contract_table(), "sort::precondition_1\nsort::postcondition_1");
+        assert_eq!(validator.get_stats().runtime_checks_sampled, 1);
+
+        metadata.contract_checks = Some("off".to_string());
+        let code = validator.generate_runtime_assertions(&metadata, "sort");
+        assert!(!code.contains("assert!"));
+        assert!("sampled:0".parse::<ContractCheckMode>().is_err());
+    }
+
+    #[test]
+    fn test_verified_checks_are_removed_from_mir() {
+        let source = r#"
+(DEFINE_MODULE
+  (NAME checked)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME identity)
+      (ACCEPTS_PARAMETER (NAME "x") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (PRECONDITION (PREDICATE_GREATER_THAN x 0))
+      (POSTCONDITION (PREDICATE_EQUALS 'result' x))
+      (BODY (RETURN_VALUE x)))))
+"#;
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        let mut lowering = crate::mir::lowering::LoweringContext::new();
+        lowering.set_contract_checks(ContractCheckMode::Full, false);
+        let mut mir_program = lowering.lower_program(&program).unwrap();
+
+        let facts = crate::verification::VerificationEngine::new().verify_contracts(&program, &mir_program);
+        let facts = &facts["identity"];
+        assert!(facts.is_proven("postcondition_1"));
+        assert!(!facts.is_proven("precondition_1"));
+
+        let function = mir_program.functions.get_mut("identity").unwrap();
+        assert_eq!(remove_proven_checks(function, facts), 1);
+        let checks: Vec<&str> = function.basic_blocks.values()
+            .filter_map(|block| match &block.terminator {
+                mir::Terminator::Assert { message: mir::AssertMessage::Contract { name, .. }, .. } => Some(name.as_str()),
+                _ => None,
+            })
+            .collect();
+        assert_eq!(checks, ["identity::precondition_1"]);
+        let statements: Vec<&mir::Statement> = function.basic_blocks.values().flat_map(|block| &block.statements).collect();
+        for name in ["aether_contract_begin", "aether_contract_end"] {
+            assert_eq!(statements.iter().filter(|statement| runtime_call(statement, name).is_some()).count(), 1);
+        }
+        assert!(crate::mir::validation::Validator::new().validate_function(function).is_ok());
+    }
 }
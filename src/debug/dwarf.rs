@@ -255,7 +255,7 @@ impl DwarfGenerator {
         
         // Add function parameters
         for (param_idx, param) in function.parameters.iter().enumerate() {
-            if let Some(local) = function.locals.get(&param.local_id) {
+            if let Some(local) = function.locals.get(param.local_id) {
                 let param_die = self.create_parameter_die(param_idx, local)?;
                 function_die.children.push(param_die);
             }
@@ -269,7 +269,7 @@ impl DwarfGenerator {
         
         // Add lexical blocks for basic blocks
         for (block_id, block) in &function.basic_blocks {
-            let block_die = self.create_lexical_block_die(*block_id as usize, block)?;
+            let block_die = self.create_lexical_block_die(block_id as usize, block)?;
             function_die.children.push(block_die);
         }
         
@@ -416,9 +416,9 @@ impl DwarfGenerator {
         for (block_id, block) in &function.basic_blocks {
             // Add line entry for block start
             self.line_program.entries.push(LineEntry {
-                address: *block_id as u64 * 0x1000, // Placeholder address
+                address: block_id as u64 * 0x1000, // Placeholder address
                 file: file_index,
-                line: (*block_id + 1) as u32, // Placeholder line number
+                line: (block_id + 1) as u32, // Placeholder line number
                 column: 1,
                 is_stmt: true,
                 basic_block: true,
@@ -430,7 +430,7 @@ impl DwarfGenerator {
                 self.line_program.entries.push(LineEntry {
                     address: (*block_id as u64 * 0x1000) + (stmt_idx as u64 * 4),
                     file: file_index,
-                    line: (*block_id + 1) as u32,
+                    line: (block_id + 1) as u32,
                     column: (stmt_idx + 1) as u32,
                     is_stmt: true,
                     basic_block: false,
@@ -213,7 +213,7 @@ impl SourceMapGenerator {
         
         // Process each basic block
         for (block_id, block) in &function.basic_blocks {
-            self.generate_block_mappings(*block_id as usize, block)?;
+            self.generate_block_mappings(block_id as usize, block)?;
         }
         
         Ok(())
@@ -599,10 +599,12 @@ mod tests {
             name: "test_function".to_string(),
             parameters: vec![],
             return_type: Type::Primitive(crate::ast::PrimitiveType::Void),
-            locals: HashMap::new(),
-            basic_blocks,
+            locals: Default::default(),
+            basic_blocks: basic_blocks.into_iter().collect(),
             entry_block: block_id,
             return_local: None,
+            entry_count: None,
+            proven_facts: None,
         });
         
         Program {
@@ -539,6 +539,7 @@ mod tests {
                 throws_exceptions: vec![],
                 thread_safe: Some(true),
                 may_block: Some(false),
+                contract_checks: None,
             },
             parameters: vec![],
             return_type: Box::new(TypeSpecifier::Primitive {
@@ -21,6 +21,9 @@ use std::collections::HashMap;
 use unicode_segmentation::UnicodeSegmentation;
 use serde::{Serialize, Deserialize};
 
+pub mod stream;
+pub use stream::TokenStream;
+
 /// Token types for AetherScript
 #[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
 pub enum TokenType {
@@ -118,7 +121,7 @@ impl Lexer {
             "VARIANTS", "VARIANT", "HOLDS", "MATCH_EXPRESSION", "CASE",
             // Type keywords
             "INTEGER", "FLOAT", "STRING", "CHAR", "BOOLEAN", "VOID", "ARRAY_OF_TYPE", 
-            "MAP_FROM_TYPE_TO_TYPE", "POINTER_TO",
+            "MAP_FROM_TYPE_TO_TYPE", "POINTER_TO", "VECTOR_OF_TYPE",
             // Function keywords
             "ACCEPTS_PARAMETER", "RETURNS", "BODY", "CALL_FUNCTION", "RETURN_VALUE", "RETURN_VOID",
             // Expression keywords
@@ -145,7 +148,7 @@ impl Lexer {
             "TRY_EXECUTE", "CATCH_EXCEPTION", "FINALLY_EXECUTE", "THROW_EXCEPTION",
             // Metadata keywords
             "INTENT", "PRECONDITION", "POSTCONDITION", "INVARIANT", "ALGORITHM_HINT",
-            "PERFORMANCE_EXPECTATION", "COMPLEXITY_EXPECTATION",
+            "PERFORMANCE_EXPECTATION", "COMPLEXITY_EXPECTATION", "CONTRACT_CHECKS",
             // Pointer operations
             "ADDRESS_OF", "DEREFERENCE", "POINTER_ADD",
             // Mutability
@@ -154,6 +157,9 @@ impl Lexer {
             "LIBRARY", "SYMBOL", "CALLING_CONVENTION", "CONVENTION", "THREAD_SAFE", "MAY_BLOCK", "VARIADIC",
             // Construction keywords
             "CONSTRUCT", "FIELD_VALUE", "ARRAY_LITERAL", "ARRAY_LENGTH", "MAP_LITERAL",
+            // SIMD vector operations
+            "VECTOR_LITERAL", "VECTOR_SPLAT", "VECTOR_LOAD", "VECTOR_STORE",
+            "VECTOR_SHUFFLE", "VECTOR_EXTRACT", "VECTOR_SELECT",
             // Misc keywords
             "NAME", "TYPE", "VALUE", "MUTABILITY", "MUTABLE", "IMMUTABLE",
             "FIELD", "PARAMETER", "ARGUMENT", "ELEMENTS", "ENTRY", "KEY",
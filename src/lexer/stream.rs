@@ -0,0 +1,152 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Streaming token source for the parser
+//!
+//! Tokens are pulled lazily from a [`Lexer`] into a bounded window so that
+//! lexing and parsing overlap in a single pass. Only the tokens between the
+//! oldest position the parser may still revisit and its lookahead horizon are
+//! resident at any time.
+
+use super::{Lexer, Token, TokenType};
+use crate::error::{LexerError, SourceLocation};
+use std::collections::VecDeque;
+
+enum Source {
+    Lexer(Box<Lexer>),
+    Tokens(std::vec::IntoIter<Token>),
+}
+
+/// Bounded lookahead buffer over a token source, indexed by absolute position
+pub struct TokenStream {
+    source: Source,
+    window: VecDeque<Token>,
+    /// Absolute index of `window.front()`
+    window_start: usize,
+    finished: bool,
+    error: Option<LexerError>,
+    peak_window: usize,
+}
+
+impl TokenStream {
+    /// Stream tokens lazily from a lexer
+    pub fn from_lexer(lexer: Lexer) -> Self {
+        Self::with_source(Source::Lexer(Box::new(lexer)))
+    }
+
+    /// Stream over an already materialized token vector
+    pub fn from_tokens(tokens: Vec<Token>) -> Self {
+        Self::with_source(Source::Tokens(tokens.into_iter()))
+    }
+
+    fn with_source(source: Source) -> Self {
+        Self {
+            source,
+            window: VecDeque::new(),
+            window_start: 0,
+            finished: false,
+            error: None,
+            peak_window: 0,
+        }
+    }
+
+    /// Token at absolute `index`, if it is buffered
+    pub fn get(&self, index: usize) -> Option<&Token> {
+        index
+            .checked_sub(self.window_start)
+            .and_then(|offset| self.window.get(offset))
+    }
+
+    /// Pull tokens until `index` is buffered or the source is exhausted
+    pub fn fill(&mut self, index: usize) {
+        while !self.finished && self.window_start + self.window.len() <= index {
+            let next = match &mut self.source {
+                Source::Lexer(lexer) => Some(lexer.next_token()),
+                Source::Tokens(tokens) => tokens.next().map(Ok),
+            };
+            match next {
+                Some(Ok(token)) => {
+                    if matches!(token.token_type, TokenType::Eof) {
+                        self.finished = true;
+                    }
+                    self.window.push_back(token);
+                }
+                Some(Err(error)) => {
+                    // Surface the lexer error to the caller and let the
+                    // parser see a clean end of input
+                    self.error = Some(error);
+                    self.finished = true;
+                    self.window.push_back(Token::new(
+                        TokenType::Eof,
+                        SourceLocation::unknown(),
+                        String::new(),
+                    ));
+                }
+                None => self.finished = true,
+            }
+        }
+        self.peak_window = self.peak_window.max(self.window.len());
+    }
+
+    /// Drop buffered tokens before absolute `index`
+    pub fn release_before(&mut self, index: usize) {
+        while self.window_start < index && !self.window.is_empty() {
+            self.window.pop_front();
+            self.window_start += 1;
+        }
+    }
+
+    /// Take the lexer error that terminated the stream, if any
+    pub fn take_error(&mut self) -> Option<LexerError> {
+        self.error.take()
+    }
+
+    /// Largest number of tokens that were resident at once
+    pub fn peak_buffered(&self) -> usize {
+        self.peak_window
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_window_is_bounded() {
+        let source = "(a b c d e f g h i j k l m n o p)".to_string();
+        let mut stream = TokenStream::from_lexer(Lexer::new(&source, "test.aether".to_string()));
+
+        let mut position = 0;
+        while stream.get(position).map(|t| !matches!(t.token_type, TokenType::Eof)).unwrap_or(true) {
+            stream.release_before(position.saturating_sub(1));
+            stream.fill(position + 2);
+            assert!(stream.get(position).is_some());
+            position += 1;
+        }
+
+        assert_eq!(position, 18);
+        assert!(stream.peak_buffered() <= 4);
+        assert!(stream.get(0).is_none());
+    }
+
+    #[test]
+    fn test_lexer_error_ends_stream() {
+        let source = "(a @)".to_string();
+        let mut stream = TokenStream::from_lexer(Lexer::new(&source, "test.aether".to_string()));
+        stream.fill(10);
+
+        assert!(matches!(stream.get(2).unwrap().token_type, TokenType::Eof));
+        assert!(matches!(stream.take_error(), Some(LexerError::UnexpectedCharacter { character: '@', .. })));
+    }
+}
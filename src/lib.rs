@@ -74,6 +74,14 @@ impl Compiler {
     /// Set optimization level (0-3)
     pub fn optimization_level(mut self, level: u8) -> Self {
         self.options.optimization_level = level.min(3);
+        self.options.size_level = 0;
+        self
+    }
+    
+    /// Set the optimization level including the size levels `Os` and `Oz`
+    pub fn opt_level(mut self, level: llvm_backend::OptLevel) -> Self {
+        self.options.optimization_level = level.speed_level();
+        self.options.size_level = level.size_level();
         self
     }
     
@@ -95,6 +103,24 @@ impl Compiler {
         self
     }
     
+    /// Set target CPU (`native` selects the host CPU)
+    pub fn target_cpu(mut self, cpu: String) -> Self {
+        self.options.target_cpu = Some(cpu);
+        self
+    }
+    
+    /// Set target features (e.g., "+avx2,+fma")
+    pub fn target_features(mut self, features: String) -> Self {
+        self.options.target_features = Some(features);
+        self
+    }
+    
+    /// Enable ThinLTO between Aether code and the runtime
+    pub fn lto(mut self, enable: bool) -> Self {
+        self.options.lto = enable;
+        self
+    }
+    
     /// Add library search path
     pub fn library_path(mut self, path: PathBuf) -> Self {
         self.options.library_paths.push(path);
@@ -131,6 +157,24 @@ impl Compiler {
         self
     }
     
+    /// Set the number of codegen units compiled in parallel
+    pub fn codegen_units(mut self, units: usize) -> Self {
+        self.options.codegen_units = units.max(1);
+        self
+    }
+    
+    /// Enable the incremental compilation cache
+    pub fn incremental(mut self, enable: bool) -> Self {
+        self.options.incremental = enable;
+        self
+    }
+    
+    /// Set the incremental cache directory
+    pub fn cache_dir(mut self, path: PathBuf) -> Self {
+        self.options.cache_dir = Some(path);
+        self
+    }
+    
     /// Compile a single source file
     pub fn compile_file(&self, input: PathBuf) -> Result<CompilationResult, CompilerError> {
         self.compile_files(&[input])
@@ -189,10 +189,10 @@ impl<'ctx> CodeGenerator<'ctx> {
         
         // Create basic blocks
         self.basic_blocks.clear();
-        for block_id in mir_function.basic_blocks.keys() {
+        for block_id in mir_function.basic_blocks.ids() {
             let bb_name = format!("bb{}", block_id);
             let basic_block = self.context.append_basic_block(function, &bb_name);
-            self.basic_blocks.insert(*block_id, basic_block);
+            self.basic_blocks.insert(block_id, basic_block);
         }
         
         // Create entry block for local variable allocations
@@ -227,7 +227,7 @@ impl<'ctx> CodeGenerator<'ctx> {
         // Allocate space for other locals
         for (local_id, local) in &mir_function.locals {
             // Skip parameters (already allocated)
-            if self.local_values.contains_key(local_id) {
+            if self.local_values.contains_key(&local_id) {
                 continue;
             }
             
@@ -236,8 +236,8 @@ impl<'ctx> CodeGenerator<'ctx> {
             let alloca = self.builder.build_alloca(local_type, &alloca_name)
                 .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
             
-            self.local_values.insert(*local_id, alloca);
-            self.local_types.insert(*local_id, local_type);
+            self.local_values.insert(local_id, alloca);
+            self.local_types.insert(local_id, local_type);
         }
         
         // Jump to the entry block of the MIR function
@@ -247,7 +247,7 @@ impl<'ctx> CodeGenerator<'ctx> {
         
         // Generate code for each basic block
         for (block_id, mir_block) in &mir_function.basic_blocks {
-            self.generate_basic_block(*block_id, mir_block)?;
+            self.generate_basic_block(block_id, mir_block)?;
         }
         
         Ok(())
@@ -280,6 +280,13 @@ impl<'ctx> CodeGenerator<'ctx> {
                     .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
             }
             
+            Statement::VectorStore { .. } => {
+                return Err(SemanticError::UnsupportedFeature {
+                    feature: "Vector stores not yet implemented in LLVM backend".to_string(),
+                    location: crate::error::SourceLocation::unknown(),
+                });
+            }
+            
             Statement::StorageLive(_) | Statement::StorageDead(_) => {
                 // These are handled by LLVM's memory management
             }
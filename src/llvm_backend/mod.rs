@@ -24,12 +24,14 @@ pub mod values;
 use crate::mir::{self, Program};
 use crate::error::SemanticError;
 use inkwell::context::Context;
-use inkwell::module::Module;
+use inkwell::attributes::{Attribute, AttributeLoc};
+use inkwell::module::{Linkage, Module};
+use inkwell::passes::PassBuilderOptions;
 use inkwell::targets::{Target, InitializationConfig, TargetMachine, CodeModel, RelocMode, FileType, TargetTriple};
 use inkwell::OptimizationLevel;
 use inkwell::AddressSpace;
 use inkwell::builder::Builder;
-use inkwell::values::{FunctionValue, PointerValue, BasicValueEnum};
+use inkwell::values::{BasicMetadataValueEnum, FunctionValue, InstructionValue, PointerValue, BasicValueEnum, VectorValue};
 use std::path::Path;
 use std::collections::{HashMap, HashSet};
 
@@ -91,9 +93,13 @@ pub struct LLVMBackend<'ctx> {
     context: &'ctx Context,
     module: Module<'ctx>,
     target_machine: Option<TargetMachine>,
+    /// Pass pipeline and code generator configuration
+    target_options: TargetOptions,
     function_declarations: Option<HashMap<String, FunctionValue<'ctx>>>,
     string_globals: HashMap<String, PointerValue<'ctx>>,
     type_definitions: HashMap<String, crate::types::TypeDefinition>,
+    /// Functions whose bodies this backend emits; `None` means all of them
+    codegen_unit: Option<HashSet<String>>,
 }
 
 impl<'ctx> LLVMBackend<'ctx> {
@@ -105,12 +111,27 @@ impl<'ctx> LLVMBackend<'ctx> {
             context,
             module,
             target_machine: None,
+            target_options: TargetOptions::default(),
             function_declarations: None,
             string_globals: HashMap::new(),
             type_definitions: HashMap::new(),
+            codegen_unit: None,
         }
     }
     
+    /// Restrict body generation to one codegen unit
+    ///
+    /// Every function of the program is still declared, so calls into other
+    /// units resolve at link time against their object files.
+    pub fn set_codegen_unit(&mut self, functions: HashSet<String>) {
+        self.codegen_unit = Some(functions);
+    }
+    
+    /// Whether this backend emits the body of `name`
+    fn defines_function(&self, name: &str) -> bool {
+        self.codegen_unit.as_ref().map_or(true, |unit| unit.contains(name))
+    }
+    
     /// Convert an AetherScript type to an LLVM basic type
     fn get_basic_type(&self, ty: &crate::types::Type) -> inkwell::types::BasicTypeEnum<'ctx> {
         match ty {
@@ -150,6 +171,13 @@ impl<'ctx> LLVMBackend<'ctx> {
                 // Pointers are represented as i8*
                 self.context.i8_type().ptr_type(AddressSpace::default()).into()
             },
+            crate::types::Type::Vector { element_type, lanes } => {
+                match self.get_basic_type(element_type) {
+                    inkwell::types::BasicTypeEnum::FloatType(float_type) => float_type.vec_type(*lanes as u32).into(),
+                    inkwell::types::BasicTypeEnum::IntType(int_type) => int_type.vec_type(*lanes as u32).into(),
+                    _ => self.context.i32_type().vec_type(*lanes as u32).into(),
+                }
+            },
             _ => self.context.i32_type().into(), // Default for complex types
         }
     }
@@ -157,7 +185,7 @@ impl<'ctx> LLVMBackend<'ctx> {
     /// Get the basic type from a local ID
     fn get_basic_type_from_local(&self, local_id: mir::LocalId, function: &mir::Function) -> Result<inkwell::types::BasicTypeEnum<'ctx>, SemanticError> {
         // Check if it's a local
-        if let Some(local) = function.locals.get(&local_id) {
+        if let Some(local) = function.locals.get(local_id) {
             Ok(self.get_basic_type(&local.ty))
         } else {
             // Check if it's a parameter
@@ -218,29 +246,88 @@ impl<'ctx> LLVMBackend<'ctx> {
     
     /// Set the target triple for code generation
     pub fn set_target_triple(&mut self, triple: &str) -> Result<(), String> {
+        let options = self.target_options.clone();
+        self.configure_target(triple, options)
+    }
+    
+    /// Set the target triple together with optimization level, CPU and features
+    pub fn configure_target(&mut self, triple: &str, options: TargetOptions) -> Result<(), String> {
         let target_triple = TargetTriple::create(triple);
         self.module.set_triple(&target_triple);
         
         let target = Target::from_triple(&target_triple)
             .map_err(|e| format!("Failed to create target: {}", e))?;
         
+        let (cpu, features) = options.resolve_cpu();
         let target_machine = target
             .create_target_machine(
                 &target_triple,
-                "generic", // CPU
-                "",        // Features
-                OptimizationLevel::Default,
+                &cpu,
+                &features,
+                options.opt_level.codegen_level(),
                 RelocMode::Default,
                 CodeModel::Default,
             )
-            .ok_or("Failed to create target machine")?;
+            .ok_or_else(|| format!("Failed to create target machine for CPU '{}'", cpu))?;
         
         self.module.set_data_layout(&target_machine.get_target_data().get_data_layout());
         self.target_machine = Some(target_machine);
+        self.target_options = options;
         
         Ok(())
     }
     
+    /// Run the LLVM pass pipeline matching the configured optimization level
+    ///
+    /// Must be called after `generate_ir` and before writing the object file.
+    pub fn run_optimization_passes(&self) -> Result<(), String> {
+        let target_machine = self.target_machine.as_ref()
+            .ok_or("Target machine not set")?;
+        let opt_level = self.target_options.opt_level;
+        let pipeline = if self.target_options.lto {
+            opt_level.lto_pre_link_pipeline()
+        } else {
+            opt_level.pass_pipeline()
+        };
+        
+        self.add_target_attributes();
+        
+        let pass_options = PassBuilderOptions::create();
+        pass_options.set_loop_vectorization(opt_level.vectorizes());
+        pass_options.set_loop_slp_vectorization(opt_level.vectorizes());
+        pass_options.set_loop_unrolling(opt_level.unrolls_loops());
+        pass_options.set_merge_functions(opt_level.is_size_level());
+        
+        self.module
+            .run_passes(pipeline, target_machine, pass_options)
+            .map_err(|e| format!("LLVM pass pipeline {} failed: {}", pipeline, e))
+    }
+    
+    /// Record the target CPU and features on every defined function
+    ///
+    /// Under LTO the linker generates code from bitcode and only sees the
+    /// CPU through these attributes.
+    fn add_target_attributes(&self) {
+        let (cpu, features) = self.target_options.resolve_cpu();
+        let cpu_attribute = self.context.create_string_attribute("target-cpu", &cpu);
+        let features_attribute = self.context.create_string_attribute("target-features", &features);
+        
+        for function in self.module.get_functions() {
+            if function.count_basic_blocks() == 0 {
+                continue;
+            }
+            function.add_attribute(AttributeLoc::Function, cpu_attribute);
+            if !features.is_empty() {
+                function.add_attribute(AttributeLoc::Function, features_attribute);
+            }
+        }
+    }
+    
+    /// Options the target machine was configured with
+    pub fn target_options(&self) -> &TargetOptions {
+        &self.target_options
+    }
+    
     /// Generate LLVM IR from MIR program
     pub fn generate_ir(&mut self, program: &Program) -> Result<(), SemanticError> {
         eprintln!("MIR program has {} functions, {} constants, {} externals, {} types", 
@@ -304,7 +391,20 @@ impl<'ctx> LLVMBackend<'ctx> {
             function_declarations.insert(name.clone(), llvm_func);
         }
         
-        for (name, function) in &program.functions {
+        // Walk functions in name order so the emitted IR is stable. Profiled
+        // functions go first, hottest first, and ones that never ran go last,
+        // since functions are laid out in module order.
+        let mut functions: Vec<(&String, &mir::Function)> = program.functions.iter().collect();
+        functions.sort_by_key(|&(name, function)| {
+            let tier = match function.entry_count {
+                Some(0) => 2,
+                Some(_) => 0,
+                None => 1,
+            };
+            (tier, std::cmp::Reverse(function.entry_count), name)
+        });
+        
+        for &(name, function) in &functions {
             // Special handling for main function
             if name == "main" {
                 // Check if main has argc/argv parameters
@@ -329,37 +429,40 @@ impl<'ctx> LLVMBackend<'ctx> {
                     let user_main = self.module.add_function(user_main_name, fn_type, None);
                     function_declarations.insert(user_main_name.to_string(), user_main);
                     
-                    // Create the real main function
-                    let i32_type = self.context.i32_type();
-                    let i8_type = self.context.i8_type();
-                    let argv_type = i8_type.ptr_type(AddressSpace::default()).ptr_type(AddressSpace::default());
-                    let param_types = vec![i32_type.into(), argv_type.into()];
-                    let main_fn_type = i32_type.fn_type(&param_types, false);
-                    let main_func = self.module.add_function("main", main_fn_type, None);
+                    // Only the unit that owns main emits the C entry point
+                    if self.defines_function(name) {
+                        // Create the real main function
+                        let i32_type = self.context.i32_type();
+                        let i8_type = self.context.i8_type();
+                        let argv_type = i8_type.ptr_type(AddressSpace::default()).ptr_type(AddressSpace::default());
+                        let param_types = vec![i32_type.into(), argv_type.into()];
+                        let main_fn_type = i32_type.fn_type(&param_types, false);
+                        let main_func = self.module.add_function("main", main_fn_type, None);
                     
-                    // Generate wrapper body
-                    let builder = self.context.create_builder();
-                    let entry = self.context.append_basic_block(main_func, "entry");
-                    builder.position_at_end(entry);
-                    
-                    // Call runtime init
-                    if let Some(init_fn) = self.module.get_function("aether_runtime_init") {
-                        let _ = builder.build_call(init_fn, &[], "call_runtime_init");
-                    }
+                        // Generate wrapper body
+                        let builder = self.context.create_builder();
+                        let entry = self.context.append_basic_block(main_func, "entry");
+                        builder.position_at_end(entry);
                     
-                    // Call user's main
-                    match builder.build_call(user_main, &[], "call_user_main") {
-                        Ok(call_site) => {
-                            let return_value = if let Some(basic_value) = call_site.try_as_basic_value().left() {
-                                basic_value.into_int_value()
-                            } else {
-                                i32_type.const_int(0, false)
-                            };
-                            builder.build_return(Some(&return_value));
+                        // Call runtime init
+                        if let Some(init_fn) = self.module.get_function("aether_runtime_init") {
+                            let _ = builder.build_call(init_fn, &[], "call_runtime_init");
                         }
-                        Err(_) => {
-                            // If call fails, just return 0
-                            builder.build_return(Some(&i32_type.const_int(0, false)));
+                    
+                        // Call user's main
+                        match builder.build_call(user_main, &[], "call_user_main") {
+                            Ok(call_site) => {
+                                let return_value = if let Some(basic_value) = call_site.try_as_basic_value().left() {
+                                    basic_value.into_int_value()
+                                } else {
+                                    i32_type.const_int(0, false)
+                                };
+                                builder.build_return(Some(&return_value));
+                            }
+                            Err(_) => {
+                                // If call fails, just return 0
+                                builder.build_return(Some(&i32_type.const_int(0, false)));
+                            }
                         }
                     }
                 } else {
@@ -436,14 +539,15 @@ impl<'ctx> LLVMBackend<'ctx> {
         self.function_declarations = Some(function_declarations);
         
         // Second pass: generate function bodies
-        for (name, function) in &program.functions {
-            eprintln!("Processing MIR function: {}", name);
-            if name == "main" && function.parameters.is_empty() {
-                // For parameterless main, we generate it as __aether_main
-                self.generate_function_body_only("__aether_main", function)?;
-            } else {
-                self.generate_function_body_only(name, function)?;
+        for &(name, function) in &functions {
+            if !self.defines_function(name) {
+                continue;
             }
+            eprintln!("Processing MIR function: {}", name);
+            // For parameterless main, we generate it as __aether_main
+            let llvm_name = if name == "main" && function.parameters.is_empty() { "__aether_main" } else { name.as_str() };
+            self.generate_function_body_only(llvm_name, function)?;
+            self.apply_function_profile(llvm_name, function);
         }
         
         Ok(())
@@ -451,6 +555,49 @@ impl<'ctx> LLVMBackend<'ctx> {
     
     
     
+    /// Mark a profiled function hot or cold
+    ///
+    /// On ELF targets it also goes in a `.text.hot` or `.text.unlikely`
+    /// section, which linkers group, so code that ran in training is packed
+    /// together away from code that never did.
+    fn apply_function_profile(&self, name: &str, function: &mir::Function) {
+        let (attribute, section) = match function.entry_count {
+            Some(0) => ("cold", ".text.unlikely."),
+            Some(_) => ("hot", ".text.hot."),
+            None => return,
+        };
+        let llvm_func = match self.module.get_function(name) {
+            Some(llvm_func) => llvm_func,
+            None => return,
+        };
+        
+        let kind = Attribute::get_named_enum_kind_id(attribute);
+        llvm_func.add_attribute(AttributeLoc::Function, self.context.create_enum_attribute(kind, 0));
+        
+        // Mach-O and COFF name sections differently
+        let triple = self.module.get_triple();
+        let triple = triple.as_str().to_string_lossy();
+        if !(triple.contains("apple") || triple.contains("windows")) {
+            llvm_func.as_global_value().set_section(Some(&format!("{}{}", section, name)));
+        }
+    }
+    
+    /// Attach profiled branch weights (`!prof` metadata) to a terminator
+    fn set_branch_weights(&self, instruction: InstructionValue<'ctx>, weights: &[u64]) {
+        if weights.is_empty() {
+            return;
+        }
+        
+        // Weights are 32-bit; larger counts are scaled down keeping their ratios
+        let scale = weights.iter().max().map_or(1, |&max| max / u64::from(u32::MAX) + 1);
+        let mut operands: Vec<BasicMetadataValueEnum<'ctx>> = vec![self.context.metadata_string("branch_weights").into()];
+        operands.extend(weights.iter().map(|&weight| {
+            BasicMetadataValueEnum::from(self.context.i32_type().const_int(weight / scale, false))
+        }));
+        let node = self.context.metadata_node(&operands);
+        let _ = instruction.set_metadata(node, self.context.get_kind_id("prof"));
+    }
+    
     /// Generate function body only (assumes function already declared)
     fn generate_function_body_only(&mut self, name: &str, function: &mir::Function) -> Result<(), SemanticError> {
         let llvm_func = self.function_declarations.as_ref()
@@ -480,7 +627,7 @@ impl<'ctx> LLVMBackend<'ctx> {
         llvm_blocks.insert(function.entry_block, entry_block);
         
         // Create other blocks
-        for &block_id in function.basic_blocks.keys() {
+        for block_id in function.basic_blocks.ids() {
             if block_id != function.entry_block {
                 let block_name = format!("bb{}", block_id);
                 let llvm_block = self.context.append_basic_block(llvm_func, &block_name);
@@ -498,7 +645,7 @@ impl<'ctx> LLVMBackend<'ctx> {
         builder.position_at_end(llvm_blocks[&function.entry_block]);
         
         // Allocate stack slots for non-parameter locals
-        for (&local_id, local) in &function.locals {
+        for (local_id, local) in &function.locals {
             if !function.parameters.iter().any(|p| p.local_id == local_id) {
                 let local_type = self.get_basic_type(&local.ty);
                 let alloca = builder.build_alloca(local_type, &format!("local_{}", local_id))
@@ -525,7 +672,7 @@ impl<'ctx> LLVMBackend<'ctx> {
         }
         
         // Process blocks in order, starting with entry block
-        let mut block_order: Vec<_> = function.basic_blocks.keys().copied().collect();
+        let mut block_order: Vec<_> = function.basic_blocks.ids().collect();
         block_order.sort();
         // Ensure entry block is first
         if let Some(entry_pos) = block_order.iter().position(|&id| id == function.entry_block) {
@@ -534,7 +681,7 @@ impl<'ctx> LLVMBackend<'ctx> {
         
         // Process each basic block in order
         for &block_id in &block_order {
-            let mir_block = &function.basic_blocks[&block_id];
+            let mir_block = &function.basic_blocks[block_id];
             eprintln!("Processing block {}: {} statements, terminator: {:?}", block_id, mir_block.statements.len(), mir_block.terminator);
             let llvm_block = llvm_blocks[&block_id];
             builder.position_at_end(llvm_block);
@@ -549,6 +696,15 @@ impl<'ctx> LLVMBackend<'ctx> {
                                 .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
                         }
                     }
+                    mir::Statement::VectorStore { array, index, value, .. } => {
+                        let value = self.generate_operand(value, &local_allocas, &builder, function)?;
+                        let element_ptr = self.array_element_pointer(array, index, &local_allocas, &builder, function)?;
+                        let store = builder.build_store(element_ptr, value)
+                            .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                        // Array elements are only guaranteed i32 alignment
+                        store.set_alignment(4)
+                            .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                    }
                     mir::Statement::StorageLive(_) | mir::Statement::StorageDead(_) => {
                         // Ignore storage markers for now
                     }
@@ -567,7 +723,7 @@ impl<'ctx> LLVMBackend<'ctx> {
                     if let Some(return_local) = function.return_local {
                         if let Some(&return_alloca) = local_allocas.get(&return_local) {
                             // Get the type of the return local
-                            let return_type = function.locals.get(&return_local)
+                            let return_type = function.locals.get(return_local)
                                 .map(|local| self.get_basic_type(&local.ty))
                                 .unwrap_or_else(|| self.context.i32_type().into());
                             
@@ -629,8 +785,9 @@ impl<'ctx> LLVMBackend<'ctx> {
                             "is_true"
                         ).map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
                         
-                        builder.build_conditional_branch(is_true, then_block, else_block)
+                        let branch = builder.build_conditional_branch(is_true, then_block, else_block)
                             .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                        self.set_branch_weights(branch, &targets.weights);
                     } else if targets.values.len() > 1 {
                         // Build a proper switch instruction for multiple cases
                         let mut cases = Vec::new();
@@ -641,8 +798,14 @@ impl<'ctx> LLVMBackend<'ctx> {
                         }
                         
                         let otherwise_block = llvm_blocks[&targets.otherwise];
-                        builder.build_switch(int_value, otherwise_block, &cases)
+                        let switch = builder.build_switch(int_value, otherwise_block, &cases)
                             .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                        
+                        // LLVM lists the default weight first
+                        if let Some((otherwise, cases)) = targets.weights.split_last() {
+                            let weights: Vec<u64> = std::iter::once(*otherwise).chain(cases.iter().copied()).collect();
+                            self.set_branch_weights(switch, &weights);
+                        }
                     } else {
                         // No cases, just jump to otherwise block
                         let target_block = llvm_blocks[&targets.otherwise];
@@ -671,6 +834,42 @@ impl<'ctx> LLVMBackend<'ctx> {
                     }
                 }
                 
+                mir::Terminator::Assert { condition, expected, message: mir::AssertMessage::Contract { message, fatal, .. }, target, .. } => {
+                    // The runtime reports a failed contract; only a non-fatal one reaches `target`
+                    let holds = match self.generate_operand(condition, &local_allocas, &builder, function)? {
+                        BasicValueEnum::IntValue(v) => v,
+                        _ => return Err(SemanticError::CodeGenError {
+                            message: "Expected integer value for contract condition".to_string()
+                        }),
+                    };
+                    let predicate = if *expected { inkwell::IntPredicate::NE } else { inkwell::IntPredicate::EQ };
+                    let passed = builder.build_int_compare(predicate, holds, holds.get_type().const_zero(), "contract_holds")
+                        .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                    
+                    let target_block = llvm_blocks[target];
+                    let failed_block = self.context.append_basic_block(llvm_func, "contract_failed");
+                    let branch = builder.build_conditional_branch(passed, target_block, failed_block)
+                        .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                    self.set_branch_weights(branch, &[u64::from(u32::MAX), 1]);
+                    
+                    builder.position_at_end(failed_block);
+                    let fail_fn = self.function_declarations.as_ref()
+                        .and_then(|decls| decls.get("aether_contract_fail"))
+                        .copied()
+                        .ok_or_else(|| SemanticError::CodeGenError {
+                            message: "Function aether_contract_fail not found".to_string()
+                        })?;
+                    let message = self.generate_operand(&mir::Operand::Constant(mir::Constant {
+                        ty: crate::types::Type::primitive(crate::ast::PrimitiveType::String),
+                        value: mir::ConstantValue::String(message.clone()),
+                    }), &local_allocas, &builder, function)?;
+                    let fatal = self.context.i32_type().const_int(u64::from(*fatal), false);
+                    builder.build_call(fail_fn, &[message.into(), fatal.into()], "")
+                        .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                    builder.build_unconditional_branch(target_block)
+                        .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                }
+                
                 mir::Terminator::Assert { .. } => {
                     // TODO: Implement assertion checks
                     return Err(SemanticError::CodeGenError {
@@ -945,6 +1144,9 @@ impl<'ctx> LLVMBackend<'ctx> {
                         
                         Ok(result_ptr.into())
                     }
+                    (op, BasicValueEnum::VectorValue(l), BasicValueEnum::VectorValue(r)) => {
+                        self.generate_vector_binary_op(*op, l, r, builder)
+                    }
                     _ => {
                         Err(SemanticError::CodeGenError {
                             message: format!("Unsupported binary operation or type mismatch: {:?}", op)
@@ -982,6 +1184,27 @@ impl<'ctx> LLVMBackend<'ctx> {
                     }
                 };
                 
+                // Accesses proven in bounds skip the runtime call, and arrays
+                // that never escape are built in the frame
+                match (function_name.as_str(), args.as_slice()) {
+                    ("array_create_stack", [mir::Operand::Constant(mir::Constant { value: mir::ConstantValue::Integer(length), .. })]) => {
+                        return self.build_stack_array(*length as u64, builder);
+                    }
+                    ("array_get_unchecked", [array, index]) => {
+                        let element_ptr = self.array_element_pointer(array, index, local_allocas, builder, function)?;
+                        return builder.build_load(self.context.i32_type(), element_ptr, "elem")
+                            .map_err(|e| SemanticError::CodeGenError { message: e.to_string() });
+                    }
+                    ("array_set_unchecked", [array, index, value]) => {
+                        let element_ptr = self.array_element_pointer(array, index, local_allocas, builder, function)?;
+                        let value = self.generate_operand(value, local_allocas, builder, function)?;
+                        builder.build_store(element_ptr, value)
+                            .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                        return Ok(self.context.i32_type().const_int(0, false).into());
+                    }
+                    _ => {}
+                }
+                
                 // Get the LLVM function first (to avoid borrowing conflicts)
                 eprintln!("DEBUG: Looking up function: {}", function_name);
                 if let Some(decls) = self.function_declarations.as_ref() {
@@ -1303,6 +1526,19 @@ impl<'ctx> LLVMBackend<'ctx> {
                         })
                     }
                     
+                    mir::AggregateKind::Vector(element_type) => {
+                        let vector_type = self.get_basic_type(&crate::types::Type::vector(element_type.clone(), operands.len()))
+                            .into_vector_type();
+                        let mut vector = vector_type.get_undef();
+                        for (lane, operand) in operands.iter().enumerate() {
+                            let value = self.generate_operand(operand, local_allocas, builder, function)?;
+                            let lane = self.context.i32_type().const_int(lane as u64, false);
+                            vector = builder.build_insert_element(vector, value, lane, "vlane")
+                                .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                        }
+                        Ok(vector.into())
+                    }
+                    
                     mir::AggregateKind::Tuple => {
                         // TODO: Implement tuple aggregate construction
                         Err(SemanticError::CodeGenError {
@@ -1421,7 +1657,7 @@ impl<'ctx> LLVMBackend<'ctx> {
                                 }
                                 mir::PlaceElem::Field { field, ty: _ } => {
                                     // For field access, calculate proper offset based on struct definition
-                                    let offset = if let Some(local_def) = function.locals.get(&place.local) {
+                                    let offset = if let Some(local_def) = function.locals.get(place.local) {
                                         if let crate::types::Type::Named { name, .. } = &local_def.ty {
                                             // Look up struct definition
                                             if let Some(type_def) = self.type_definitions.get(name) {
@@ -1515,6 +1751,104 @@ impl<'ctx> LLVMBackend<'ctx> {
                 }
             }
             
+            mir::Rvalue::VectorLoad { array, index, lanes } => {
+                let element_ptr = self.array_element_pointer(array, index, local_allocas, builder, function)?;
+                // Runtime arrays only hold i32 elements
+                let vector_type = self.context.i32_type().vec_type(*lanes);
+                let loaded = builder.build_load(vector_type, element_ptr, "vload")
+                    .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                if let Some(instruction) = inkwell::values::BasicValue::as_instruction_value(&loaded) {
+                    instruction.set_alignment(4)
+                        .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                }
+                Ok(loaded)
+            }
+            
+            mir::Rvalue::VectorSplat { operand, lanes } => {
+                let scalar = self.generate_operand(operand, local_allocas, builder, function)?;
+                let vector_type = match scalar {
+                    BasicValueEnum::IntValue(v) => v.get_type().vec_type(*lanes),
+                    BasicValueEnum::FloatValue(v) => v.get_type().vec_type(*lanes),
+                    _ => return Err(SemanticError::CodeGenError {
+                        message: "Vector splat of a non-scalar value".to_string()
+                    }),
+                };
+                let undef = vector_type.get_undef();
+                let zero = self.context.i32_type().const_zero();
+                let inserted = builder.build_insert_element(undef, scalar, zero, "splat_insert")
+                    .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                let mask = inkwell::types::VectorType::const_vector(&vec![zero; *lanes as usize]);
+                builder.build_shuffle_vector(inserted, undef, mask, "splat")
+                    .map(|v| v.into())
+                    .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })
+            }
+            
+            mir::Rvalue::VectorReduce { op, operand } => {
+                let vector = match self.generate_operand(operand, local_allocas, builder, function)? {
+                    BasicValueEnum::VectorValue(v) => v,
+                    _ => return Err(SemanticError::CodeGenError {
+                        message: "Vector reduction of a non-vector value".to_string()
+                    }),
+                };
+                let intrinsic_name = match op {
+                    mir::BinOp::Add => "llvm.vector.reduce.add",
+                    mir::BinOp::Mul => "llvm.vector.reduce.mul",
+                    mir::BinOp::BitAnd => "llvm.vector.reduce.and",
+                    mir::BinOp::BitOr => "llvm.vector.reduce.or",
+                    mir::BinOp::BitXor => "llvm.vector.reduce.xor",
+                    _ => return Err(SemanticError::CodeGenError {
+                        message: format!("Unsupported vector reduction: {:?}", op)
+                    }),
+                };
+                let declaration = inkwell::intrinsics::Intrinsic::find(intrinsic_name)
+                    .and_then(|intrinsic| intrinsic.get_declaration(&self.module, &[vector.get_type().into()]))
+                    .ok_or_else(|| SemanticError::CodeGenError {
+                        message: format!("Intrinsic {} not available", intrinsic_name)
+                    })?;
+                builder.build_call(declaration, &[vector.into()], "reduce")
+                    .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?
+                    .try_as_basic_value()
+                    .left()
+                    .ok_or_else(|| SemanticError::CodeGenError {
+                        message: format!("{} returned no value", intrinsic_name)
+                    })
+            }
+            
+            mir::Rvalue::VectorShuffle { left, right, mask } => {
+                let left = self.generate_vector_operand(left, local_allocas, builder, function)?;
+                let right = self.generate_vector_operand(right, local_allocas, builder, function)?;
+                let mask: Vec<_> = mask.iter()
+                    .map(|lane| self.context.i32_type().const_int(*lane as u64, false))
+                    .collect();
+                let mask = inkwell::types::VectorType::const_vector(&mask);
+                builder.build_shuffle_vector(left, right, mask, "shuffle")
+                    .map(|v| v.into())
+                    .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })
+            }
+            
+            mir::Rvalue::VectorExtract { vector, lane } => {
+                let vector = self.generate_vector_operand(vector, local_allocas, builder, function)?;
+                let lane = match self.generate_operand(lane, local_allocas, builder, function)? {
+                    BasicValueEnum::IntValue(v) => v,
+                    _ => return Err(SemanticError::CodeGenError {
+                        message: "Vector lane index is not an integer".to_string()
+                    }),
+                };
+                builder.build_extract_element(vector, lane, "lane")
+                    .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })
+            }
+            
+            mir::Rvalue::VectorSelect { mask, if_true, if_false } => {
+                // Boolean lanes are stored as i32, so narrow the mask to i1 first
+                let mask = self.generate_vector_operand(mask, local_allocas, builder, function)?;
+                let condition = builder.build_int_compare(inkwell::IntPredicate::NE, mask, mask.get_type().const_zero(), "mask")
+                    .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+                let if_true = self.generate_vector_operand(if_true, local_allocas, builder, function)?;
+                let if_false = self.generate_vector_operand(if_false, local_allocas, builder, function)?;
+                builder.build_select(condition, if_true, if_false, "select")
+                    .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })
+            }
+            
             mir::Rvalue::Len(_) => {
                 // TODO: Implement array/slice length
                 Err(SemanticError::CodeGenError {
@@ -1525,7 +1859,7 @@ impl<'ctx> LLVMBackend<'ctx> {
             mir::Rvalue::Discriminant(place) => {
                 // Get the discriminant of an enum
                 // First, get the type of the enum to determine discriminant size
-                let enum_type_name = if let Some(local) = function.locals.get(&place.local) {
+                let enum_type_name = if let Some(local) = function.locals.get(place.local) {
                     match &local.ty {
                         crate::types::Type::Named { name, .. } => name.clone(),
                         _ => {
@@ -1631,6 +1965,7 @@ impl<'ctx> LLVMBackend<'ctx> {
         global.set_initializer(&string_const);
         global.set_constant(true);
         global.set_unnamed_addr(true); // Allow optimization
+        global.set_linkage(Linkage::Private); // Names repeat across codegen units
         
         // Get pointer to the global
         let global_ptr = global.as_pointer_value();
@@ -1641,6 +1976,136 @@ impl<'ctx> LLVMBackend<'ctx> {
         global_ptr
     }
     
+    /// Generate an operand that must be a vector
+    fn generate_vector_operand(
+        &mut self,
+        operand: &mir::Operand,
+        local_allocas: &HashMap<mir::LocalId, PointerValue<'ctx>>,
+        builder: &Builder<'ctx>,
+        function: &mir::Function
+    ) -> Result<VectorValue<'ctx>, SemanticError> {
+        match self.generate_operand(operand, local_allocas, builder, function)? {
+            BasicValueEnum::VectorValue(v) => Ok(v),
+            other => Err(SemanticError::CodeGenError {
+                message: format!("Expected a vector operand, found {:?}", other.get_type())
+            }),
+        }
+    }
+    
+    /// Lane-wise arithmetic and comparisons on two vectors of the same type
+    ///
+    /// Comparison results are widened to i32 lanes, matching how scalar
+    /// Booleans are stored.
+    fn generate_vector_binary_op(
+        &self,
+        op: mir::BinOp,
+        left: VectorValue<'ctx>,
+        right: VectorValue<'ctx>,
+        builder: &Builder<'ctx>
+    ) -> Result<BasicValueEnum<'ctx>, SemanticError> {
+        let is_float = left.get_type().get_element_type().is_float_type();
+        let codegen_error = |e: inkwell::builder::BuilderError| SemanticError::CodeGenError { message: e.to_string() };
+        
+        let comparison = match op {
+            mir::BinOp::Eq => Some((inkwell::FloatPredicate::OEQ, inkwell::IntPredicate::EQ)),
+            mir::BinOp::Ne => Some((inkwell::FloatPredicate::ONE, inkwell::IntPredicate::NE)),
+            mir::BinOp::Lt => Some((inkwell::FloatPredicate::OLT, inkwell::IntPredicate::SLT)),
+            mir::BinOp::Le => Some((inkwell::FloatPredicate::OLE, inkwell::IntPredicate::SLE)),
+            mir::BinOp::Gt => Some((inkwell::FloatPredicate::OGT, inkwell::IntPredicate::SGT)),
+            mir::BinOp::Ge => Some((inkwell::FloatPredicate::OGE, inkwell::IntPredicate::SGE)),
+            _ => None,
+        };
+        if let Some((float_predicate, int_predicate)) = comparison {
+            let mask = if is_float {
+                builder.build_float_compare(float_predicate, left, right, "vfcmp").map_err(codegen_error)?
+            } else {
+                builder.build_int_compare(int_predicate, left, right, "vcmp").map_err(codegen_error)?
+            };
+            let mask_type = self.context.i32_type().vec_type(left.get_type().get_size());
+            return builder.build_int_z_extend(mask, mask_type, "vcmp_ext")
+                .map(|v| v.into())
+                .map_err(codegen_error);
+        }
+        
+        let result = match (op, is_float) {
+            (mir::BinOp::Add, true) => builder.build_float_add(left, right, "vfadd"),
+            (mir::BinOp::Sub, true) => builder.build_float_sub(left, right, "vfsub"),
+            (mir::BinOp::Mul, true) => builder.build_float_mul(left, right, "vfmul"),
+            (mir::BinOp::Div, true) => builder.build_float_div(left, right, "vfdiv"),
+            (mir::BinOp::Rem, true) => builder.build_float_rem(left, right, "vfrem"),
+            (mir::BinOp::Add, false) => builder.build_int_add(left, right, "vadd"),
+            (mir::BinOp::Sub, false) => builder.build_int_sub(left, right, "vsub"),
+            (mir::BinOp::Mul, false) => builder.build_int_mul(left, right, "vmul"),
+            (mir::BinOp::Div, false) => builder.build_int_signed_div(left, right, "vdiv"),
+            (mir::BinOp::Rem, false) => builder.build_int_signed_rem(left, right, "vrem"),
+            (mir::BinOp::BitAnd, false) => builder.build_and(left, right, "vand"),
+            (mir::BinOp::BitOr, false) => builder.build_or(left, right, "vor"),
+            (mir::BinOp::BitXor, false) => builder.build_xor(left, right, "vxor"),
+            _ => return Err(SemanticError::CodeGenError {
+                message: format!("Unsupported vector operation: {:?}", op)
+            }),
+        };
+        result.map(|v| v.into()).map_err(codegen_error)
+    }
+    
+    /// A zeroed runtime-layout array of `length` elements in the frame
+    ///
+    /// The slot is reserved in the entry block, so it is allocated once per
+    /// call whichever block creates the array.
+    fn build_stack_array(&self, length: u64, builder: &Builder<'ctx>) -> Result<BasicValueEnum<'ctx>, SemanticError> {
+        let codegen_error = |e: inkwell::builder::BuilderError| SemanticError::CodeGenError { message: e.to_string() };
+        let entry = builder.get_insert_block()
+            .and_then(|block| block.get_parent())
+            .and_then(|function| function.get_first_basic_block())
+            .ok_or_else(|| SemanticError::CodeGenError { message: "Stack array outside a function".to_string() })?;
+        let entry_builder = self.context.create_builder();
+        match entry.get_first_instruction() {
+            Some(first) => entry_builder.position_before(&first),
+            None => entry_builder.position_at_end(entry),
+        }
+        
+        let i32_type = self.context.i32_type();
+        let array_type = i32_type.array_type(length as u32 + 1);
+        let slot = entry_builder.build_alloca(array_type, "stack_array").map_err(codegen_error)?;
+        builder.build_store(slot, array_type.const_zero()).map_err(codegen_error)?;
+        builder.build_store(slot, i32_type.const_int(length, false)).map_err(codegen_error)?;
+        Ok(slot.into())
+    }
+    
+    /// Address of element `index` of a runtime array
+    ///
+    /// Arrays are an i32 length followed by the i32 elements, matching
+    /// `array_create` in the runtime.
+    fn array_element_pointer(
+        &mut self,
+        array: &mir::Operand,
+        index: &mir::Operand,
+        local_allocas: &HashMap<mir::LocalId, PointerValue<'ctx>>,
+        builder: &Builder<'ctx>,
+        function: &mir::Function
+    ) -> Result<PointerValue<'ctx>, SemanticError> {
+        let base = match self.generate_operand(array, local_allocas, builder, function)? {
+            BasicValueEnum::PointerValue(ptr) => ptr,
+            _ => return Err(SemanticError::CodeGenError {
+                message: "Array element access on a non-pointer value".to_string()
+            }),
+        };
+        let index = match self.generate_operand(index, local_allocas, builder, function)? {
+            BasicValueEnum::IntValue(v) => v,
+            _ => return Err(SemanticError::CodeGenError {
+                message: "Array index is not an integer".to_string()
+            }),
+        };
+        
+        let i32_type = self.context.i32_type();
+        let index = builder.build_int_s_extend_or_bit_cast(index, self.context.i64_type(), "elem_index")
+            .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+        let slot = builder.build_int_add(index, self.context.i64_type().const_int(1, false), "elem_slot")
+            .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })?;
+        unsafe { builder.build_in_bounds_gep(i32_type, base, &[slot], "elem_ptr") }
+            .map_err(|e| SemanticError::CodeGenError { message: e.to_string() })
+    }
+    
     /// Generate code for an operand
     fn generate_operand(
         &mut self,
@@ -1682,7 +2147,7 @@ impl<'ctx> LLVMBackend<'ctx> {
                             }
                             mir::PlaceElem::Field { field, ty } => {
                                 // Calculate field offset based on the containing type
-                                let field_offset = if let Some(local_def) = function.locals.get(&place.local) {
+                                let field_offset = if let Some(local_def) = function.locals.get(place.local) {
                                     if let crate::types::Type::Named { name, .. } = &local_def.ty {
                                         // Look up type definition
                                         if let Some(type_def) = self.type_definitions.get(name) {
@@ -1769,7 +2234,7 @@ impl<'ctx> LLVMBackend<'ctx> {
                     // Load the value from the final pointer
                     let local_type = if place.projection.is_empty() {
                         // No projections, get the type of the local
-                        function.locals.get(&place.local)
+                        function.locals.get(place.local)
                             .map(|local| self.get_basic_type(&local.ty))
                             .or_else(|| {
                                 // Check if it's a parameter
@@ -1922,6 +2387,24 @@ impl<'ctx> LLVMBackend<'ctx> {
             .map_err(|e| e.to_string())
     }
     
+    /// Write LLVM bitcode for link-time optimization
+    pub fn write_bitcode_file<P: AsRef<Path>>(&self, path: P) -> Result<(), String> {
+        if self.module.write_bitcode_to_path(path.as_ref()) {
+            Ok(())
+        } else {
+            Err(format!("Failed to write bitcode to {}", path.as_ref().display()))
+        }
+    }
+    
+    /// Write the file handed to the linker: bitcode under LTO, machine code otherwise
+    pub fn write_link_input<P: AsRef<Path>>(&self, path: P) -> Result<(), String> {
+        if self.target_options.lto {
+            self.write_bitcode_file(path)
+        } else {
+            self.write_object_file(path)
+        }
+    }
+    
     /// Write assembly file
     pub fn write_assembly_file<P: AsRef<Path>>(&self, path: P) -> Result<(), String> {
         let target_machine = self.target_machine.as_ref()
@@ -2280,7 +2763,44 @@ impl<'ctx> LLVMBackend<'ctx> {
         let allocation_count_type = i32_type.fn_type(&[], false);
         let allocation_count_fn = self.module.add_function("aether_allocation_count", allocation_count_type, None);
         function_declarations.insert("aether_allocation_count".to_string(), allocation_count_fn);
-        
+
+        // Profile counters inserted by --profile-generate
+        // aether_profile_init(char* counter_names) -> void
+        let profile_init_type = void_type.fn_type(&[i8_ptr_type.into()], false);
+        let profile_init_fn = self.module.add_function("aether_profile_init", profile_init_type, None);
+        function_declarations.insert("aether_profile_init".to_string(), profile_init_fn);
+
+        // aether_profile_count(int counter) -> void
+        let profile_count_type = void_type.fn_type(&[i32_type.into()], false);
+        let profile_count_fn = self.module.add_function("aether_profile_count", profile_count_type, None);
+        function_declarations.insert("aether_profile_count".to_string(), profile_count_fn);
+
+        // Contract checks emitted by --contract-checks
+        // aether_contract_init(char* contract_names) -> void
+        let contract_init_type = void_type.fn_type(&[i8_ptr_type.into()], false);
+        let contract_init_fn = self.module.add_function("aether_contract_init", contract_init_type, None);
+        function_declarations.insert("aether_contract_init".to_string(), contract_init_fn);
+
+        // aether_contract_sample(int contract, int one_in) -> int
+        let contract_sample_type = i32_type.fn_type(&[i32_type.into(), i32_type.into()], false);
+        let contract_sample_fn = self.module.add_function("aether_contract_sample", contract_sample_type, None);
+        function_declarations.insert("aether_contract_sample".to_string(), contract_sample_fn);
+
+        // aether_contract_begin() -> int
+        let contract_begin_type = i32_type.fn_type(&[], false);
+        let contract_begin_fn = self.module.add_function("aether_contract_begin", contract_begin_type, None);
+        function_declarations.insert("aether_contract_begin".to_string(), contract_begin_fn);
+
+        // aether_contract_end(int contract, int start) -> void
+        let contract_end_type = void_type.fn_type(&[i32_type.into(), i32_type.into()], false);
+        let contract_end_fn = self.module.add_function("aether_contract_end", contract_end_type, None);
+        function_declarations.insert("aether_contract_end".to_string(), contract_end_fn);
+
+        // aether_contract_fail(char* message, int fatal) -> void
+        let contract_fail_type = void_type.fn_type(&[i8_ptr_type.into(), i32_type.into()], false);
+        let contract_fail_fn = self.module.add_function("aether_contract_fail", contract_fail_type, None);
+        function_declarations.insert("aether_contract_fail".to_string(), contract_fail_fn);
+
         // HTTP and networking function aliases
         // tcp_server(char* host, int port) -> int
         let tcp_server_type = i32_type.fn_type(&[i8_ptr_type.into(), i32_type.into()], false);
@@ -2445,6 +2965,183 @@ impl TargetArch {
     }
 }
 
+/// Optimization level for the LLVM pass pipeline and code generator
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum OptLevel {
+    O0,
+    O1,
+    O2,
+    O3,
+    /// Optimize for size
+    Os,
+    /// Optimize aggressively for size
+    Oz,
+}
+
+impl OptLevel {
+    /// Build from a speed level (0-3) and a size level (0 none, 1 `s`, 2 `z`)
+    pub fn from_levels(optimization_level: u8, size_level: u8) -> Self {
+        match (optimization_level, size_level) {
+            (0, _) => OptLevel::O0,
+            (_, 1) => OptLevel::Os,
+            (_, s) if s >= 2 => OptLevel::Oz,
+            (1, _) => OptLevel::O1,
+            (2, _) => OptLevel::O2,
+            _ => OptLevel::O3,
+        }
+    }
+    
+    /// Speed level (0-3); size levels optimize like O2
+    pub fn speed_level(&self) -> u8 {
+        match self {
+            OptLevel::O0 => 0,
+            OptLevel::O1 => 1,
+            OptLevel::O2 | OptLevel::Os | OptLevel::Oz => 2,
+            OptLevel::O3 => 3,
+        }
+    }
+    
+    /// Size level (0 none, 1 `s`, 2 `z`)
+    pub fn size_level(&self) -> u8 {
+        match self {
+            OptLevel::Os => 1,
+            OptLevel::Oz => 2,
+            _ => 0,
+        }
+    }
+    
+    /// Whether this level trades speed for code size
+    pub fn is_size_level(&self) -> bool {
+        self.size_level() > 0
+    }
+    
+    /// New pass manager pipeline description
+    pub fn pass_pipeline(&self) -> &'static str {
+        match self {
+            OptLevel::O0 => "default<O0>",
+            OptLevel::O1 => "default<O1>",
+            OptLevel::O2 => "default<O2>",
+            OptLevel::O3 => "default<O3>",
+            OptLevel::Os => "default<Os>",
+            OptLevel::Oz => "default<Oz>",
+        }
+    }
+    
+    /// Pipeline run before emitting bitcode for ThinLTO
+    ///
+    /// The linker runs the remaining optimizations once runtime code is visible.
+    pub fn lto_pre_link_pipeline(&self) -> &'static str {
+        match self {
+            OptLevel::O0 => "thinlto-pre-link<O0>",
+            OptLevel::O1 => "thinlto-pre-link<O1>",
+            OptLevel::O2 => "thinlto-pre-link<O2>",
+            OptLevel::O3 => "thinlto-pre-link<O3>",
+            OptLevel::Os => "thinlto-pre-link<Os>",
+            OptLevel::Oz => "thinlto-pre-link<Oz>",
+        }
+    }
+    
+    /// Code generator level used by the target machine
+    pub fn codegen_level(&self) -> OptimizationLevel {
+        match self {
+            OptLevel::O0 => OptimizationLevel::None,
+            OptLevel::O1 => OptimizationLevel::Less,
+            OptLevel::O2 | OptLevel::Os | OptLevel::Oz => OptimizationLevel::Default,
+            OptLevel::O3 => OptimizationLevel::Aggressive,
+        }
+    }
+    
+    /// Loop and SLP vectorization run from O2 on, but not when optimizing for size
+    fn vectorizes(&self) -> bool {
+        matches!(self, OptLevel::O2 | OptLevel::O3)
+    }
+    
+    /// Loop unrolling is skipped at O0 and Oz
+    fn unrolls_loops(&self) -> bool {
+        !matches!(self, OptLevel::O0 | OptLevel::Oz)
+    }
+}
+
+impl Default for OptLevel {
+    fn default() -> Self {
+        OptLevel::O2
+    }
+}
+
+impl std::str::FromStr for OptLevel {
+    type Err = String;
+    
+    fn from_str(s: &str) -> Result<Self, Self::Err> {
+        match s {
+            "0" => Ok(OptLevel::O0),
+            "1" => Ok(OptLevel::O1),
+            "2" => Ok(OptLevel::O2),
+            "3" => Ok(OptLevel::O3),
+            "s" => Ok(OptLevel::Os),
+            "z" => Ok(OptLevel::Oz),
+            _ => Err(format!("invalid optimization level '{}' (expected 0, 1, 2, 3, s or z)", s)),
+        }
+    }
+}
+
+impl std::fmt::Display for OptLevel {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let level = match self {
+            OptLevel::O0 => "0",
+            OptLevel::O1 => "1",
+            OptLevel::O2 => "2",
+            OptLevel::O3 => "3",
+            OptLevel::Os => "s",
+            OptLevel::Oz => "z",
+        };
+        write!(f, "O{}", level)
+    }
+}
+
+/// Target machine configuration
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct TargetOptions {
+    pub opt_level: OptLevel,
+    /// CPU name; `native` selects the host CPU and its features
+    pub cpu: String,
+    /// Comma separated feature list such as `+avx2,-sse4a`
+    pub features: String,
+    /// Emit bitcode for ThinLTO with the runtime instead of object code
+    pub lto: bool,
+}
+
+impl TargetOptions {
+    /// CPU name and feature string passed to LLVM
+    ///
+    /// Explicit features are appended after the host features so they win.
+    pub fn resolve_cpu(&self) -> (String, String) {
+        if self.cpu != "native" {
+            return (self.cpu.clone(), self.features.clone());
+        }
+        
+        let cpu = TargetMachine::get_host_cpu_name().to_string();
+        let mut features = TargetMachine::get_host_cpu_features().to_string();
+        if !self.features.is_empty() {
+            if !features.is_empty() {
+                features.push(',');
+            }
+            features.push_str(&self.features);
+        }
+        (cpu, features)
+    }
+}
+
+impl Default for TargetOptions {
+    fn default() -> Self {
+        Self {
+            opt_level: OptLevel::default(),
+            cpu: "generic".to_string(),
+            features: String::new(),
+            lto: false,
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -2501,4 +3198,46 @@ mod tests {
         
         assert!(result.is_ok());
     }
+    
+    #[test]
+    fn test_opt_level_mapping() {
+        assert_eq!(OptLevel::from_levels(0, 2), OptLevel::O0);
+        assert_eq!(OptLevel::from_levels(2, 1), OptLevel::Os);
+        assert_eq!(OptLevel::from_levels(2, 2), OptLevel::Oz);
+        assert_eq!(OptLevel::from_levels(3, 0), OptLevel::O3);
+        assert_eq!("z".parse::<OptLevel>().unwrap(), OptLevel::Oz);
+        assert!("4".parse::<OptLevel>().is_err());
+        
+        for level in [OptLevel::O0, OptLevel::O1, OptLevel::O2, OptLevel::O3, OptLevel::Os, OptLevel::Oz] {
+            assert_eq!(OptLevel::from_levels(level.speed_level(), level.size_level()), level);
+        }
+        assert_eq!(OptLevel::O3.codegen_level(), OptimizationLevel::Aggressive);
+        assert_eq!(OptLevel::Os.pass_pipeline(), "default<Os>");
+    }
+    
+    #[test]
+    fn test_pass_pipeline_at_each_level() {
+        LLVMBackend::initialize_targets();
+        
+        for level in [OptLevel::O0, OptLevel::O1, OptLevel::O2, OptLevel::O3, OptLevel::Os, OptLevel::Oz] {
+            let context = Context::create();
+            let mut backend = LLVMBackend::new(&context, "opt_test");
+            let options = TargetOptions {
+                opt_level: level,
+                cpu: "native".to_string(),
+                lto: level == OptLevel::O2,
+                ..TargetOptions::default()
+            };
+            backend.configure_target(TargetArch::native().target_triple(), options).unwrap();
+            
+            let program = Program {
+                functions: HashMap::new(),
+                global_constants: HashMap::new(),
+                external_functions: HashMap::new(),
+                type_definitions: HashMap::new(),
+            };
+            backend.generate_ir(&program).unwrap();
+            assert!(backend.run_optimization_passes().is_ok(), "{} failed", level);
+        }
+    }
 }
\ No newline at end of file
@@ -14,7 +14,7 @@
 
 //! Type conversion between MIR types and LLVM types
 
-use crate::types::Type;
+use crate::types::{Type, TypeId, TypeTable};
 use crate::ast::PrimitiveType;
 use crate::error::SemanticError;
 use inkwell::context::Context;
@@ -26,6 +26,9 @@ use std::collections::HashMap;
 pub struct TypeConverter<'ctx> {
     context: &'ctx Context,
     type_cache: HashMap<String, BasicTypeEnum<'ctx>>,
+    /// Interned MIR types, so each structural type is lowered once
+    type_table: TypeTable,
+    lowered: HashMap<TypeId, BasicTypeEnum<'ctx>>,
 }
 
 impl<'ctx> TypeConverter<'ctx> {
@@ -34,11 +37,31 @@ impl<'ctx> TypeConverter<'ctx> {
         Self {
             context,
             type_cache: HashMap::new(),
+            type_table: TypeTable::new(),
+            lowered: HashMap::new(),
         }
     }
     
     /// Convert a MIR type to an LLVM type
     pub fn convert_type(&mut self, mir_type: &Type) -> Result<BasicTypeEnum<'ctx>, SemanticError> {
+        if let Type::Primitive(prim_type) = mir_type {
+            return self.convert_primitive_type(*prim_type);
+        }
+        let id = self.type_table.intern(mir_type);
+        self.convert_type_id(id, mir_type)
+    }
+    
+    /// Convert an interned type, reusing the LLVM type lowered for its `TypeId`
+    pub fn convert_type_id(&mut self, id: TypeId, mir_type: &Type) -> Result<BasicTypeEnum<'ctx>, SemanticError> {
+        if let Some(cached_type) = self.lowered.get(&id) {
+            return Ok(*cached_type);
+        }
+        let llvm_type = self.lower_type(mir_type)?;
+        self.lowered.insert(id, llvm_type);
+        Ok(llvm_type)
+    }
+    
+    fn lower_type(&mut self, mir_type: &Type) -> Result<BasicTypeEnum<'ctx>, SemanticError> {
         match mir_type {
             Type::Primitive(prim_type) => self.convert_primitive_type(*prim_type),
             
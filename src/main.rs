@@ -17,7 +17,9 @@
 //! Command-line interface for the AetherScript compiler
 
 use aether::Compiler;
+use aether::contracts::ContractCheckMode;
 use aether::pipeline::CompileOptions;
+use aether::llvm_backend::OptLevel;
 use clap::{Parser, Subcommand};
 use std::path::PathBuf;
 use std::process;
@@ -82,6 +84,8 @@ fn format_type(type_spec: &aether::ast::TypeSpecifier) -> String {
             format!("Array<{}>", format_type(element_type)),
         aether::ast::TypeSpecifier::Map { key_type, value_type, .. } => 
             format!("Map<{}, {}>", format_type(key_type), format_type(value_type)),
+        aether::ast::TypeSpecifier::Vector { element_type, lanes, .. } => 
+            format!("Vector<{}, {}>", format_type(element_type), lanes),
         aether::ast::TypeSpecifier::Pointer { target_type, is_mutable, .. } => 
             format!("{}{}", if *is_mutable { "*mut " } else { "*" }, format_type(target_type)),
         aether::ast::TypeSpecifier::Function { parameter_types, return_type, .. } => {
@@ -133,9 +137,21 @@ enum Commands {
         #[arg(short, long)]
         output: Option<PathBuf>,
         
-        /// Optimization level (0-3)
+        /// Optimization level (0-3, s or z)
         #[arg(short = 'O', long, default_value = "2")]
-        optimization: u8,
+        optimization: OptLevel,
+        
+        /// Target CPU (e.g., skylake, or native for the host CPU)
+        #[arg(long)]
+        target_cpu: Option<String>,
+        
+        /// Target features (e.g., +avx2,+fma)
+        #[arg(long)]
+        target_features: Option<String>,
+        
+        /// ThinLTO with the runtime (requires clang, lld and the LTO runtime build)
+        #[arg(long)]
+        lto: bool,
         
         /// Generate debug information
         #[arg(short, long)]
@@ -164,6 +180,38 @@ enum Commands {
         /// Link with library
         #[arg(short = 'l', long = "link")]
         link_libraries: Vec<String>,
+        
+        /// Number of codegen units compiled in parallel
+        #[arg(short = 'j', long = "jobs", default_value = "1")]
+        jobs: usize,
+        
+        /// Reuse unchanged work from previous compilations
+        #[arg(long)]
+        incremental: bool,
+        
+        /// Incremental cache directory (defaults to target/aether-cache)
+        #[arg(long, requires = "incremental")]
+        cache_dir: Option<PathBuf>,
+        
+        /// Instrument the program to write an execution profile when it exits
+        #[arg(long, conflicts_with = "profile_use")]
+        profile_generate: bool,
+        
+        /// Optimize using a profile from an instrumented build
+        #[arg(long)]
+        profile_use: Option<PathBuf>,
+        
+        /// Runtime contract checks: off, debug, full or sampled[:N]
+        #[arg(long, default_value = "debug")]
+        contract_checks: ContractCheckMode,
+        
+        /// Print the time each optimization pass took and how often it ran
+        #[arg(long)]
+        time_passes: bool,
+        
+        /// Write optimization remarks to FILE (JSON if it ends in .json, YAML otherwise)
+        #[arg(long, value_name = "FILE")]
+        opt_remarks: Option<PathBuf>,
     },
     
     /// Check syntax without generating code
@@ -221,6 +269,26 @@ enum Commands {
         #[arg(short, long)]
         verbose: bool,
     },
+    
+    /// Work with profiles written by `--profile-generate` builds
+    Profdata {
+        #[command(subcommand)]
+        action: ProfdataAction,
+    },
+}
+
+#[derive(Subcommand)]
+enum ProfdataAction {
+    /// Combine the profiles of several runs into one
+    Merge {
+        /// Raw or merged profiles
+        #[arg(required = true)]
+        input: Vec<PathBuf>,
+        
+        /// Merged profile to write
+        #[arg(short, long)]
+        output: PathBuf,
+    },
 }
 
 fn main() {
@@ -231,6 +299,9 @@ fn main() {
             input, 
             output, 
             optimization, 
+            target_cpu,
+            target_features,
+            lto,
             debug, 
             verbose,
             keep_intermediates,
@@ -238,9 +309,21 @@ fn main() {
             library,
             library_paths,
             link_libraries,
+            jobs,
+            incremental,
+            cache_dir,
+            profile_generate,
+            profile_use,
+            contract_checks,
+            time_passes,
+            opt_remarks,
         }) => {
             let mut options = CompileOptions::default();
-            options.optimization_level = optimization.min(3);
+            options.optimization_level = optimization.speed_level();
+            options.size_level = optimization.size_level();
+            options.target_cpu = target_cpu;
+            options.target_features = target_features;
+            options.lto = lto;
             options.debug_info = debug;
             options.verbose = verbose;
             options.keep_intermediates = keep_intermediates;
@@ -248,6 +331,14 @@ fn main() {
             options.compile_as_library = library;
             options.library_paths = library_paths;
             options.link_libraries = link_libraries;
+            options.codegen_units = jobs.max(1);
+            options.incremental = incremental;
+            options.cache_dir = cache_dir;
+            options.profile_generate = profile_generate;
+            options.profile_use = profile_use;
+            options.contract_checks = contract_checks;
+            options.time_passes = time_passes;
+            options.opt_remarks = opt_remarks;
             
             if let Some(output_path) = output {
                 options.output = Some(output_path);
@@ -257,7 +348,13 @@ fn main() {
             match compiler.compile_files(&input) {
                 Ok(result) => {
                     println!("Compilation completed successfully");
+                    if let Some(cache_stats) = &result.stats.cache {
+                        println!("{}", cache_stats);
+                    }
                     if verbose || cli.verbose {
+                        for (name, count) in &result.stats.optimizations {
+                            println!("  {}: {}", name, count);
+                        }
                         println!("Output: {}", result.executable_path.display());
                     }
                     Ok(result)
@@ -514,6 +611,22 @@ fn main() {
             })
         }
         
+        Some(Commands::Profdata { action: ProfdataAction::Merge { input, output } }) => {
+            use aether::optimizations::profile_guided::ProfileGuidedOptimizationPass;
+            
+            // Loading several profiles into one pass adds their counts up
+            let mut profile = ProfileGuidedOptimizationPass::new();
+            input.iter()
+                .try_for_each(|path| profile.load_profile_data(path))
+                .and_then(|_| profile.save_profile_data(&output))
+                .map(|_| aether::pipeline::CompilationResult {
+                    executable_path: output,
+                    intermediate_files: vec![],
+                    stats: Default::default(),
+                })
+                .map_err(aether::error::CompilerError::SemanticError)
+        }
+        
         None => {
             // No subcommand provided - print error and help
             eprintln!("Error: No subcommand provided");
@@ -0,0 +1,264 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Dense storage for MIR entities addressed by integer IDs
+//!
+//! Blocks and locals are numbered from zero as they are created, so they live
+//! in a vector slot at their ID. Removing an entry leaves a vacant slot and
+//! keeps every other ID stable; `compact` closes the gaps and reports how IDs
+//! moved so references can be rewritten.
+
+use std::fmt;
+use std::ops::{Index, IndexMut};
+
+/// A vector of optional slots indexed by `u32` IDs
+#[derive(Clone, PartialEq)]
+pub struct IndexVec<T> {
+    slots: Vec<Option<T>>,
+    len: usize,
+}
+
+impl<T> Default for IndexVec<T> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl<T> IndexVec<T> {
+    pub fn new() -> Self {
+        Self { slots: Vec::new(), len: 0 }
+    }
+
+    pub fn with_capacity(capacity: usize) -> Self {
+        Self { slots: Vec::with_capacity(capacity), len: 0 }
+    }
+
+    /// Append a value at the next unused ID and return that ID
+    pub fn push(&mut self, value: T) -> u32 {
+        let id = self.slots.len() as u32;
+        self.slots.push(Some(value));
+        self.len += 1;
+        id
+    }
+
+    /// Store a value at `id`, growing the vector if needed
+    pub fn insert(&mut self, id: u32, value: T) -> Option<T> {
+        let index = id as usize;
+        if index >= self.slots.len() {
+            self.slots.resize_with(index + 1, || None);
+        }
+        let previous = self.slots[index].replace(value);
+        if previous.is_none() {
+            self.len += 1;
+        }
+        previous
+    }
+
+    /// Vacate the slot at `id`; other IDs are unaffected
+    pub fn remove(&mut self, id: u32) -> Option<T> {
+        let removed = self.slots.get_mut(id as usize).and_then(Option::take);
+        if removed.is_some() {
+            self.len -= 1;
+        }
+        removed
+    }
+
+    pub fn get(&self, id: u32) -> Option<&T> {
+        self.slots.get(id as usize).and_then(Option::as_ref)
+    }
+
+    pub fn get_mut(&mut self, id: u32) -> Option<&mut T> {
+        self.slots.get_mut(id as usize).and_then(Option::as_mut)
+    }
+
+    pub fn contains(&self, id: u32) -> bool {
+        self.get(id).is_some()
+    }
+
+    /// Number of occupied slots
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// One past the largest ID ever stored; sizes side tables indexed by ID
+    pub fn id_bound(&self) -> usize {
+        self.slots.len()
+    }
+
+    /// Whether some IDs below `id_bound` are vacant
+    pub fn has_gaps(&self) -> bool {
+        self.len != self.slots.len()
+    }
+
+    pub fn clear(&mut self) {
+        self.slots.clear();
+        self.len = 0;
+    }
+
+    /// Occupied IDs in ascending order
+    pub fn ids(&self) -> impl Iterator<Item = u32> + '_ {
+        self.iter().map(|(id, _)| id)
+    }
+
+    pub fn values(&self) -> impl Iterator<Item = &T> + '_ {
+        self.slots.iter().flatten()
+    }
+
+    pub fn values_mut(&mut self) -> impl Iterator<Item = &mut T> + '_ {
+        self.slots.iter_mut().flatten()
+    }
+
+    /// Occupied entries in ascending ID order
+    pub fn iter(&self) -> Iter<'_, T> {
+        Iter { slots: self.slots.iter().enumerate() }
+    }
+
+    pub fn iter_mut(&mut self) -> IterMut<'_, T> {
+        IterMut { slots: self.slots.iter_mut().enumerate() }
+    }
+
+    /// Keep only the entries for which `keep` returns true
+    pub fn retain(&mut self, mut keep: impl FnMut(u32, &mut T) -> bool) {
+        for (index, slot) in self.slots.iter_mut().enumerate() {
+            if let Some(value) = slot {
+                if !keep(index as u32, value) {
+                    *slot = None;
+                    self.len -= 1;
+                }
+            }
+        }
+    }
+
+    /// Close the gaps left by removals, keeping entries in ID order
+    ///
+    /// Returns a table from each old ID to its new ID (`None` for vacant
+    /// slots).
+    pub fn compact(&mut self) -> Vec<Option<u32>> {
+        let mut remap = Vec::with_capacity(self.slots.len());
+        let mut next = 0u32;
+        for slot in &self.slots {
+            if slot.is_some() {
+                remap.push(Some(next));
+                next += 1;
+            } else {
+                remap.push(None);
+            }
+        }
+        self.slots.retain(Option::is_some);
+        remap
+    }
+}
+
+/// Iterator over the occupied entries of an `IndexVec`
+pub struct Iter<'a, T> {
+    slots: std::iter::Enumerate<std::slice::Iter<'a, Option<T>>>,
+}
+
+impl<'a, T> Iterator for Iter<'a, T> {
+    type Item = (u32, &'a T);
+
+    fn next(&mut self) -> Option<Self::Item> {
+        self.slots.find_map(|(index, slot)| slot.as_ref().map(|value| (index as u32, value)))
+    }
+}
+
+/// Mutable iterator over the occupied entries of an `IndexVec`
+pub struct IterMut<'a, T> {
+    slots: std::iter::Enumerate<std::slice::IterMut<'a, Option<T>>>,
+}
+
+impl<'a, T> Iterator for IterMut<'a, T> {
+    type Item = (u32, &'a mut T);
+
+    fn next(&mut self) -> Option<Self::Item> {
+        self.slots.find_map(|(index, slot)| slot.as_mut().map(|value| (index as u32, value)))
+    }
+}
+
+impl<'a, T> IntoIterator for &'a IndexVec<T> {
+    type Item = (u32, &'a T);
+    type IntoIter = Iter<'a, T>;
+
+    fn into_iter(self) -> Self::IntoIter {
+        self.iter()
+    }
+}
+
+impl<'a, T> IntoIterator for &'a mut IndexVec<T> {
+    type Item = (u32, &'a mut T);
+    type IntoIter = IterMut<'a, T>;
+
+    fn into_iter(self) -> Self::IntoIter {
+        self.iter_mut()
+    }
+}
+
+impl<T> Index<u32> for IndexVec<T> {
+    type Output = T;
+
+    fn index(&self, id: u32) -> &T {
+        self.get(id).unwrap_or_else(|| panic!("no entry for ID {}", id))
+    }
+}
+
+impl<T> IndexMut<u32> for IndexVec<T> {
+    fn index_mut(&mut self, id: u32) -> &mut T {
+        self.get_mut(id).unwrap_or_else(|| panic!("no entry for ID {}", id))
+    }
+}
+
+impl<T> FromIterator<(u32, T)> for IndexVec<T> {
+    fn from_iter<I: IntoIterator<Item = (u32, T)>>(iter: I) -> Self {
+        let mut vec = Self::new();
+        for (id, value) in iter {
+            vec.insert(id, value);
+        }
+        vec
+    }
+}
+
+impl<T: fmt::Debug> fmt::Debug for IndexVec<T> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_map().entries(self.iter()).finish()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_remove_keeps_ids_stable_until_compaction() {
+        let mut vec: IndexVec<&str> = IndexVec::new();
+        let a = vec.push("a");
+        let b = vec.push("b");
+        let c = vec.push("c");
+
+        assert_eq!(vec.remove(b), Some("b"));
+        assert_eq!(vec.len(), 2);
+        assert_eq!(vec[c], "c");
+        assert!(vec.has_gaps());
+        assert_eq!(vec.ids().collect::<Vec<_>>(), vec![a, c]);
+
+        let remap = vec.compact();
+        assert_eq!(remap, vec![Some(0), None, Some(1)]);
+        assert!(!vec.has_gaps());
+        assert_eq!(vec[1], "c");
+        assert_eq!(vec.push("d"), 2);
+    }
+}
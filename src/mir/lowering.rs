@@ -17,12 +17,16 @@
 //! Converts the high-level AST representation into MIR form
 
 use crate::ast::{self, PrimitiveType};
+use crate::contracts::ContractCheckMode;
 use crate::mir::*;
 use crate::mir::Builder;
 use crate::types::{Type, TypeDefinition};
 use crate::symbols::{SymbolTable, SymbolKind};
 use crate::error::{SemanticError, SourceLocation};
+use rayon::prelude::*;
 use std::collections::HashMap;
+use std::ops::RangeFrom;
+use std::sync::Arc;
 
 /// Loop context for tracking break/continue targets
 #[derive(Debug, Clone)]
@@ -35,6 +39,81 @@ struct LoopContext {
     break_block: BasicBlockId,
 }
 
+/// Program-level declarations visible to forked lowering contexts
+///
+/// Collected before any function body is lowered, so calls and constant
+/// references resolve the same way no matter which order bodies run in.
+#[derive(Debug, Default)]
+struct SharedDeclarations {
+    global_constants: HashMap<String, Constant>,
+    external_functions: HashMap<String, ExternalFunction>,
+    function_return_types: HashMap<String, Type>,
+}
+
+/// Runtime contract checks to emit
+///
+/// Timed checks get their contract ids in source order before any body is
+/// lowered, so the ids and the table handed to `aether_contract_init` do not
+/// depend on the order parallel workers finish in.
+#[derive(Debug, Default)]
+struct ContractChecks {
+    /// Mode of functions without a `CONTRACT_CHECKS` override
+    mode: ContractCheckMode,
+    
+    /// Whether `ContractCheckMode::Debug` checks are emitted
+    debug_build: bool,
+    
+    /// First contract id of each function with timed checks
+    first_ids: HashMap<String, usize>,
+    
+    /// `function::kind_index` of every timed check, indexed by contract id
+    names: Vec<String>,
+}
+
+impl ContractChecks {
+    /// Assign contract ids to the timed checks of `ast_program`
+    fn plan(mode: ContractCheckMode, debug_build: bool, ast_program: &ast::Program) -> Self {
+        let mut checks = Self { mode, debug_build, ..Self::default() };
+        for function in ast_program.modules.iter().flat_map(|module| &module.function_definitions) {
+            if !matches!(checks.mode_for(function), ContractCheckMode::Full | ContractCheckMode::Sampled { .. }) {
+                continue;
+            }
+            checks.first_ids.insert(function.name.name.clone(), checks.names.len());
+            for (kind, assertions) in contract_kinds(&function.metadata) {
+                for index in 1..=assertions.len() {
+                    checks.names.push(format!("{}::{}_{}", function.name.name, kind, index));
+                }
+            }
+        }
+        checks
+    }
+    
+    /// The function's `CONTRACT_CHECKS` override, else the default mode
+    fn mode_for(&self, function: &ast::Function) -> ContractCheckMode {
+        function.metadata.contract_checks.as_deref()
+            .and_then(|mode| mode.parse().ok())
+            .unwrap_or(self.mode)
+    }
+    
+    /// Whether checks in `mode` are emitted at all
+    fn emits(&self, mode: ContractCheckMode) -> bool {
+        match mode {
+            ContractCheckMode::Off => false,
+            ContractCheckMode::Debug => self.debug_build,
+            ContractCheckMode::Full | ContractCheckMode::Sampled { .. } => true,
+        }
+    }
+}
+
+/// A function's contract assertions by kind, in contract id order
+fn contract_kinds(metadata: &ast::FunctionMetadata) -> [(&'static str, &[ast::ContractAssertion]); 3] {
+    [
+        ("precondition", &metadata.preconditions),
+        ("postcondition", &metadata.postconditions),
+        ("invariant", &metadata.invariants),
+    ]
+}
+
 /// AST to MIR lowering context
 pub struct LoweringContext {
     /// MIR builder
@@ -59,7 +138,13 @@ pub struct LoweringContext {
     loop_stack: Vec<LoopContext>,
     
     /// Symbol table from semantic analysis
-    symbol_table: Option<SymbolTable>,
+    symbol_table: Option<Arc<SymbolTable>>,
+    
+    /// Declarations shared with the context this one was forked from
+    shared: Option<Arc<SharedDeclarations>>,
+    
+    /// Runtime contract checks, shared with forked contexts
+    contract_checks: Arc<ContractChecks>,
 }
 
 impl LoweringContext {
@@ -78,22 +163,36 @@ impl LoweringContext {
             return_local: None,
             loop_stack: Vec::new(),
             symbol_table: None,
+            shared: None,
+            contract_checks: Arc::default(),
         }
     }
     
     /// Create a new lowering context with a symbol table
     pub fn with_symbol_table(symbol_table: SymbolTable) -> Self {
         let mut ctx = Self::new();
-        ctx.symbol_table = Some(symbol_table);
+        ctx.symbol_table = Some(Arc::new(symbol_table));
         ctx
     }
     
+    /// Emit runtime contract checks in `mode`; debug-mode checks only in a debug build
+    pub fn set_contract_checks(&mut self, mode: ContractCheckMode, debug_build: bool) {
+        self.contract_checks = Arc::new(ContractChecks { mode, debug_build, ..ContractChecks::default() });
+    }
+    
+    /// Assign contract ids for `ast_program` under the configured mode
+    fn plan_contract_checks(&mut self, ast_program: &ast::Program) {
+        let checks = &self.contract_checks;
+        self.contract_checks = Arc::new(ContractChecks::plan(checks.mode, checks.debug_build, ast_program));
+    }
+    
     /// Lower an AST program to MIR
     pub fn lower_program(&mut self, ast_program: &ast::Program) -> Result<Program, SemanticError> {
         // Copy type definitions from symbol table if available
         if let Some(ref symbol_table) = self.symbol_table {
             self.program.type_definitions = symbol_table.get_type_definitions().clone();
         }
+        self.plan_contract_checks(ast_program);
         
         for module in &ast_program.modules {
             self.lower_module(module)?;
@@ -102,6 +201,89 @@ impl LoweringContext {
         Ok(self.program.clone())
     }
     
+    /// Lower an AST program to MIR, lowering function bodies in parallel
+    ///
+    /// Constants, external functions and function signatures are collected
+    /// sequentially first. Each body is then lowered by a forked context that
+    /// sees those declarations read-only, and the results are inserted in
+    /// source order so the first lowering error reported is deterministic.
+    pub fn lower_program_parallel(&mut self, ast_program: &ast::Program) -> Result<Program, SemanticError> {
+        if let Some(ref symbol_table) = self.symbol_table {
+            self.program.type_definitions = symbol_table.get_type_definitions().clone();
+        }
+        self.plan_contract_checks(ast_program);
+        
+        let mut function_return_types = HashMap::new();
+        for module in &ast_program.modules {
+            self.current_module = Some(module.name.name.clone());
+            for constant in &module.constant_declarations {
+                self.lower_constant(constant)?;
+            }
+            for ext_func in &module.external_functions {
+                self.lower_external_function(ext_func)?;
+            }
+            for function in &module.function_definitions {
+                let return_type = self.ast_type_to_mir_type(&function.return_type)?;
+                function_return_types.insert(function.name.name.clone(), return_type);
+            }
+        }
+        
+        let shared = Arc::new(SharedDeclarations {
+            global_constants: self.program.global_constants.clone(),
+            external_functions: self.program.external_functions.clone(),
+            function_return_types,
+        });
+        let symbol_table = self.symbol_table.clone();
+        let contract_checks = self.contract_checks.clone();
+        
+        let jobs: Vec<(&String, &ast::Function)> = ast_program.modules.iter()
+            .flat_map(|module| module.function_definitions.iter().map(move |function| (&module.name.name, function)))
+            .collect();
+        let lowered: Vec<Result<Function, SemanticError>> = jobs.par_iter()
+            .map(|(module_name, function)| {
+                let mut ctx = Self::new();
+                ctx.current_module = Some((*module_name).clone());
+                ctx.symbol_table = symbol_table.clone();
+                ctx.shared = Some(shared.clone());
+                ctx.contract_checks = contract_checks.clone();
+                ctx.lower_function(function)?;
+                ctx.program.functions.remove(&function.name.name)
+                    .ok_or_else(|| SemanticError::Internal {
+                        message: format!("Lowered function {} missing from its context", function.name.name),
+                    })
+            })
+            .collect();
+        
+        for function in lowered {
+            let function = function?;
+            self.program.functions.insert(function.name.clone(), function);
+        }
+        
+        Ok(self.program.clone())
+    }
+    
+    /// Look up a global constant, including ones shared by a parent context
+    fn lookup_global_constant(&self, name: &str) -> Option<&Constant> {
+        self.program.global_constants.get(name)
+            .or_else(|| self.shared.as_ref().and_then(|shared| shared.global_constants.get(name)))
+    }
+    
+    /// Declared return type of a known function, if it has been seen
+    fn lookup_function_return_type(&self, name: &str) -> Option<Type> {
+        if let Some(ext_func) = self.program.external_functions.get(name)
+            .or_else(|| self.shared.as_ref().and_then(|shared| shared.external_functions.get(name))) {
+            eprintln!("lower_function_call: found external function {} with return type {:?}", name, ext_func.return_type);
+            return Some(ext_func.return_type.clone());
+        }
+        if let Some(func) = self.program.functions.get(name) {
+            eprintln!("lower_function_call: found regular function {} with return type {:?}", name, func.return_type);
+            return Some(func.return_type.clone());
+        }
+        self.shared.as_ref()
+            .and_then(|shared| shared.function_return_types.get(name))
+            .cloned()
+    }
+    
     /// Lower a module
     fn lower_module(&mut self, module: &ast::Module) -> Result<(), SemanticError> {
         self.current_module = Some(module.name.name.clone());
@@ -199,13 +381,33 @@ impl LoweringContext {
             }
         }
         
+        let checks = Arc::clone(&self.contract_checks);
+        if function.name.name == "main" && !checks.names.is_empty() {
+            let table = Operand::Constant(Constant {
+                ty: Type::primitive(PrimitiveType::String),
+                value: ConstantValue::String(checks.names.join("\n")),
+            });
+            self.lower_runtime_call("aether_contract_init", vec![table], Type::primitive(PrimitiveType::Void));
+        }
+        let contract_mode = checks.mode_for(function);
+        let checked = checks.emits(contract_mode);
+        let mut contract_ids = checks.first_ids.get(&function.name.name).map(|&first| first..);
+        
+        // Preconditions run on every call, sampled or not
+        if checked {
+            for (index, precondition) in function.metadata.preconditions.iter().enumerate() {
+                let id = contract_ids.as_mut().and_then(Iterator::next);
+                self.lower_contract_check(&function.name.name, "precondition", index, precondition, id, None)?;
+            }
+        }
+        
         // Lower function body
         self.lower_block(&function.body)?;
         
         // Add implicit return if needed
         if let Some(func) = &self.builder.current_function {
             if let Some(block_id) = self.builder.current_block {
-                if let Some(block) = func.basic_blocks.get(&block_id) {
+                if let Some(block) = func.basic_blocks.get(block_id) {
                     if matches!(block.terminator, Terminator::Unreachable) {
                         self.builder.set_terminator(Terminator::Return);
                     }
@@ -213,6 +415,10 @@ impl LoweringContext {
             }
         }
         
+        if checked {
+            self.lower_exit_checks(function, contract_mode, contract_ids)?;
+        }
+        
         // Finish and add to program
         let mut mir_function = self.builder.finish_function();
         mir_function.return_local = self.return_local;
@@ -221,6 +427,137 @@ impl LoweringContext {
         Ok(())
     }
     
+    /// Check postconditions and invariants on a single exit path
+    ///
+    /// Every return is redirected to one exit block, where `result` names the
+    /// return value. Sampled mode runs each check on one call in `one_in`.
+    fn lower_exit_checks(
+        &mut self,
+        function: &ast::Function,
+        mode: ContractCheckMode,
+        mut contract_ids: Option<RangeFrom<usize>>,
+    ) -> Result<(), SemanticError> {
+        let metadata = &function.metadata;
+        if metadata.postconditions.is_empty() && metadata.invariants.is_empty() {
+            return Ok(());
+        }
+        
+        let exit_block = self.builder.new_block();
+        if let Some(func) = &mut self.builder.current_function {
+            for block in func.basic_blocks.values_mut() {
+                if matches!(block.terminator, Terminator::Return) {
+                    block.terminator = Terminator::Goto { target: exit_block };
+                }
+            }
+            if let Some(return_local) = self.return_local {
+                self.var_map.insert("result".to_string(), return_local);
+                self.var_types.insert("result".to_string(), func.return_type.clone());
+            }
+        }
+        self.builder.switch_to_block(exit_block);
+        
+        let one_in = match mode {
+            ContractCheckMode::Sampled { one_in } => Some(one_in),
+            _ => None,
+        };
+        for (kind, assertions) in contract_kinds(metadata).into_iter().skip(1) {
+            for (index, assertion) in assertions.iter().enumerate() {
+                let id = contract_ids.as_mut().and_then(Iterator::next);
+                self.lower_contract_check(&function.name.name, kind, index, assertion, id, one_in)?;
+            }
+        }
+        self.builder.set_terminator(Terminator::Return);
+        
+        Ok(())
+    }
+    
+    /// Lower one contract check as an `Assert`
+    ///
+    /// With a contract id the check is timed by `aether_contract_begin`/`end`,
+    /// and with a sampling rate it only runs when `aether_contract_sample` says so.
+    fn lower_contract_check(
+        &mut self,
+        function_name: &str,
+        kind: &str,
+        index: usize,
+        assertion: &ast::ContractAssertion,
+        id: Option<usize>,
+        one_in: Option<u32>,
+    ) -> Result<(), SemanticError> {
+        let continue_block = self.builder.new_block();
+        if let (Some(id), Some(one_in)) = (id, one_in) {
+            let sampled = self.lower_runtime_call(
+                "aether_contract_sample",
+                vec![integer_operand(id as i128), integer_operand(one_in as i128)],
+                Type::primitive(PrimitiveType::Boolean),
+            );
+            let check_block = self.builder.new_block();
+            self.builder.set_terminator(Terminator::SwitchInt {
+                discriminant: Operand::Copy(Place { local: sampled, projection: vec![] }),
+                switch_ty: Type::primitive(PrimitiveType::Boolean),
+                targets: SwitchTargets {
+                    values: vec![1],
+                    targets: vec![check_block],
+                    otherwise: continue_block,
+                    weights: vec![],
+                },
+            });
+            self.builder.switch_to_block(check_block);
+        }
+        
+        let start = id.map(|_| {
+            self.lower_runtime_call("aether_contract_begin", vec![], Type::primitive(PrimitiveType::Integer))
+        });
+        let condition = self.lower_expression(&assertion.condition)?;
+        let checked_block = self.builder.new_block();
+        let name = format!("{}::{}_{}", function_name, kind, index + 1);
+        let message = match &assertion.message {
+            Some(message) => format!("{} violated: {}", name, message),
+            None => format!("{} violated", name),
+        };
+        self.builder.set_terminator(Terminator::Assert {
+            condition,
+            expected: true,
+            message: AssertMessage::Contract {
+                name,
+                message,
+                fatal: !matches!(assertion.failure_action, ast::FailureAction::LogWarning),
+            },
+            target: checked_block,
+            cleanup: None,
+        });
+        
+        self.builder.switch_to_block(checked_block);
+        if let (Some(id), Some(start)) = (id, start) {
+            self.lower_runtime_call(
+                "aether_contract_end",
+                vec![integer_operand(id as i128), Operand::Copy(Place { local: start, projection: vec![] })],
+                Type::primitive(PrimitiveType::Void),
+            );
+        }
+        self.builder.set_terminator(Terminator::Goto { target: continue_block });
+        self.builder.switch_to_block(continue_block);
+        
+        Ok(())
+    }
+    
+    /// Call a runtime support function, returning the local holding its result
+    fn lower_runtime_call(&mut self, name: &str, args: Vec<Operand>, return_type: Type) -> LocalId {
+        let result_local = self.builder.new_local(return_type, false);
+        self.builder.push_statement(Statement::Assign {
+            place: Place { local: result_local, projection: vec![] },
+            rvalue: Rvalue::Call {
+                func: Operand::Constant(Constant {
+                    ty: Type::primitive(PrimitiveType::String),
+                    value: ConstantValue::String(name.to_string()),
+                }),
+                args,
+            },
+            source_info: SourceInfo { span: SourceLocation::unknown(), scope: 0 },
+        });
+        result_local
+    }
+    
     /// Lower a block
     fn lower_block(&mut self, block: &ast::Block) -> Result<(), SemanticError> {
         let _scope = self.builder.push_scope();
@@ -302,6 +639,31 @@ impl LoweringContext {
                             },
                         });
                     }
+                    ast::AssignmentTarget::ArrayElement { array, index } => {
+                        // Array element assignments go through array_set
+                        let array_op = self.lower_expression(array)?;
+                        let index_op = self.lower_expression(index)?;
+                        let value_op = self.lower_expression(value)?;
+                        
+                        let result_local = self.builder.new_local(Type::primitive(PrimitiveType::Void), false);
+                        self.builder.push_statement(Statement::Assign {
+                            place: Place {
+                                local: result_local,
+                                projection: vec![],
+                            },
+                            rvalue: Rvalue::Call {
+                                func: Operand::Constant(Constant {
+                                    ty: Type::primitive(PrimitiveType::String),
+                                    value: ConstantValue::String("array_set".to_string()),
+                                }),
+                                args: vec![array_op, index_op, value_op],
+                            },
+                            source_info: SourceInfo {
+                                span: source_location.clone(),
+                                scope: 0,
+                            },
+                        });
+                    }
                     _ => {
                         // For other assignment targets, use the normal path
                         let place = self.lower_assignment_target(target)?;
@@ -431,6 +793,7 @@ impl LoweringContext {
                 values: vec![1], // true = 1
                 targets: vec![then_bb],
                 otherwise: else_bb,
+                weights: vec![],
             },
         });
         
@@ -486,6 +849,7 @@ impl LoweringContext {
                 values: vec![1], // true = 1
                 targets: vec![loop_body],
                 otherwise: loop_end,
+                weights: vec![],
             },
         });
         
@@ -671,6 +1035,7 @@ impl LoweringContext {
                 values: vec![1], // true = 1
                 targets: vec![loop_body],
                 otherwise: loop_end,
+                weights: vec![],
             },
         });
         
@@ -779,7 +1144,7 @@ impl LoweringContext {
                         projection: vec![],
                     }))
                 // Then check global constants
-                } else if let Some(constant) = self.program.global_constants.get(&name.name) {
+                } else if let Some(constant) = self.lookup_global_constant(&name.name) {
                     Ok(Operand::Constant(constant.clone()))
                 } else {
                     Err(SemanticError::UndefinedSymbol {
@@ -829,6 +1194,10 @@ impl LoweringContext {
                 self.lower_binary_op(BinOp::Le, left, right, source_location)
             }
             
+            ast::Expression::GreaterThanOrEqual { left, right, source_location } => {
+                self.lower_binary_op(BinOp::Ge, left, right, source_location)
+            }
+            
             ast::Expression::FunctionCall { call, source_location } => {
                 self.lower_function_call(call, source_location)
             }
@@ -909,6 +1278,16 @@ impl LoweringContext {
                 self.lower_map_access(map, key, source_location)
             }
             
+            ast::Expression::VectorLiteral { .. } |
+            ast::Expression::VectorSplat { .. } |
+            ast::Expression::VectorLoad { .. } |
+            ast::Expression::VectorStore { .. } |
+            ast::Expression::VectorShuffle { .. } |
+            ast::Expression::VectorExtract { .. } |
+            ast::Expression::VectorSelect { .. } => {
+                self.lower_vector_expression(expr)
+            }
+            
             _ => {
                 Err(SemanticError::UnsupportedFeature {
                     feature: "Expression type not yet implemented in MIR lowering".to_string(),
@@ -933,8 +1312,15 @@ impl LoweringContext {
         let left_type = self.infer_operand_type(&left_op)?;
         let right_type = self.infer_operand_type(&right_op)?;
         
+        // Vector operations are lane-wise; comparisons yield one Boolean per lane
+        let vector_lanes = left_type.vector_parts().map(|(_, lanes)| lanes);
+        
         // Determine result type based on operation and operand types
         let result_type = match op {
+            BinOp::Eq | BinOp::Ne | BinOp::Lt | BinOp::Le | BinOp::Gt | BinOp::Ge if vector_lanes.is_some() => {
+                Type::vector(Type::primitive(PrimitiveType::Boolean), vector_lanes.unwrap_or_default())
+            }
+            _ if vector_lanes.is_some() => left_type.clone(),
             BinOp::Add | BinOp::Sub | BinOp::Mul | BinOp::Div | BinOp::Rem | BinOp::Mod => {
                 // Numeric operations - result type follows operand types
                 // If either operand is float, result is float
@@ -1030,14 +1416,9 @@ impl LoweringContext {
         });
         
         // Determine the return type of the function
-        let result_type = if let Some(ext_func) = self.program.external_functions.get(function_name) {
-            // External function - use its declared return type
-            eprintln!("lower_function_call: found external function {} with return type {:?}", function_name, ext_func.return_type);
-            ext_func.return_type.clone()
-        } else if let Some(func) = self.program.functions.get(function_name) {
-            // Regular function - use its declared return type
-            eprintln!("lower_function_call: found regular function {} with return type {:?}", function_name, func.return_type);
-            func.return_type.clone()
+        let result_type = if let Some(return_type) = self.lookup_function_return_type(function_name) {
+            // External or regular function - use its declared return type
+            return_type
         } else if is_builtin {
             // Built-in function - for now assume integer
             eprintln!("lower_function_call: built-in function {}, assuming integer return", function_name);
@@ -1186,6 +1567,10 @@ impl LoweringContext {
                 let value_ty = self.ast_type_to_mir_type(value_type)?;
                 Ok(Type::map(key_ty, value_ty))
             }
+            ast::TypeSpecifier::Vector { element_type, lanes, .. } => {
+                let element_ty = self.ast_type_to_mir_type(element_type)?;
+                Ok(Type::vector(element_ty, *lanes as usize))
+            }
             ast::TypeSpecifier::Owned { base_type, ownership: _, .. } => {
                 // For now, treat owned types as their base type in MIR
                 // The ownership information is already tracked in the semantic layer
@@ -1663,6 +2048,105 @@ impl LoweringContext {
         }))
     }
     
+    /// Lower a SIMD vector expression
+    ///
+    /// Lane types were checked during semantic analysis, so result types
+    /// follow directly from the operands.
+    fn lower_vector_expression(&mut self, expr: &ast::Expression) -> Result<Operand, SemanticError> {
+        let (result_type, rvalue, source_location) = match expr {
+            ast::Expression::VectorLiteral { elements, source_location } => {
+                let mut operands = Vec::with_capacity(elements.len());
+                for element in elements {
+                    operands.push(self.lower_expression(element)?);
+                }
+                let element_type = match operands.first() {
+                    Some(operand) => self.infer_operand_type(operand)?,
+                    None => Type::primitive(PrimitiveType::Integer),
+                };
+                let result_type = Type::vector(element_type.clone(), operands.len());
+                (result_type, Rvalue::Aggregate { kind: AggregateKind::Vector(element_type), operands }, source_location)
+            }
+            ast::Expression::VectorSplat { value, lanes, source_location } => {
+                let operand = self.lower_expression(value)?;
+                let result_type = Type::vector(self.infer_operand_type(&operand)?, *lanes as usize);
+                (result_type, Rvalue::VectorSplat { operand, lanes: *lanes }, source_location)
+            }
+            ast::Expression::VectorLoad { array, index, lanes, source_location } => {
+                let array = self.lower_expression(array)?;
+                let index = self.lower_expression(index)?;
+                let result_type = Type::vector(Type::primitive(PrimitiveType::Integer), *lanes as usize);
+                (result_type, Rvalue::VectorLoad { array, index, lanes: *lanes }, source_location)
+            }
+            ast::Expression::VectorStore { array, index, value, source_location } => {
+                let array = self.lower_expression(array)?;
+                let index = self.lower_expression(index)?;
+                let value = self.lower_expression(value)?;
+                self.builder.push_statement(Statement::VectorStore {
+                    array,
+                    index,
+                    value,
+                    source_info: SourceInfo {
+                        span: source_location.clone(),
+                        scope: 0,
+                    },
+                });
+                return Ok(Operand::Constant(Constant {
+                    ty: Type::primitive(PrimitiveType::Void),
+                    value: ConstantValue::Null,
+                }));
+            }
+            ast::Expression::VectorShuffle { left, right, mask, source_location } => {
+                let left = self.lower_expression(left)?;
+                let right = self.lower_expression(right)?;
+                let element_type = match self.infer_operand_type(&left)? {
+                    Type::Vector { element_type, .. } => *element_type,
+                    other => other,
+                };
+                let result_type = Type::vector(element_type, mask.len());
+                (result_type, Rvalue::VectorShuffle { left, right, mask: mask.clone() }, source_location)
+            }
+            ast::Expression::VectorExtract { vector, lane, source_location } => {
+                let vector = self.lower_expression(vector)?;
+                let lane = self.lower_expression(lane)?;
+                let result_type = match self.infer_operand_type(&vector)? {
+                    Type::Vector { element_type, .. } => *element_type,
+                    other => other,
+                };
+                (result_type, Rvalue::VectorExtract { vector, lane }, source_location)
+            }
+            ast::Expression::VectorSelect { mask, if_true, if_false, source_location } => {
+                let mask = self.lower_expression(mask)?;
+                let if_true = self.lower_expression(if_true)?;
+                let if_false = self.lower_expression(if_false)?;
+                let result_type = self.infer_operand_type(&if_true)?;
+                (result_type, Rvalue::VectorSelect { mask, if_true, if_false }, source_location)
+            }
+            _ => {
+                return Err(SemanticError::Internal {
+                    message: "lower_vector_expression called on a non-vector expression".to_string(),
+                });
+            }
+        };
+        
+        let result_local = self.builder.new_local(result_type, false);
+        self.builder.push_statement(Statement::Assign {
+            place: Place {
+                local: result_local,
+                projection: vec![],
+            },
+            rvalue,
+            source_info: SourceInfo {
+                span: source_location.clone(),
+                scope: 0,
+            },
+        });
+        
+        Ok(Operand::Copy(Place {
+            local: result_local,
+            projection: vec![],
+        }))
+    }
+    
     /// Lower an array length expression
     fn lower_array_length(
         &mut self,
@@ -1791,7 +2275,7 @@ impl LoweringContext {
     fn get_type_of_place(&self, place: &Place) -> Result<Type, SemanticError> {
         // Start with the type of the local
         let local_type = if let Some(func) = &self.builder.current_function {
-            if let Some(local_info) = func.locals.get(&place.local) {
+            if let Some(local_info) = func.locals.get(place.local) {
                 local_info.ty.clone()
             } else {
                 // Check if it's a parameter
@@ -2163,6 +2647,7 @@ impl LoweringContext {
                 values: case_blocks.iter().map(|(v, _)| *v).collect(),
                 targets: case_blocks.iter().map(|(_, b)| *b).collect(),
                 otherwise: join_block, // TODO: Handle exhaustiveness
+                weights: vec![],
             },
         });
         
@@ -2762,6 +3247,7 @@ impl LoweringContext {
                 values: vec![1],
                 targets: vec![loop_body],
                 otherwise: loop_end,
+                weights: vec![],
             },
         });
         
@@ -3148,6 +3634,14 @@ impl LoweringContext {
     }
 }
 
+/// An `INTEGER` constant operand
+fn integer_operand(value: i128) -> Operand {
+    Operand::Constant(Constant {
+        ty: Type::primitive(PrimitiveType::Integer),
+        value: ConstantValue::Integer(value),
+    })
+}
+
 impl Default for LoweringContext {
     fn default() -> Self {
         Self::new()
@@ -3166,6 +3660,12 @@ pub fn lower_ast_to_mir_with_symbols(ast_program: &ast::Program, symbol_table: S
     context.lower_program(ast_program)
 }
 
+/// Lower an AST program to MIR, lowering function bodies on the rayon pool
+pub fn lower_ast_to_mir_parallel(ast_program: &ast::Program, symbol_table: SymbolTable) -> Result<Program, SemanticError> {
+    let mut context = LoweringContext::with_symbol_table(symbol_table);
+    context.lower_program_parallel(ast_program)
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -3196,6 +3696,7 @@ mod tests {
                 throws_exceptions: vec![],
                 thread_safe: None,
                 may_block: None,
+                contract_checks: None,
             },
             body: ast::Block {
                 statements: vec![
@@ -3220,4 +3721,155 @@ mod tests {
         assert_eq!(mir_func.name, "test");
         assert_eq!(mir_func.basic_blocks.len(), 1);
     }
-}
\ No newline at end of file
+    
+    #[test]
+    fn test_parallel_lowering_matches_sequential() {
+        let source = r#"
+(DEFINE_MODULE
+  (NAME calls)
+  (CONTENT
+    (DECLARE_CONSTANT (NAME LIMIT) (TYPE INTEGER) (VALUE 10))
+    (DEFINE_FUNCTION
+      (NAME caller)
+      (RETURNS INTEGER)
+      (BODY (RETURN_VALUE (EXPRESSION_ADD (CALL_FUNCTION square LIMIT) 1))))
+    (DEFINE_FUNCTION
+      (NAME square)
+      (ACCEPTS_PARAMETER (NAME "x") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY (RETURN_VALUE (EXPRESSION_MULTIPLY x x))))))
+"#;
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        
+        let sequential = lower_ast_to_mir(&program).unwrap();
+        let parallel = LoweringContext::new().lower_program_parallel(&program).unwrap();
+        
+        let mut names: Vec<_> = parallel.functions.keys().cloned().collect();
+        names.sort();
+        assert_eq!(names, vec!["caller".to_string(), "square".to_string()]);
+        assert_eq!(parallel.global_constants.len(), sequential.global_constants.len());
+        for name in &names {
+            let (s, p) = (&sequential.functions[name], &parallel.functions[name]);
+            assert_eq!(s.basic_blocks.len(), p.basic_blocks.len());
+            assert_eq!(s.locals.len(), p.locals.len());
+            assert_eq!(s.return_type, p.return_type);
+        }
+    }
+
+    #[test]
+    fn test_vector_select_lowering() {
+        let source = r#"
+(DEFINE_MODULE
+  (NAME simd)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME clamp_negatives)
+      (ACCEPTS_PARAMETER (NAME "data") (TYPE (ARRAY_OF_TYPE INTEGER)))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME lanes) (TYPE (VECTOR_OF_TYPE INTEGER 4)) (VALUE (VECTOR_LOAD data 0 4)))
+        (DECLARE_VARIABLE (NAME zero) (TYPE (VECTOR_OF_TYPE INTEGER 4)) (VALUE (VECTOR_SPLAT 0 4)))
+        (DECLARE_VARIABLE (NAME clamped) (TYPE (VECTOR_OF_TYPE INTEGER 4))
+          (VALUE (VECTOR_SELECT (PREDICATE_LESS_THAN lanes zero) zero lanes)))
+        (VECTOR_STORE data 0 clamped)
+        (RETURN_VALUE (VECTOR_EXTRACT clamped 0))))))
+"#;
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        crate::semantic::SemanticAnalyzer::new().analyze_program(&program).unwrap();
+
+        let mir = lower_ast_to_mir(&program).unwrap();
+        let function = &mir.functions["clamp_negatives"];
+        let statements: Vec<_> = function.basic_blocks.values().flat_map(|b| &b.statements).collect();
+
+        let mask_type = Type::vector(Type::primitive(PrimitiveType::Boolean), 4);
+        assert!(function.locals.values().any(|local| local.ty == mask_type));
+        assert!(statements.iter().any(|s| matches!(s, Statement::Assign { rvalue: Rvalue::VectorSelect { .. }, .. })));
+        assert!(statements.iter().any(|s| matches!(s, Statement::VectorStore { .. })));
+        assert!(crate::mir::validation::Validator::new().validate_function(function).is_ok());
+    }
+
+    /// Runtime functions called by `function`, in block order
+    fn runtime_calls(function: &Function) -> Vec<(String, Vec<Operand>)> {
+        function.basic_blocks.values()
+            .flat_map(|block| &block.statements)
+            .filter_map(|statement| match statement {
+                Statement::Assign { rvalue: Rvalue::Call { func: Operand::Constant(Constant { value: ConstantValue::String(name), .. }), args }, .. }
+                    if name.starts_with("aether_contract_") => Some((name.clone(), args.clone())),
+                _ => None,
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_contract_check_modes() {
+        let source = r#"
+(DEFINE_MODULE
+  (NAME checked)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME halve)
+      (ACCEPTS_PARAMETER (NAME "x") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (PRECONDITION (PREDICATE_GREATER_THAN x 0) "x must be positive")
+      (POSTCONDITION (PREDICATE_LESS_THAN 'result' x))
+      (BODY (RETURN_VALUE (EXPRESSION_DIVIDE x 2))))
+    (DEFINE_FUNCTION
+      (NAME main)
+      (RETURNS INTEGER)
+      (BODY (RETURN_VALUE (CALL_FUNCTION halve 8))))))
+"#;
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        let lower = |mode: ContractCheckMode, debug_build: bool| {
+            let mut ctx = LoweringContext::new();
+            ctx.set_contract_checks(mode, debug_build);
+            ctx.lower_program(&program).unwrap()
+        };
+        let asserts = |mir: &Program| -> Vec<AssertMessage> {
+            mir.functions["halve"].basic_blocks.values()
+                .filter_map(|block| match &block.terminator {
+                    Terminator::Assert { message, .. } => Some(message.clone()),
+                    _ => None,
+                })
+                .collect()
+        };
+        
+        // Off, and debug mode outside a debug build, emit nothing
+        for mir in [lower(ContractCheckMode::Off, true), lower(ContractCheckMode::Debug, false)] {
+            assert!(asserts(&mir).is_empty());
+            assert!(runtime_calls(&mir.functions["main"]).is_empty());
+        }
+        
+        // Debug checks are untimed
+        let debug = lower(ContractCheckMode::Debug, true);
+        assert_eq!(asserts(&debug).len(), 2);
+        assert!(runtime_calls(&debug.functions["halve"]).is_empty());
+        
+        let full = lower(ContractCheckMode::Full, false);
+        let messages = asserts(&full);
+        assert!(matches!(&messages[0], AssertMessage::Contract { name, message, fatal: true }
+            if name == "halve::precondition_1" && message == "halve::precondition_1 violated: x must be positive"));
+        assert!(matches!(&messages[1], AssertMessage::Contract { name, message, fatal: true }
+            if name == "halve::postcondition_1" && message == "halve::postcondition_1 violated"));
+        let names: Vec<String> = runtime_calls(&full.functions["halve"]).into_iter().map(|(name, _)| name).collect();
+        assert_eq!(names, ["aether_contract_begin", "aether_contract_end", "aether_contract_begin", "aether_contract_end"]);
+        let init = &runtime_calls(&full.functions["main"])[0];
+        assert_eq!(init.0, "aether_contract_init");
+        assert!(matches!(&init.1[0], Operand::Constant(Constant { value: ConstantValue::String(table), .. })
+            if table == "halve::precondition_1\nhalve::postcondition_1"));
+        assert!(crate::mir::validation::Validator::new().validate_function(&full.functions["halve"]).is_ok());
+        
+        // Sampling gates the postcondition but not the precondition
+        let sampled = lower(ContractCheckMode::Sampled { one_in: 50 }, false);
+        let calls = runtime_calls(&sampled.functions["halve"]);
+        let samples: Vec<_> = calls.iter().filter(|(name, _)| name == "aether_contract_sample").collect();
+        assert_eq!(samples.len(), 1);
+        assert!(matches!(samples[0].1.as_slice(), [
+            Operand::Constant(Constant { value: ConstantValue::Integer(1), .. }),
+            Operand::Constant(Constant { value: ConstantValue::Integer(50), .. }),
+        ]));
+        assert_eq!(asserts(&sampled).len(), 2);
+    }
+}
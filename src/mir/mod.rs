@@ -20,12 +20,18 @@
 
 pub mod lowering;
 pub mod dataflow;
+pub mod index_vec;
 pub mod validation;
 
+pub use index_vec::IndexVec;
+
 use crate::types::Type;
 use crate::error::SourceLocation;
+use crate::verification::facts::ProvenFacts;
 use std::collections::HashMap;
 use std::fmt;
+use std::ops::{Deref, DerefMut};
+use std::sync::OnceLock;
 
 /// A MIR program consists of multiple functions
 #[derive(Debug, Clone)]
@@ -42,10 +48,193 @@ pub struct Function {
     pub name: String,
     pub parameters: Vec<Parameter>,
     pub return_type: Type,
-    pub locals: HashMap<LocalId, Local>,
-    pub basic_blocks: HashMap<BasicBlockId, BasicBlock>,
+    pub locals: IndexVec<Local>,
+    pub basic_blocks: BasicBlocks,
     pub entry_block: BasicBlockId,
     pub return_local: Option<LocalId>,
+    /// Times the function was entered in the training profile, if profiled
+    pub entry_count: Option<u64>,
+    /// What verification proved about the function; renumbering blocks
+    /// keeps its loop headers current
+    pub proven_facts: Option<Box<ProvenFacts>>,
+}
+
+impl Function {
+    /// Control flow graph of this function, built once and cached until the
+    /// blocks are next mutated
+    pub fn cfg(&self) -> &cfg::Cfg {
+        self.basic_blocks.cfg(self.entry_block)
+    }
+    
+    /// Renumber blocks and locals densely after passes removed some
+    ///
+    /// Returns whether any ID changed. IDs stay put if a reference points at
+    /// a removed entry, since there is nothing sound to map it to.
+    pub fn compact(&mut self) -> bool {
+        let mut changed = false;
+        
+        if self.basic_blocks.has_gaps() {
+            let blocks = &self.basic_blocks;
+            let dangling = blocks.values().any(|block| {
+                cfg::successors(block).iter().any(|target| !blocks.contains(*target))
+            }) || !blocks.contains(self.entry_block);
+            
+            if !dangling {
+                let remap = self.basic_blocks.compact();
+                let map = |id: &mut BasicBlockId| *id = remap[*id as usize].unwrap();
+                for block in self.basic_blocks.values_mut() {
+                    map(&mut block.id);
+                    block.terminator.visit_targets_mut(map);
+                }
+                map(&mut self.entry_block);
+                if let Some(facts) = &mut self.proven_facts {
+                    facts.remap_loop_headers(|header| remap.get(header as usize).copied().flatten());
+                }
+                changed = true;
+            }
+        }
+        
+        if self.locals.has_gaps() {
+            let locals = &self.locals;
+            let mut dangling = self.parameters.iter().any(|param| !locals.contains(param.local_id))
+                || self.return_local.map_or(false, |local| !locals.contains(local));
+            for block in self.basic_blocks.values() {
+                for statement in &block.statements {
+                    statement.visit_locals(|local| dangling |= !locals.contains(local));
+                }
+                block.terminator.visit_locals(|local| dangling |= !locals.contains(local));
+            }
+            
+            if !dangling {
+                let remap = self.locals.compact();
+                let map = |id: &mut LocalId| *id = remap[*id as usize].unwrap();
+                for block in self.basic_blocks.values_mut() {
+                    for statement in &mut block.statements {
+                        statement.visit_locals_mut(map);
+                    }
+                    block.terminator.visit_locals_mut(map);
+                }
+                for param in &mut self.parameters {
+                    map(&mut param.local_id);
+                }
+                if let Some(local) = &mut self.return_local {
+                    map(local);
+                }
+                changed = true;
+            }
+        }
+        
+        changed
+    }
+    
+    /// Renumber blocks so that they are laid out in `order`
+    ///
+    /// Code generation emits blocks in ID order. `order` must list every
+    /// block exactly once, starting with the entry block.
+    pub fn reorder_blocks(&mut self, order: &[BasicBlockId]) {
+        debug_assert_eq!(order.len(), self.basic_blocks.len());
+        debug_assert_eq!(order.first(), Some(&self.entry_block));
+        
+        let mut remap = vec![0; self.basic_blocks.id_bound()];
+        for (new_id, &old_id) in order.iter().enumerate() {
+            remap[old_id as usize] = new_id as BasicBlockId;
+        }
+        let map = |id: &mut BasicBlockId| *id = remap[*id as usize];
+        
+        let mut old_blocks = std::mem::take(&mut self.basic_blocks);
+        for &old_id in order {
+            let mut block = old_blocks.remove(old_id).expect("reorder_blocks order names a missing block");
+            map(&mut block.id);
+            block.terminator.visit_targets_mut(map);
+            self.basic_blocks.insert(block.id, block);
+        }
+        map(&mut self.entry_block);
+        if let Some(facts) = &mut self.proven_facts {
+            facts.remap_loop_headers(|header| order.iter().position(|&old_id| old_id == header).map(|new_id| new_id as BasicBlockId));
+        }
+    }
+}
+
+/// The basic blocks of a function together with their cached CFG
+///
+/// Reads go straight to the underlying storage. Any mutable access drops the
+/// cached graph, so a pass that edits blocks never sees stale edges.
+#[derive(Clone, Default)]
+pub struct BasicBlocks {
+    blocks: IndexVec<BasicBlock>,
+    cfg: OnceLock<cfg::Cfg>,
+}
+
+impl BasicBlocks {
+    pub fn new() -> Self {
+        Self::default()
+    }
+    
+    /// Get the CFG rooted at `entry`, building it on first use
+    ///
+    /// Changing a function's entry block without touching its blocks must be
+    /// followed by `invalidate_cfg`.
+    pub fn cfg(&self, entry: BasicBlockId) -> &cfg::Cfg {
+        let cfg = self.cfg.get_or_init(|| cfg::Cfg::new(&self.blocks, entry));
+        debug_assert_eq!(cfg.entry(), entry, "stale CFG for a moved entry block");
+        cfg
+    }
+    
+    /// Drop the cached CFG
+    pub fn invalidate_cfg(&mut self) {
+        self.cfg.take();
+    }
+}
+
+impl Deref for BasicBlocks {
+    type Target = IndexVec<BasicBlock>;
+    
+    fn deref(&self) -> &Self::Target {
+        &self.blocks
+    }
+}
+
+impl DerefMut for BasicBlocks {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        self.invalidate_cfg();
+        &mut self.blocks
+    }
+}
+
+impl fmt::Debug for BasicBlocks {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        self.blocks.fmt(f)
+    }
+}
+
+impl From<IndexVec<BasicBlock>> for BasicBlocks {
+    fn from(blocks: IndexVec<BasicBlock>) -> Self {
+        Self { blocks, cfg: OnceLock::new() }
+    }
+}
+
+impl FromIterator<(BasicBlockId, BasicBlock)> for BasicBlocks {
+    fn from_iter<I: IntoIterator<Item = (BasicBlockId, BasicBlock)>>(iter: I) -> Self {
+        Self::from(iter.into_iter().collect::<IndexVec<_>>())
+    }
+}
+
+impl<'a> IntoIterator for &'a BasicBlocks {
+    type Item = (BasicBlockId, &'a BasicBlock);
+    type IntoIter = index_vec::Iter<'a, BasicBlock>;
+    
+    fn into_iter(self) -> Self::IntoIter {
+        self.blocks.iter()
+    }
+}
+
+impl<'a> IntoIterator for &'a mut BasicBlocks {
+    type Item = (BasicBlockId, &'a mut BasicBlock);
+    type IntoIter = index_vec::IterMut<'a, BasicBlock>;
+    
+    fn into_iter(self) -> Self::IntoIter {
+        self.deref_mut().iter_mut()
+    }
 }
 
 /// Function parameter
@@ -89,6 +278,14 @@ pub enum Statement {
         source_info: SourceInfo,
     },
     
+    /// Store every lane of `value` to consecutive array elements from `index`
+    VectorStore {
+        array: Operand,
+        index: Operand,
+        value: Operand,
+        source_info: SourceInfo,
+    },
+    
     /// Storage marker for lifetime analysis
     StorageLive(LocalId),
     StorageDead(LocalId),
@@ -146,6 +343,45 @@ pub enum Rvalue {
     
     /// Discriminant for enums
     Discriminant(Place),
+    
+    /// Load `lanes` consecutive array elements starting at `index`
+    VectorLoad {
+        array: Operand,
+        index: Operand,
+        lanes: u32,
+    },
+    
+    /// Broadcast a scalar to every lane
+    VectorSplat {
+        operand: Operand,
+        lanes: u32,
+    },
+    
+    /// Combine the lanes of a vector with `op`
+    VectorReduce {
+        op: BinOp,
+        operand: Operand,
+    },
+    
+    /// Pick lanes from the concatenation of `left` and `right`
+    VectorShuffle {
+        left: Operand,
+        right: Operand,
+        mask: Vec<u32>,
+    },
+    
+    /// Read one lane of a vector
+    VectorExtract {
+        vector: Operand,
+        lane: Operand,
+    },
+    
+    /// Lane-wise choice between two vectors by a Boolean mask
+    VectorSelect {
+        mask: Operand,
+        if_true: Operand,
+        if_false: Operand,
+    },
 }
 
 /// Operands (values that can be used)
@@ -243,6 +479,8 @@ pub struct SwitchTargets {
     pub values: Vec<u128>,
     pub targets: Vec<BasicBlockId>,
     pub otherwise: BasicBlockId,
+    /// Profiled counts of `targets` then `otherwise`; empty when unprofiled
+    pub weights: Vec<u64>,
 }
 
 /// Assertion messages
@@ -253,6 +491,242 @@ pub enum AssertMessage {
     DivisionByZero(Operand),
     RemainderByZero(Operand),
     Custom(String),
+    /// A contract condition, named `function::kind_index` as in the contract
+    /// table; a non-fatal failure only reports
+    Contract { name: String, message: String, fatal: bool },
+}
+
+impl Place {
+    /// Call `f` on every local this place mentions, including index locals
+    pub fn visit_locals(&self, f: &mut dyn FnMut(LocalId)) {
+        f(self.local);
+        for elem in &self.projection {
+            if let PlaceElem::Index(index) = elem {
+                f(*index);
+            }
+        }
+    }
+    
+    pub fn visit_locals_mut(&mut self, f: &mut dyn FnMut(&mut LocalId)) {
+        f(&mut self.local);
+        for elem in &mut self.projection {
+            if let PlaceElem::Index(index) = elem {
+                f(index);
+            }
+        }
+    }
+}
+
+impl Operand {
+    pub fn visit_locals(&self, f: &mut dyn FnMut(LocalId)) {
+        if let Operand::Copy(place) | Operand::Move(place) = self {
+            place.visit_locals(f);
+        }
+    }
+    
+    pub fn visit_locals_mut(&mut self, f: &mut dyn FnMut(&mut LocalId)) {
+        if let Operand::Copy(place) | Operand::Move(place) = self {
+            place.visit_locals_mut(f);
+        }
+    }
+}
+
+impl Rvalue {
+    pub fn visit_locals(&self, f: &mut dyn FnMut(LocalId)) {
+        match self {
+            Rvalue::Use(operand) | Rvalue::UnaryOp { operand, .. } | Rvalue::Cast { operand, .. } |
+            Rvalue::VectorSplat { operand, .. } | Rvalue::VectorReduce { operand, .. } => {
+                operand.visit_locals(f)
+            }
+            Rvalue::BinaryOp { left, right, .. } | Rvalue::VectorLoad { array: left, index: right, .. } |
+            Rvalue::VectorShuffle { left, right, .. } | Rvalue::VectorExtract { vector: left, lane: right } => {
+                left.visit_locals(f);
+                right.visit_locals(f);
+            }
+            Rvalue::VectorSelect { mask, if_true, if_false } => {
+                mask.visit_locals(f);
+                if_true.visit_locals(f);
+                if_false.visit_locals(f);
+            }
+            Rvalue::Call { func, args } => {
+                func.visit_locals(f);
+                args.iter().for_each(|arg| arg.visit_locals(f));
+            }
+            Rvalue::Aggregate { operands, .. } => operands.iter().for_each(|op| op.visit_locals(f)),
+            Rvalue::Ref { place, .. } | Rvalue::Len(place) | Rvalue::Discriminant(place) => {
+                place.visit_locals(f)
+            }
+        }
+    }
+    
+    pub fn visit_locals_mut(&mut self, f: &mut dyn FnMut(&mut LocalId)) {
+        match self {
+            Rvalue::Use(operand) | Rvalue::UnaryOp { operand, .. } | Rvalue::Cast { operand, .. } |
+            Rvalue::VectorSplat { operand, .. } | Rvalue::VectorReduce { operand, .. } => {
+                operand.visit_locals_mut(f)
+            }
+            Rvalue::BinaryOp { left, right, .. } | Rvalue::VectorLoad { array: left, index: right, .. } |
+            Rvalue::VectorShuffle { left, right, .. } | Rvalue::VectorExtract { vector: left, lane: right } => {
+                left.visit_locals_mut(f);
+                right.visit_locals_mut(f);
+            }
+            Rvalue::VectorSelect { mask, if_true, if_false } => {
+                mask.visit_locals_mut(f);
+                if_true.visit_locals_mut(f);
+                if_false.visit_locals_mut(f);
+            }
+            Rvalue::Call { func, args } => {
+                func.visit_locals_mut(f);
+                args.iter_mut().for_each(|arg| arg.visit_locals_mut(f));
+            }
+            Rvalue::Aggregate { operands, .. } => operands.iter_mut().for_each(|op| op.visit_locals_mut(f)),
+            Rvalue::Ref { place, .. } | Rvalue::Len(place) | Rvalue::Discriminant(place) => {
+                place.visit_locals_mut(f)
+            }
+        }
+    }
+    
+    /// The operands this rvalue reads; place-based rvalues have none
+    pub fn operands(&self) -> Vec<&Operand> {
+        match self {
+            Rvalue::Use(operand) | Rvalue::UnaryOp { operand, .. } | Rvalue::Cast { operand, .. } |
+            Rvalue::VectorSplat { operand, .. } | Rvalue::VectorReduce { operand, .. } => vec![operand],
+            Rvalue::BinaryOp { left, right, .. } | Rvalue::VectorLoad { array: left, index: right, .. } |
+            Rvalue::VectorShuffle { left, right, .. } | Rvalue::VectorExtract { vector: left, lane: right } => {
+                vec![left, right]
+            }
+            Rvalue::VectorSelect { mask, if_true, if_false } => vec![mask, if_true, if_false],
+            Rvalue::Call { func, args } => std::iter::once(func).chain(args.iter()).collect(),
+            Rvalue::Aggregate { operands, .. } => operands.iter().collect(),
+            Rvalue::Ref { .. } | Rvalue::Len(_) | Rvalue::Discriminant(_) => vec![],
+        }
+    }
+    
+    pub fn operands_mut(&mut self) -> Vec<&mut Operand> {
+        match self {
+            Rvalue::Use(operand) | Rvalue::UnaryOp { operand, .. } | Rvalue::Cast { operand, .. } |
+            Rvalue::VectorSplat { operand, .. } | Rvalue::VectorReduce { operand, .. } => vec![operand],
+            Rvalue::BinaryOp { left, right, .. } | Rvalue::VectorLoad { array: left, index: right, .. } |
+            Rvalue::VectorShuffle { left, right, .. } | Rvalue::VectorExtract { vector: left, lane: right } => {
+                vec![left, right]
+            }
+            Rvalue::VectorSelect { mask, if_true, if_false } => vec![mask, if_true, if_false],
+            Rvalue::Call { func, args } => std::iter::once(func).chain(args.iter_mut()).collect(),
+            Rvalue::Aggregate { operands, .. } => operands.iter_mut().collect(),
+            Rvalue::Ref { .. } | Rvalue::Len(_) | Rvalue::Discriminant(_) => vec![],
+        }
+    }
+}
+
+impl Statement {
+    /// Call `f` on every local the statement reads or writes
+    pub fn visit_locals(&self, mut f: impl FnMut(LocalId)) {
+        match self {
+            Statement::Assign { place, rvalue, .. } => {
+                place.visit_locals(&mut f);
+                rvalue.visit_locals(&mut f);
+            }
+            Statement::VectorStore { array, index, value, .. } => {
+                array.visit_locals(&mut f);
+                index.visit_locals(&mut f);
+                value.visit_locals(&mut f);
+            }
+            Statement::StorageLive(local) | Statement::StorageDead(local) => f(*local),
+            Statement::Nop => {}
+        }
+    }
+    
+    pub fn visit_locals_mut(&mut self, mut f: impl FnMut(&mut LocalId)) {
+        match self {
+            Statement::Assign { place, rvalue, .. } => {
+                place.visit_locals_mut(&mut f);
+                rvalue.visit_locals_mut(&mut f);
+            }
+            Statement::VectorStore { array, index, value, .. } => {
+                array.visit_locals_mut(&mut f);
+                index.visit_locals_mut(&mut f);
+                value.visit_locals_mut(&mut f);
+            }
+            Statement::StorageLive(local) | Statement::StorageDead(local) => f(local),
+            Statement::Nop => {}
+        }
+    }
+}
+
+impl AssertMessage {
+    fn operands_mut(&mut self) -> Vec<&mut Operand> {
+        match self {
+            AssertMessage::BoundsCheck { len, index } => vec![len, index],
+            AssertMessage::Overflow(_, left, right) => vec![left, right],
+            AssertMessage::DivisionByZero(op) | AssertMessage::RemainderByZero(op) => vec![op],
+            AssertMessage::Custom(_) | AssertMessage::Contract { .. } => vec![],
+        }
+    }
+    
+    fn operands(&self) -> Vec<&Operand> {
+        match self {
+            AssertMessage::BoundsCheck { len, index } => vec![len, index],
+            AssertMessage::Overflow(_, left, right) => vec![left, right],
+            AssertMessage::DivisionByZero(op) | AssertMessage::RemainderByZero(op) => vec![op],
+            AssertMessage::Custom(_) | AssertMessage::Contract { .. } => vec![],
+        }
+    }
+}
+
+impl Terminator {
+    /// Call `f` on every local the terminator reads or writes
+    pub fn visit_locals(&self, mut f: impl FnMut(LocalId)) {
+        match self {
+            Terminator::SwitchInt { discriminant, .. } => discriminant.visit_locals(&mut f),
+            Terminator::Call { func, args, destination, .. } => {
+                func.visit_locals(&mut f);
+                args.iter().for_each(|arg| arg.visit_locals(&mut f));
+                destination.visit_locals(&mut f);
+            }
+            Terminator::Drop { place, .. } => place.visit_locals(&mut f),
+            Terminator::Assert { condition, message, .. } => {
+                condition.visit_locals(&mut f);
+                message.operands().into_iter().for_each(|op| op.visit_locals(&mut f));
+            }
+            Terminator::Goto { .. } | Terminator::Return | Terminator::Unreachable => {}
+        }
+    }
+    
+    pub fn visit_locals_mut(&mut self, mut f: impl FnMut(&mut LocalId)) {
+        match self {
+            Terminator::SwitchInt { discriminant, .. } => discriminant.visit_locals_mut(&mut f),
+            Terminator::Call { func, args, destination, .. } => {
+                func.visit_locals_mut(&mut f);
+                args.iter_mut().for_each(|arg| arg.visit_locals_mut(&mut f));
+                destination.visit_locals_mut(&mut f);
+            }
+            Terminator::Drop { place, .. } => place.visit_locals_mut(&mut f),
+            Terminator::Assert { condition, message, .. } => {
+                condition.visit_locals_mut(&mut f);
+                message.operands_mut().into_iter().for_each(|op| op.visit_locals_mut(&mut f));
+            }
+            Terminator::Goto { .. } | Terminator::Return | Terminator::Unreachable => {}
+        }
+    }
+    
+    /// Call `f` on every successor block ID, in `cfg::successors` order
+    pub fn visit_targets_mut(&mut self, mut f: impl FnMut(&mut BasicBlockId)) {
+        match self {
+            Terminator::Goto { target } => f(target),
+            Terminator::SwitchInt { targets, .. } => {
+                targets.targets.iter_mut().for_each(&mut f);
+                f(&mut targets.otherwise);
+            }
+            Terminator::Call { target, cleanup, .. } => {
+                target.iter_mut().chain(cleanup.iter_mut()).for_each(f);
+            }
+            Terminator::Drop { target, unwind: other, .. } | Terminator::Assert { target, cleanup: other, .. } => {
+                f(target);
+                other.iter_mut().for_each(f);
+            }
+            Terminator::Return | Terminator::Unreachable => {}
+        }
+    }
 }
 
 /// Binary operations
@@ -313,6 +787,7 @@ pub enum CastKind {
 #[derive(Debug, Clone)]
 pub enum AggregateKind {
     Array(Type),
+    Vector(Type), // lane type; one operand per lane
     Tuple,
     Struct(String, Vec<String>), // struct name and field names
     Enum(String, String),         // enum name and variant name
@@ -461,14 +936,20 @@ impl Builder {
     
     /// Start building a new function
     pub fn start_function(&mut self, name: String, params: Vec<(String, Type)>, return_type: Type) {
+        // IDs are per function so they index its dense storage from zero
+        self.next_local_id = 0;
+        self.next_block_id = 0;
+        
         let function = Function {
             name: name.clone(),
             parameters: Vec::new(),
             return_type,
-            locals: HashMap::new(),
-            basic_blocks: HashMap::new(),
+            locals: IndexVec::new(),
+            basic_blocks: BasicBlocks::new(),
             entry_block: 0,
             return_local: None,
+            entry_count: None,
+            proven_facts: None,
         };
         
         self.current_function = Some(function);
@@ -538,7 +1019,7 @@ impl Builder {
     /// Add a statement to the current block
     pub fn push_statement(&mut self, statement: Statement) {
         if let (Some(func), Some(block_id)) = (&mut self.current_function, self.current_block) {
-            if let Some(block) = func.basic_blocks.get_mut(&block_id) {
+            if let Some(block) = func.basic_blocks.get_mut(block_id) {
                 block.statements.push(statement);
             }
         }
@@ -547,7 +1028,7 @@ impl Builder {
     /// Set the terminator for the current block
     pub fn set_terminator(&mut self, terminator: Terminator) {
         if let (Some(func), Some(block_id)) = (&mut self.current_function, self.current_block) {
-            if let Some(block) = func.basic_blocks.get_mut(&block_id) {
+            if let Some(block) = func.basic_blocks.get_mut(block_id) {
                 block.terminator = terminator;
             }
         }
@@ -581,42 +1062,134 @@ impl Builder {
 pub mod cfg {
     use super::*;
     
-    /// Get predecessors of a basic block
-    pub fn predecessors(func: &Function, block_id: BasicBlockId) -> Vec<BasicBlockId> {
-        let mut preds = Vec::new();
-        
-        for (pred_id, block) in &func.basic_blocks {
-            match &block.terminator {
-                Terminator::Goto { target } => {
-                    if *target == block_id {
-                        preds.push(*pred_id);
-                    }
-                }
-                Terminator::SwitchInt { targets, .. } => {
-                    if targets.targets.contains(&block_id) || targets.otherwise == block_id {
-                        preds.push(*pred_id);
-                    }
-                }
-                Terminator::Call { target, cleanup, .. } => {
-                    if target.as_ref() == Some(&block_id) || cleanup.as_ref() == Some(&block_id) {
-                        preds.push(*pred_id);
-                    }
-                }
-                Terminator::Drop { target, unwind, .. } => {
-                    if *target == block_id || unwind.as_ref() == Some(&block_id) {
-                        preds.push(*pred_id);
+    /// Control flow graph of a function
+    ///
+    /// Edges and a reverse postorder are computed once in O(blocks + edges).
+    /// Side tables are indexed directly by block ID; vacant IDs have no edges.
+    #[derive(Debug, Clone)]
+    pub struct Cfg {
+        entry: BasicBlockId,
+        blocks: Vec<BasicBlockId>,
+        present: Vec<bool>,
+        successors: Vec<Vec<BasicBlockId>>,
+        predecessors: Vec<Vec<BasicBlockId>>,
+        reverse_postorder: Vec<BasicBlockId>,
+        rpo_index: Vec<Option<usize>>,
+    }
+    
+    impl Cfg {
+        pub fn new(blocks: &IndexVec<BasicBlock>, entry: BasicBlockId) -> Self {
+            let bound = blocks.id_bound();
+            let mut present = vec![false; bound];
+            let mut successors = vec![Vec::new(); bound];
+            for (id, block) in blocks {
+                present[id as usize] = true;
+                successors[id as usize] = super::cfg::successors(block);
+            }
+            let exists = |id: BasicBlockId| present.get(id as usize).copied().unwrap_or(false);
+            
+            let mut predecessors = vec![Vec::new(); bound];
+            for (id, succs) in successors.iter().enumerate() {
+                for &succ in succs {
+                    let preds: &mut Vec<BasicBlockId> = match predecessors.get_mut(succ as usize) {
+                        Some(preds) if exists(succ) => preds,
+                        _ => continue,
+                    };
+                    // Switches may branch to one block several times
+                    if preds.last() != Some(&(id as BasicBlockId)) {
+                        preds.push(id as BasicBlockId);
                     }
                 }
-                Terminator::Assert { target, cleanup, .. } => {
-                    if *target == block_id || cleanup.as_ref() == Some(&block_id) {
-                        preds.push(*pred_id);
+            }
+            
+            // Iterative DFS from the entry; unreachable blocks get no number
+            let mut postorder = Vec::with_capacity(blocks.len());
+            let mut visited = vec![false; bound];
+            if exists(entry) {
+                let mut stack = vec![(entry, 0usize)];
+                visited[entry as usize] = true;
+                while let Some(&(node, next)) = stack.last() {
+                    if let Some(&succ) = successors[node as usize].get(next) {
+                        stack.last_mut().unwrap().1 += 1;
+                        if exists(succ) && !visited[succ as usize] {
+                            visited[succ as usize] = true;
+                            stack.push((succ, 0));
+                        }
+                    } else {
+                        postorder.push(node);
+                        stack.pop();
                     }
                 }
-                _ => {}
             }
+            
+            let reverse_postorder: Vec<BasicBlockId> = postorder.into_iter().rev().collect();
+            let mut rpo_index = vec![None; bound];
+            for (position, &id) in reverse_postorder.iter().enumerate() {
+                rpo_index[id as usize] = Some(position);
+            }
+            
+            Self {
+                entry,
+                blocks: blocks.ids().collect(),
+                present,
+                successors,
+                predecessors,
+                reverse_postorder,
+                rpo_index,
+            }
+        }
+        
+        pub fn entry(&self) -> BasicBlockId {
+            self.entry
+        }
+        
+        /// Size of side tables indexed by block ID
+        pub fn len(&self) -> usize {
+            self.present.len()
+        }
+        
+        pub fn is_empty(&self) -> bool {
+            self.blocks.is_empty()
+        }
+        
+        /// All block IDs in ascending order
+        pub fn blocks(&self) -> &[BasicBlockId] {
+            &self.blocks
+        }
+        
+        /// Dense index of a block, if it exists
+        pub fn index(&self, block: BasicBlockId) -> Option<usize> {
+            let index = block as usize;
+            self.present.get(index).copied().unwrap_or(false).then_some(index)
+        }
+        
+        pub fn successors(&self, block: BasicBlockId) -> &[BasicBlockId] {
+            self.index(block).map_or(&[], |index| &self.successors[index])
+        }
+        
+        pub fn predecessors(&self, block: BasicBlockId) -> &[BasicBlockId] {
+            self.index(block).map_or(&[], |index| &self.predecessors[index])
+        }
+        
+        /// Blocks reachable from the entry, each before its successors
+        /// (back edges aside)
+        pub fn reverse_postorder(&self) -> &[BasicBlockId] {
+            &self.reverse_postorder
+        }
+        
+        /// Position of a block in the reverse postorder
+        pub fn rpo_index(&self, block: BasicBlockId) -> Option<usize> {
+            self.index(block).and_then(|index| self.rpo_index[index])
         }
         
-        preds
+        pub fn is_reachable(&self, block: BasicBlockId) -> bool {
+            self.rpo_index(block).is_some()
+        }
+    }
+    
+    /// Get predecessors of a basic block
+    pub fn predecessors(func: &Function, block_id: BasicBlockId) -> Vec<BasicBlockId> {
+        func.cfg().predecessors(block_id).to_vec()
     }
     
     /// Get successors of a basic block
@@ -677,17 +1250,15 @@ impl fmt::Display for Function {
         writeln!(f)?;
         
         // Print basic blocks
-        for block_id in 0..self.basic_blocks.len() as u32 {
-            if let Some(block) = self.basic_blocks.get(&block_id) {
-                writeln!(f, "  bb{}:", block_id)?;
-                
-                for stmt in &block.statements {
-                    writeln!(f, "    {:?}", stmt)?;
-                }
-                
-                writeln!(f, "    {:?}", block.terminator)?;
-                writeln!(f)?;
+        for (block_id, block) in &self.basic_blocks {
+            writeln!(f, "  bb{}:", block_id)?;
+            
+            for stmt in &block.statements {
+                writeln!(f, "    {:?}", stmt)?;
             }
+            
+            writeln!(f, "    {:?}", block.terminator)?;
+            writeln!(f)?;
         }
         
         writeln!(f, "}}")
@@ -771,6 +1342,7 @@ mod tests {
                 values: vec![1],
                 targets: vec![bb1],
                 otherwise: bb2,
+                weights: vec![],
             },
         });
         
@@ -791,12 +1363,57 @@ mod tests {
         assert!(bb2_preds.contains(&bb1));
         
         // Test successors
-        let bb0_succs = cfg::successors(&function.basic_blocks[&bb0]);
+        let bb0_succs = cfg::successors(&function.basic_blocks[bb0]);
         assert_eq!(bb0_succs.len(), 2);
         assert!(bb0_succs.contains(&bb1));
         assert!(bb0_succs.contains(&bb2));
     }
-    
+
+    #[test]
+    fn test_cfg_cache_order_and_invalidation() {
+        let mut builder = Builder::new();
+        builder.start_function("test".to_string(), vec![], Type::primitive(PrimitiveType::Integer));
+
+        // bb0 -> bb1 -> bb2 -> bb1 (loop), bb1 -> bb3; bb4 is unreachable
+        let bb0 = builder.current_block.unwrap();
+        let bb1 = builder.new_block();
+        let bb2 = builder.new_block();
+        let bb3 = builder.new_block();
+        let bb4 = builder.new_block();
+        builder.set_terminator(Terminator::Goto { target: bb1 });
+        builder.switch_to_block(bb1);
+        builder.set_terminator(Terminator::SwitchInt {
+            discriminant: Operand::Constant(Constant {
+                ty: Type::primitive(PrimitiveType::Boolean),
+                value: ConstantValue::Bool(true),
+            }),
+            switch_ty: Type::primitive(PrimitiveType::Boolean),
+            targets: SwitchTargets { values: vec![1], targets: vec![bb2], otherwise: bb3, weights: vec![] },
+        });
+        builder.switch_to_block(bb2);
+        builder.set_terminator(Terminator::Goto { target: bb1 });
+        builder.switch_to_block(bb3);
+        builder.set_terminator(Terminator::Return);
+        builder.switch_to_block(bb4);
+        builder.set_terminator(Terminator::Goto { target: bb3 });
+
+        let mut function = builder.finish_function();
+
+        let cfg = function.cfg();
+        assert_eq!(cfg.reverse_postorder()[0], bb0);
+        assert!(cfg.rpo_index(bb1) < cfg.rpo_index(bb2));
+        assert!(cfg.rpo_index(bb1) < cfg.rpo_index(bb3));
+        assert!(!cfg.is_reachable(bb4));
+        assert_eq!(cfg.predecessors(bb1), &[bb0, bb2]);
+        assert_eq!(cfg.predecessors(bb3), &[bb1, bb4]);
+
+        // Any mutable access drops the cached graph
+        function.basic_blocks.get_mut(bb0).unwrap().terminator = Terminator::Goto { target: bb4 };
+        let cfg = function.cfg();
+        assert!(cfg.is_reachable(bb4));
+        assert!(!cfg.is_reachable(bb1));
+    }
+
     #[test]
     fn test_constant_values() {
         let bool_const = Constant {
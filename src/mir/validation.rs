@@ -89,7 +89,7 @@ impl Validator {
         for (block_id, block) in &function.basic_blocks {
             for (stmt_idx, stmt) in block.statements.iter().enumerate() {
                 let location = Location {
-                    block: *block_id,
+                    block: block_id,
                     statement_index: Some(stmt_idx),
                 };
                 
@@ -97,7 +97,7 @@ impl Validator {
             }
             
             let term_location = Location {
-                block: *block_id,
+                block: block_id,
                 statement_index: Some(block.statements.len()),
             };
             
@@ -106,7 +106,7 @@ impl Validator {
         
         // Check parameters
         for param in &function.parameters {
-            if !function.locals.contains_key(&param.local_id) {
+            if !function.locals.contains(param.local_id) {
                 self.errors.push(ValidationError::UndefinedLocal {
                     local: param.local_id,
                     location: Location { block: function.entry_block, statement_index: None },
@@ -116,7 +116,7 @@ impl Validator {
         
         // Check all used locals are defined
         for (local, location) in used_locals {
-            if !function.locals.contains_key(&local) {
+            if !function.locals.contains(local) {
                 self.errors.push(ValidationError::UndefinedLocal { local, location });
             }
         }
@@ -134,6 +134,11 @@ impl Validator {
                 used.insert((place.local, location));
                 self.collect_rvalue_locals(rvalue, used, location);
             }
+            Statement::VectorStore { array, index, value, .. } => {
+                self.collect_operand_locals(array, used, location);
+                self.collect_operand_locals(index, used, location);
+                self.collect_operand_locals(value, used, location);
+            }
             Statement::StorageLive(local) | Statement::StorageDead(local) => {
                 used.insert((*local, location));
             }
@@ -177,6 +182,20 @@ impl Validator {
             Rvalue::Len(place) | Rvalue::Discriminant(place) => {
                 used.insert((place.local, location));
             }
+            Rvalue::VectorLoad { array: left, index: right, .. } |
+            Rvalue::VectorShuffle { left, right, .. } |
+            Rvalue::VectorExtract { vector: left, lane: right } => {
+                self.collect_operand_locals(left, used, location);
+                self.collect_operand_locals(right, used, location);
+            }
+            Rvalue::VectorSelect { mask, if_true, if_false } => {
+                self.collect_operand_locals(mask, used, location);
+                self.collect_operand_locals(if_true, used, location);
+                self.collect_operand_locals(if_false, used, location);
+            }
+            Rvalue::VectorSplat { operand, .. } | Rvalue::VectorReduce { operand, .. } => {
+                self.collect_operand_locals(operand, used, location);
+            }
         }
     }
     
@@ -226,7 +245,7 @@ impl Validator {
     /// Check basic block structure
     fn check_basic_blocks(&mut self, function: &Function) {
         // Check entry block exists
-        if !function.basic_blocks.contains_key(&function.entry_block) {
+        if !function.basic_blocks.contains(function.entry_block) {
             self.errors.push(ValidationError::InvalidEdge {
                 from: function.entry_block,
                 to: function.entry_block,
@@ -235,44 +254,30 @@ impl Validator {
         
         // Check all blocks have terminators
         for (block_id, block) in &function.basic_blocks {
-            if matches!(block.terminator, Terminator::Unreachable) && *block_id != function.entry_block {
+            if matches!(block.terminator, Terminator::Unreachable) && block_id != function.entry_block {
                 // Unreachable is only valid as a placeholder during construction
-                self.errors.push(ValidationError::MissingTerminator { block: *block_id });
+                self.errors.push(ValidationError::MissingTerminator { block: block_id });
             }
         }
     }
     
     /// Check control flow graph validity
     fn check_cfg(&mut self, function: &Function) {
-        let mut reachable = HashSet::new();
-        let mut worklist = vec![function.entry_block];
-        
-        // Find all reachable blocks
-        while let Some(block_id) = worklist.pop() {
-            if reachable.insert(block_id) {
-                if let Some(block) = function.basic_blocks.get(&block_id) {
-                    for succ in cfg::successors(block) {
-                        if !reachable.contains(&succ) {
-                            worklist.push(succ);
-                        }
-                    }
-                }
-            }
-        }
+        let cfg = function.cfg();
         
         // Check all blocks are reachable
-        for block_id in function.basic_blocks.keys() {
-            if !reachable.contains(block_id) {
-                self.errors.push(ValidationError::UnreachableCode { block: *block_id });
+        for &block_id in cfg.blocks() {
+            if !cfg.is_reachable(block_id) {
+                self.errors.push(ValidationError::UnreachableCode { block: block_id });
             }
         }
         
         // Check all edges point to valid blocks
         for (block_id, block) in &function.basic_blocks {
             for succ in cfg::successors(block) {
-                if !function.basic_blocks.contains_key(&succ) {
+                if !function.basic_blocks.contains(succ) {
                     self.errors.push(ValidationError::InvalidEdge {
-                        from: *block_id,
+                        from: block_id,
                         to: succ,
                     });
                 }
@@ -299,7 +304,7 @@ impl Validator {
             for (stmt_idx, stmt) in block.statements.iter().enumerate() {
                 if let Statement::Assign { place, .. } = stmt {
                     let location = Location {
-                        block: *block_id,
+                        block: block_id,
                         statement_index: Some(stmt_idx),
                     };
                     
@@ -393,8 +398,10 @@ mod tests {
             parameters: vec![],
             return_type: Type::primitive(PrimitiveType::Integer),
             return_local: None,
-            locals: HashMap::new(),
-            basic_blocks: HashMap::new(),
+            entry_count: None,
+            proven_facts: None,
+            locals: Default::default(),
+            basic_blocks: Default::default(),
             entry_block: 0,
         };
         
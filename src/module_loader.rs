@@ -22,6 +22,63 @@ use crate::error::{SemanticError, SourceLocation};
 use std::collections::HashMap;
 use std::path::PathBuf;
 use std::fs;
+use std::sync::OnceLock;
+
+/// Standard library sources, embedded at compile time
+const STDLIB_SOURCES: [(&str, &str); 5] = [
+    ("core", include_str!("stdlib/core.aether")),
+    ("io", include_str!("stdlib/io.aether")),
+    ("math", include_str!("stdlib/math.aether")),
+    ("collections", include_str!("stdlib/collections.aether")),
+    ("string", include_str!("stdlib/string.aether")),
+];
+
+/// Precompiled interface of a standard library module
+///
+/// Each module is parsed at most once per process, on first import, and
+/// reduced to its declarations: importers only ever see signatures, so
+/// function bodies are dropped and are not re-checked. All loaders share
+/// the result, including a parse failure.
+fn stdlib_interface(name: &str) -> Option<&'static Result<Module, SemanticError>> {
+    const UNPARSED: OnceLock<Result<Module, SemanticError>> = OnceLock::new();
+    static INTERFACES: [OnceLock<Result<Module, SemanticError>>; STDLIB_SOURCES.len()] = [UNPARSED; STDLIB_SOURCES.len()];
+    
+    let index = STDLIB_SOURCES.iter().position(|(stdlib_name, _)| *stdlib_name == name)?;
+    Some(INTERFACES[index].get_or_init(|| {
+        let (name, source) = STDLIB_SOURCES[index];
+        let mut module = parse_module_source(name, source)?;
+        for function in &mut module.function_definitions {
+            function.body.statements = Vec::new();
+        }
+        Ok(module)
+    }))
+}
+
+/// Lex and parse a single-module source file
+fn parse_module_source(module_name: &str, source_code: &str) -> Result<Module, SemanticError> {
+    // Lex and parse the module in a single streaming pass
+    let lexer = crate::lexer::Lexer::new(source_code, module_name.to_string());
+    let mut parser = Parser::from_lexer(lexer);
+    let parsed = parser.parse_program();
+    if let Some(e) = parser.take_lexer_error() {
+        return Err(SemanticError::Internal {
+            message: format!("Failed to tokenize module '{}': {}", module_name, e),
+        });
+    }
+    let program = parsed
+        .map_err(|e| SemanticError::Internal {
+            message: format!("Failed to parse module '{}': {}", module_name, e),
+        })?;
+    
+    // Extract the module (assuming single-module files for now)
+    if program.modules.len() != 1 {
+        return Err(SemanticError::Internal {
+            message: format!("Module file '{}' must contain exactly one module", module_name),
+        });
+    }
+    
+    Ok(program.modules.into_iter().next().unwrap())
+}
 
 /// Source of a module
 #[derive(Debug, Clone, PartialEq)]
@@ -51,26 +108,18 @@ pub struct ModuleLoader {
     
     /// Search paths for modules
     search_paths: Vec<PathBuf>,
-    
-    /// Standard library modules (module name -> source code)
-    stdlib_modules: HashMap<String, String>,
 }
 
 impl ModuleLoader {
     pub fn new() -> Self {
-        let mut loader = Self {
+        Self {
             module_cache: HashMap::new(),
             search_paths: vec![
                 PathBuf::from("."),
                 PathBuf::from("./modules"),
                 PathBuf::from("./src"),
             ],
-            stdlib_modules: HashMap::new(),
-        };
-        
-        // Register standard library modules
-        loader.register_stdlib_modules();
-        loader
+        }
     }
     
     /// Add a search path for modules
@@ -108,11 +157,11 @@ impl ModuleLoader {
     }
     
     /// Resolve a module name to its source
-    fn resolve_module(&self, module_name: &str) -> Result<ModuleSource, SemanticError> {
+    pub fn resolve_module(&self, module_name: &str) -> Result<ModuleSource, SemanticError> {
         // 1. Check if it's a standard library module (using underscore convention)
         if module_name.starts_with("std_") {
             let stdlib_name = module_name.strip_prefix("std_").unwrap();
-            if self.stdlib_modules.contains_key(stdlib_name) {
+            if stdlib_interface(stdlib_name).is_some() {
                 return Ok(ModuleSource::Stdlib(stdlib_name.to_string()));
             }
         }
@@ -120,7 +169,7 @@ impl ModuleLoader {
         // Also check with dot notation for backward compatibility
         if module_name.starts_with("std.") {
             let stdlib_name = module_name.strip_prefix("std.").unwrap();
-            if self.stdlib_modules.contains_key(stdlib_name) {
+            if stdlib_interface(stdlib_name).is_some() {
                 return Ok(ModuleSource::Stdlib(stdlib_name.to_string()));
             }
         }
@@ -161,11 +210,11 @@ impl ModuleLoader {
                     })?
             }
             ModuleSource::Stdlib(name) => {
-                self.stdlib_modules.get(name)
+                return stdlib_interface(name)
                     .ok_or_else(|| SemanticError::Internal {
                         message: format!("Standard library module '{}' not found", name),
                     })?
-                    .clone()
+                    .clone();
             }
             ModuleSource::Package(_, _) => {
                 return Err(SemanticError::Internal {
@@ -175,53 +224,7 @@ impl ModuleLoader {
             ModuleSource::Memory(code) => code.clone(),
         };
         
-        // Tokenize and parse the module
-        let mut lexer = crate::lexer::Lexer::new(&source_code, module_name.to_string());
-        let tokens = lexer.tokenize()
-            .map_err(|e| SemanticError::Internal {
-                message: format!("Failed to tokenize module '{}': {}", module_name, e),
-            })?;
-            
-        let mut parser = Parser::new(tokens);
-        let program = parser.parse_program()
-            .map_err(|e| SemanticError::Internal {
-                message: format!("Failed to parse module '{}': {}", module_name, e),
-            })?;
-        
-        // Extract the module (assuming single-module files for now)
-        if program.modules.len() != 1 {
-            return Err(SemanticError::Internal {
-                message: format!("Module file '{}' must contain exactly one module", module_name),
-            });
-        }
-        
-        Ok(program.modules.into_iter().next().unwrap())
-    }
-    
-    /// Register standard library modules
-    fn register_stdlib_modules(&mut self) {
-        // For now, we'll register the stdlib modules as empty - in a real implementation
-        // these would be loaded from embedded files or a stdlib directory
-        
-        // Core module
-        self.stdlib_modules.insert("core".to_string(), 
-            std::fs::read_to_string("src/stdlib/core.aether").unwrap_or_else(|_| String::new()));
-        
-        // I/O module
-        self.stdlib_modules.insert("io".to_string(), 
-            std::fs::read_to_string("src/stdlib/io.aether").unwrap_or_else(|_| String::new()));
-        
-        // Math module
-        self.stdlib_modules.insert("math".to_string(), 
-            std::fs::read_to_string("src/stdlib/math.aether").unwrap_or_else(|_| String::new()));
-        
-        // Collections module
-        self.stdlib_modules.insert("collections".to_string(), 
-            std::fs::read_to_string("src/stdlib/collections.aether").unwrap_or_else(|_| String::new()));
-        
-        // String utilities
-        self.stdlib_modules.insert("string".to_string(), 
-            std::fs::read_to_string("src/stdlib/string.aether").unwrap_or_else(|_| String::new()));
+        parse_module_source(module_name, &source_code)
     }
     
     /// Get all loaded modules
@@ -293,6 +296,23 @@ mod tests {
         }
     }
     
+    #[test]
+    fn test_stdlib_interfaces_are_parsed_once() {
+        let first = stdlib_interface("io").unwrap();
+        let second = stdlib_interface("io").unwrap();
+        assert!(std::ptr::eq(first, second));
+        assert!(stdlib_interface("unknown").is_none());
+        
+        let module = first.as_ref().unwrap();
+        assert!(!module.function_definitions.is_empty());
+        assert!(module.function_definitions.iter().all(|f| f.body.statements.is_empty()));
+        
+        let mut loader = ModuleLoader::new();
+        let loaded = loader.load_module("std.io").unwrap();
+        assert_eq!(loaded.source, ModuleSource::Stdlib("io".to_string()));
+        assert_eq!(loaded.module.function_definitions.len(), module.function_definitions.len());
+    }
+    
     #[test]
     fn test_module_caching() {
         let mut loader = ModuleLoader::new();
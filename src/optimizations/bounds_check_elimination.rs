@@ -0,0 +1,450 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Bounds-check elimination
+//!
+//! Every `array_get`/`array_set` call checks its index at runtime. Inside a
+//! loop guarded by `i < array_length(a)`, where `i` starts non-negative and
+//! steps by one, an access `a[i]` made before the step is always in bounds.
+//! Such calls are renamed to `array_get_unchecked`/`array_set_unchecked`,
+//! which the backend lowers to a plain element load or store.
+//!
+//! Verified contracts extend this to bounds the loop test alone does not
+//! show: a proven `n <= length(a)` on a parameter `n` makes `i < n` as good
+//! as `i < array_length(a)`, and a proven `start >= 0` makes a parameter a
+//! valid starting index. The facts travel with the function as
+//! `Function::proven_facts`.
+
+use super::loop_optimizations::{LoopInfo, LoopOptimizationPass};
+use super::OptimizationPass;
+use crate::error::SemanticError;
+use crate::mir::{BinOp, Constant, ConstantValue, Function, LocalId, Operand, Rvalue, Statement, Terminator};
+use crate::verification::facts::ProvenFacts;
+use std::collections::{BTreeMap, HashMap, HashSet};
+
+/// Bounds checks handled in one function
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct BoundsCheckReport {
+    /// Checks proven redundant and removed
+    pub eliminated: usize,
+
+    /// Checked accesses left in the function
+    pub remaining: usize,
+}
+
+/// Removes bounds checks that loop ranges make redundant
+#[derive(Debug)]
+pub struct BoundsCheckEliminationPass {
+    loop_analysis: LoopOptimizationPass,
+    reports: BTreeMap<String, BoundsCheckReport>,
+}
+
+/// Where each local is assigned: (block, statement index), with a call
+/// terminator's destination at the index past the last statement
+type Definitions = HashMap<LocalId, Vec<(usize, usize)>>;
+
+impl BoundsCheckEliminationPass {
+    pub fn new() -> Self {
+        Self {
+            loop_analysis: LoopOptimizationPass::new(),
+            reports: BTreeMap::new(),
+        }
+    }
+
+    /// Per-function results, by function name
+    pub fn reports(&self) -> &BTreeMap<String, BoundsCheckReport> {
+        &self.reports
+    }
+
+    /// Total checks removed across all functions
+    pub fn total_eliminated(&self) -> usize {
+        self.reports.values().map(|report| report.eliminated).sum()
+    }
+
+    /// Accesses `(block, statement)` proven in bounds by one loop's exit test
+    fn find_safe_accesses(&self, function: &Function, loop_info: &LoopInfo, definitions: &Definitions) -> Vec<(usize, usize)> {
+        let bounds = match &loop_info.bounds {
+            Some(bounds) if bounds.comparison == BinOp::Lt && bounds.step == 1 => bounds,
+            _ => return Vec::new(),
+        };
+        let induction = bounds.induction_var.local;
+        let basic_iv = match self.loop_analysis.basic_induction_vars(loop_info.header).iter()
+            .find(|iv| iv.variable.local == induction)
+        {
+            Some(iv) => iv,
+            None => return Vec::new(),
+        };
+
+        // Only the latch may step `i`, so every other block in the loop runs
+        // while `i < end` still holds
+        let steps_in_latch = matches!(
+            function.basic_blocks.get(basic_iv.increment_block as u32).map(|block| &block.terminator),
+            Some(Terminator::Goto { target }) if *target as usize == loop_info.header
+        );
+        let header = loop_info.header as u32;
+        if !steps_in_latch || !self.is_non_negative(function, &bounds.initial_value, header, definitions) {
+            return Vec::new();
+        }
+        let array = match self.length_source(function, &bounds.final_value, definitions)
+            .or_else(|| self.proven_length_bound(function, &bounds.final_value, header, definitions))
+        {
+            Some(array) if self.is_fixed_array(function, array, definitions) => array,
+            _ => return Vec::new(),
+        };
+
+        let mut safe = Vec::new();
+        for &block_id in &loop_info.blocks {
+            if block_id == loop_info.header {
+                continue;
+            }
+            let block = match function.basic_blocks.get(block_id as u32) {
+                Some(block) => block,
+                None => continue,
+            };
+            for (index, statement) in block.statements.iter().enumerate() {
+                if block_id == basic_iv.increment_block && index >= basic_iv.increment_statement {
+                    break;
+                }
+                if let Statement::Assign { rvalue: Rvalue::Call { func, args }, .. } = statement {
+                    let checked = matches!(callee_name(func), Some("array_get") if args.len() == 2)
+                        || matches!(callee_name(func), Some("array_set") if args.len() == 3);
+                    if checked && operand_local(&args[0]) == Some(array) && operand_local(&args[1]) == Some(induction) {
+                        safe.push((block_id, index));
+                    }
+                }
+            }
+        }
+        safe
+    }
+
+    /// Whether `operand` is a non-negative integer constant, an array length,
+    /// or a parameter proven non-negative at the loop `header`
+    fn is_non_negative(&self, function: &Function, operand: &Operand, header: u32, definitions: &Definitions) -> bool {
+        match operand {
+            Operand::Constant(Constant { value: ConstantValue::Integer(value), .. }) => *value >= 0,
+            _ => self.length_source(function, operand, definitions).is_some() || matches!(
+                (self.function_facts(function), fixed_parameter(function, operand, definitions)),
+                (Some(facts), Some(name)) if facts.range_of(name, Some(header)).0.map_or(false, |min| min >= 0)
+            ),
+        }
+    }
+
+    /// The array parameter that a parameter `operand` is proven not to exceed
+    /// the length of at the loop `header`
+    fn proven_length_bound(&self, function: &Function, operand: &Operand, header: u32, definitions: &Definitions) -> Option<LocalId> {
+        let facts = self.function_facts(function)?;
+        let bound = fixed_parameter(function, operand, definitions)?;
+        function.parameters.iter()
+            .find(|parameter| facts.within_length(bound, &parameter.name, Some(header)))
+            .map(|parameter| parameter.local_id)
+    }
+
+    fn function_facts<'a>(&self, function: &'a Function) -> Option<&'a ProvenFacts> {
+        function.proven_facts.as_deref()
+    }
+
+    /// The array whose `array_length` `operand` holds, following copies
+    ///
+    /// Each local on the way must have a single assignment.
+    fn length_source(&self, function: &Function, operand: &Operand, definitions: &Definitions) -> Option<LocalId> {
+        let mut local = operand_local(operand)?;
+        let mut visited = HashSet::new();
+
+        while visited.insert(local) {
+            let (block, index) = match definitions.get(&local).map(Vec::as_slice) {
+                Some([definition]) => *definition,
+                _ => return None,
+            };
+            match function.basic_blocks.get(block as u32)?.statements.get(index)? {
+                Statement::Assign { rvalue: Rvalue::Use(source), .. } => local = operand_local(source)?,
+                Statement::Assign { rvalue: Rvalue::Call { func, args }, .. }
+                    if callee_name(func) == Some("array_length") && args.len() == 1 =>
+                {
+                    return operand_local(&args[0]);
+                }
+                _ => return None,
+            }
+        }
+
+        None
+    }
+
+    /// Whether `array` holds the same array wherever it is read
+    ///
+    /// Parameters that are never reassigned qualify, as do locals assigned
+    /// once outside every loop, ahead of all their uses.
+    fn is_fixed_array(&self, function: &Function, array: LocalId, definitions: &Definitions) -> bool {
+        match definitions.get(&array).map(Vec::as_slice) {
+            None | Some([]) => function.parameters.iter().any(|parameter| parameter.local_id == array),
+            Some([(block, _)]) => {
+                !self.loop_analysis.loops().iter().any(|loop_info| loop_info.blocks.contains(block))
+                    && self.defined_before_uses(function, array, *block, definitions)
+            }
+            _ => false,
+        }
+    }
+
+    /// Whether the single assignment of `local` in `block` dominates every read
+    fn defined_before_uses(&self, function: &Function, local: LocalId, block: usize, definitions: &Definitions) -> bool {
+        let (_, definition) = definitions[&local][0];
+        function.basic_blocks.iter().all(|(block_id, candidate)| {
+            candidate.statements.iter().enumerate().all(|(index, statement)| {
+                let reads = match statement {
+                    Statement::Assign { rvalue, .. } => rvalue_reads(rvalue, local),
+                    _ => false,
+                };
+                !reads || if block_id as usize == block {
+                    index > definition
+                } else {
+                    self.loop_analysis.block_dominates(block, block_id as usize)
+                }
+            })
+        })
+    }
+}
+
+impl OptimizationPass for BoundsCheckEliminationPass {
+    fn name(&self) -> &'static str {
+        "bounds-check-elimination"
+    }
+
+    fn is_function_local(&self) -> bool {
+        true
+    }
+
+    fn run_on_function(&mut self, function: &mut Function) -> Result<bool, SemanticError> {
+        self.loop_analysis.analyze_function(function)?;
+
+        let mut definitions: Definitions = HashMap::new();
+        for (block_id, block) in &function.basic_blocks {
+            for (index, statement) in block.statements.iter().enumerate() {
+                if let Statement::Assign { place, .. } = statement {
+                    definitions.entry(place.local).or_default().push((block_id as usize, index));
+                }
+            }
+            if let Terminator::Call { destination, .. } = &block.terminator {
+                // Recorded one past the last statement
+                definitions.entry(destination.local).or_default().push((block_id as usize, block.statements.len()));
+            }
+        }
+
+        let mut safe: Vec<(usize, usize)> = self.loop_analysis.loops().iter()
+            .flat_map(|loop_info| self.find_safe_accesses(function, loop_info, &definitions))
+            .collect();
+        safe.sort_unstable();
+        safe.dedup();
+
+        for &(block_id, index) in &safe {
+            if let Statement::Assign { rvalue: Rvalue::Call { func: Operand::Constant(constant), .. }, .. } =
+                &mut function.basic_blocks[block_id as u32].statements[index]
+            {
+                if let ConstantValue::String(name) = &mut constant.value {
+                    name.push_str("_unchecked");
+                }
+            }
+        }
+
+        let remaining = function.basic_blocks.values()
+            .flat_map(|block| block.statements.iter())
+            .filter(|statement| matches!(
+                statement,
+                Statement::Assign { rvalue: Rvalue::Call { func, .. }, .. }
+                    if matches!(callee_name(func), Some("array_get" | "array_set"))
+            ))
+            .count();
+        let report = self.reports.entry(function.name.clone()).or_default();
+        report.eliminated += safe.len();
+        report.remaining = remaining;
+
+        Ok(!safe.is_empty())
+    }
+
+    fn statistics(&self) -> Vec<(&'static str, usize)> {
+        vec![("bounds checks eliminated", self.total_eliminated())]
+    }
+}
+
+impl Default for BoundsCheckEliminationPass {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+fn callee_name(func: &Operand) -> Option<&str> {
+    match func {
+        Operand::Constant(Constant { value: ConstantValue::String(name), .. }) => Some(name),
+        _ => None,
+    }
+}
+
+/// The name of the parameter `operand` reads, if it is never reassigned
+fn fixed_parameter<'f>(function: &'f Function, operand: &Operand, definitions: &Definitions) -> Option<&'f str> {
+    let local = operand_local(operand)?;
+    if definitions.get(&local).map_or(false, |assignments| !assignments.is_empty()) {
+        return None;
+    }
+    function.parameters.iter()
+        .find(|parameter| parameter.local_id == local)
+        .map(|parameter| parameter.name.as_str())
+}
+
+fn operand_local(operand: &Operand) -> Option<LocalId> {
+    match operand {
+        Operand::Copy(place) | Operand::Move(place) if place.projection.is_empty() => Some(place.local),
+        _ => None,
+    }
+}
+
+fn rvalue_reads(rvalue: &Rvalue, local: LocalId) -> bool {
+    let mut reads = false;
+    rvalue.visit_locals(&mut |used| reads |= used == local);
+    reads
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::mir::Program;
+
+    fn lower(source: &str) -> Program {
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        crate::mir::lowering::lower_ast_to_mir(&program).unwrap()
+    }
+
+    fn calls(function: &Function, name: &str) -> usize {
+        function.basic_blocks.values()
+            .flat_map(|block| block.statements.iter())
+            .filter(|statement| matches!(
+                statement,
+                Statement::Assign { rvalue: Rvalue::Call { func, .. }, .. } if callee_name(func) == Some(name)
+            ))
+            .count()
+    }
+
+    #[test]
+    fn test_loop_indexed_accesses_are_unchecked() {
+        let mut program = lower(r#"
+(DEFINE_MODULE
+  (NAME bounds)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME sum_positive)
+      (ACCEPTS_PARAMETER (NAME "data") (TYPE (ARRAY_OF_TYPE INTEGER)))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME total) (TYPE INTEGER) (VALUE 0))
+        (DECLARE_VARIABLE (NAME i) (TYPE INTEGER) (VALUE 0))
+        (LOOP_WHILE_CONDITION (PREDICATE_LESS_THAN i (ARRAY_LENGTH data))
+          (ITERATION_BODY
+            (IF_CONDITION (PREDICATE_GREATER_THAN (GET_ARRAY_ELEMENT data i) 0)
+              (THEN_EXECUTE
+                (ASSIGN (TARGET_VARIABLE total) (SOURCE_EXPRESSION (EXPRESSION_ADD total (GET_ARRAY_ELEMENT data i))))))
+            (ASSIGN (TARGET_VARIABLE i) (SOURCE_EXPRESSION (EXPRESSION_ADD i 1)))))
+        (RETURN_VALUE total)))
+    (DEFINE_FUNCTION
+      (NAME fill)
+      (ACCEPTS_PARAMETER (NAME "data") (TYPE (ARRAY_OF_TYPE INTEGER)))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME n) (TYPE INTEGER) (VALUE (ARRAY_LENGTH data)))
+        (DECLARE_VARIABLE (NAME i) (TYPE INTEGER) (VALUE 0))
+        (LOOP_WHILE_CONDITION (PREDICATE_LESS_THAN i n)
+          (ITERATION_BODY
+            (SET_ARRAY_ELEMENT data i i)
+            (ASSIGN (TARGET_VARIABLE i) (SOURCE_EXPRESSION (EXPRESSION_ADD i 1)))))
+        (RETURN_VALUE 0)))))
+"#);
+        let mut pass = BoundsCheckEliminationPass::new();
+        assert!(pass.run_on_program(&mut program).unwrap());
+
+        let sum = &program.functions["sum_positive"];
+        assert_eq!(calls(sum, "array_get"), 0);
+        assert_eq!(calls(sum, "array_get_unchecked"), 2);
+        assert_eq!(calls(&program.functions["fill"], "array_set_unchecked"), 1);
+        assert_eq!(pass.reports()["sum_positive"], BoundsCheckReport { eliminated: 2, remaining: 0 });
+        assert_eq!(pass.total_eliminated(), 3);
+
+        // Nothing left to prove on a second run
+        assert!(!pass.run_on_program(&mut program).unwrap());
+        assert!(crate::mir::validation::Validator::new().validate_function(&program.functions["sum_positive"]).is_ok());
+    }
+
+    #[test]
+    fn test_unrelated_bound_keeps_checks() {
+        let mut program = lower(r#"
+(DEFINE_MODULE
+  (NAME bounds)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME shifted)
+      (ACCEPTS_PARAMETER (NAME "data") (TYPE (ARRAY_OF_TYPE INTEGER)))
+      (ACCEPTS_PARAMETER (NAME "n") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME total) (TYPE INTEGER) (VALUE 0))
+        (DECLARE_VARIABLE (NAME i) (TYPE INTEGER) (VALUE 0))
+        (LOOP_WHILE_CONDITION (PREDICATE_LESS_THAN i n)
+          (ITERATION_BODY
+            (ASSIGN (TARGET_VARIABLE total) (SOURCE_EXPRESSION (EXPRESSION_ADD total (GET_ARRAY_ELEMENT data i))))
+            (ASSIGN (TARGET_VARIABLE i) (SOURCE_EXPRESSION (EXPRESSION_ADD i 1)))
+            (ASSIGN (TARGET_VARIABLE total) (SOURCE_EXPRESSION (EXPRESSION_ADD total (GET_ARRAY_ELEMENT data i))))))
+        (RETURN_VALUE total)))))
+"#);
+        let mut pass = BoundsCheckEliminationPass::new();
+        assert!(!pass.run_on_program(&mut program).unwrap());
+        assert_eq!(calls(&program.functions["shifted"], "array_get"), 2);
+        assert_eq!(pass.reports()["shifted"], BoundsCheckReport { eliminated: 0, remaining: 2 });
+    }
+
+    #[test]
+    fn test_verified_bound_removes_checks() {
+        use crate::verification::facts::Fact;
+
+        let source = r#"
+(DEFINE_MODULE
+  (NAME bounds)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME prefix_sum)
+      (ACCEPTS_PARAMETER (NAME "data") (TYPE (ARRAY_OF_TYPE INTEGER)))
+      (ACCEPTS_PARAMETER (NAME "start") (TYPE INTEGER))
+      (ACCEPTS_PARAMETER (NAME "n") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME total) (TYPE INTEGER) (VALUE 0))
+        (DECLARE_VARIABLE (NAME i) (TYPE INTEGER) (VALUE start))
+        (LOOP_WHILE_CONDITION (PREDICATE_LESS_THAN i n)
+          (ITERATION_BODY
+            (ASSIGN (TARGET_VARIABLE total) (SOURCE_EXPRESSION (EXPRESSION_ADD total (GET_ARRAY_ELEMENT data i))))
+            (ASSIGN (TARGET_VARIABLE i) (SOURCE_EXPRESSION (EXPRESSION_ADD i 1)))))
+        (RETURN_VALUE total)))))
+"#;
+        let mut facts = ProvenFacts::default();
+        facts.add_entry_fact(Fact::WithinLength { variable: "n".to_string(), array: "data".to_string() });
+
+        // The length bound alone says nothing about where `i` starts
+        let mut program = lower(source);
+        program.functions.get_mut("prefix_sum").unwrap().proven_facts = Some(Box::new(facts.clone()));
+        let mut pass = BoundsCheckEliminationPass::new();
+        assert!(!pass.run_on_program(&mut program).unwrap());
+
+        facts.add_entry_fact(Fact::Range { variable: "start".to_string(), min: Some(0), max: None });
+        program.functions.get_mut("prefix_sum").unwrap().proven_facts = Some(Box::new(facts));
+        let mut pass = BoundsCheckEliminationPass::new();
+        assert!(pass.run_on_program(&mut program).unwrap());
+        assert_eq!(calls(&program.functions["prefix_sum"], "array_get_unchecked"), 1);
+        assert_eq!(pass.total_eliminated(), 1);
+    }
+}
@@ -136,6 +136,10 @@ impl OptimizationPass for CommonSubexpressionEliminationPass {
         "common-subexpression-elimination"
     }
     
+    fn is_function_local(&self) -> bool {
+        true
+    }
+    
     fn run_on_function(&mut self, function: &mut Function) -> Result<bool, SemanticError> {
         let mut changed = false;
         
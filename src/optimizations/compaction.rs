@@ -0,0 +1,163 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! ID compaction pass
+//!
+//! Block and local IDs stay stable while passes remove entries, which leaves
+//! vacant slots in the function's dense storage. This pass renumbers them so
+//! later passes and codegen iterate over tightly packed vectors.
+
+use super::OptimizationPass;
+use crate::mir::Function;
+use crate::error::SemanticError;
+
+/// Renumbers blocks and locals after removals
+pub struct CompactionPass {
+    compacted_functions: usize,
+}
+
+impl CompactionPass {
+    pub fn new() -> Self {
+        Self { compacted_functions: 0 }
+    }
+
+    /// Number of functions whose IDs were renumbered
+    pub fn compacted_functions(&self) -> usize {
+        self.compacted_functions
+    }
+}
+
+impl OptimizationPass for CompactionPass {
+    fn name(&self) -> &'static str {
+        "compaction"
+    }
+
+    fn is_function_local(&self) -> bool {
+        true
+    }
+
+    fn run_on_function(&mut self, function: &mut Function) -> Result<bool, SemanticError> {
+        if function.compact() {
+            self.compacted_functions += 1;
+        }
+
+        // Renumbering never exposes new work to the other passes
+        Ok(false)
+    }
+}
+
+impl Default for CompactionPass {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::mir::{Builder, Statement, Terminator, Rvalue, Operand, Place, SourceInfo};
+    use crate::types::Type;
+    use crate::ast::PrimitiveType;
+    use crate::error::SourceLocation;
+
+    #[test]
+    fn test_compaction_rewrites_targets_and_places() {
+        let mut builder = Builder::new();
+        builder.start_function("test".to_string(), vec![], Type::primitive(PrimitiveType::Integer));
+        let dead_local = builder.new_local(Type::primitive(PrimitiveType::Integer), false);
+        let live_local = builder.new_local(Type::primitive(PrimitiveType::Integer), false);
+        let entry = builder.current_block.unwrap();
+        let dead_block = builder.new_block();
+        let exit = builder.new_block();
+
+        builder.set_terminator(Terminator::Goto { target: exit });
+        builder.switch_to_block(exit);
+        builder.push_statement(Statement::StorageLive(live_local));
+        builder.push_statement(Statement::Assign {
+            place: Place { local: live_local, projection: vec![] },
+            rvalue: Rvalue::Use(Operand::Copy(Place { local: live_local, projection: vec![] })),
+            source_info: SourceInfo { span: SourceLocation::unknown(), scope: 0 },
+        });
+        builder.set_terminator(Terminator::Return);
+
+        let mut function = builder.finish_function();
+        function.basic_blocks.remove(dead_block);
+        function.locals.remove(dead_local);
+
+        let mut pass = CompactionPass::new();
+        assert!(!pass.run_on_function(&mut function).unwrap());
+        assert_eq!(pass.compacted_functions(), 1);
+
+        assert_eq!(function.basic_blocks.ids().collect::<Vec<_>>(), vec![0, 1]);
+        assert_eq!(function.locals.ids().collect::<Vec<_>>(), vec![0]);
+        assert!(matches!(
+            function.basic_blocks[entry].terminator,
+            Terminator::Goto { target: 1 }
+        ));
+        assert_eq!(function.basic_blocks[1].id, 1);
+        assert!(matches!(function.basic_blocks[1].statements[0], Statement::StorageLive(0)));
+
+        // Already dense: nothing to do
+        assert!(!function.compact());
+    }
+
+    #[test]
+    fn test_compaction_moves_loop_facts() {
+        use crate::verification::facts::{Fact, ProvenFacts};
+        use crate::verification::invariants::LoopInvariant;
+        use crate::verification::contracts::{BinaryOp, ConstantValue, Expression};
+        use crate::verification::{ConditionResult, VerificationResult};
+
+        // entry -> (removed) -> header <-> header; facts are proven at the header
+        let mut builder = Builder::new();
+        builder.start_function("test".to_string(), vec![], Type::primitive(PrimitiveType::Void));
+        let dead_block = builder.new_block();
+        let header = builder.new_block();
+        builder.set_terminator(Terminator::Goto { target: header });
+        builder.switch_to_block(header);
+        builder.set_terminator(Terminator::Goto { target: header });
+        let mut function = builder.finish_function();
+        function.basic_blocks.remove(dead_block);
+
+        let mut invariant = LoopInvariant::new(header);
+        invariant.add_condition(
+            "bounded".to_string(),
+            Expression::BinaryOp {
+                op: BinaryOp::Ge,
+                left: Box::new(Expression::Variable("n".to_string())),
+                right: Box::new(Expression::Constant(ConstantValue::Integer(0))),
+            },
+            SourceLocation::unknown(),
+        );
+        let result = VerificationResult {
+            name: "test".to_string(),
+            verified: true,
+            conditions: vec![ConditionResult {
+                name: "loop_invariant_bounded (LoopInvariantEntry)".to_string(),
+                condition: String::new(),
+                verified: true,
+                location: SourceLocation::unknown(),
+                verification_time_ms: 0,
+            }],
+            counterexamples: Vec::new(),
+        };
+        function.proven_facts = Some(Box::new(ProvenFacts::from_result(&result, None, &[invariant])));
+
+        assert!(function.compact());
+        let facts = function.proven_facts.as_ref().unwrap();
+        let fact = Fact::Range { variable: "n".to_string(), min: Some(0), max: None };
+        assert_eq!(facts.loop_facts(1), [fact]);
+        assert!(facts.loop_facts(header).is_empty());
+    }
+}
@@ -166,6 +166,10 @@ impl OptimizationPass for ConstantFoldingPass {
         "constant-folding"
     }
     
+    fn is_function_local(&self) -> bool {
+        true
+    }
+    
     fn run_on_function(&mut self, function: &mut Function) -> Result<bool, SemanticError> {
         self.changed = false;
         
@@ -17,11 +17,9 @@
 //! Removes unreachable code and unused assignments
 
 use super::OptimizationPass;
-use crate::mir::{
-    Function, Statement, Terminator, BasicBlockId, LocalId, Operand, Rvalue,
-};
+use crate::mir::{Function, Statement, BasicBlockId, LocalId, Place, Rvalue};
+use crate::mir::dataflow::BitSet;
 use crate::error::SemanticError;
-use std::collections::HashSet;
 
 /// Dead code elimination optimization pass
 pub struct DeadCodeEliminationPass {
@@ -37,165 +35,56 @@ impl DeadCodeEliminationPass {
         }
     }
     
-    /// Find all reachable basic blocks
-    fn find_reachable_blocks(&self, function: &Function) -> HashSet<BasicBlockId> {
-        let mut reachable = HashSet::new();
-        let mut worklist = vec![function.entry_block];
-        
-        while let Some(block_id) = worklist.pop() {
-            if reachable.insert(block_id) {
-                if let Some(block) = function.basic_blocks.get(&block_id) {
-                    // Add successors to worklist
-                    match &block.terminator {
-                        Terminator::Goto { target } => {
-                            if !reachable.contains(target) {
-                                worklist.push(*target);
-                            }
-                        }
-                        Terminator::SwitchInt { targets, .. } => {
-                            for &target in &targets.targets {
-                                if !reachable.contains(&target) {
-                                    worklist.push(target);
-                                }
-                            }
-                            if !reachable.contains(&targets.otherwise) {
-                                worklist.push(targets.otherwise);
-                            }
-                        }
-                        Terminator::Call { target, cleanup, .. } => {
-                            if let Some(target) = target {
-                                if !reachable.contains(target) {
-                                    worklist.push(*target);
-                                }
-                            }
-                            if let Some(cleanup) = cleanup {
-                                if !reachable.contains(cleanup) {
-                                    worklist.push(*cleanup);
-                                }
-                            }
-                        }
-                        Terminator::Drop { target, unwind, .. } => {
-                            if !reachable.contains(target) {
-                                worklist.push(*target);
-                            }
-                            if let Some(unwind) = unwind {
-                                if !reachable.contains(unwind) {
-                                    worklist.push(*unwind);
-                                }
-                            }
-                        }
-                        Terminator::Assert { target, cleanup, .. } => {
-                            if !reachable.contains(target) {
-                                worklist.push(*target);
-                            }
-                            if let Some(cleanup) = cleanup {
-                                if !reachable.contains(cleanup) {
-                                    worklist.push(*cleanup);
-                                }
-                            }
-                        }
-                        _ => {}
-                    }
-                }
-            }
-        }
-        
-        reachable
-    }
-    
     /// Remove unreachable basic blocks
     fn remove_unreachable_blocks(&mut self, function: &mut Function) -> bool {
-        let reachable = self.find_reachable_blocks(function);
-        let original_count = function.basic_blocks.len();
-        
-        // Remove unreachable blocks
-        function.basic_blocks.retain(|&block_id, _| reachable.contains(&block_id));
-        
-        let removed = original_count - function.basic_blocks.len();
+        let cfg = function.cfg();
+        let unreachable: Vec<BasicBlockId> = cfg.blocks().iter()
+            .copied()
+            .filter(|&block_id| !cfg.is_reachable(block_id))
+            .collect();
+        
+        // Leave the cached CFG intact when there is nothing to remove
+        let removed = unreachable.len();
+        if removed > 0 {
+            function.basic_blocks.retain(|block_id, _| !unreachable.contains(&block_id));
+        }
+
         self.removed_blocks += removed;
         removed > 0
     }
     
-    /// Check if a local is used in an operand
-    fn local_used_in_operand(&self, operand: &Operand, local: LocalId) -> bool {
-        match operand {
-            Operand::Copy(place) | Operand::Move(place) => place.local == local,
-            Operand::Constant(_) => false,
-        }
-    }
-    
-    /// Check if a local is used in an rvalue
-    fn local_used_in_rvalue(&self, rvalue: &Rvalue, local: LocalId) -> bool {
-        match rvalue {
-            Rvalue::Use(operand) => self.local_used_in_operand(operand, local),
-            Rvalue::BinaryOp { left, right, .. } => {
-                self.local_used_in_operand(left, local) || self.local_used_in_operand(right, local)
-            }
-            Rvalue::UnaryOp { operand, .. } => self.local_used_in_operand(operand, local),
-            Rvalue::Call { func, args } => {
-                self.local_used_in_operand(func, local) || 
-                args.iter().any(|arg| self.local_used_in_operand(arg, local))
-            }
-            Rvalue::Aggregate { operands, .. } => {
-                operands.iter().any(|operand| self.local_used_in_operand(operand, local))
-            }
-            Rvalue::Cast { operand, .. } => self.local_used_in_operand(operand, local),
-            Rvalue::Ref { place, .. } => place.local == local,
-            Rvalue::Len(place) | Rvalue::Discriminant(place) => place.local == local,
-        }
-    }
-    
-    /// Check if a local is used in a terminator
-    fn local_used_in_terminator(&self, terminator: &Terminator, local: LocalId) -> bool {
-        match terminator {
-            Terminator::SwitchInt { discriminant, .. } => {
-                self.local_used_in_operand(discriminant, local)
-            }
-            Terminator::Call { func, args, destination, .. } => {
-                self.local_used_in_operand(func, local) ||
-                args.iter().any(|arg| self.local_used_in_operand(arg, local)) ||
-                destination.local == local
-            }
-            Terminator::Drop { place, .. } => place.local == local,
-            Terminator::Assert { condition, .. } => self.local_used_in_operand(condition, local),
-            _ => false,
-        }
+    /// Whether an assignment must be kept even if its local is never read
+    fn has_side_effects(place: &Place, rvalue: &Rvalue) -> bool {
+        !place.projection.is_empty() || matches!(rvalue, Rvalue::Call { .. })
     }
     
     /// Find all locals that are used (not just assigned to)
-    fn find_used_locals(&self, function: &Function) -> HashSet<LocalId> {
-        let mut used = HashSet::new();
+    fn find_used_locals(&self, function: &Function) -> BitSet {
+        let mut used = BitSet::new_empty(function.locals.id_bound());
+        let mut mark = |local: LocalId| {
+            used.insert(local as usize);
+        };
         
-        // Function parameters are always considered used
+        // Function parameters and the return slot are always considered used
         for param in &function.parameters {
-            used.insert(param.local_id);
+            mark(param.local_id);
+        }
+        if let Some(return_local) = function.return_local {
+            mark(return_local);
         }
         
         for block in function.basic_blocks.values() {
-            // Check statements
             for statement in &block.statements {
                 match statement {
-                    Statement::Assign { rvalue, .. } => {
-                        // Check rvalue for used locals
-                        for local_id in function.locals.keys() {
-                            if self.local_used_in_rvalue(rvalue, *local_id) {
-                                used.insert(*local_id);
-                            }
-                        }
+                    // Kept assignments still write their place
+                    Statement::Assign { place, rvalue, .. } if Self::has_side_effects(place, rvalue) => {
+                        statement.visit_locals(&mut mark);
                     }
-                    Statement::StorageLive(local) | Statement::StorageDead(local) => {
-                        used.insert(*local);
-                    }
-                    Statement::Nop => {}
-                }
-            }
-            
-            // Check terminator
-            for local_id in function.locals.keys() {
-                if self.local_used_in_terminator(&block.terminator, *local_id) {
-                    used.insert(*local_id);
+                    Statement::Assign { rvalue, .. } => rvalue.visit_locals(&mut mark),
+                    _ => statement.visit_locals(&mut mark),
                 }
             }
+            block.terminator.visit_locals(&mut mark);
         }
         
         used
@@ -213,8 +102,7 @@ impl DeadCodeEliminationPass {
                 match statement {
                     Statement::Assign { place, rvalue, .. } => {
                         // Keep assignment if the local is used, has side effects, or is a function call
-                        let has_side_effects = !place.projection.is_empty() || matches!(rvalue, Rvalue::Call { .. });
-                        if used_locals.contains(&place.local) || has_side_effects {
+                        if used_locals.contains(place.local as usize) || Self::has_side_effects(place, rvalue) {
                             new_statements.push(statement.clone());
                         } else {
                             // Remove this dead assignment
@@ -240,7 +128,7 @@ impl DeadCodeEliminationPass {
         let original_count = function.locals.len();
         
         // Remove unused locals
-        function.locals.retain(|&local_id, _| used_locals.contains(&local_id));
+        function.locals.retain(|local_id, _| used_locals.contains(local_id as usize));
         
         let removed = original_count - function.locals.len();
         removed > 0
@@ -252,6 +140,10 @@ impl OptimizationPass for DeadCodeEliminationPass {
         "dead-code-elimination"
     }
     
+    fn is_function_local(&self) -> bool {
+        true
+    }
+    
     fn run_on_function(&mut self, function: &mut Function) -> Result<bool, SemanticError> {
         let mut changed = false;
         
@@ -277,7 +169,7 @@ impl Default for DeadCodeEliminationPass {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::mir::{Builder, Place, SourceInfo, Rvalue, Operand, Constant, ConstantValue};
+    use crate::mir::{Builder, SourceInfo, Operand, Constant, ConstantValue, Terminator};
     use crate::types::Type;
     use crate::ast::PrimitiveType;
     use crate::error::SourceLocation;
@@ -0,0 +1,1064 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Global value numbering and partial redundancy elimination
+//!
+//! Value numbering walks the dominator tree with a scoped table, so a value
+//! computed in one block is reused by every block it dominates. Partial
+//! redundancies, computed on some paths into a block but not all, are removed
+//! by lazy code motion: the computation is placed on the paths that lack it,
+//! as late as possible, and the redundant one becomes a copy.
+//!
+//! MIR locals may be assigned many times, so only locals with one definition
+//! that dominates every read take part; each holds a single value. Array
+//! element loads are numbered like arithmetic when no store or call in the
+//! function may write the array, and are otherwise forwarded within a block
+//! up to the next store that may alias.
+
+use super::interprocedural::EscapeAnalysis;
+use super::loop_optimizations::DominanceInfo;
+use super::remarks::{self, Remark};
+use super::OptimizationPass;
+use crate::error::SemanticError;
+use crate::mir::dataflow::{run_analysis, BitSet, DataFlowAnalysis, Direction, Location};
+use crate::mir::{
+    BasicBlock, BasicBlockId, BinOp, Constant, ConstantValue, Function, Local, LocalId, Operand, Place,
+    PlaceElem, Rvalue, SourceInfo, Statement, Terminator, UnOp,
+};
+use std::collections::{HashMap, HashSet};
+
+/// A value number
+type ValueNumber = usize;
+
+/// A computation keyed by the value numbers of its operands
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+enum ValueKey {
+    Binary(BinOp, ValueNumber, ValueNumber),
+    Unary(UnOp, ValueNumber),
+    /// `array_length`; an array keeps its length for life
+    Length(ValueNumber),
+    /// Element load from an array nothing in the function writes
+    Load(ValueNumber, ValueNumber),
+}
+
+/// What an assignment's right-hand side computes
+enum Computation {
+    /// A copy of an existing value
+    Copy(ValueNumber),
+    
+    /// A pure function of its operands' values
+    Pure(ValueKey),
+    
+    /// An element load from an array in copy class `class`
+    Load { class: usize, element: (ValueNumber, ValueNumber) },
+    
+    /// An element store of a known value
+    Store { class: usize, element: (ValueNumber, ValueNumber), value: ValueNumber },
+}
+
+/// Global value numbering with partial redundancy elimination
+pub struct GlobalValueNumberingPass {
+    redundant_values: usize,
+    forwarded_loads: usize,
+    partial_redundancies: usize,
+    remarks: Vec<Remark>,
+}
+
+impl GlobalValueNumberingPass {
+    pub fn new() -> Self {
+        Self {
+            redundant_values: 0,
+            forwarded_loads: 0,
+            partial_redundancies: 0,
+            remarks: Vec::new(),
+        }
+    }
+    
+    /// Replace computations whose value a dominating definition already holds
+    fn number_values(&mut self, function: &mut Function, dominance: &DominanceInfo, stable: &StableLocals, memory: &MemoryModel) -> bool {
+        let mut table = ValueTable::default();
+        for param in &function.parameters {
+            if stable.contains(param.local_id) {
+                table.define(param.local_id, None);
+            }
+        }
+        
+        let mut changed = false;
+        
+        // Preorder over the dominator tree; a block's leaders are dropped
+        // once its subtree is done
+        let mut stack = vec![(function.entry_block as usize, None)];
+        while let Some((block_id, scope)) = stack.pop() {
+            if let Some(scope) = scope {
+                table.leave(scope);
+                continue;
+            }
+            stack.push((block_id, Some(table.enter())));
+            stack.extend(dominance.children(block_id).iter().rev().map(|&child| (child, None)));
+            
+            // Loads and stores of arrays that are written somewhere in the
+            // function, valid until the next aliasing store
+            let mut block_loads: HashMap<(ValueNumber, ValueNumber), (usize, ValueNumber)> = HashMap::new();
+            
+            let block = &mut function.basic_blocks[block_id as BasicBlockId];
+            for statement in &mut block.statements {
+                match statement_clobber(statement) {
+                    Some(Clobber::Array(array)) => {
+                        let class = memory.class_of(array);
+                        block_loads.retain(|_, (other, _)| !memory.may_alias(class, *other));
+                    }
+                    Some(Clobber::Unknown) => block_loads.retain(|_, (class, _)| memory.is_fresh(*class)),
+                    None => {}
+                }
+                
+                let (place, rvalue) = match statement {
+                    Statement::Assign { place, rvalue, .. } => (place, rvalue),
+                    _ => continue,
+                };
+                
+                let mut value = None;
+                match table.classify(rvalue, memory) {
+                    Some(Computation::Copy(copied)) => value = Some(copied),
+                    Some(Computation::Pure(key)) => {
+                        let (number, known) = table.number(key);
+                        if let (true, Some(leader)) = (known, table.leader(number)) {
+                            *rvalue = Rvalue::Use(leader);
+                            self.redundant_values += 1;
+                            changed = true;
+                        }
+                        value = Some(number);
+                    }
+                    Some(Computation::Load { class, element }) => {
+                        if let Some(&(_, loaded)) = block_loads.get(&element) {
+                            if let Some(leader) = table.leader(loaded) {
+                                *rvalue = Rvalue::Use(leader);
+                                self.forwarded_loads += 1;
+                                changed = true;
+                                value = Some(loaded);
+                            }
+                        }
+                        if value.is_none() && place.projection.is_empty() && stable.contains(place.local) {
+                            let loaded = table.fresh();
+                            block_loads.insert(element, (class, loaded));
+                            value = Some(loaded);
+                        }
+                    }
+                    Some(Computation::Store { class, element, value: stored }) => {
+                        block_loads.insert(element, (class, stored));
+                    }
+                    None => {}
+                }
+                
+                if place.projection.is_empty() && stable.contains(place.local) {
+                    table.define(place.local, value);
+                }
+            }
+        }
+        
+        changed
+    }
+    
+    /// Lazy code motion over the expressions of stable operands
+    ///
+    /// Computations are inserted on the edges where the expression becomes
+    /// both needed on every path and not yet available, and the redundant
+    /// computations then read a temporary instead.
+    fn eliminate_partial_redundancies(&mut self, function: &mut Function, stable: &StableLocals) -> bool {
+        let universe = ExpressionUniverse::collect(function, stable);
+        if universe.expressions.is_empty() || !function.cfg().predecessors(function.entry_block).is_empty() {
+            return false;
+        }
+        let size = universe.expressions.len();
+        
+        let cfg = function.cfg();
+        let order: Vec<BasicBlockId> = cfg.reverse_postorder().to_vec();
+        let successors: HashMap<BasicBlockId, Vec<BasicBlockId>> = order.iter()
+            .map(|&block| {
+                let mut targets = cfg.successors(block).to_vec();
+                targets.dedup();
+                (block, targets)
+            })
+            .collect();
+        let predecessors: HashMap<BasicBlockId, Vec<BasicBlockId>> = order.iter()
+            .map(|&block| (block, cfg.predecessors(block).iter().copied().filter(|&pred| cfg.is_reachable(pred)).collect()))
+            .collect();
+        
+        let availability = run_analysis(function, Availability { universe: &universe });
+        let anticipation = run_analysis(function, Anticipation { universe: &universe });
+        let full = BitSet::new_filled(size);
+        let (antloc, killed) = universe.local_properties(function);
+        
+        // EARLIEST(p, s): anticipated at s, not available out of p, and p
+        // could not have computed it any earlier
+        let mut earliest: HashMap<(BasicBlockId, BasicBlockId), BitSet> = HashMap::new();
+        for &pred in &order {
+            let mut blocked = full.clone();
+            blocked.subtract(anticipation.exit_fact(pred).unwrap());
+            blocked.union(&killed[&pred]);
+            for &succ in &successors[&pred] {
+                let mut set = anticipation.entry_fact(succ).unwrap().clone();
+                set.subtract(availability.exit_fact(pred).unwrap());
+                set.intersect(&blocked);
+                earliest.insert((pred, succ), set);
+            }
+        }
+        
+        // LATER_in(b): placement can still be delayed to the start of b
+        let later_edge = |later_in: &HashMap<BasicBlockId, BitSet>, pred: BasicBlockId, succ: BasicBlockId| {
+            let mut set = later_in[&pred].clone();
+            set.subtract(&antloc[&pred]);
+            set.union(&earliest[&(pred, succ)]);
+            set
+        };
+        let mut later_in: HashMap<BasicBlockId, BitSet> = order.iter().map(|&block| (block, full.clone())).collect();
+        later_in.insert(function.entry_block, anticipation.entry_fact(function.entry_block).unwrap().clone());
+        let mut changed = true;
+        while changed {
+            changed = false;
+            for &block in order.iter().skip(1) {
+                let mut set = full.clone();
+                for &pred in &predecessors[&block] {
+                    set.intersect(&later_edge(&later_in, pred, block));
+                }
+                if set != later_in[&block] {
+                    later_in.insert(block, set);
+                    changed = true;
+                }
+            }
+        }
+        
+        // Only expressions with a redundant computation are worth a temporary
+        let mut delete: HashMap<BasicBlockId, BitSet> = HashMap::new();
+        let mut moved = BitSet::new_empty(size);
+        for &block in &order {
+            let mut set = antloc[&block].clone();
+            set.subtract(&later_in[&block]);
+            moved.union(&set);
+            delete.insert(block, set);
+        }
+        if moved.is_empty() {
+            return false;
+        }
+        let mut insert: Vec<(BasicBlockId, BasicBlockId, BitSet)> = Vec::new();
+        for &pred in &order {
+            for &succ in &successors[&pred] {
+                let mut set = later_edge(&later_in, pred, succ);
+                set.subtract(&later_in[&succ]);
+                set.intersect(&moved);
+                if !set.is_empty() {
+                    insert.push((pred, succ, set));
+                }
+            }
+        }
+        drop(availability);
+        drop(anticipation);
+        
+        let temporaries: HashMap<usize, LocalId> = moved.iter()
+            .map(|expression| {
+                let ty = function.locals[universe.origins[expression].0].ty.clone();
+                (expression, function.locals.push(Local { ty, is_mutable: true, source_info: None }))
+            })
+            .collect();
+        let copy = |local: LocalId| Rvalue::Use(Operand::Copy(Place { local, projection: vec![] }));
+        
+        // The first computation in a deleting block reads the temporary; all
+        // others keep computing and also fill it
+        for &block_id in &order {
+            let block = &mut function.basic_blocks[block_id];
+            let mut deleted = delete[&block_id].clone();
+            let mut statements = Vec::with_capacity(block.statements.len());
+            for (index, mut statement) in std::mem::take(&mut block.statements).into_iter().enumerate() {
+                let expression = match universe.at.get(&(block_id, index)) {
+                    Some(&expression) if moved.contains(expression) => expression,
+                    _ => {
+                        statements.push(statement);
+                        continue;
+                    }
+                };
+                let temporary = temporaries[&expression];
+                if deleted.remove(expression) {
+                    if let Statement::Assign { rvalue, .. } = &mut statement {
+                        *rvalue = copy(temporary);
+                    }
+                    self.partial_redundancies += 1;
+                    statements.push(statement);
+                } else if let Statement::Assign { place, source_info, .. } = &statement {
+                    let fill = Statement::Assign {
+                        place: Place { local: temporary, projection: vec![] },
+                        rvalue: copy(place.local),
+                        source_info: source_info.clone(),
+                    };
+                    statements.push(statement);
+                    statements.push(fill);
+                }
+            }
+            block.statements = statements;
+        }
+        
+        // Insertions go at the end of a single-successor predecessor, the
+        // start of a single-predecessor successor, or a new edge block
+        for (pred, succ, set) in insert {
+            let remark = Remark::applied(self.name(), &function.name, format!(
+                "moved {} partially redundant computation(s) to the edge from block {} to block {}",
+                set.count(), pred, succ,
+            ));
+            remarks::record(&mut self.remarks, remark);
+            let computations: Vec<Statement> = set.iter()
+                .map(|expression| Statement::Assign {
+                    place: Place { local: temporaries[&expression], projection: vec![] },
+                    rvalue: universe.expressions[expression].to_rvalue(),
+                    source_info: universe.origins[expression].1.clone(),
+                })
+                .collect();
+            if successors[&pred].len() == 1 {
+                function.basic_blocks[pred].statements.extend(computations);
+            } else if predecessors[&succ].len() == 1 {
+                function.basic_blocks[succ].statements.splice(0..0, computations);
+            } else {
+                let edge = function.basic_blocks.id_bound() as BasicBlockId;
+                function.basic_blocks.insert(edge, BasicBlock {
+                    id: edge,
+                    statements: computations,
+                    terminator: Terminator::Goto { target: succ },
+                });
+                function.basic_blocks[pred].terminator.visit_targets_mut(|target| {
+                    if *target == succ {
+                        *target = edge;
+                    }
+                });
+            }
+        }
+        
+        true
+    }
+}
+
+impl OptimizationPass for GlobalValueNumberingPass {
+    fn name(&self) -> &'static str {
+        "global-value-numbering"
+    }
+    
+    fn is_function_local(&self) -> bool {
+        true
+    }
+    
+    fn statistics(&self) -> Vec<(&'static str, usize)> {
+        vec![
+            ("redundant values removed", self.redundant_values),
+            ("loads forwarded", self.forwarded_loads),
+            ("partial redundancies removed", self.partial_redundancies),
+        ]
+    }
+    
+    fn remarks(&self) -> &[Remark] {
+        &self.remarks
+    }
+    
+    fn run_on_function(&mut self, function: &mut Function) -> Result<bool, SemanticError> {
+        if function.basic_blocks.is_empty() {
+            return Ok(false);
+        }
+        
+        let dominance = DominanceInfo::compute(function);
+        let stable = StableLocals::compute(function, &dominance);
+        let memory = MemoryModel::compute(function);
+        
+        let mut changed = self.number_values(function, &dominance, &stable, &memory);
+        changed |= self.eliminate_partial_redundancies(function, &stable);
+        Ok(changed)
+    }
+}
+
+impl Default for GlobalValueNumberingPass {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Value numbers of stable locals, constants and computations, with the
+/// operand holding each value in the part of the dominator tree being walked
+#[derive(Default)]
+struct ValueTable {
+    next: ValueNumber,
+    locals: HashMap<LocalId, ValueNumber>,
+    constants: HashMap<Constant, ValueNumber>,
+    expressions: HashMap<ValueKey, ValueNumber>,
+    leaders: HashMap<ValueNumber, Operand>,
+    /// Values given a leader, in order, so leaving a subtree can drop them
+    scoped: Vec<ValueNumber>,
+}
+
+impl ValueTable {
+    fn fresh(&mut self) -> ValueNumber {
+        self.next += 1;
+        self.next - 1
+    }
+    
+    /// Start a dominator subtree, returning the mark to leave it with
+    fn enter(&self) -> usize {
+        self.scoped.len()
+    }
+    
+    fn leave(&mut self, mark: usize) {
+        for value in self.scoped.drain(mark..) {
+            self.leaders.remove(&value);
+        }
+    }
+    
+    /// Record a stable local's value, making it the leader if none is in scope
+    fn define(&mut self, local: LocalId, value: Option<ValueNumber>) {
+        let value = value.unwrap_or_else(|| self.fresh());
+        self.locals.insert(local, value);
+        if !self.leaders.contains_key(&value) {
+            self.leaders.insert(value, Operand::Copy(Place { local, projection: vec![] }));
+            self.scoped.push(value);
+        }
+    }
+    
+    fn leader(&self, value: ValueNumber) -> Option<Operand> {
+        self.leaders.get(&value).cloned()
+    }
+    
+    /// Value number of `key`, and whether it was already known
+    fn number(&mut self, key: ValueKey) -> (ValueNumber, bool) {
+        match self.expressions.get(&key) {
+            Some(&value) => (value, true),
+            None => {
+                let value = self.fresh();
+                self.expressions.insert(key, value);
+                (value, false)
+            }
+        }
+    }
+    
+    /// Value number of a stable local or a constant
+    fn operand(&mut self, operand: &Operand) -> Option<ValueNumber> {
+        match operand {
+            Operand::Copy(place) | Operand::Move(place) if place.projection.is_empty() => {
+                self.locals.get(&place.local).copied()
+            }
+            Operand::Constant(constant) => {
+                if let Some(&value) = self.constants.get(constant) {
+                    return Some(value);
+                }
+                // Constants lead their value everywhere
+                let value = self.fresh();
+                self.constants.insert(constant.clone(), value);
+                self.leaders.insert(value, operand.clone());
+                Some(value)
+            }
+            _ => None,
+        }
+    }
+    
+    fn classify(&mut self, rvalue: &Rvalue, memory: &MemoryModel) -> Option<Computation> {
+        match rvalue {
+            Rvalue::Use(operand) => self.operand(operand).map(Computation::Copy),
+            Rvalue::BinaryOp { op, left, right } => {
+                let (mut left, mut right) = (self.operand(left)?, self.operand(right)?);
+                if is_commutative(*op) && left > right {
+                    std::mem::swap(&mut left, &mut right);
+                }
+                Some(Computation::Pure(ValueKey::Binary(*op, left, right)))
+            }
+            Rvalue::UnaryOp { op, operand } => Some(Computation::Pure(ValueKey::Unary(*op, self.operand(operand)?))),
+            Rvalue::Call { func, args } => {
+                let array = args.first().and_then(operand_local);
+                match (callee_name(func), args.len()) {
+                    (Some("array_length"), 1) => Some(Computation::Pure(ValueKey::Length(self.operand(&args[0])?))),
+                    (Some("array_get" | "array_get_unchecked"), 2) => {
+                        let element = (self.operand(&args[0])?, self.operand(&args[1])?);
+                        let class = memory.class_of(array?);
+                        if memory.is_unclobbered(class) {
+                            Some(Computation::Pure(ValueKey::Load(element.0, element.1)))
+                        } else {
+                            Some(Computation::Load { class, element })
+                        }
+                    }
+                    (Some("array_set" | "array_set_unchecked"), 3) => {
+                        let element = (self.operand(&args[0])?, self.operand(&args[1])?);
+                        let value = self.operand(&args[2])?;
+                        Some(Computation::Store { class: memory.class_of(array?), element, value })
+                    }
+                    _ => None,
+                }
+            }
+            _ => None,
+        }
+    }
+}
+
+/// Locals that hold one value for as long as they are read
+///
+/// A local qualifies when its single whole assignment dominates every read
+/// and it is never written through a projection, referenced or ended early.
+/// Parameters qualify when never assigned.
+struct StableLocals {
+    locals: HashSet<LocalId>,
+}
+
+impl StableLocals {
+    fn compute(function: &Function, dominance: &DominanceInfo) -> Self {
+        let mut definitions: HashMap<LocalId, Vec<(usize, usize)>> = HashMap::new();
+        let mut excluded: HashSet<LocalId> = HashSet::new();
+        for (block_id, block) in function.basic_blocks.iter() {
+            for (index, statement) in block.statements.iter().enumerate() {
+                match statement {
+                    Statement::Assign { place, rvalue, .. } => {
+                        if place.projection.is_empty() {
+                            definitions.entry(place.local).or_default().push((block_id as usize, index));
+                        } else {
+                            excluded.insert(place.local);
+                        }
+                        if let Rvalue::Ref { place, .. } = rvalue {
+                            excluded.insert(place.local);
+                        }
+                    }
+                    Statement::StorageDead(local) => {
+                        excluded.insert(*local);
+                    }
+                    _ => {}
+                }
+            }
+            match &block.terminator {
+                Terminator::Call { destination: place, .. } | Terminator::Drop { place, .. } => {
+                    excluded.insert(place.local);
+                }
+                _ => {}
+            }
+        }
+        
+        let mut single: HashMap<LocalId, (usize, usize)> = definitions.iter()
+            .filter(|(_, defs)| defs.len() == 1)
+            .map(|(&local, defs)| (local, defs[0]))
+            .collect();
+        let mut locals: HashSet<LocalId> = HashSet::new();
+        for param in &function.parameters {
+            // An assigned parameter also holds its incoming value
+            if single.remove(&param.local_id).is_none() && !definitions.contains_key(&param.local_id) {
+                locals.insert(param.local_id);
+            }
+        }
+        
+        // Every read must come after the definition on all paths
+        let cfg = function.cfg();
+        for (block_id, block) in function.basic_blocks.iter() {
+            if !cfg.is_reachable(block_id) {
+                continue;
+            }
+            let mut check = |local: LocalId, index: usize| {
+                if let Some(&(def_block, def_index)) = single.get(&local) {
+                    let dominated = if def_block == block_id as usize {
+                        def_index < index
+                    } else {
+                        dominance.dominates(def_block, block_id as usize)
+                    };
+                    if !dominated {
+                        single.remove(&local);
+                    }
+                }
+            };
+            for (index, statement) in block.statements.iter().enumerate() {
+                visit_reads(statement, |local| check(local, index));
+            }
+            block.terminator.visit_locals(|local| check(local, block.statements.len()));
+        }
+        
+        locals.extend(single.into_keys());
+        locals.retain(|local| !excluded.contains(local));
+        Self { locals }
+    }
+    
+    fn contains(&self, local: LocalId) -> bool {
+        self.locals.contains(&local)
+    }
+    
+    /// The operand in `Copy` form if it is a constant or a stable local
+    fn operand(&self, operand: &Operand) -> Option<Operand> {
+        match operand {
+            Operand::Copy(place) | Operand::Move(place) if place.projection.is_empty() && self.contains(place.local) => {
+                Some(Operand::Copy(place.clone()))
+            }
+            Operand::Constant(_) => Some(operand.clone()),
+            _ => None,
+        }
+    }
+}
+
+/// Memory a statement may write
+enum Clobber {
+    /// Elements of the array a local holds
+    Array(LocalId),
+    
+    /// Anything reachable from outside the function
+    Unknown,
+}
+
+fn statement_clobber(statement: &Statement) -> Option<Clobber> {
+    match statement {
+        Statement::Assign { place, rvalue, .. } => {
+            if place.projection.iter().any(|elem| matches!(elem, PlaceElem::Deref)) {
+                return Some(Clobber::Unknown);
+            }
+            if !place.projection.is_empty() {
+                return Some(Clobber::Array(place.local));
+            }
+            match rvalue {
+                Rvalue::Call { func, args } => match callee_name(func) {
+                    Some("array_get" | "array_get_unchecked" | "array_length" | "array_create" | "array_create_stack") => None,
+                    Some("array_set" | "array_set_unchecked") => {
+                        Some(args.first().and_then(operand_local).map_or(Clobber::Unknown, Clobber::Array))
+                    }
+                    _ => Some(Clobber::Unknown),
+                },
+                _ => None,
+            }
+        }
+        Statement::VectorStore { array, .. } => Some(operand_local(array).map_or(Clobber::Unknown, Clobber::Array)),
+        _ => None,
+    }
+}
+
+/// Which array accesses may touch the same elements
+///
+/// Locals joined by copies share a class. A class is fresh when it holds one
+/// array created in this function that never escapes it; a fresh array can
+/// only be reached through its own class.
+struct MemoryModel {
+    class_of: HashMap<LocalId, usize>,
+    fresh: Vec<bool>,
+    /// Classes that no store or call in the function may write
+    unclobbered: Vec<bool>,
+}
+
+impl MemoryModel {
+    fn compute(function: &Function) -> Self {
+        let classes = EscapeAnalysis::copy_classes(function);
+        let escaping = EscapeAnalysis::escaping_locals(function);
+        let class_of: HashMap<LocalId, usize> = classes.iter().enumerate()
+            .flat_map(|(class, members)| members.iter().map(move |&local| (local, class)))
+            .collect();
+        
+        // Count allocations per class and reject any other kind of definition
+        let mut allocations = vec![0usize; classes.len()];
+        let mut other_definitions = vec![false; classes.len()];
+        let mut clobbers = Vec::new();
+        for block in function.basic_blocks.values() {
+            for statement in &block.statements {
+                if let Statement::Assign { place, rvalue, .. } = statement {
+                    if place.projection.is_empty() {
+                        let class = class_of[&place.local];
+                        match rvalue {
+                            Rvalue::Call { func, .. } if matches!(callee_name(func), Some("array_create" | "array_create_stack")) => {
+                                allocations[class] += 1;
+                            }
+                            Rvalue::Use(operand) if operand_local(operand).map(|local| class_of[&local]) == Some(class) => {}
+                            _ => other_definitions[class] = true,
+                        }
+                    }
+                }
+                clobbers.extend(statement_clobber(statement));
+            }
+            match &block.terminator {
+                Terminator::Call { destination: place, .. } | Terminator::Drop { place, .. } => {
+                    other_definitions[class_of[&place.local]] = true;
+                    clobbers.push(Clobber::Unknown);
+                }
+                _ => {}
+            }
+        }
+        
+        let fresh: Vec<bool> = classes.iter().enumerate()
+            .map(|(class, members)| {
+                allocations[class] == 1 && !other_definitions[class]
+                    && !members.iter().any(|local| escaping.contains(local))
+            })
+            .collect();
+        
+        let mut model = Self { class_of, unclobbered: vec![true; fresh.len()], fresh };
+        for clobber in clobbers {
+            for class in 0..model.fresh.len() {
+                model.unclobbered[class] &= match &clobber {
+                    Clobber::Array(array) => !model.may_alias(model.class_of(*array), class),
+                    Clobber::Unknown => model.fresh[class],
+                };
+            }
+        }
+        model
+    }
+    
+    fn class_of(&self, local: LocalId) -> usize {
+        self.class_of[&local]
+    }
+    
+    fn is_fresh(&self, class: usize) -> bool {
+        self.fresh[class]
+    }
+    
+    fn is_unclobbered(&self, class: usize) -> bool {
+        self.unclobbered[class]
+    }
+    
+    fn may_alias(&self, a: usize, b: usize) -> bool {
+        a == b || (!self.fresh[a] && !self.fresh[b])
+    }
+}
+
+/// An expression tracked by lazy code motion, with operands in `Copy` form
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+enum Expression {
+    Binary(BinOp, Operand, Operand),
+    Unary(UnOp, Operand),
+}
+
+impl Expression {
+    /// The expression an rvalue computes, if it is safe to compute anywhere
+    /// its stable operands are defined
+    fn from_rvalue(rvalue: &Rvalue, stable: &StableLocals) -> Option<Self> {
+        match rvalue {
+            // Division may trap, so it is never computed on a new path
+            Rvalue::BinaryOp { op: BinOp::Div | BinOp::Rem | BinOp::Mod | BinOp::Offset, .. } => None,
+            // Constant operands alone are left to constant folding
+            Rvalue::BinaryOp { left: Operand::Constant(_), right: Operand::Constant(_), .. } => None,
+            Rvalue::BinaryOp { op, left, right } => {
+                Some(Expression::Binary(*op, stable.operand(left)?, stable.operand(right)?))
+            }
+            Rvalue::UnaryOp { operand: Operand::Constant(_), .. } => None,
+            Rvalue::UnaryOp { op, operand } => Some(Expression::Unary(*op, stable.operand(operand)?)),
+            _ => None,
+        }
+    }
+    
+    fn to_rvalue(&self) -> Rvalue {
+        match self {
+            Expression::Binary(op, left, right) => Rvalue::BinaryOp { op: *op, left: left.clone(), right: right.clone() },
+            Expression::Unary(op, operand) => Rvalue::UnaryOp { op: *op, operand: operand.clone() },
+        }
+    }
+}
+
+/// The lazy code motion candidates of a function
+struct ExpressionUniverse {
+    expressions: Vec<Expression>,
+    /// Destination local and source of the first computation of each
+    origins: Vec<(LocalId, SourceInfo)>,
+    /// Expression computed by the statement at (block, index)
+    at: HashMap<(BasicBlockId, usize), usize>,
+    /// Expressions whose value changes when each local is assigned
+    kills: HashMap<LocalId, BitSet>,
+}
+
+impl ExpressionUniverse {
+    fn collect(function: &Function, stable: &StableLocals) -> Self {
+        let mut universe = Self { expressions: Vec::new(), origins: Vec::new(), at: HashMap::new(), kills: HashMap::new() };
+        let mut indices: HashMap<Expression, usize> = HashMap::new();
+        let cfg = function.cfg();
+        
+        for &block_id in cfg.reverse_postorder() {
+            for (index, statement) in function.basic_blocks[block_id].statements.iter().enumerate() {
+                let (place, rvalue, source_info) = match statement {
+                    Statement::Assign { place, rvalue, source_info } if place.projection.is_empty() => (place, rvalue, source_info),
+                    _ => continue,
+                };
+                let expression = match Expression::from_rvalue(rvalue, stable) {
+                    Some(expression) => expression,
+                    None => continue,
+                };
+                let id = match indices.get(&expression) {
+                    Some(&id) => id,
+                    None => {
+                        let id = universe.expressions.len();
+                        let operands = match &expression {
+                            Expression::Binary(_, left, right) => vec![operand_local(left), operand_local(right)],
+                            Expression::Unary(_, operand) => vec![operand_local(operand)],
+                        };
+                        for local in operands.into_iter().flatten() {
+                            universe.kills.entry(local).or_default().insert(id);
+                        }
+                        indices.insert(expression.clone(), id);
+                        universe.expressions.push(expression);
+                        universe.origins.push((place.local, source_info.clone()));
+                        id
+                    }
+                };
+                universe.at.insert((block_id, index), id);
+            }
+        }
+        
+        universe
+    }
+    
+    /// Remove the expressions an assignment to `place` changes
+    fn kill(&self, place: &Place, fact: &mut BitSet) {
+        if place.projection.is_empty() {
+            if let Some(killed) = self.kills.get(&place.local) {
+                fact.subtract(killed);
+            }
+        }
+    }
+    
+    /// Per reachable block: expressions computed before any operand changes,
+    /// and expressions whose operands change
+    fn local_properties(&self, function: &Function) -> (HashMap<BasicBlockId, BitSet>, HashMap<BasicBlockId, BitSet>) {
+        let size = self.expressions.len();
+        let mut antloc = HashMap::new();
+        let mut killed = HashMap::new();
+        for &block_id in function.cfg().reverse_postorder() {
+            let mut exposed = BitSet::new_empty(size);
+            let mut changed = BitSet::new_empty(size);
+            for (index, statement) in function.basic_blocks[block_id].statements.iter().enumerate() {
+                if let Statement::Assign { place, .. } = statement {
+                    if let Some(&expression) = self.at.get(&(block_id, index)) {
+                        if !changed.contains(expression) {
+                            exposed.insert(expression);
+                        }
+                    }
+                    if place.projection.is_empty() {
+                        if let Some(kills) = self.kills.get(&place.local) {
+                            changed.union(kills);
+                        }
+                    }
+                }
+            }
+            antloc.insert(block_id, exposed);
+            killed.insert(block_id, changed);
+        }
+        (antloc, killed)
+    }
+}
+
+/// Expressions computed on every path to a point since their operands last changed
+struct Availability<'a> {
+    universe: &'a ExpressionUniverse,
+}
+
+impl DataFlowAnalysis for Availability<'_> {
+    type Fact = BitSet;
+    
+    fn direction(&self) -> Direction {
+        Direction::Forward
+    }
+    
+    fn initial_fact(&self) -> Self::Fact {
+        BitSet::new_empty(self.universe.expressions.len())
+    }
+    
+    fn bottom(&self) -> Self::Fact {
+        BitSet::new_filled(self.universe.expressions.len())
+    }
+    
+    fn transfer_statement(&self, stmt: &Statement, fact: &mut Self::Fact, location: Location) {
+        if let Statement::Assign { place, .. } = stmt {
+            if let Some(&expression) = self.universe.at.get(&(location.block, location.statement_index.unwrap_or(0))) {
+                fact.insert(expression);
+            }
+            self.universe.kill(place, fact);
+        }
+    }
+    
+    fn transfer_terminator(&self, _term: &Terminator, _fact: &mut Self::Fact, _location: Location) {}
+    
+    fn join(&self, into: &mut Self::Fact, other: &Self::Fact) -> bool {
+        into.intersect(other)
+    }
+}
+
+/// Expressions computed on every path from a point before their operands change
+struct Anticipation<'a> {
+    universe: &'a ExpressionUniverse,
+}
+
+impl DataFlowAnalysis for Anticipation<'_> {
+    type Fact = BitSet;
+    
+    fn direction(&self) -> Direction {
+        Direction::Backward
+    }
+    
+    fn initial_fact(&self) -> Self::Fact {
+        BitSet::new_empty(self.universe.expressions.len())
+    }
+    
+    fn bottom(&self) -> Self::Fact {
+        BitSet::new_filled(self.universe.expressions.len())
+    }
+    
+    fn transfer_statement(&self, stmt: &Statement, fact: &mut Self::Fact, location: Location) {
+        if let Statement::Assign { place, .. } = stmt {
+            self.universe.kill(place, fact);
+            if let Some(&expression) = self.universe.at.get(&(location.block, location.statement_index.unwrap_or(0))) {
+                fact.insert(expression);
+            }
+        }
+    }
+    
+    fn transfer_terminator(&self, term: &Terminator, fact: &mut Self::Fact, _location: Location) {
+        // Nothing is needed on a path that never returns
+        if matches!(term, Terminator::Unreachable | Terminator::Call { target: None, .. }) {
+            fact.clear();
+        }
+    }
+    
+    fn join(&self, into: &mut Self::Fact, other: &Self::Fact) -> bool {
+        into.intersect(other)
+    }
+}
+
+/// Call `f` on every local a statement reads
+fn visit_reads(statement: &Statement, mut f: impl FnMut(LocalId)) {
+    match statement {
+        Statement::Assign { place, rvalue, .. } => {
+            if !place.projection.is_empty() {
+                place.visit_locals(&mut f);
+            }
+            rvalue.visit_locals(&mut f);
+        }
+        Statement::VectorStore { .. } => statement.visit_locals(f),
+        Statement::StorageLive(_) | Statement::StorageDead(_) | Statement::Nop => {}
+    }
+}
+
+fn is_commutative(op: BinOp) -> bool {
+    matches!(op, BinOp::Add | BinOp::Mul | BinOp::BitXor | BinOp::BitAnd | BinOp::BitOr
+        | BinOp::Eq | BinOp::Ne | BinOp::And | BinOp::Or)
+}
+
+fn callee_name(func: &Operand) -> Option<&str> {
+    match func {
+        Operand::Constant(Constant { value: ConstantValue::String(name), .. }) => Some(name),
+        _ => None,
+    }
+}
+
+fn operand_local(operand: &Operand) -> Option<LocalId> {
+    match operand {
+        Operand::Copy(place) | Operand::Move(place) if place.projection.is_empty() => Some(place.local),
+        _ => None,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::mir::Program;
+    
+    fn lower(source: &str) -> Program {
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        crate::mir::lowering::lower_ast_to_mir(&program).unwrap()
+    }
+    
+    fn count(function: &Function, matches: impl Fn(&Rvalue) -> bool) -> usize {
+        function.basic_blocks.values()
+            .flat_map(|block| block.statements.iter())
+            .filter(|statement| matches!(statement, Statement::Assign { rvalue, .. } if matches(rvalue)))
+            .count()
+    }
+    
+    fn multiplies(rvalue: &Rvalue) -> bool {
+        matches!(rvalue, Rvalue::BinaryOp { op: BinOp::Mul, .. })
+    }
+    
+    #[test]
+    fn test_values_reused_across_dominated_blocks() {
+        let mut program = lower(r#"
+(DEFINE_MODULE
+  (NAME gvn)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME area)
+      (ACCEPTS_PARAMETER (NAME "w") (TYPE INTEGER))
+      (ACCEPTS_PARAMETER (NAME "h") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME a) (TYPE INTEGER) (VALUE (EXPRESSION_MULTIPLY w h)))
+        (IF_CONDITION (PREDICATE_GREATER_THAN a 100)
+          (THEN_EXECUTE (RETURN_VALUE (EXPRESSION_MULTIPLY h w))))
+        (RETURN_VALUE (EXPRESSION_ADD a (EXPRESSION_MULTIPLY w h)))))))
+"#);
+        let mut pass = GlobalValueNumberingPass::new();
+        assert!(pass.run_on_program(&mut program).unwrap());
+        
+        assert_eq!(count(&program.functions["area"], multiplies), 1);
+        assert_eq!(pass.redundant_values, 2);
+        assert!(!pass.run_on_program(&mut program).unwrap());
+    }
+    
+    #[test]
+    fn test_partial_redundancy_moved_to_the_other_branch() {
+        let mut program = lower(r#"
+(DEFINE_MODULE
+  (NAME pre)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME scaled)
+      (ACCEPTS_PARAMETER (NAME "a") (TYPE INTEGER))
+      (ACCEPTS_PARAMETER (NAME "b") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME r) (TYPE INTEGER) (MUTABILITY MUTABLE) (VALUE 0))
+        (IF_CONDITION (PREDICATE_GREATER_THAN a 0)
+          (THEN_EXECUTE
+            (ASSIGN (TARGET_VARIABLE r) (SOURCE_EXPRESSION (EXPRESSION_MULTIPLY a b)))))
+        (RETURN_VALUE (EXPRESSION_ADD r (EXPRESSION_MULTIPLY a b)))))))
+"#);
+        let mut pass = GlobalValueNumberingPass::new();
+        assert!(pass.run_on_program(&mut program).unwrap());
+        assert_eq!(pass.partial_redundancies, 1);
+        assert_eq!(pass.remarks().len(), 1);
+        assert!(pass.remarks()[0].message.starts_with("moved 1 partially redundant computation(s)"));
+        
+        // One multiply per branch, none at the join
+        let function = &program.functions["scaled"];
+        assert_eq!(count(function, multiplies), 2);
+        let join = function.basic_blocks.values()
+            .find(|block| matches!(block.terminator, Terminator::Return))
+            .unwrap();
+        assert!(!join.statements.iter().any(|statement| matches!(statement, Statement::Assign { rvalue, .. } if multiplies(rvalue))));
+        
+        assert!(!pass.run_on_program(&mut program).unwrap());
+    }
+    
+    #[test]
+    fn test_loads_forwarded_until_an_aliasing_store() {
+        let mut program = lower(r#"
+(DEFINE_MODULE
+  (NAME loads)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME reload)
+      (ACCEPTS_PARAMETER (NAME "data") (TYPE (ARRAY_OF_TYPE INTEGER)))
+      (ACCEPTS_PARAMETER (NAME "i") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME x) (TYPE INTEGER) (VALUE (GET_ARRAY_ELEMENT data i)))
+        (DECLARE_VARIABLE (NAME y) (TYPE INTEGER) (VALUE (GET_ARRAY_ELEMENT data i)))
+        (SET_ARRAY_ELEMENT data 0 5)
+        (DECLARE_VARIABLE (NAME z) (TYPE INTEGER) (VALUE (GET_ARRAY_ELEMENT data i)))
+        (SET_ARRAY_ELEMENT data i 7)
+        (DECLARE_VARIABLE (NAME w) (TYPE INTEGER) (VALUE (GET_ARRAY_ELEMENT data i)))
+        (RETURN_VALUE (EXPRESSION_ADD (EXPRESSION_ADD x y) (EXPRESSION_ADD z w)))))))
+"#);
+        let mut pass = GlobalValueNumberingPass::new();
+        assert!(pass.run_on_program(&mut program).unwrap());
+        
+        // `y` reuses `x` and `w` the stored 7; `z` may see the first store
+        let loads = count(&program.functions["reload"], |rvalue| matches!(
+            rvalue,
+            Rvalue::Call { func, .. } if callee_name(func) == Some("array_get")
+        ));
+        assert_eq!(loads, 2);
+        assert_eq!(pass.forwarded_loads, 2);
+    }
+}
@@ -14,14 +14,29 @@
 
 //! Function inlining optimization pass
 //! 
-//! Inlines small functions to reduce call overhead
+//! Inlines calls bottom-up over the strongly connected components of the
+//! call graph, so a callee is already in its final shape when its callers
+//! weigh it. Each call site is judged by a cost model: the callee's size
+//! against a budget raised for constant arguments, calls inside loops, and
+//! call sites the profile marks hot. The program holds the functions of
+//! every module, so calls across modules are inlined like any other.
+//! Calls through a local that can only hold one known function are first
+//! rewritten to call it directly.
 
+use super::loop_optimizations::LoopOptimizationPass;
+use super::profile_guided::InlineDecision;
+use super::remarks::{self, Remark};
 use super::OptimizationPass;
-use std::collections::HashSet;
-use crate::mir::{Function, Program, Statement, Terminator, Rvalue, Operand, Place, LocalId,
-                 BasicBlockId, SourceInfo};
+use crate::mir::{BasicBlock, BasicBlockId, Constant, ConstantValue, Function, LocalId, Operand, Place, Program,
+                 Rvalue, Statement, Terminator};
 use crate::error::SemanticError;
-use std::collections::HashMap;
+use std::collections::{BTreeMap, HashMap, HashSet};
+
+/// Budget added per constant argument, which usually folds away code
+const CONSTANT_ARGUMENT_BONUS: usize = 5;
+
+/// Budget added per loop the call site sits in
+const LOOP_DEPTH_BONUS: usize = 10;
 
 /// Function inlining optimization pass
 #[derive(Debug)]
@@ -29,15 +44,41 @@ pub struct InliningPass {
     /// Inlining threshold (e.g., number of statements)
     threshold: usize,
     
-    /// Functions already inlined to prevent recursion
-    inlined_functions: HashSet<String>,
+    /// Longest chain of calls that may be inlined into one function
+    max_depth: usize,
+    
+    /// Inlining chain depth already inside each function
+    inline_depth: HashMap<String, usize>,
+    
+    /// Profile advice per call site, keyed `caller::callee`
+    call_site_decisions: HashMap<String, InlineDecision>,
+    
+    remarks: Vec<Remark>,
+    inlined_calls: usize,
+    devirtualized_calls: usize,
 }
 
+/// Position of a call statement: (block, statement index)
+type CallSite = (BasicBlockId, usize);
+
 impl InliningPass {
     pub fn new() -> Self {
         Self {
             threshold: 20,
-            inlined_functions: HashSet::new(),
+            max_depth: 3,
+            inline_depth: HashMap::new(),
+            call_site_decisions: HashMap::new(),
+            remarks: Vec::new(),
+            inlined_calls: 0,
+            devirtualized_calls: 0,
+        }
+    }
+    
+    /// Create an inliner that follows profile advice for each call site
+    pub fn with_call_site_decisions(decisions: HashMap<String, InlineDecision>) -> Self {
+        Self {
+            call_site_decisions: decisions,
+            ..Self::new()
         }
     }
     
@@ -48,6 +89,7 @@ impl InliningPass {
     
     /// Set the maximum inlining depth
     pub fn set_max_inline_depth(&mut self, depth: usize) {
+        self.max_depth = depth;
     }
     
     /// Calculate the "cost" of a function for inlining decisions
@@ -68,42 +110,170 @@ impl InliningPass {
         cost
     }
     
-    /// Check if a function is suitable for inlining
-    fn should_inline(&self, function: &Function) -> bool {
-        // Don't inline recursive functions (basic check)
-        if self.has_recursive_calls(function) {
-            return false;
+    /// Whether `function` calls itself directly
+    fn has_recursive_calls(&self, function: &Function) -> bool {
+        callees(function).contains(function.name.as_str())
+    }
+    
+    /// Size budget for inlining `callee` at one call site of `caller`
+    ///
+    /// `None` means the profile rules the call site out.
+    fn budget(&self, caller: &str, callee: &str, args: &[Operand], loop_depth: usize) -> Option<usize> {
+        let constant_args = args.iter().filter(|arg| matches!(arg, Operand::Constant(_))).count();
+        let budget = self.threshold + CONSTANT_ARGUMENT_BONUS * constant_args + LOOP_DEPTH_BONUS * loop_depth;
+        match self.call_site_decisions.get(&format!("{}::{}", caller, callee)) {
+            Some(InlineDecision::NeverInline) => None,
+            Some(InlineDecision::AlwaysInline) => Some(budget * 4),
+            Some(InlineDecision::InlineHot) => Some(budget * 2),
+            Some(InlineDecision::Default) | None => Some(budget),
         }
-        
-        // Check size constraints
-        let cost = self.calculate_function_cost(function);
-        cost <= self.threshold
     }
     
-    /// Basic check for recursive calls
-    fn has_recursive_calls(&self, function: &Function) -> bool {
+    /// Point calls through a local at the one function it can hold
+    fn devirtualize(&mut self, function: &mut Function, known: &HashSet<String>) -> usize {
+        // A call terminator's destination is recorded as `None`
+        let mut definitions: HashMap<LocalId, Vec<Option<&Rvalue>>> = HashMap::new();
         for block in function.basic_blocks.values() {
             for statement in &block.statements {
+                if let Statement::Assign { place, rvalue, .. } = statement {
+                    definitions.entry(place.local).or_default().push(Some(rvalue));
+                }
+            }
+            if let Terminator::Call { destination, .. } = &block.terminator {
+                definitions.entry(destination.local).or_default().push(None);
+            }
+        }
+        let parameters: HashSet<LocalId> = function.parameters.iter().map(|p| p.local_id).collect();
+        let target = |operand: &Operand| -> Option<String> {
+            let mut local = match operand {
+                Operand::Copy(place) | Operand::Move(place) if place.projection.is_empty() => place.local,
+                _ => return None,
+            };
+            let mut visited = HashSet::new();
+            while visited.insert(local) && !parameters.contains(&local) {
+                match definitions.get(&local).map(Vec::as_slice) {
+                    Some([Some(Rvalue::Use(Operand::Constant(Constant { value: ConstantValue::String(name), .. })))])
+                        if known.contains(name) => return Some(name.clone()),
+                    Some([Some(Rvalue::Use(Operand::Copy(place) | Operand::Move(place)))]) if place.projection.is_empty() => {
+                        local = place.local;
+                    }
+                    _ => return None,
+                }
+            }
+            None
+        };
+        
+        let mut rewrites = Vec::new();
+        for (block_id, block) in &function.basic_blocks {
+            for (index, statement) in block.statements.iter().enumerate() {
                 if let Statement::Assign { rvalue: Rvalue::Call { func, .. }, .. } = statement {
-                    if let Operand::Constant(_constant) = func {
-                        // In a real implementation, we'd check if the constant refers to the same function
-                        // For now, just assume no recursion
+                    if let Some(name) = target(func) {
+                        rewrites.push((block_id, Some(index), name));
                     }
                 }
             }
-            
             if let Terminator::Call { func, .. } = &block.terminator {
-                if let Operand::Constant(_constant) = func {
-                    // Same as above - in practice we'd need better function identification
+                if let Some(name) = target(func) {
+                    rewrites.push((block_id, None, name));
                 }
             }
         }
         
-        false // Conservative: assume no recursion for now
+        for (block_id, index, name) in &rewrites {
+            let block = &mut function.basic_blocks[*block_id];
+            let func = match index {
+                Some(index) => match &mut block.statements[*index] {
+                    Statement::Assign { rvalue: Rvalue::Call { func, .. }, .. } => func,
+                    _ => unreachable!(),
+                },
+                None => match &mut block.terminator {
+                    Terminator::Call { func, .. } => func,
+                    _ => unreachable!(),
+                },
+            };
+            *func = Operand::Constant(Constant {
+                ty: crate::types::Type::primitive(crate::ast::PrimitiveType::String),
+                value: ConstantValue::String(name.clone()),
+            });
+            self.remark(Remark::applied(self.name(), &function.name, format!("devirtualized call to `{}`", name)));
+        }
+        rewrites.len()
     }
     
+    /// Record a remark once, however many times the pipeline reruns the pass
+    fn remark(&mut self, remark: Remark) {
+        remarks::record(&mut self.remarks, remark);
+    }
     
-    
+    /// Inline the calls of `caller` that the cost model accepts
+    fn inline_calls(&mut self, caller: &mut Function, program: &Program, recursive: &HashSet<String>) -> Result<bool, SemanticError> {
+        let mut loop_analysis = LoopOptimizationPass::new();
+        loop_analysis.analyze_function(caller)?;
+        let mut loop_depth: HashMap<BasicBlockId, usize> = HashMap::new();
+        for loop_info in loop_analysis.loops() {
+            for &block in &loop_info.blocks {
+                *loop_depth.entry(block as BasicBlockId).or_insert(0) += 1;
+            }
+        }
+        
+        // Blocks to scan, each from a statement index on
+        let mut worklist: Vec<CallSite> = caller.basic_blocks.ids().map(|id| (id, 0)).collect();
+        worklist.sort_unstable_by(|a, b| b.cmp(a));
+        let mut changed = false;
+        
+        while let Some((block_id, start)) = worklist.pop() {
+            let site = caller.basic_blocks[block_id].statements.iter().enumerate().skip(start).find_map(|(index, statement)| {
+                match statement {
+                    Statement::Assign { rvalue: Rvalue::Call { func, args }, .. } => match callee_name(func) {
+                        Some(name) if program.functions.contains_key(name) || recursive.contains(name) => {
+                            Some((index, name.to_string(), args.clone()))
+                        }
+                        _ => None,
+                    },
+                    _ => None,
+                }
+            });
+            let (index, callee_name, args) = match site {
+                Some(site) => site,
+                None => continue,
+            };
+            
+            let depth = loop_depth.get(&block_id).copied().unwrap_or(0);
+            let callee = program.functions.get(&callee_name).filter(|_| !recursive.contains(&callee_name));
+            let cost = callee.map_or(0, |callee| self.calculate_function_cost(callee));
+            let callee_depth = self.inline_depth.get(&callee_name).copied().unwrap_or(0);
+            let verdict = match (callee, self.budget(&caller.name, &callee_name, &args, depth)) {
+                (None, _) => Err("recursive call".to_string()),
+                (_, None) => Err("profile marks the call site cold".to_string()),
+                (Some(_), Some(budget)) if cost > budget => Err(format!("cost {} exceeds budget {}", cost, budget)),
+                (Some(_), Some(_)) if callee_depth >= self.max_depth => Err(format!("inlining depth {} reached", self.max_depth)),
+                (Some(callee), Some(_)) if callee.parameters.len() != args.len() => Err("argument count mismatch".to_string()),
+                (Some(callee), Some(budget)) => Ok((callee, budget)),
+            };
+            let (callee, budget) = match verdict {
+                Ok(accepted) => accepted,
+                Err(reason) => {
+                    self.remark(Remark::missed(self.name(), &caller.name,
+                        format!("`{}` not inlined: {}", callee_name, reason)));
+                    worklist.push((block_id, index + 1));
+                    continue;
+                }
+            };
+            self.remark(Remark::applied(self.name(), &caller.name,
+                format!("inlined `{}` (cost {}, budget {})", callee_name, cost, budget)));
+            
+            let continuation = inline_call(caller, (block_id, index), callee);
+            loop_depth.insert(continuation, depth);
+            worklist.push((continuation, 0));
+            
+            let caller_depth = self.inline_depth.entry(caller.name.clone()).or_insert(0);
+            *caller_depth = (*caller_depth).max(callee_depth + 1);
+            self.inlined_calls += 1;
+            changed = true;
+        }
+        
+        Ok(changed)
+    }
 }
 
 impl OptimizationPass for InliningPass {
@@ -112,58 +282,240 @@ impl OptimizationPass for InliningPass {
     }
     
     fn run_on_function(&mut self, _function: &mut Function) -> Result<bool, SemanticError> {
-        // Single function inlining requires access to the whole program
-        // For now, return false (no changes)
+        // Inlining needs the callees, which only the whole program has
         Ok(false)
     }
     
     fn run_on_program(&mut self, program: &mut Program) -> Result<bool, SemanticError> {
-        let changed = false;
+        let known: HashSet<String> = program.functions.keys()
+            .chain(program.external_functions.keys())
+            .cloned()
+            .collect();
+        let mut devirtualized = 0;
+        for function in program.functions.values_mut() {
+            devirtualized += self.devirtualize(function, &known);
+        }
+        self.devirtualized_calls += devirtualized;
         
-        // Find functions that are candidates for inlining
-        let mut inline_candidates = Vec::new();
+        let components = call_graph_components(program);
+        let recursive: HashSet<String> = components.iter()
+            .filter(|component| component.len() > 1 || self.has_recursive_calls(&program.functions[&component[0]]))
+            .flatten()
+            .cloned()
+            .collect();
         
-        for (name, function) in &program.functions {
-            if self.should_inline(function) {
-                inline_candidates.push(name.clone());
-            }
+        let mut changed = devirtualized > 0;
+        for name in components.iter().flatten() {
+            let mut caller = match program.functions.remove(name) {
+                Some(caller) => caller,
+                None => continue,
+            };
+            let result = self.inline_calls(&mut caller, program, &recursive);
+            program.functions.insert(name.clone(), caller);
+            changed |= result?;
         }
         
-        // For each function, look for calls to inline candidates
-        for (caller_name, caller_function) in &mut program.functions {
-            if inline_candidates.contains(caller_name) {
-                continue; // Don't modify functions we're trying to inline
+        Ok(changed)
+    }
+    
+    fn remarks(&self) -> &[Remark] {
+        &self.remarks
+    }
+    
+    fn statistics(&self) -> Vec<(&'static str, usize)> {
+        vec![
+            ("calls inlined", self.inlined_calls),
+            ("calls devirtualized", self.devirtualized_calls),
+        ]
+    }
+}
+
+impl Default for InliningPass {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+fn callee_name(func: &Operand) -> Option<&str> {
+    match func {
+        Operand::Constant(Constant { value: ConstantValue::String(name), .. }) => Some(name),
+        _ => None,
+    }
+}
+
+/// Names of the functions `function` calls directly
+fn callees(function: &Function) -> HashSet<&str> {
+    let mut names = HashSet::new();
+    for block in function.basic_blocks.values() {
+        for statement in &block.statements {
+            if let Statement::Assign { rvalue: Rvalue::Call { func, .. }, .. } = statement {
+                names.extend(callee_name(func));
             }
+        }
+        if let Terminator::Call { func, .. } = &block.terminator {
+            names.extend(callee_name(func));
+        }
+    }
+    names
+}
+
+/// Strongly connected components of the call graph, callees before callers
+///
+/// Tarjan's algorithm emits components in reverse topological order, which
+/// is the bottom-up order the inliner wants.
+fn call_graph_components(program: &Program) -> Vec<Vec<String>> {
+    let names: BTreeMap<&str, usize> = program.functions.keys()
+        .map(String::as_str)
+        .collect::<std::collections::BTreeSet<_>>()
+        .into_iter()
+        .enumerate()
+        .map(|(index, name)| (name, index))
+        .collect();
+    let order: Vec<&str> = names.keys().copied().collect();
+    let edges: Vec<Vec<usize>> = order.iter()
+        .map(|name| {
+            let mut targets: Vec<usize> = callees(&program.functions[*name]).into_iter()
+                .filter_map(|callee| names.get(callee).copied())
+                .collect();
+            targets.sort_unstable();
+            targets
+        })
+        .collect();
+    
+    struct Tarjan<'a> {
+        edges: &'a [Vec<usize>],
+        index: Vec<Option<usize>>,
+        low: Vec<usize>,
+        on_stack: Vec<bool>,
+        stack: Vec<usize>,
+        next: usize,
+        components: Vec<Vec<usize>>,
+    }
+    
+    impl Tarjan<'_> {
+        fn visit(&mut self, node: usize) {
+            self.index[node] = Some(self.next);
+            self.low[node] = self.next;
+            self.next += 1;
+            self.stack.push(node);
+            self.on_stack[node] = true;
             
-            // Look for calls in each basic block
-            for block in caller_function.basic_blocks.values_mut() {
-                let mut new_statements = Vec::new();
-                
-                for statement in &block.statements {
-                    match statement {
-                        Statement::Assign { place: _, rvalue: Rvalue::Call { func: _, args: _ }, source_info: _ } => {
-                            // Check if this is a call to an inline candidate
-                            // This is simplified - in practice we'd need better function identification
-                            new_statements.push(statement.clone());
-                        }
-                        _ => {
-                            new_statements.push(statement.clone());
-                        }
+            for &target in &self.edges[node] {
+                match self.index[target] {
+                    None => {
+                        self.visit(target);
+                        self.low[node] = self.low[node].min(self.low[target]);
+                    }
+                    Some(index) if self.on_stack[target] => self.low[node] = self.low[node].min(index),
+                    Some(_) => {}
+                }
+            }
+            
+            if Some(self.low[node]) == self.index[node] {
+                let mut component = Vec::new();
+                while let Some(member) = self.stack.pop() {
+                    self.on_stack[member] = false;
+                    component.push(member);
+                    if member == node {
+                        break;
                     }
                 }
-                
-                block.statements = new_statements;
+                self.components.push(component);
             }
         }
-        
-        Ok(changed)
     }
+    
+    let mut tarjan = Tarjan {
+        edges: &edges,
+        index: vec![None; order.len()],
+        low: vec![0; order.len()],
+        on_stack: vec![false; order.len()],
+        stack: Vec::new(),
+        next: 0,
+        components: Vec::new(),
+    };
+    for node in 0..order.len() {
+        if tarjan.index[node].is_none() {
+            tarjan.visit(node);
+        }
+    }
+    
+    tarjan.components.into_iter()
+        .map(|component| component.into_iter().map(|node| order[node].to_string()).collect())
+        .collect()
 }
 
-impl Default for InliningPass {
-    fn default() -> Self {
-        Self::new()
+/// Move the statements of `block_id` from `index` on, and its terminator,
+/// into a new block that `block_id` jumps to
+fn split_block(function: &mut Function, block_id: BasicBlockId, index: usize) -> BasicBlockId {
+    let block = &mut function.basic_blocks[block_id];
+    let statements = block.statements.split_off(index);
+    let terminator = std::mem::replace(&mut block.terminator, Terminator::Unreachable);
+    let continuation = new_block(function, statements, terminator);
+    function.basic_blocks[block_id].terminator = Terminator::Goto { target: continuation };
+    continuation
+}
+
+fn new_block(function: &mut Function, statements: Vec<Statement>, terminator: Terminator) -> BasicBlockId {
+    let id = function.basic_blocks.id_bound() as BasicBlockId;
+    function.basic_blocks.insert(id, BasicBlock { id, statements, terminator });
+    id
+}
+
+/// Replace the call at `site` in `caller` with a copy of `callee`'s body
+///
+/// Returns the block holding the statements that followed the call.
+fn inline_call(caller: &mut Function, (block_id, index): CallSite, callee: &Function) -> BasicBlockId {
+    let continuation = split_block(caller, block_id, index + 1);
+    let (destination, args, source_info) = match caller.basic_blocks[block_id].statements.pop() {
+        Some(Statement::Assign { place, rvalue: Rvalue::Call { args, .. }, source_info }) => (place, args, source_info),
+        _ => unreachable!("inline_call is only given call statements"),
+    };
+    
+    let locals: HashMap<LocalId, LocalId> = callee.locals.iter()
+        .map(|(id, local)| (id, caller.locals.push(local.clone())))
+        .collect();
+    let blocks: HashMap<BasicBlockId, BasicBlockId> = callee.basic_blocks.ids()
+        .map(|id| (id, new_block(caller, Vec::new(), Terminator::Unreachable)))
+        .collect();
+    
+    // Parameters become ordinary locals holding the arguments
+    let call_block = &mut caller.basic_blocks[block_id];
+    for (parameter, arg) in callee.parameters.iter().zip(args) {
+        call_block.statements.push(Statement::Assign {
+            place: Place { local: locals[&parameter.local_id], projection: vec![] },
+            rvalue: Rvalue::Use(arg),
+            source_info: source_info.clone(),
+        });
+    }
+    call_block.terminator = Terminator::Goto { target: blocks[&callee.entry_block] };
+    
+    for (id, block) in &callee.basic_blocks {
+        let mut statements = block.statements.clone();
+        for statement in &mut statements {
+            statement.visit_locals_mut(|local| *local = locals[local]);
+        }
+        let mut terminator = block.terminator.clone();
+        terminator.visit_locals_mut(|local| *local = locals[local]);
+        terminator.visit_targets_mut(|target| *target = blocks[target]);
+        
+        if let Terminator::Return = terminator {
+            if let Some(result) = callee.return_local {
+                statements.push(Statement::Assign {
+                    place: destination.clone(),
+                    rvalue: Rvalue::Use(Operand::Copy(Place { local: locals[&result], projection: vec![] })),
+                    source_info: source_info.clone(),
+                });
+            }
+            terminator = Terminator::Goto { target: continuation };
+        }
+        
+        let inlined = &mut caller.basic_blocks[blocks[&id]];
+        inlined.statements = statements;
+        inlined.terminator = terminator;
     }
+    
+    continuation
 }
 
 #[cfg(test)]
@@ -173,6 +525,7 @@ mod tests {
     use crate::types::Type;
     use crate::ast::PrimitiveType;
     use crate::error::SourceLocation;
+    use crate::optimizations::remarks::RemarkKind;
     
     #[test]
     fn test_function_cost_calculation() {
@@ -237,8 +590,9 @@ mod tests {
         
         let function = builder.finish_function();
         
-        // Small function should be eligible for inlining
-        assert!(pass.should_inline(&function));
+        // Small function should be eligible for inlining at a plain call site
+        assert!(!pass.has_recursive_calls(&function));
+        assert!(pass.calculate_function_cost(&function) <= pass.budget("caller", "small", &[], 0).unwrap());
     }
     
     #[test]
@@ -281,4 +635,105 @@ mod tests {
         // Function should still exist (not actually inlined in this simplified implementation)
         assert!(program.functions.contains_key("small"));
     }
-}
\ No newline at end of file
+    
+    fn lower(source: &str) -> Program {
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        crate::mir::lowering::lower_ast_to_mir(&program).unwrap()
+    }
+    
+    const CALLS: &str = r#"
+(DEFINE_MODULE
+  (NAME inl)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME square)
+      (ACCEPTS_PARAMETER (NAME "x") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (RETURN_VALUE (EXPRESSION_MULTIPLY x x))))
+    (DEFINE_FUNCTION
+      (NAME fact)
+      (ACCEPTS_PARAMETER (NAME "n") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (IF_CONDITION (PREDICATE_LESS_THAN n 2)
+          (THEN_EXECUTE (RETURN_VALUE 1)))
+        (RETURN_VALUE (EXPRESSION_MULTIPLY n (CALL_FUNCTION fact (EXPRESSION_SUBTRACT n 1))))))
+    (DEFINE_FUNCTION
+      (NAME sum_squares)
+      (ACCEPTS_PARAMETER (NAME "n") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME total) (TYPE INTEGER) (VALUE 0))
+        (DECLARE_VARIABLE (NAME i) (TYPE INTEGER) (VALUE 0))
+        (LOOP_WHILE_CONDITION (PREDICATE_LESS_THAN i n)
+          (ITERATION_BODY
+            (ASSIGN (TARGET_VARIABLE total) (SOURCE_EXPRESSION (EXPRESSION_ADD total (CALL_FUNCTION square i))))
+            (ASSIGN (TARGET_VARIABLE i) (SOURCE_EXPRESSION (EXPRESSION_ADD i 1)))))
+        (RETURN_VALUE (EXPRESSION_ADD total (CALL_FUNCTION fact 5)))))))
+"#;
+    
+    #[test]
+    fn test_bottom_up_inlining_with_cost_model() {
+        let mut program = lower(CALLS);
+        let mut pass = InliningPass::new();
+        assert!(pass.run_on_program(&mut program).unwrap());
+        
+        let caller = &program.functions["sum_squares"];
+        let remaining = callees(caller);
+        assert!(!remaining.contains("square"));
+        assert!(remaining.contains("fact"));
+        assert!(crate::mir::validation::Validator::new().validate_function(caller).is_ok());
+        
+        assert!(pass.remarks().iter().any(|remark| remark.kind == RemarkKind::Applied
+            && remark.message.starts_with("inlined `square`")));
+        assert!(pass.remarks().iter().any(|remark| remark.message == "`fact` not inlined: recursive call"));
+        assert!(pass.statistics().contains(&("calls inlined", 1)));
+        
+        // A second run finds nothing new and repeats no remarks
+        let remarks = pass.remarks().len();
+        assert!(!pass.run_on_program(&mut program).unwrap());
+        assert_eq!(pass.remarks().len(), remarks);
+    }
+    
+    #[test]
+    fn test_profile_and_devirtualization() {
+        let mut program = lower(CALLS);
+        
+        // Route the call to `square` through a local holding the function
+        let caller = program.functions.get_mut("sum_squares").unwrap();
+        let target = caller.locals.push(crate::mir::Local {
+            ty: Type::primitive(PrimitiveType::String),
+            is_mutable: false,
+            source_info: None,
+        });
+        let entry = caller.entry_block;
+        for block in caller.basic_blocks.values_mut() {
+            for statement in &mut block.statements {
+                if let Statement::Assign { rvalue: Rvalue::Call { func, .. }, .. } = statement {
+                    if callee_name(func) == Some("square") {
+                        *func = Operand::Copy(Place { local: target, projection: vec![] });
+                    }
+                }
+            }
+        }
+        caller.basic_blocks[entry].statements.insert(0, Statement::Assign {
+            place: Place { local: target, projection: vec![] },
+            rvalue: Rvalue::Use(Operand::Constant(Constant {
+                ty: Type::primitive(PrimitiveType::String),
+                value: ConstantValue::String("square".to_string()),
+            })),
+            source_info: SourceInfo { span: SourceLocation::unknown(), scope: 0 },
+        });
+        
+        let mut decisions = HashMap::new();
+        decisions.insert("sum_squares::square".to_string(), InlineDecision::NeverInline);
+        let mut pass = InliningPass::with_call_site_decisions(decisions);
+        assert!(pass.run_on_program(&mut program).unwrap());
+        
+        assert!(callees(&program.functions["sum_squares"]).contains("square"));
+        assert!(pass.statistics().contains(&("calls devirtualized", 1)));
+        assert!(pass.remarks().iter().any(|remark| remark.message == "`square` not inlined: profile marks the call site cold"));
+    }
+}
@@ -17,10 +17,10 @@
 //! Performs analysis and optimizations that span multiple functions,
 //! including global constant propagation, escape analysis, and side effect analysis.
 
-use crate::mir::{Function, Program, BasicBlock, Statement, Rvalue, Operand, Place, Terminator, Constant};
+use crate::mir::{Function, Program, BasicBlock, Statement, Rvalue, Operand, Place, Terminator, Constant, ConstantValue, LocalId};
 use crate::error::SemanticError;
 use crate::optimizations::OptimizationPass;
-use std::collections::{HashMap, HashSet};
+use std::collections::{BTreeMap, HashMap, HashSet};
 
 /// Interprocedural analysis pass
 #[derive(Debug)]
@@ -89,6 +89,102 @@ pub struct EscapeAnalysis {
     returned_variables: HashMap<String, HashSet<Place>>,
 }
 
+impl EscapeAnalysis {
+    /// Partition the locals of `function` into classes joined by whole-value
+    /// copies `a = b`, which leave both naming the same allocation
+    pub fn copy_classes(function: &Function) -> Vec<Vec<LocalId>> {
+        let mut parent: HashMap<LocalId, LocalId> = function.locals.ids().map(|id| (id, id)).collect();
+        fn find(parent: &mut HashMap<LocalId, LocalId>, mut local: LocalId) -> LocalId {
+            while parent[&local] != local {
+                let grandparent = parent[&parent[&local]];
+                parent.insert(local, grandparent);
+                local = grandparent;
+            }
+            local
+        }
+        
+        for block in function.basic_blocks.values() {
+            for statement in &block.statements {
+                if let Statement::Assign { place, rvalue: Rvalue::Use(Operand::Copy(source) | Operand::Move(source)), .. } = statement {
+                    if place.projection.is_empty() && source.projection.is_empty()
+                        && parent.contains_key(&place.local) && parent.contains_key(&source.local)
+                    {
+                        let (a, b) = (find(&mut parent, place.local), find(&mut parent, source.local));
+                        parent.insert(a, b);
+                    }
+                }
+            }
+        }
+        
+        let mut classes: BTreeMap<LocalId, Vec<LocalId>> = BTreeMap::new();
+        for id in function.locals.ids() {
+            let root = find(&mut parent, id);
+            classes.entry(root).or_default().push(id);
+        }
+        classes.into_values().collect()
+    }
+    
+    /// Locals whose value may outlive `function` or be seen by a callee
+    ///
+    /// A copy class escapes as a whole. Element accesses through the runtime
+    /// array accessors and field accesses through projections do not escape.
+    pub fn escaping_locals(function: &Function) -> HashSet<LocalId> {
+        let mut escaping: HashSet<LocalId> = function.parameters.iter().map(|p| p.local_id).collect();
+        escaping.extend(function.return_local);
+        
+        fn escape(operand: &Operand, escaping: &mut HashSet<LocalId>) {
+            if let Operand::Copy(place) | Operand::Move(place) = operand {
+                if place.projection.is_empty() {
+                    escaping.insert(place.local);
+                }
+            }
+        }
+        
+        for block in function.basic_blocks.values() {
+            for statement in &block.statements {
+                match statement {
+                    Statement::Assign { place, rvalue, .. } => match rvalue {
+                        Rvalue::Use(Operand::Copy(source) | Operand::Move(source))
+                            if place.projection.is_empty() && source.projection.is_empty() => {}
+                        Rvalue::Call { func, args } => {
+                            let callee = match func {
+                                Operand::Constant(Constant { value: ConstantValue::String(name), .. }) => name.as_str(),
+                                _ => "",
+                            };
+                            // The runtime accessors do not keep the array handle
+                            let accessor = matches!(callee,
+                                "array_get" | "array_get_unchecked" | "array_set" | "array_set_unchecked" | "array_length");
+                            for (i, arg) in args.iter().enumerate() {
+                                if !(accessor && i == 0) {
+                                    escape(arg, &mut escaping);
+                                }
+                            }
+                        }
+                        Rvalue::Use(operand) => escape(operand, &mut escaping),
+                        Rvalue::VectorLoad { index, .. } => escape(index, &mut escaping),
+                        _ => rvalue.visit_locals(&mut |local| { escaping.insert(local); }),
+                    },
+                    Statement::VectorStore { value, .. } => escape(value, &mut escaping),
+                    Statement::StorageLive(_) | Statement::StorageDead(_) | Statement::Nop => {}
+                }
+            }
+            
+            match &block.terminator {
+                Terminator::Call { args, .. } => args.iter().for_each(|arg| escape(arg, &mut escaping)),
+                Terminator::Drop { place, .. } => { escaping.insert(place.local); }
+                _ => {}
+            }
+        }
+        
+        for class in Self::copy_classes(function) {
+            if class.iter().any(|local| escaping.contains(local)) {
+                escaping.extend(class);
+            }
+        }
+        escaping
+    }
+}
+
 /// Global constant propagation analysis
 #[derive(Debug, Default)]
 pub struct GlobalConstantAnalysis {
@@ -675,10 +771,15 @@ impl InterproceduralAnalysisPass {
         escaping: &mut HashSet<Place>,
         local: &mut HashSet<Place>,
         passed: &mut HashSet<Place>,
-        _returned: &mut HashSet<Place>,
+        returned: &mut HashSet<Place>,
     ) -> Result<(), SemanticError> {
-        // This is a simplified escape analysis
-        // A real implementation would be much more sophisticated
+        let escaping_locals = EscapeAnalysis::escaping_locals(function);
+        for &local in &escaping_locals {
+            escaping.insert(Place { local, projection: vec![] });
+        }
+        if let Some(local) = function.return_local {
+            returned.insert(Place { local, projection: vec![] });
+        }
         
         for block in function.basic_blocks.values() {
             for statement in &block.statements {
@@ -686,29 +787,22 @@ impl InterproceduralAnalysisPass {
                     Statement::Assign { place, rvalue, .. } => {
                         match rvalue {
                             Rvalue::Call { args, .. } => {
-                                // Arguments to function calls may escape
                                 for arg in args {
                                     if let Operand::Move(arg_place) | Operand::Copy(arg_place) = arg {
-                                        escaping.insert(arg_place.clone());
                                         passed.insert(arg_place.clone());
                                     }
                                 }
                             }
-                            _ => {
+                            _ if !escaping_locals.contains(&place.local) => {
                                 // Local assignment
                                 local.insert(place.clone());
                             }
+                            _ => {}
                         }
                     }
                     _ => {}
                 }
             }
-            
-            // Check terminator for returns
-            if let Terminator::Return = &block.terminator {
-                // The return value escapes
-                // In a real implementation, we'd track what's being returned
-            }
         }
         
         Ok(())
@@ -20,7 +20,6 @@
 use crate::mir::{Function, BasicBlock, Statement, Rvalue, Operand, Place, Terminator, BinOp};
 use crate::error::SemanticError;
 use crate::optimizations::OptimizationPass;
-use crate::types::Type;
 use std::collections::{HashMap, HashSet, VecDeque};
 
 /// Advanced loop optimization pass
@@ -124,6 +123,93 @@ pub struct DominanceInfo {
     pub dom_frontier: HashMap<usize, HashSet<usize>>,
 }
 
+impl DominanceInfo {
+    /// Dominator tree of the blocks reachable in `function`
+    ///
+    /// Iterates immediate dominators over reverse postorder (Cooper, Harvey
+    /// and Kennedy), which settles in two or three sweeps even on large
+    /// functions. Children in `dom_tree` are listed in reverse postorder.
+    pub fn compute(function: &Function) -> Self {
+        let cfg = function.cfg();
+        let order = cfg.reverse_postorder();
+        let mut info = Self::default();
+        
+        // Immediate dominators by reverse postorder position
+        let mut idom: Vec<Option<usize>> = vec![None; order.len()];
+        if order.is_empty() {
+            return info;
+        }
+        idom[0] = Some(0);
+        
+        let mut changed = true;
+        while changed {
+            changed = false;
+            for position in 1..order.len() {
+                let mut new_idom = None;
+                for &pred in cfg.predecessors(order[position]) {
+                    let pred = match cfg.rpo_index(pred) {
+                        Some(pred) if idom[pred].is_some() => pred,
+                        _ => continue,
+                    };
+                    new_idom = Some(match new_idom {
+                        Some(current) => Self::common_dominator(&idom, pred, current),
+                        None => pred,
+                    });
+                }
+                if new_idom.is_some() && idom[position] != new_idom {
+                    idom[position] = new_idom;
+                    changed = true;
+                }
+            }
+        }
+        
+        for position in 1..order.len() {
+            if let Some(parent) = idom[position] {
+                let (block, parent) = (order[position] as usize, order[parent] as usize);
+                info.idom.insert(block, parent);
+                info.dom_tree.entry(parent).or_insert_with(Vec::new).push(block);
+            }
+        }
+        
+        info
+    }
+    
+    /// Nearest common dominator of two positions whose dominators are known
+    fn common_dominator(idom: &[Option<usize>], mut a: usize, mut b: usize) -> usize {
+        while a != b {
+            while a > b {
+                a = idom[a].unwrap();
+            }
+            while b > a {
+                b = idom[b].unwrap();
+            }
+        }
+        a
+    }
+    
+    /// Whether block `a` dominates block `b`
+    pub fn dominates(&self, a: usize, b: usize) -> bool {
+        if a == b {
+            return true;
+        }
+        
+        let mut current = b;
+        while let Some(&idom) = self.idom.get(&current) {
+            if idom == a {
+                return true;
+            }
+            current = idom;
+        }
+        
+        false
+    }
+    
+    /// Blocks immediately dominated by `block`
+    pub fn children(&self, block: usize) -> &[usize] {
+        self.dom_tree.get(&block).map_or(&[], |children| children.as_slice())
+    }
+}
+
 /// Loop invariant analysis
 #[derive(Debug, Default)]
 pub struct LoopInvariantAnalysis {
@@ -286,128 +372,41 @@ impl LoopOptimizationPass {
         // Step 5: Analyze induction variables
         self.analyze_induction_variables(function)?;
         
-        // Step 6: Analyze data dependencies
+        // Step 6: Derive loop bounds from the exit tests
+        self.analyze_loop_bounds(function);
+        
+        // Step 7: Analyze data dependencies
         self.analyze_data_dependencies(function)?;
         
         Ok(())
     }
     
+    /// Loops found by the last `analyze_function`
+    pub fn loops(&self) -> &[LoopInfo] {
+        &self.loops
+    }
+    
+    /// Basic induction variables of the loop headed by `header`
+    pub fn basic_induction_vars(&self, header: usize) -> &[BasicInductionVar] {
+        self.induction_analysis.basic_induction_vars.get(&header).map_or(&[], |ivs| ivs.as_slice())
+    }
+    
+    /// Whether block `a` dominates block `b` in the last analyzed function
+    pub fn block_dominates(&self, a: usize, b: usize) -> bool {
+        self.dominates(a, b)
+    }
+    
     /// Build dominance information
     fn build_dominance_info(&mut self, function: &Function) -> Result<(), SemanticError> {
-        let blocks: Vec<usize> = function.basic_blocks.keys().copied().map(|id| id as usize).collect();
-        if blocks.is_empty() {
-            return Ok(());
-        }
-        
-        // Find entry block (assume block 0)
-        let entry = blocks[0];
-        
-        // Compute dominators using iterative algorithm
-        let mut dom = HashMap::new();
-        dom.insert(entry, vec![entry]);
-        
-        // Initialize all other blocks to all blocks
-        for &block in &blocks {
-            if block != entry {
-                dom.insert(block, blocks.clone());
-            }
-        }
-        
-        // Iterate until fixed point
-        let mut changed = true;
-        while changed {
-            changed = false;
-            
-            for &block in &blocks {
-                if block == entry {
-                    continue;
-                }
-                
-                // Find predecessors
-                let predecessors = self.find_predecessors(function, block);
-                if predecessors.is_empty() {
-                    continue;
-                }
-                
-                // New dominators = {block} ∪ (∩ dominators of predecessors)
-                let mut new_dom = vec![block];
-                
-                if let Some(first_pred) = predecessors.first() {
-                    let mut intersection = dom.get(first_pred).unwrap().clone();
-                    
-                    for &pred in predecessors.iter().skip(1) {
-                        if let Some(pred_dom) = dom.get(&pred) {
-                            intersection.retain(|x| pred_dom.contains(x));
-                        }
-                    }
-                    
-                    new_dom.extend(intersection);
-                }
-                
-                new_dom.sort();
-                new_dom.dedup();
-                
-                if dom.get(&block) != Some(&new_dom) {
-                    dom.insert(block, new_dom);
-                    changed = true;
-                }
-            }
-        }
-        
-        // Compute immediate dominators
-        for &block in &blocks {
-            if block == entry {
-                continue;
-            }
-            
-            if let Some(dominators) = dom.get(&block) {
-                // Remove block itself
-                let mut strict_dom: Vec<usize> = dominators.iter().filter(|&&x| x != block).copied().collect();
-                strict_dom.sort();
-                
-                // Find immediate dominator (the one not dominated by any other)
-                for &candidate in &strict_dom {
-                    let mut is_immediate = true;
-                    
-                    for &other in &strict_dom {
-                        if other != candidate {
-                            if let Some(other_dom) = dom.get(&other) {
-                                if other_dom.contains(&candidate) {
-                                    is_immediate = false;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                    
-                    if is_immediate {
-                        self.dominance_info.idom.insert(block, candidate);
-                        break;
-                    }
-                }
-            }
-        }
-        
-        // Build dominance tree
-        for (&child, &parent) in &self.dominance_info.idom {
-            self.dominance_info.dom_tree.entry(parent).or_insert_with(Vec::new).push(child);
-        }
-        
+        self.dominance_info = DominanceInfo::compute(function);
         Ok(())
     }
     
     /// Find predecessors of a block
     fn find_predecessors(&self, function: &Function, block: usize) -> Vec<usize> {
-        let mut predecessors = Vec::new();
-        
-        for (&pred_id, pred_block) in &function.basic_blocks {
-            let targets = self.get_terminator_targets(&pred_block.terminator);
-            if targets.contains(&(block as u32)) {
-                predecessors.push(pred_id as usize);
-            }
-        }
-        
-        predecessors
+        function.cfg().predecessors(block as u32).iter()
+            .map(|&pred| pred as usize)
+            .collect()
     }
     
     /// Get target blocks from a terminator
@@ -455,7 +454,7 @@ impl LoopOptimizationPass {
         // Find back edges (edges where target dominates source)
         let mut back_edges = Vec::new();
         
-        for (&block_id, block) in &function.basic_blocks {
+        for (block_id, block) in &function.basic_blocks {
             let targets = self.get_terminator_targets(&block.terminator);
             
             for target in targets {
@@ -493,19 +492,7 @@ impl LoopOptimizationPass {
     
     /// Check if block a dominates block b
     fn dominates(&self, a: usize, b: usize) -> bool {
-        if a == b {
-            return true;
-        }
-        
-        let mut current = b;
-        while let Some(&idom) = self.dominance_info.idom.get(&current) {
-            if idom == a {
-                return true;
-            }
-            current = idom;
-        }
-        
-        false
+        self.dominance_info.dominates(a, b)
     }
     
     /// Find the natural loop for a back edge
@@ -559,7 +546,7 @@ impl LoopOptimizationPass {
         let mut exits = HashSet::new();
         
         for &block in loop_blocks {
-            if let Some(block_info) = function.basic_blocks.get(&(block as u32)) {
+            if let Some(block_info) = function.basic_blocks.get(block as u32) {
                 let targets = self.get_terminator_targets(&block_info.terminator);
                 
                 for target in targets {
@@ -632,7 +619,7 @@ impl LoopOptimizationPass {
             
             // Analyze each block in the loop
             for &block_id in &loop_info.blocks {
-                if let Some(block) = function.basic_blocks.get(&(block_id as u32)) {
+                if let Some(block) = function.basic_blocks.get(block_id as u32) {
                     for (stmt_idx, statement) in block.statements.iter().enumerate() {
                         if self.is_loop_invariant(statement, loop_info, function)? {
                             let invariant_stmt = InvariantStatement {
@@ -776,39 +763,67 @@ impl LoopOptimizationPass {
     }
     
     /// Find basic induction variables in a loop
+    ///
+    /// Matches `i = i + c`, and the `t = i + c; i = t` pair lowering emits,
+    /// where that step is the only assignment to `i` inside the loop.
     fn find_basic_induction_variables(
         &self,
         loop_info: &LoopInfo,
         function: &Function,
         basic_ivs: &mut Vec<BasicInductionVar>,
     ) -> Result<(), SemanticError> {
-        // Look for variables of the form: i = i + c
+        let mut assignments: HashMap<u32, usize> = HashMap::new();
+        for &block_id in &loop_info.blocks {
+            if let Some(block) = function.basic_blocks.get(block_id as u32) {
+                for statement in &block.statements {
+                    if let Statement::Assign { place, .. } = statement {
+                        *assignments.entry(place.local).or_insert(0) += 1;
+                    }
+                }
+            }
+        }
+        
         for &block_id in &loop_info.blocks {
-            if let Some(block) = function.basic_blocks.get(&(block_id as u32)) {
+            if let Some(block) = function.basic_blocks.get(block_id as u32) {
                 for (stmt_idx, statement) in block.statements.iter().enumerate() {
-                    if let Statement::Assign { place, rvalue, .. } = statement {
-                        if let Rvalue::BinaryOp { op: BinOp::Add, left, right } = rvalue {
-                            // Check if left operand is the same variable
-                            if let Operand::Move(left_place) | Operand::Copy(left_place) = left {
-                                if left_place.local == place.local {
-                                    // Check if right operand is a constant
-                                    if let Operand::Constant(constant) = right {
-                                        if let Some(step) = self.extract_integer_constant(constant) {
-                                            let basic_iv = BasicInductionVar {
-                                                variable: place.clone(),
-                                                initial_value: Operand::Constant(crate::mir::Constant {
-                                                    ty: function.locals.get(&place.local)
-                                                    .map(|l| l.ty.clone())
-                                                    .unwrap_or(Type::Error),
-                                                    value: crate::mir::ConstantValue::Integer(0),
-                                                }),
-                                                step,
-                                                increment_block: block_id,
-                                                increment_statement: stmt_idx,
-                                            };
-                                            
-                                            basic_ivs.push(basic_iv);
-                                        }
+                    let (place, rvalue) = match statement {
+                        Statement::Assign { place, rvalue, .. } if place.projection.is_empty() => (place, rvalue),
+                        _ => continue,
+                    };
+                    if assignments.get(&place.local) != Some(&1) {
+                        continue;
+                    }
+                    
+                    // Look through `i = t` to the step computing `t`
+                    let step_rvalue = match rvalue {
+                        Rvalue::Use(Operand::Copy(temp) | Operand::Move(temp))
+                            if temp.projection.is_empty() && temp.local != place.local =>
+                        {
+                            block.statements[..stmt_idx].iter().rev().find_map(|earlier| match earlier {
+                                Statement::Assign { place: target, rvalue, .. } if target.local == temp.local => Some(rvalue),
+                                _ => None,
+                            })
+                        }
+                        _ => Some(rvalue),
+                    };
+                    
+                    if let Some(Rvalue::BinaryOp { op: BinOp::Add, left, right }) = step_rvalue {
+                        // Check if left operand is the same variable
+                        if let Operand::Move(left_place) | Operand::Copy(left_place) = left {
+                            if left_place.local == place.local {
+                                // Check if right operand is a constant
+                                if let Operand::Constant(constant) = right {
+                                    if let Some(step) = self.extract_integer_constant(constant) {
+                                        let basic_iv = BasicInductionVar {
+                                            variable: place.clone(),
+                                            initial_value: self.find_entry_value(function, loop_info, place)
+                                                .unwrap_or_else(|| Operand::Copy(place.clone())),
+                                            step,
+                                            increment_block: block_id,
+                                            increment_statement: stmt_idx,
+                                        };
+                                        
+                                        basic_ivs.push(basic_iv);
                                     }
                                 }
                             }
@@ -821,6 +836,119 @@ impl LoopOptimizationPass {
         Ok(())
     }
     
+    /// Value a variable holds when control enters the loop
+    ///
+    /// Walks back from the preheader through blocks with a single
+    /// predecessor to the last plain assignment of `place`. Copies are
+    /// followed further back in case they lead to a constant.
+    fn find_entry_value(&self, function: &Function, loop_info: &LoopInfo, place: &Place) -> Option<Operand> {
+        let mut block_id = loop_info.preheader?;
+        let mut visited = HashSet::new();
+        let mut target = place.local;
+        let mut found: Option<Operand> = None;
+        
+        while visited.insert(block_id) {
+            let block = function.basic_blocks.get(block_id as u32)?;
+            if matches!(&block.terminator, Terminator::Call { destination, .. } if destination.local == target) {
+                return found;
+            }
+            for statement in block.statements.iter().rev() {
+                match statement {
+                    Statement::Assign { place: assigned, rvalue, .. } if assigned.local == target => {
+                        match rvalue {
+                            Rvalue::Use(operand @ Operand::Constant(_)) if assigned.projection.is_empty() => {
+                                return Some(operand.clone());
+                            }
+                            Rvalue::Use(operand @ (Operand::Copy(source) | Operand::Move(source)))
+                                if assigned.projection.is_empty() && source.projection.is_empty() =>
+                            {
+                                found.get_or_insert_with(|| operand.clone());
+                                target = source.local;
+                            }
+                            _ => return found,
+                        }
+                    }
+                    _ => {}
+                }
+            }
+            
+            match self.find_predecessors(function, block_id).as_slice() {
+                [pred] => block_id = *pred,
+                _ => return found,
+            }
+        }
+        
+        found
+    }
+    
+    /// Fill in `LoopInfo::bounds` for loops with a recognizable exit test
+    ///
+    /// The header must end in a switch that enters the loop when
+    /// `i < end` (or `i <= end`) holds and leaves it otherwise, where `i` is
+    /// a basic induction variable stepped outside the header.
+    fn analyze_loop_bounds(&mut self, function: &Function) {
+        let bounds: Vec<Option<LoopBounds>> = self.loops.iter()
+            .map(|loop_info| self.match_loop_bounds(function, loop_info))
+            .collect();
+        
+        for (loop_info, bounds) in self.loops.iter_mut().zip(bounds) {
+            if let Some(bounds) = &bounds {
+                if let (Operand::Constant(start), Operand::Constant(end)) = (&bounds.initial_value, &bounds.final_value) {
+                    if let (crate::mir::ConstantValue::Integer(start), crate::mir::ConstantValue::Integer(end)) = (&start.value, &end.value) {
+                        let end = if bounds.comparison == BinOp::Le { end + 1 } else { *end };
+                        let step = bounds.step as i128;
+                        loop_info.iteration_count = u64::try_from(((end - start).max(0) + step - 1) / step).ok();
+                    }
+                }
+            }
+            loop_info.bounds = bounds;
+        }
+    }
+    
+    /// Match the exit test of one loop against its induction variables
+    fn match_loop_bounds(&self, function: &Function, loop_info: &LoopInfo) -> Option<LoopBounds> {
+        let header = function.basic_blocks.get(loop_info.header as u32)?;
+        let condition = match &header.terminator {
+            Terminator::SwitchInt { discriminant: Operand::Copy(place) | Operand::Move(place), targets, .. }
+                if targets.values == [1]
+                    && targets.targets.len() == 1
+                    && loop_info.blocks.contains(&(targets.targets[0] as usize))
+                    && !loop_info.blocks.contains(&(targets.otherwise as usize)) =>
+            {
+                place
+            }
+            _ => return None,
+        };
+        
+        let test = header.statements.iter().rev().find_map(|statement| match statement {
+            Statement::Assign { place, rvalue, .. } if place.local == condition.local => Some(rvalue),
+            _ => None,
+        })?;
+        let (comparison, induction, end) = match test {
+            Rvalue::BinaryOp { op: op @ (BinOp::Lt | BinOp::Le), left, right } => (*op, left, right),
+            Rvalue::BinaryOp { op: BinOp::Gt, left, right } => (BinOp::Lt, right, left),
+            Rvalue::BinaryOp { op: BinOp::Ge, left, right } => (BinOp::Le, right, left),
+            _ => return None,
+        };
+        let induction = match induction {
+            Operand::Copy(place) | Operand::Move(place) if place.projection.is_empty() => place,
+            _ => return None,
+        };
+        
+        let basic_iv = self.induction_analysis.basic_induction_vars.get(&loop_info.header)?
+            .iter()
+            .find(|iv| iv.variable.local == induction.local && iv.increment_block != loop_info.header && iv.step > 0)?;
+        
+        Some(LoopBounds {
+            induction_var: basic_iv.variable.clone(),
+            initial_value: basic_iv.initial_value.clone(),
+            final_value: end.clone(),
+            step: basic_iv.step,
+            comparison,
+            known_bounds: matches!(basic_iv.initial_value, Operand::Constant(_)) && matches!(end, Operand::Constant(_)),
+        })
+    }
+    
     /// Extract integer constant value
     fn extract_integer_constant(&self, constant: &crate::mir::Constant) -> Option<i64> {
         match &constant.value {
@@ -839,7 +967,7 @@ impl LoopOptimizationPass {
     ) -> Result<(), SemanticError> {
         // Look for variables of the form: j = i * c + d
         for &block_id in &loop_info.blocks {
-            if let Some(block) = function.basic_blocks.get(&(block_id as u32)) {
+            if let Some(block) = function.basic_blocks.get(block_id as u32) {
                 for statement in &block.statements {
                     if let Statement::Assign { place, rvalue, .. } = statement {
                         // Try to match derived IV patterns
@@ -915,7 +1043,7 @@ impl LoopOptimizationPass {
             
             // Analyze dependencies within the loop
             for block_id in blocks {
-                if let Some(block) = function.basic_blocks.get(&(block_id as u32)) {
+                if let Some(block) = function.basic_blocks.get(block_id as u32) {
                     self.analyze_block_dependencies(block, block_id, &loop_info, &mut loop_carried_deps)?;
                 }
             }
@@ -15,12 +15,18 @@
 //! Optimization passes for MIR
 //! 
 //! Implements fundamental optimization techniques including dead code elimination,
-//! constant folding, and common subexpression elimination.
+//! constant folding, common subexpression elimination and global value numbering.
 
 pub mod constant_folding;
 pub mod dead_code_elimination;
+pub mod compaction;
 pub mod common_subexpression;
+pub mod gvn;
 pub mod inlining;
+pub mod bounds_check_elimination;
+pub mod scalar_replacement;
+pub mod remarks;
+pub mod report;
 
 // Advanced optimization passes
 pub mod whole_program;
@@ -30,7 +36,13 @@ pub mod interprocedural;
 pub mod loop_optimizations;
 
 use crate::mir::{Function, Program};
+use remarks::Remark;
+use report::{OptimizationReport, PassTiming};
 use crate::error::SemanticError;
+use rayon::prelude::*;
+use std::collections::BTreeMap;
+use std::ops::Range;
+use std::time::Instant;
 
 /// Trait for MIR optimization passes
 pub trait OptimizationPass {
@@ -40,6 +52,23 @@ pub trait OptimizationPass {
     /// Run the optimization pass on a function
     fn run_on_function(&mut self, function: &mut Function) -> Result<bool, SemanticError>;
     
+    /// Whether the pass only reads and writes the function it is given
+    ///
+    /// Function-local passes may run on different functions concurrently.
+    fn is_function_local(&self) -> bool {
+        false
+    }
+    
+    /// Named counts of the transformations made so far, for compile statistics
+    fn statistics(&self) -> Vec<(&'static str, usize)> {
+        Vec::new()
+    }
+    
+    /// Decisions recorded so far, in order
+    fn remarks(&self) -> &[Remark] {
+        &[]
+    }
+    
     /// Run the optimization pass on a program
     fn run_on_program(&mut self, program: &mut Program) -> Result<bool, SemanticError> {
         let mut changed = false;
@@ -54,6 +83,12 @@ pub trait OptimizationPass {
 pub struct OptimizationManager {
     passes: Vec<Box<dyn OptimizationPass>>,
     max_iterations: usize,
+    /// Time and runs of each pass since the last `take_report`
+    timings: Vec<PassTiming>,
+    iterations: usize,
+    /// Remarks and statistics already handed out by `take_report`
+    remarks_taken: Vec<usize>,
+    statistics_taken: BTreeMap<&'static str, usize>,
 }
 
 impl OptimizationManager {
@@ -62,11 +97,17 @@ impl OptimizationManager {
         Self {
             passes: Vec::new(),
             max_iterations: 10,
+            timings: Vec::new(),
+            iterations: 0,
+            remarks_taken: Vec::new(),
+            statistics_taken: BTreeMap::new(),
         }
     }
     
     /// Add an optimization pass
     pub fn add_pass(&mut self, pass: Box<dyn OptimizationPass>) {
+        self.timings.push(PassTiming::new(pass.name()));
+        self.remarks_taken.push(0);
         self.passes.push(pass);
     }
     
@@ -79,9 +120,10 @@ impl OptimizationManager {
     pub fn optimize_program(&mut self, program: &mut Program) -> Result<(), SemanticError> {
         for _iteration in 0..self.max_iterations {
             let mut any_changed = false;
+            self.iterations += 1;
             
-            for pass in &mut self.passes {
-                let changed = pass.run_on_program(program)?;
+            for index in 0..self.passes.len() {
+                let changed = self.run_pass(index, |pass| pass.run_on_program(program))?;
                 any_changed |= changed;
             }
             
@@ -94,25 +136,157 @@ impl OptimizationManager {
         Ok(())
     }
     
-    /// Run all optimization passes on a function
-    pub fn optimize_function(&mut self, function: &mut Function) -> Result<(), SemanticError> {
-        for _iteration in 0..self.max_iterations {
+    /// Run the pass at `index` through `run`, timing it
+    fn run_pass<F>(&mut self, index: usize, run: F) -> Result<bool, SemanticError>
+    where
+        F: FnOnce(&mut dyn OptimizationPass) -> Result<bool, SemanticError>,
+    {
+        let start = Instant::now();
+        let changed = run(self.passes[index].as_mut())?;
+        let timing = &mut self.timings[index];
+        timing.time += start.elapsed();
+        timing.runs += 1;
+        timing.changes += changed as usize;
+        Ok(changed)
+    }
+    
+    /// Statistics, remarks and pass timings since the last call
+    pub fn take_report(&mut self) -> OptimizationReport {
+        let statistics = self.statistics();
+        let mut report = OptimizationReport {
+            statistics: statistics.iter()
+                .map(|(name, count)| (*name, count - self.statistics_taken.get(name).copied().unwrap_or(0)))
+                .collect(),
+            iterations: std::mem::take(&mut self.iterations),
+            ..Default::default()
+        };
+        for ((pass, taken), timing) in self.passes.iter().zip(&mut self.remarks_taken).zip(&mut self.timings) {
+            report.remarks.extend_from_slice(&pass.remarks()[*taken..]);
+            *taken = pass.remarks().len();
+            report.timings.push(std::mem::replace(timing, PassTiming::new(pass.name())));
+        }
+        self.statistics_taken = statistics;
+        report
+    }
+    
+    /// Statistics of every pass, summed by name
+    pub fn statistics(&self) -> BTreeMap<&'static str, usize> {
+        let mut totals = BTreeMap::new();
+        for (name, count) in self.passes.iter().flat_map(|pass| pass.statistics()) {
+            *totals.entry(name).or_insert(0) += count;
+        }
+        totals
+    }
+    
+    /// Remarks of every pass, in pipeline order
+    pub fn remarks(&self) -> Vec<&Remark> {
+        self.passes.iter().flat_map(|pass| pass.remarks()).collect()
+    }
+    
+    /// Whether every pass in this pipeline is function-local
+    pub fn is_function_local(&self) -> bool {
+        self.passes.iter().all(|pass| pass.is_function_local())
+    }
+    
+    /// Whether every pass after the leading whole-program ones is function-local
+    ///
+    /// Such pipelines can run under `optimize_program_parallel`.
+    pub fn is_parallelizable(&self) -> bool {
+        self.passes[self.whole_program_prefix()..].iter().all(|pass| pass.is_function_local())
+    }
+    
+    /// Number of passes before the first function-local one
+    fn whole_program_prefix(&self) -> usize {
+        self.passes.iter().position(|pass| pass.is_function_local()).unwrap_or(self.passes.len())
+    }
+    
+    /// Keep only the passes in `range`
+    fn retain_passes(&mut self, range: Range<usize>) {
+        self.passes = self.passes.drain(range.clone()).collect();
+        self.timings = self.timings.drain(range.clone()).collect();
+        self.remarks_taken = self.remarks_taken.drain(range).collect();
+    }
+    
+    /// Optimize a program, running its function-local passes on the rayon pool
+    ///
+    /// `make_pipeline` builds one manager per worker and must be
+    /// parallelizable. Each round runs the leading whole-program passes, such
+    /// as inlining, over the program and then one round of the remaining
+    /// passes on every function in parallel, until a round changes nothing.
+    /// That is the order `optimize_program` runs them in, so the result is
+    /// the same. Errors are reported in function-name order. Returns the
+    /// reports of both stages, remarks in function order.
+    pub fn optimize_program_parallel<F>(program: &mut Program, make_pipeline: F) -> Result<OptimizationReport, SemanticError>
+    where
+        F: Fn() -> OptimizationManager + Sync + Send,
+    {
+        let mut whole_program = make_pipeline();
+        let prefix = whole_program.whole_program_prefix();
+        let end = whole_program.passes.len();
+        whole_program.retain_passes(0..prefix);
+        let function_local = || {
+            let mut manager = make_pipeline();
+            manager.retain_passes(prefix..end);
+            manager
+        };
+        
+        let mut local = OptimizationReport::default();
+        for _iteration in 0..whole_program.max_iterations {
+            whole_program.iterations += 1;
             let mut any_changed = false;
+            for index in 0..prefix {
+                any_changed |= whole_program.run_pass(index, |pass| pass.run_on_program(program))?;
+            }
+            
+            let mut functions: Vec<&mut Function> = program.functions.values_mut().collect();
+            functions.sort_by(|a, b| a.name.cmp(&b.name));
             
-            for pass in &mut self.passes {
-                let changed = pass.run_on_function(function)?;
+            // Workers may reuse a manager, so each function takes its own report
+            let results: Vec<Result<(bool, OptimizationReport), SemanticError>> = functions.into_par_iter()
+                .map_init(&function_local, |manager, function| {
+                    let changed = manager.run_function_round(function)?;
+                    Ok((changed, manager.take_report()))
+                })
+                .collect();
+            for result in results {
+                let (changed, report) = result?;
                 any_changed |= changed;
+                local.merge(report);
             }
             
-            // If no passes made changes, we've reached a fixed point
             if !any_changed {
                 break;
             }
         }
         
+        let mut report = whole_program.take_report();
+        report.append(local);
+        Ok(report)
+    }
+    
+    /// Run all optimization passes on a function
+    pub fn optimize_function(&mut self, function: &mut Function) -> Result<(), SemanticError> {
+        for _iteration in 0..self.max_iterations {
+            self.iterations += 1;
+            
+            // If no passes made changes, we've reached a fixed point
+            if !self.run_function_round(function)? {
+                break;
+            }
+        }
+        
         Ok(())
     }
     
+    /// Run each pass once on a function, returning whether any changed it
+    fn run_function_round(&mut self, function: &mut Function) -> Result<bool, SemanticError> {
+        let mut any_changed = false;
+        for index in 0..self.passes.len() {
+            any_changed |= self.run_pass(index, |pass| pass.run_on_function(function))?;
+        }
+        Ok(any_changed)
+    }
+    
     /// Create a default optimization pipeline
     pub fn create_default_pipeline() -> Self {
         let mut manager = Self::new();
@@ -120,11 +294,47 @@ impl OptimizationManager {
         // Add optimization passes in order
         manager.add_pass(Box::new(constant_folding::ConstantFoldingPass::new()));
         manager.add_pass(Box::new(dead_code_elimination::DeadCodeEliminationPass::new()));
+        manager.add_pass(Box::new(compaction::CompactionPass::new()));
         manager.add_pass(Box::new(common_subexpression::CommonSubexpressionEliminationPass::new()));
+        manager.add_pass(Box::new(bounds_check_elimination::BoundsCheckEliminationPass::new()));
+        manager.add_pass(Box::new(scalar_replacement::ScalarReplacementPass::new()));
         
         manager
     }
     
+    /// Create the default pipeline behind the inliner
+    ///
+    /// Used from -O2 up when optimizing for size.
+    pub fn create_inlining_pipeline() -> Self {
+        let mut manager = Self::new();
+        manager.add_pass(Box::new(inlining::InliningPass::new()));
+        for pass in Self::create_default_pipeline().passes {
+            manager.add_pass(pass);
+        }
+        manager
+    }
+    
+    /// Create the inlining pipeline followed by loop vectorization
+    ///
+    /// Used from -O2 up, where the larger code is worth it.
+    pub fn create_vectorizing_pipeline() -> Self {
+        let mut manager = Self::create_inlining_pipeline();
+        manager.add_pass(Box::new(gvn::GlobalValueNumberingPass::new()));
+        manager.add_pass(Box::new(vectorization::VectorizationPass::new()));
+        manager
+    }
+    
+    /// The pipeline constructor for a speed and size level
+    ///
+    /// Size levels skip vectorization since it duplicates every loop it touches.
+    pub fn pipeline_for_levels(optimization_level: u8, size_level: u8) -> fn() -> Self {
+        match (optimization_level, size_level) {
+            (0..=1, _) => Self::create_default_pipeline,
+            (_, 0) => Self::create_vectorizing_pipeline,
+            _ => Self::create_inlining_pipeline,
+        }
+    }
+    
     /// Create an advanced optimization pipeline with all passes
     pub fn create_advanced_pipeline() -> Self {
         let mut manager = Self::new();
@@ -132,9 +342,12 @@ impl OptimizationManager {
         // Basic optimizations first
         manager.add_pass(Box::new(constant_folding::ConstantFoldingPass::new()));
         manager.add_pass(Box::new(dead_code_elimination::DeadCodeEliminationPass::new()));
+        manager.add_pass(Box::new(compaction::CompactionPass::new()));
+        manager.add_pass(Box::new(scalar_replacement::ScalarReplacementPass::new()));
         
         // Advanced loop optimizations
         manager.add_pass(Box::new(loop_optimizations::LoopOptimizationPass::new()));
+        manager.add_pass(Box::new(bounds_check_elimination::BoundsCheckEliminationPass::new()));
         
         // Interprocedural analysis
         manager.add_pass(Box::new(interprocedural::InterproceduralAnalysisPass::new()));
@@ -142,8 +355,9 @@ impl OptimizationManager {
         // Auto-vectorization
         manager.add_pass(Box::new(vectorization::VectorizationPass::new()));
         
-        // Common subexpression elimination after other optimizations
+        // Redundancy elimination after other optimizations
         manager.add_pass(Box::new(common_subexpression::CommonSubexpressionEliminationPass::new()));
+        manager.add_pass(Box::new(gvn::GlobalValueNumberingPass::new()));
         
         // Inlining pass
         manager.add_pass(Box::new(inlining::InliningPass::new()));
@@ -155,17 +369,25 @@ impl OptimizationManager {
     pub fn create_pgo_pipeline(profile_data_path: &str) -> Result<Self, SemanticError> {
         let mut manager = Self::new();
         
+        // Profile-guided optimization comes first: the profile was collected
+        // on the MIR as lowered. Inlining follows its call-site advice.
+        let mut pgo = profile_guided::ProfileGuidedOptimizationPass::from_file(profile_data_path)?;
+        let inliner = inlining::InliningPass::with_call_site_decisions(pgo.call_site_decisions()?);
+        manager.add_pass(Box::new(pgo));
+        
         // Basic optimizations
         manager.add_pass(Box::new(constant_folding::ConstantFoldingPass::new()));
         manager.add_pass(Box::new(dead_code_elimination::DeadCodeEliminationPass::new()));
-        
-        // Profile-guided optimization
-        manager.add_pass(Box::new(profile_guided::ProfileGuidedOptimizationPass::from_file(profile_data_path)?));
+        manager.add_pass(Box::new(compaction::CompactionPass::new()));
+        manager.add_pass(Box::new(scalar_replacement::ScalarReplacementPass::new()));
         
         // Advanced optimizations guided by profile data
         manager.add_pass(Box::new(loop_optimizations::LoopOptimizationPass::new()));
+        manager.add_pass(Box::new(bounds_check_elimination::BoundsCheckEliminationPass::new()));
         manager.add_pass(Box::new(vectorization::VectorizationPass::new()));
         manager.add_pass(Box::new(common_subexpression::CommonSubexpressionEliminationPass::new()));
+        manager.add_pass(Box::new(gvn::GlobalValueNumberingPass::new()));
+        manager.add_pass(Box::new(inliner));
         
         Ok(manager)
     }
@@ -183,9 +405,13 @@ impl OptimizationManager {
         // Standard optimizations
         manager.add_pass(Box::new(constant_folding::ConstantFoldingPass::new()));
         manager.add_pass(Box::new(dead_code_elimination::DeadCodeEliminationPass::new()));
+        manager.add_pass(Box::new(compaction::CompactionPass::new()));
+        manager.add_pass(Box::new(scalar_replacement::ScalarReplacementPass::new()));
         manager.add_pass(Box::new(loop_optimizations::LoopOptimizationPass::new()));
+        manager.add_pass(Box::new(bounds_check_elimination::BoundsCheckEliminationPass::new()));
         manager.add_pass(Box::new(vectorization::VectorizationPass::new()));
         manager.add_pass(Box::new(common_subexpression::CommonSubexpressionEliminationPass::new()));
+        manager.add_pass(Box::new(gvn::GlobalValueNumberingPass::new()));
         
         manager
     }
@@ -254,4 +480,150 @@ mod tests {
         // Function should still be valid after optimization
         assert_eq!(function.name, "test");
     }
-}
\ No newline at end of file
+    
+    #[test]
+    fn test_parallel_optimization_matches_sequential() {
+        let mut program = Program {
+            functions: std::collections::HashMap::new(),
+            global_constants: std::collections::HashMap::new(),
+            external_functions: std::collections::HashMap::new(),
+            type_definitions: std::collections::HashMap::new(),
+        };
+        
+        for name in ["a", "b", "c"] {
+            let mut builder = Builder::new();
+            builder.start_function(name.to_string(), vec![], Type::primitive(PrimitiveType::Integer));
+            let temp = builder.new_local(Type::primitive(PrimitiveType::Integer), false);
+            builder.push_statement(Statement::Assign {
+                place: Place { local: temp, projection: vec![] },
+                rvalue: Rvalue::BinaryOp {
+                    op: crate::mir::BinOp::Add,
+                    left: Operand::Constant(Constant {
+                        ty: Type::primitive(PrimitiveType::Integer),
+                        value: ConstantValue::Integer(2),
+                    }),
+                    right: Operand::Constant(Constant {
+                        ty: Type::primitive(PrimitiveType::Integer),
+                        value: ConstantValue::Integer(3),
+                    }),
+                },
+                source_info: SourceInfo {
+                    span: SourceLocation::unknown(),
+                    scope: 0,
+                },
+            });
+            program.functions.insert(name.to_string(), builder.finish_function());
+        }
+        
+        let mut sequential = program.clone();
+        let mut manager = OptimizationManager::create_default_pipeline();
+        manager.optimize_program(&mut sequential).unwrap();
+        
+        assert!(OptimizationManager::create_default_pipeline().is_function_local());
+        let report = OptimizationManager::optimize_program_parallel(&mut program, OptimizationManager::create_default_pipeline).unwrap();
+        assert_eq!(report.iterations, manager.take_report().iterations);
+        assert!(report.timings.iter().all(|timing| timing.runs >= program.functions.len()));
+        
+        let blocks = |function: &Function| {
+            let mut blocks: Vec<String> = function.basic_blocks.iter()
+                .map(|(id, block)| format!("{}: {:?}", id, block))
+                .collect();
+            blocks.sort();
+            blocks
+        };
+        for (name, function) in &program.functions {
+            assert_eq!(blocks(function), blocks(&sequential.functions[name]));
+        }
+    }
+    
+    #[test]
+    fn test_o2_pipeline_inlines_small_callees() {
+        let source = r#"
+(DEFINE_MODULE
+  (NAME inl)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME square)
+      (ACCEPTS_PARAMETER (NAME "x") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (RETURN_VALUE (EXPRESSION_MULTIPLY x x))))
+    (DEFINE_FUNCTION
+      (NAME area)
+      (ACCEPTS_PARAMETER (NAME "side") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (RETURN_VALUE (EXPRESSION_ADD (CALL_FUNCTION square side) 1))))))
+"#;
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let ast = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        let mut program = crate::mir::lowering::lower_ast_to_mir(&ast).unwrap();
+        
+        assert!(OptimizationManager::pipeline_for_levels(1, 0)().is_function_local());
+        let make_pipeline = OptimizationManager::pipeline_for_levels(2, 0);
+        assert!(make_pipeline().is_parallelizable());
+        let report = OptimizationManager::optimize_program_parallel(&mut program, make_pipeline).unwrap();
+        
+        assert_eq!(report.statistics.get("calls inlined"), Some(&1));
+        assert!(report.remarks.iter().any(|remark| remark.pass == "inlining" && remark.message.starts_with("inlined `square`")));
+        assert_eq!(report.timings[0].pass, "inlining");
+        let calls_square = program.functions["area"].basic_blocks.values()
+            .flat_map(|block| block.statements.iter())
+            .any(|statement| matches!(statement, Statement::Assign { rvalue: Rvalue::Call { func: Operand::Constant(Constant { value: ConstantValue::String(name), .. }), .. }, .. } if name == "square"));
+        assert!(!calls_square);
+    }
+    
+    #[test]
+    fn test_parallel_o2_pipeline_matches_sequential() {
+        let source = r#"
+(DEFINE_MODULE
+  (NAME inl)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME seven)
+      (RETURNS INTEGER)
+      (BODY (RETURN_VALUE 7)))
+    (DEFINE_FUNCTION
+      (NAME total)
+      (ACCEPTS_PARAMETER (NAME "z") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (RETURN_VALUE (EXPRESSION_ADD (CALL_FUNCTION seven) z))))))
+"#;
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let ast = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        let mut parallel = crate::mir::lowering::lower_ast_to_mir(&ast).unwrap();
+        
+        // Dead stores make `seven` too big to inline until they are removed
+        let seven = parallel.functions.get_mut("seven").unwrap();
+        let dead = seven.locals.push(crate::mir::Local {
+            ty: Type::primitive(PrimitiveType::Integer),
+            is_mutable: true,
+            source_info: None,
+        });
+        let entry = seven.entry_block;
+        for value in 0..30 {
+            seven.basic_blocks[entry].statements.insert(0, Statement::Assign {
+                place: Place { local: dead, projection: vec![] },
+                rvalue: Rvalue::Use(Operand::Constant(Constant {
+                    ty: Type::primitive(PrimitiveType::Integer),
+                    value: ConstantValue::Integer(value),
+                })),
+                source_info: SourceInfo { span: SourceLocation::unknown(), scope: 0 },
+            });
+        }
+        let mut sequential = parallel.clone();
+        
+        let make_pipeline = OptimizationManager::pipeline_for_levels(2, 0);
+        let mut manager = make_pipeline();
+        manager.optimize_program(&mut sequential).unwrap();
+        let sequential_report = manager.take_report();
+        let parallel_report = OptimizationManager::optimize_program_parallel(&mut parallel, make_pipeline).unwrap();
+        
+        assert_eq!(sequential_report.statistics.get("calls inlined"), Some(&1));
+        assert_eq!(parallel_report.statistics, sequential_report.statistics);
+        for (name, function) in &parallel.functions {
+            assert_eq!(function.to_string(), sequential.functions[name].to_string(), "{} differs", name);
+        }
+    }
+}
@@ -16,11 +16,25 @@
 //!
 //! Uses runtime profiling data to guide optimization decisions, including
 //! function inlining, basic block layout, and branch prediction.
+//!
+//! Profiles are collected by compiling with `--profile-generate`, which
+//! inserts counters into the MIR as lowered, before any optimization. The
+//! pass consumes profiles at the same point, so block numbers in the profile
+//! name the same blocks the pass sees. Each function's profile carries a
+//! checksum of its control-flow graph; when the source has changed since the
+//! profile was taken, the function's block, branch and loop records no longer
+//! fit and are dropped.
 
-use crate::mir::{Function, Program, BasicBlock, Terminator};
-use crate::error::SemanticError;
+use crate::ast::PrimitiveType;
+use crate::mir::{cfg, BasicBlockId, Constant, ConstantValue, Function, Local, LocalId, Operand, Place, Program,
+                 BasicBlock, Rvalue, SourceInfo, Statement, Terminator};
+use crate::error::{SemanticError, SourceLocation};
+use crate::optimizations::loop_optimizations::LoopOptimizationPass;
+use crate::optimizations::remarks::{self, Remark};
 use crate::optimizations::OptimizationPass;
-use std::collections::HashMap;
+use crate::types::Type;
+use std::cmp::Reverse;
+use std::collections::{BTreeMap, HashMap, HashSet};
 use std::fs::File;
 use std::io::{BufRead, BufReader, Write};
 use std::path::Path;
@@ -42,6 +56,11 @@ pub struct ProfileGuidedOptimizationPass {
     
     /// Basic block layout decisions
     layout_decisions: HashMap<String, BlockLayout>,
+    
+    /// Whether the profile has been applied; later runs would see renumbered blocks
+    applied: bool,
+    
+    remarks: Vec<Remark>,
 }
 
 /// Profile data collected from program execution
@@ -61,6 +80,13 @@ pub struct ProfileData {
     
     /// Loop iteration counts
     loop_iteration_counts: HashMap<String, HashMap<usize, LoopProfile>>,
+    
+    /// Taken counts of instrumented branch edges, resolved into
+    /// `branch_frequencies` once the whole run has been read
+    edge_counts: HashMap<String, HashMap<usize, u64>>,
+    
+    /// CFG checksum of each function as instrumented
+    checksums: HashMap<String, u64>,
 }
 
 /// Branch profiling information
@@ -124,6 +150,11 @@ pub struct BlockLayout {
 /// Profile collection instrumentation
 #[derive(Debug, Default)]
 pub struct ProfileInstrumentation {
+    /// Inserted probes; a probe's id is its runtime counter index
+    pub probes: Vec<ProbePoint>,
+    
+    /// CFG checksum of each instrumented function, taken before instrumenting
+    pub checksums: Vec<(String, u64)>,
 }
 
 /// A profiling probe point
@@ -147,6 +178,7 @@ pub enum ProbeLocation {
     BasicBlock(String, usize),
     Branch(String, usize),
     LoopHeader(String, usize),
+    CallSite(String, String),
 }
 
 /// Type of profiling probe
@@ -165,6 +197,8 @@ impl ProfileGuidedOptimizationPass {
             hot_block_threshold: 500,
             inline_decisions: HashMap::new(),
             layout_decisions: HashMap::new(),
+            applied: false,
+            remarks: Vec::new(),
         }
     }
     
@@ -185,15 +219,10 @@ impl ProfileGuidedOptimizationPass {
         self.parse_profile_data(reader)
     }
     
-    /// Parse profile data from a reader
+    /// Parse profile data from a reader, adding it to any already loaded
     fn parse_profile_data<R: BufRead>(&mut self, reader: R) -> Result<(), SemanticError> {
-        for line in reader.lines() {
-            let line = line.map_err(|e| SemanticError::Internal {
-                message: format!("Failed to read profile data: {}", e),
-            })?;
-            
-            self.parse_profile_line(&line)?;
-        }
+        let run = ProfileData::parse(reader)?;
+        self.profile_data.merge(run);
         
         // Compute derived metrics
         self.compute_branch_probabilities();
@@ -202,98 +231,6 @@ impl ProfileGuidedOptimizationPass {
         Ok(())
     }
     
-    /// Parse a single line of profile data
-    fn parse_profile_line(&mut self, line: &str) -> Result<(), SemanticError> {
-        let parts: Vec<&str> = line.trim().split(':').collect();
-        if parts.len() < 3 {
-            return Ok(()); // Skip malformed lines
-        }
-        
-        match parts[0] {
-            "FUNC" => {
-                // Function execution count: FUNC:function_name:count
-                if parts.len() >= 3 {
-                    let function_name = parts[1].to_string();
-                    let count = parts[2].parse::<u64>().unwrap_or(0);
-                    self.profile_data.function_counts.insert(function_name, count);
-                }
-            }
-            "BLOCK" => {
-                // Basic block execution count: BLOCK:function_name:block_id:count
-                if parts.len() >= 4 {
-                    let function_name = parts[1].to_string();
-                    let block_id = parts[2].parse::<usize>().unwrap_or(0);
-                    let count = parts[3].parse::<u64>().unwrap_or(0);
-                    
-                    self.profile_data.block_counts
-                        .entry(function_name)
-                        .or_insert_with(HashMap::new)
-                        .insert(block_id, count);
-                }
-            }
-            "BRANCH" => {
-                // Branch profile: BRANCH:function_name:block_id:total:taken
-                if parts.len() >= 5 {
-                    let function_name = parts[1].to_string();
-                    let block_id = parts[2].parse::<usize>().unwrap_or(0);
-                    let total = parts[3].parse::<u64>().unwrap_or(0);
-                    let taken = parts[4].parse::<u64>().unwrap_or(0);
-                    
-                    let branch_profile = BranchProfile {
-                        total_count: total,
-                        taken_count: taken,
-                        probability: if total > 0 { taken as f64 / total as f64 } else { 0.0 },
-                    };
-                    
-                    self.profile_data.branch_frequencies
-                        .entry(function_name)
-                        .or_insert_with(HashMap::new)
-                        .insert(block_id, branch_profile);
-                }
-            }
-            "CALL" => {
-                // Function call frequency: CALL:caller:callee:count
-                if parts.len() >= 4 {
-                    let caller = parts[1].to_string();
-                    let callee = parts[2].to_string();
-                    let count = parts[3].parse::<u64>().unwrap_or(0);
-                    
-                    self.profile_data.call_frequencies
-                        .entry(caller)
-                        .or_insert_with(HashMap::new)
-                        .insert(callee, count);
-                }
-            }
-            "LOOP" => {
-                // Loop profile: LOOP:function_name:block_id:entries:total_iterations:max_iterations
-                if parts.len() >= 6 {
-                    let function_name = parts[1].to_string();
-                    let block_id = parts[2].parse::<usize>().unwrap_or(0);
-                    let entries = parts[3].parse::<u64>().unwrap_or(0);
-                    let total_iterations = parts[4].parse::<u64>().unwrap_or(0);
-                    let max_iterations = parts[5].parse::<u64>().unwrap_or(0);
-                    
-                    let loop_profile = LoopProfile {
-                        entry_count: entries,
-                        total_iterations,
-                        avg_iterations: if entries > 0 { total_iterations as f64 / entries as f64 } else { 0.0 },
-                        max_iterations,
-                    };
-                    
-                    self.profile_data.loop_iteration_counts
-                        .entry(function_name)
-                        .or_insert_with(HashMap::new)
-                        .insert(block_id, loop_profile);
-                }
-            }
-            _ => {
-                // Unknown profile data type, skip
-            }
-        }
-        
-        Ok(())
-    }
-    
     /// Compute branch probabilities from raw counts
     fn compute_branch_probabilities(&mut self) {
         for branch_map in self.profile_data.branch_frequencies.values_mut() {
@@ -323,6 +260,14 @@ impl ProfileGuidedOptimizationPass {
         Ok(())
     }
     
+    /// Inlining advice for each profiled call site, keyed `caller::callee`
+    ///
+    /// The decisions are carried out by `InliningPass`.
+    pub fn call_site_decisions(&mut self) -> Result<HashMap<String, InlineDecision>, SemanticError> {
+        self.make_inlining_decisions()?;
+        Ok(self.inline_decisions.clone())
+    }
+    
     /// Make function inlining decisions based on profile data
     fn make_inlining_decisions(&mut self) -> Result<(), SemanticError> {
         self.inline_decisions.clear();
@@ -428,10 +373,11 @@ impl ProfileGuidedOptimizationPass {
     
     /// Apply profile-guided optimizations to a program
     pub fn apply_optimizations(&self, program: &mut Program) -> Result<bool, SemanticError> {
-        let mut changed = false;
+        let mut changed = self.annotate_entry_counts(program);
         
-        // Apply inlining decisions
-        if self.apply_profile_guided_inlining(program)? {
+        // Branch weights are looked up by block ID, so they go on before
+        // the layout renumbers blocks
+        if self.apply_branch_optimizations(program)? {
             changed = true;
         }
         
@@ -440,56 +386,21 @@ impl ProfileGuidedOptimizationPass {
             changed = true;
         }
         
-        // Apply branch prediction optimizations
-        if self.apply_branch_optimizations(program)? {
-            changed = true;
-        }
-        
         Ok(changed)
     }
     
-    /// Apply profile-guided function inlining
-    fn apply_profile_guided_inlining(&self, program: &mut Program) -> Result<bool, SemanticError> {
+    /// Record profiled entry counts, which code generation uses to order
+    /// functions and to separate the ones that never ran
+    fn annotate_entry_counts(&self, program: &mut Program) -> bool {
         let mut changed = false;
-        
-        for (call_site, decision) in &self.inline_decisions {
-            match decision {
-                InlineDecision::AlwaysInline => {
-                    if self.try_inline_call_site(program, call_site)? {
-                        changed = true;
-                    }
-                }
-                InlineDecision::InlineHot => {
-                    // Only inline in hot paths
-                    if self.is_hot_call_site(call_site) && self.try_inline_call_site(program, call_site)? {
-                        changed = true;
-                    }
-                }
-                _ => {
-                    // Don't inline or use default heuristics
-                }
-            }
-        }
-        
-        Ok(changed)
-    }
-    
-    /// Try to inline a specific call site
-    fn try_inline_call_site(&self, _program: &mut Program, call_site: &str) -> Result<bool, SemanticError> {
-        // Placeholder for actual inlining implementation
-        eprintln!("Would inline call site: {}", call_site);
-        Ok(false)
-    }
-    
-    /// Check if a call site is in a hot path
-    fn is_hot_call_site(&self, call_site: &str) -> bool {
-        // Extract caller from call site string
-        if let Some(caller) = call_site.split("::").next() {
-            if let Some(&count) = self.profile_data.function_counts.get(caller) {
-                return count > self.hot_function_threshold;
+        for function in program.functions.values_mut() {
+            let count = self.profile_data.function_counts.get(&function.name).copied();
+            if count.is_some() && function.entry_count != count {
+                function.entry_count = count;
+                changed = true;
             }
         }
-        false
+        changed
     }
     
     /// Apply basic block layout optimizations
@@ -507,12 +418,45 @@ impl ProfileGuidedOptimizationPass {
         Ok(changed)
     }
     
-    /// Reorder basic blocks in a function
+    /// Lay blocks out as hot fall-through chains, with cold blocks last
+    ///
+    /// Each block is followed by its most frequently executed successor not
+    /// yet placed; when a chain ends, the next one starts at the hottest block
+    /// left. Code generation emits blocks in this order, so the hot path runs
+    /// through straight-line code and rarely run blocks stay out of its way.
     fn reorder_basic_blocks(&self, function: &mut Function, layout: &BlockLayout) -> Result<bool, SemanticError> {
-        // This would reorder the basic blocks in the function
-        // For now, just report what would be done
-        eprintln!("Would reorder blocks in function {}: {:?}", function.name, layout.block_order);
-        Ok(false)
+        let counts = match self.profile_data.block_counts.get(&function.name) {
+            Some(counts) => counts,
+            None => return Ok(false),
+        };
+        let count = |block: BasicBlockId| counts.get(&(block as usize)).copied().unwrap_or(0);
+        let entry = function.entry_block;
+        let cold: HashSet<BasicBlockId> = layout.cold_blocks.iter()
+            .map(|&block| block as BasicBlockId)
+            .filter(|&block| block != entry && function.basic_blocks.contains(block))
+            .collect();
+        
+        let mut heads: Vec<BasicBlockId> = function.basic_blocks.ids().filter(|block| !cold.contains(block)).collect();
+        heads.sort_by_key(|&block| (block != entry, Reverse(count(block)), block));
+        
+        let mut placed = HashSet::new();
+        let mut order = Vec::with_capacity(function.basic_blocks.len());
+        for head in heads {
+            let mut next = Some(head);
+            while let Some(block) = next.filter(|&block| placed.insert(block)) {
+                order.push(block);
+                next = cfg::successors(&function.basic_blocks[block]).into_iter()
+                    .filter(|successor| !placed.contains(successor) && !cold.contains(successor))
+                    .max_by_key(|&successor| (count(successor), Reverse(successor)));
+            }
+        }
+        order.extend(function.basic_blocks.ids().filter(|block| cold.contains(block)));
+        
+        if order.iter().copied().eq(function.basic_blocks.ids()) {
+            return Ok(false);
+        }
+        function.reorder_blocks(&order);
+        Ok(true)
     }
     
     /// Apply branch prediction optimizations
@@ -536,7 +480,7 @@ impl ProfileGuidedOptimizationPass {
         
         for (block_id, branch_profile) in branch_data {
             let block_id_u32 = *block_id as u32;
-            if let Some(block) = function.basic_blocks.get_mut(&block_id_u32) {
+            if let Some(block) = function.basic_blocks.get_mut(block_id_u32) {
                 if self.optimize_block_branches(block, branch_profile)? {
                     changed = true;
                 }
@@ -546,20 +490,16 @@ impl ProfileGuidedOptimizationPass {
         Ok(changed)
     }
     
-    /// Optimize branches in a basic block
+    /// Attach the profiled taken and not-taken counts to a two-way branch,
+    /// which code generation emits as branch weights
     fn optimize_block_branches(&self, block: &mut BasicBlock, branch_profile: &BranchProfile) -> Result<bool, SemanticError> {
-        // This would optimize the branch based on probability
-        // For example:
-        // - Reorder branch targets to put likely target first
-        // - Add branch prediction hints
-        // - Transform unlikely branches to reduce overhead
-        
         match &mut block.terminator {
-            Terminator::SwitchInt {  .. } => {
-                // Could reorder switch targets based on branch probabilities
-                if branch_profile.probability > 0.9 {
-                    eprintln!("Would optimize highly predictable branch (p={:.2})", branch_profile.probability);
-                    return Ok(false); // Not actually implemented
+            Terminator::SwitchInt { targets, .. } if targets.targets.len() == 1 => {
+                let not_taken = branch_profile.total_count.saturating_sub(branch_profile.taken_count);
+                let weights = vec![branch_profile.taken_count, not_taken];
+                if targets.weights != weights {
+                    targets.weights = weights;
+                    return Ok(true);
                 }
             }
             _ => {}
@@ -568,47 +508,123 @@ impl ProfileGuidedOptimizationPass {
         Ok(false)
     }
     
-    /// Generate instrumentation code for profile collection
-    pub fn generate_instrumentation(&self, _program: &mut Program) -> Result<ProfileInstrumentation, SemanticError> {
-        // This would insert profiling probes into the program
-        // For now, return empty instrumentation
-        Ok(ProfileInstrumentation {})
-    }
-    
-    /// Save profile data to a file
-    pub fn save_profile_data<P: AsRef<Path>>(&self, path: P) -> Result<(), SemanticError> {
-        let mut file = File::create(path).map_err(|e| SemanticError::Internal {
-            message: format!("Failed to create profile data file: {}", e),
-        })?;
+    /// Insert profile counters into every function of `program`
+    ///
+    /// Each function counts its entries, each block its executions, each
+    /// two-way branch how often its first target was taken, and each call to
+    /// another function of the program how often it was made. `main` hands the
+    /// runtime the counter names, followed by one `CFG` line per function, which
+    /// are written out when the program exits; without a `main` the counters
+    /// stay disabled.
+    pub fn generate_instrumentation(&self, program: &mut Program) -> Result<ProfileInstrumentation, SemanticError> {
+        let mut instrumentation = ProfileInstrumentation::default();
+        let defined: HashSet<String> = program.functions.keys().cloned().collect();
+        let mut names: Vec<&String> = defined.iter().collect();
+        names.sort();
         
-        // Write function counts
-        for (function_name, count) in &self.profile_data.function_counts {
-            writeln!(file, "FUNC:{}:{}", function_name, count).map_err(|e| SemanticError::Internal {
-                message: format!("Failed to write profile data: {}", e),
-            })?;
+        for name in names {
+            if let Some(function) = program.functions.get_mut(name) {
+                instrument_function(function, &defined, &mut instrumentation);
+            }
         }
         
-        // Write block counts
-        for (function_name, block_counts) in &self.profile_data.block_counts {
-            for (block_id, count) in block_counts {
-                writeln!(file, "BLOCK:{}:{}:{}", function_name, block_id, count).map_err(|e| SemanticError::Internal {
-                    message: format!("Failed to write profile data: {}", e),
-                })?;
-            }
+        if let Some(main) = program.functions.get_mut("main") {
+            // Checksums follow the counters, so probe ids still index the table
+            let table = instrumentation.probes.iter()
+                .map(ProbePoint::counter_name)
+                .chain(instrumentation.checksums.iter().map(|(name, checksum)| format!("CFG:{}:{}", name, checksum)))
+                .collect::<Vec<_>>()
+                .join("\n");
+            let sink = void_local(main);
+            let table = Operand::Constant(Constant {
+                ty: Type::primitive(PrimitiveType::String),
+                value: ConstantValue::String(table),
+            });
+            let entry = main.entry_block;
+            main.basic_blocks[entry].statements.insert(0, runtime_call(sink, "aether_profile_init", table));
         }
         
-        // Write branch frequencies
-        for (function_name, branch_data) in &self.profile_data.branch_frequencies {
-            for (block_id, branch_profile) in branch_data {
-                writeln!(file, "BRANCH:{}:{}:{}:{}", 
-                        function_name, block_id, 
-                        branch_profile.total_count, branch_profile.taken_count).map_err(|e| SemanticError::Internal {
-                    message: format!("Failed to write profile data: {}", e),
-                })?;
+        Ok(instrumentation)
+    }
+    
+    /// Drop the block, branch and loop records of functions whose CFG has
+    /// changed since the profile was taken
+    ///
+    /// Those records name blocks by number, which would now point at other
+    /// blocks. Entry and call counts are keyed by name and stay. Profiles
+    /// without a checksum are trusted as they are.
+    fn drop_stale_records(&mut self, program: &Program) {
+        let mut names: Vec<&String> = program.functions.keys().collect();
+        names.sort();
+        for name in names {
+            let recorded = match self.profile_data.checksums.get(name) {
+                Some(&checksum) => checksum,
+                None => continue,
+            };
+            let checksum = cfg_checksum(&program.functions[name]);
+            if checksum == recorded {
+                continue;
+            }
+            self.profile_data.remove_block_records(name);
+            let remark = Remark::missed(self.name(), name, format!(
+                "profile block counts ignored: CFG checksum {:016x} does not match profiled {:016x}",
+                checksum, recorded));
+            remarks::record(&mut self.remarks, remark);
+        }
+    }
+    
+    /// Estimate loop trip counts from block counts for functions whose
+    /// profile has no loop records
+    ///
+    /// A loop is entered as often as its header runs minus its back edges.
+    /// Block counters cannot observe per-entry maxima, so derived profiles
+    /// leave `max_iterations` at zero.
+    fn derive_loop_profiles(&mut self, program: &Program) {
+        for (function_name, block_counts) in &self.profile_data.block_counts {
+            if self.profile_data.loop_iteration_counts.contains_key(function_name) {
+                continue;
+            }
+            let function = match program.functions.get(function_name) {
+                Some(function) => function,
+                None => continue,
+            };
+            let mut loop_analysis = LoopOptimizationPass::new();
+            if loop_analysis.analyze_function(function).is_err() {
+                continue;
+            }
+            
+            let count = |block: &usize| block_counts.get(block).copied().unwrap_or(0);
+            let mut loops = HashMap::new();
+            for loop_info in loop_analysis.loops() {
+                let header_count = count(&loop_info.header);
+                let back_edges: u64 = loop_info.back_edges.iter().map(|(latch, _)| count(latch)).sum();
+                let back_edges = back_edges.min(header_count);
+                let entry_count = header_count - back_edges;
+                if entry_count == 0 {
+                    continue;
+                }
+                loops.insert(loop_info.header, LoopProfile {
+                    entry_count,
+                    total_iterations: back_edges,
+                    avg_iterations: back_edges as f64 / entry_count as f64,
+                    max_iterations: 0,
+                });
+            }
+            if !loops.is_empty() {
+                self.profile_data.loop_iteration_counts.insert(function_name.clone(), loops);
             }
         }
+    }
+    
+    /// Save profile data to a file
+    pub fn save_profile_data<P: AsRef<Path>>(&self, path: P) -> Result<(), SemanticError> {
+        let mut file = File::create(path).map_err(|e| SemanticError::Internal {
+            message: format!("Failed to create profile data file: {}", e),
+        })?;
         
-        Ok(())
+        self.profile_data.write(&mut file).map_err(|e| SemanticError::Internal {
+            message: format!("Failed to write profile data: {}", e),
+        })
     }
     
     /// Get statistics about the loaded profile data
@@ -632,6 +648,316 @@ impl ProfileGuidedOptimizationPass {
     }
 }
 
+impl ProfileData {
+    /// Parse the profile of one or more runs
+    ///
+    /// Repeated records add up, so a raw profile may hold one counter per
+    /// call site. `EDGE` records hold the taken count of a branch whose total
+    /// is the count of its block.
+    pub fn parse<R: BufRead>(reader: R) -> Result<Self, SemanticError> {
+        let mut data = Self::default();
+        for line in reader.lines() {
+            let line = line.map_err(|e| SemanticError::Internal {
+                message: format!("Failed to read profile data: {}", e),
+            })?;
+            
+            data.parse_line(&line);
+        }
+        data.resolve_edges();
+        Ok(data)
+    }
+    
+    /// Parse a single line of profile data
+    fn parse_line(&mut self, line: &str) {
+        let parts: Vec<&str> = line.trim().split(':').collect();
+        if parts.len() < 3 {
+            return; // Skip malformed lines
+        }
+        let number = |index: usize| parts.get(index).and_then(|part| part.parse::<u64>().ok()).unwrap_or(0);
+        let block_id = || parts[2].parse::<usize>().unwrap_or(0);
+        let function_name = parts[1].to_string();
+        
+        match parts[0] {
+            "CFG" => {
+                // CFG checksum: CFG:function_name:checksum
+                if let Ok(checksum) = parts[2].parse::<u64>() {
+                    self.checksums.insert(function_name, checksum);
+                }
+            }
+            "FUNC" => {
+                // Function execution count: FUNC:function_name:count
+                *self.function_counts.entry(function_name).or_insert(0) += number(2);
+            }
+            "BLOCK" if parts.len() >= 4 => {
+                // Basic block execution count: BLOCK:function_name:block_id:count
+                *self.block_counts.entry(function_name).or_default().entry(block_id()).or_insert(0) += number(3);
+            }
+            "EDGE" if parts.len() >= 4 => {
+                // Taken branch edge: EDGE:function_name:block_id:count
+                *self.edge_counts.entry(function_name).or_default().entry(block_id()).or_insert(0) += number(3);
+            }
+            "BRANCH" if parts.len() >= 5 => {
+                // Branch profile: BRANCH:function_name:block_id:total:taken
+                self.add_branch(function_name, block_id(), number(3), number(4));
+            }
+            "CALL" if parts.len() >= 4 => {
+                // Function call frequency: CALL:caller:callee:count
+                let callee = parts[2].to_string();
+                *self.call_frequencies.entry(function_name).or_default().entry(callee).or_insert(0) += number(3);
+            }
+            "LOOP" if parts.len() >= 6 => {
+                // Loop profile: LOOP:function_name:block_id:entries:total_iterations:max_iterations
+                self.add_loop(function_name, block_id(), LoopProfile {
+                    entry_count: number(3),
+                    total_iterations: number(4),
+                    avg_iterations: 0.0,
+                    max_iterations: number(5),
+                });
+            }
+            _ => {
+                // Unknown profile data type, skip
+            }
+        }
+    }
+    
+    /// Turn edge counts into branch profiles using the block counts of the same run
+    fn resolve_edges(&mut self) {
+        for (function_name, edges) in std::mem::take(&mut self.edge_counts) {
+            for (block_id, taken) in edges {
+                let total = self.block_counts.get(&function_name)
+                    .and_then(|counts| counts.get(&block_id))
+                    .copied()
+                    .unwrap_or(taken);
+                self.add_branch(function_name.clone(), block_id, total, taken);
+            }
+        }
+    }
+    
+    fn add_branch(&mut self, function_name: String, block_id: usize, total: u64, taken: u64) {
+        let branch = self.branch_frequencies.entry(function_name).or_default().entry(block_id)
+            .or_insert(BranchProfile { total_count: 0, taken_count: 0, probability: 0.0 });
+        branch.total_count += total;
+        branch.taken_count += taken;
+        if branch.total_count > 0 {
+            branch.probability = branch.taken_count as f64 / branch.total_count as f64;
+        }
+    }
+    
+    fn add_loop(&mut self, function_name: String, block_id: usize, profile: LoopProfile) {
+        let entry = self.loop_iteration_counts.entry(function_name).or_default().entry(block_id)
+            .or_insert(LoopProfile { entry_count: 0, total_iterations: 0, avg_iterations: 0.0, max_iterations: 0 });
+        entry.entry_count += profile.entry_count;
+        entry.total_iterations += profile.total_iterations;
+        entry.max_iterations = entry.max_iterations.max(profile.max_iterations);
+        if entry.entry_count > 0 {
+            entry.avg_iterations = entry.total_iterations as f64 / entry.entry_count as f64;
+        }
+    }
+    
+    /// Forget the records that name blocks of `function_name`
+    fn remove_block_records(&mut self, function_name: &str) {
+        self.block_counts.remove(function_name);
+        self.branch_frequencies.remove(function_name);
+        self.loop_iteration_counts.remove(function_name);
+    }
+    
+    /// Add the counts of another run to this profile
+    ///
+    /// Block records of a run whose CFG checksum differs from the one already
+    /// loaded come from another build of the function and are left out.
+    pub fn merge(&mut self, mut other: ProfileData) {
+        for (function_name, checksum) in std::mem::take(&mut other.checksums) {
+            match self.checksums.get(&function_name) {
+                Some(&own) if own != checksum => other.remove_block_records(&function_name),
+                Some(_) => {}
+                None => {
+                    self.checksums.insert(function_name, checksum);
+                }
+            }
+        }
+        for (function_name, count) in other.function_counts {
+            *self.function_counts.entry(function_name).or_insert(0) += count;
+        }
+        for (function_name, blocks) in other.block_counts {
+            let counts = self.block_counts.entry(function_name).or_default();
+            for (block_id, count) in blocks {
+                *counts.entry(block_id).or_insert(0) += count;
+            }
+        }
+        for (function_name, branches) in other.branch_frequencies {
+            for (block_id, branch) in branches {
+                self.add_branch(function_name.clone(), block_id, branch.total_count, branch.taken_count);
+            }
+        }
+        for (caller, callees) in other.call_frequencies {
+            let counts = self.call_frequencies.entry(caller).or_default();
+            for (callee, count) in callees {
+                *counts.entry(callee).or_insert(0) += count;
+            }
+        }
+        for (function_name, loops) in other.loop_iteration_counts {
+            for (block_id, profile) in loops {
+                self.add_loop(function_name.clone(), block_id, profile);
+            }
+        }
+    }
+    
+    /// Write the profile in the format `parse` reads, sorted so merged
+    /// profiles diff cleanly
+    pub fn write<W: Write>(&self, out: &mut W) -> std::io::Result<()> {
+        for (function_name, checksum) in sorted(&self.checksums) {
+            writeln!(out, "CFG:{}:{}", function_name, checksum)?;
+        }
+        for (function_name, count) in sorted(&self.function_counts) {
+            writeln!(out, "FUNC:{}:{}", function_name, count)?;
+        }
+        for (function_name, blocks) in sorted(&self.block_counts) {
+            for (block_id, count) in sorted(blocks) {
+                writeln!(out, "BLOCK:{}:{}:{}", function_name, block_id, count)?;
+            }
+        }
+        for (function_name, branches) in sorted(&self.branch_frequencies) {
+            for (block_id, branch) in sorted(branches) {
+                writeln!(out, "BRANCH:{}:{}:{}:{}", function_name, block_id, branch.total_count, branch.taken_count)?;
+            }
+        }
+        for (caller, callees) in sorted(&self.call_frequencies) {
+            for (callee, count) in sorted(callees) {
+                writeln!(out, "CALL:{}:{}:{}", caller, callee, count)?;
+            }
+        }
+        for (function_name, loops) in sorted(&self.loop_iteration_counts) {
+            for (block_id, profile) in sorted(loops) {
+                writeln!(out, "LOOP:{}:{}:{}:{}:{}", function_name, block_id,
+                         profile.entry_count, profile.total_iterations, profile.max_iterations)?;
+            }
+        }
+        Ok(())
+    }
+}
+
+fn sorted<K: Ord, V>(map: &HashMap<K, V>) -> BTreeMap<&K, &V> {
+    map.iter().collect()
+}
+
+impl ProbePoint {
+    /// Name the runtime writes this probe's count under
+    pub fn counter_name(&self) -> String {
+        match &self.location {
+            ProbeLocation::FunctionEntry(function) => format!("FUNC:{}", function),
+            ProbeLocation::BasicBlock(function, block) => format!("BLOCK:{}:{}", function, block),
+            ProbeLocation::Branch(function, block) => format!("EDGE:{}:{}", function, block),
+            ProbeLocation::CallSite(caller, callee) => format!("CALL:{}:{}", caller, callee),
+            ProbeLocation::FunctionExit(function) => format!("EXIT:{}", function),
+            ProbeLocation::LoopHeader(function, block) => format!("HEADER:{}:{}", function, block),
+        }
+    }
+}
+
+impl ProfileInstrumentation {
+    fn add_counter(&mut self, location: ProbeLocation) -> u64 {
+        let id = self.probes.len() as u64;
+        self.probes.push(ProbePoint { id, location, probe_type: ProbeType::Counter });
+        id
+    }
+}
+
+/// Checksum of a function's control-flow graph: its blocks and their successors
+///
+/// FNV-1a over fixed-width values, so the checksum does not change between
+/// compiler builds.
+pub fn cfg_checksum(function: &Function) -> u64 {
+    fn add(hash: &mut u64, value: u64) {
+        for byte in value.to_le_bytes() {
+            *hash = (*hash ^ byte as u64).wrapping_mul(0x100000001b3);
+        }
+    }
+    
+    let mut hash = 0xcbf29ce484222325;
+    add(&mut hash, function.entry_block as u64);
+    for block_id in function.basic_blocks.ids() {
+        let successors = cfg::successors(&function.basic_blocks[block_id]);
+        add(&mut hash, block_id as u64);
+        add(&mut hash, successors.len() as u64);
+        for successor in successors {
+            add(&mut hash, successor as u64);
+        }
+    }
+    hash
+}
+
+/// Count entries, blocks, taken branch edges and calls to `defined` functions
+fn instrument_function(function: &mut Function, defined: &HashSet<String>, instrumentation: &mut ProfileInstrumentation) {
+    let name = function.name.clone();
+    instrumentation.checksums.push((name.clone(), cfg_checksum(function)));
+    let sink = void_local(function);
+    let blocks: Vec<BasicBlockId> = function.basic_blocks.ids().collect();
+    
+    // The taken edge of a two-way branch gets a block of its own to count in
+    for &block_id in &blocks {
+        let target = match &function.basic_blocks[block_id].terminator {
+            Terminator::SwitchInt { targets, .. } if targets.targets.len() == 1 => targets.targets[0],
+            _ => continue,
+        };
+        let counter = instrumentation.add_counter(ProbeLocation::Branch(name.clone(), block_id as usize));
+        let edge = function.basic_blocks.id_bound() as BasicBlockId;
+        function.basic_blocks.insert(edge, BasicBlock {
+            id: edge,
+            statements: vec![count_call(sink, counter)],
+            terminator: Terminator::Goto { target },
+        });
+        if let Terminator::SwitchInt { targets, .. } = &mut function.basic_blocks[block_id].terminator {
+            targets.targets[0] = edge;
+        }
+    }
+    
+    for &block_id in &blocks {
+        let mut statements = Vec::new();
+        if block_id == function.entry_block {
+            let counter = instrumentation.add_counter(ProbeLocation::FunctionEntry(name.clone()));
+            statements.push(count_call(sink, counter));
+        }
+        let counter = instrumentation.add_counter(ProbeLocation::BasicBlock(name.clone(), block_id as usize));
+        statements.push(count_call(sink, counter));
+        
+        for statement in std::mem::take(&mut function.basic_blocks[block_id].statements) {
+            if let Statement::Assign { rvalue: Rvalue::Call { func: Operand::Constant(Constant { value: ConstantValue::String(callee), .. }), .. }, .. } = &statement {
+                if defined.contains(callee) {
+                    let counter = instrumentation.add_counter(ProbeLocation::CallSite(name.clone(), callee.clone()));
+                    statements.push(count_call(sink, counter));
+                }
+            }
+            statements.push(statement);
+        }
+        function.basic_blocks[block_id].statements = statements;
+    }
+}
+
+fn void_local(function: &mut Function) -> LocalId {
+    function.locals.push(Local { ty: Type::primitive(PrimitiveType::Void), is_mutable: false, source_info: None })
+}
+
+fn count_call(sink: LocalId, counter: u64) -> Statement {
+    runtime_call(sink, "aether_profile_count", Operand::Constant(Constant {
+        ty: Type::primitive(PrimitiveType::Integer),
+        value: ConstantValue::Integer(counter as i128),
+    }))
+}
+
+fn runtime_call(sink: LocalId, name: &str, arg: Operand) -> Statement {
+    Statement::Assign {
+        place: Place { local: sink, projection: vec![] },
+        rvalue: Rvalue::Call {
+            func: Operand::Constant(Constant {
+                ty: Type::primitive(PrimitiveType::String),
+                value: ConstantValue::String(name.to_string()),
+            }),
+            args: vec![arg],
+        },
+        source_info: SourceInfo { span: SourceLocation::unknown(), scope: 0 },
+    }
+}
+
 /// Statistics about profile data
 #[derive(Debug)]
 pub struct ProfileStatistics {
@@ -654,12 +980,23 @@ impl OptimizationPass for ProfileGuidedOptimizationPass {
     }
     
     fn run_on_program(&mut self, program: &mut Program) -> Result<bool, SemanticError> {
+        if self.applied {
+            return Ok(false);
+        }
+        self.applied = true;
+        
         // Analyze profile data and make decisions
+        self.drop_stale_records(program);
+        self.derive_loop_profiles(program);
         self.analyze_and_decide()?;
         
         // Apply optimizations based on profile data
         self.apply_optimizations(program)
     }
+    
+    fn remarks(&self) -> &[Remark] {
+        &self.remarks
+    }
 }
 
 impl Default for ProfileGuidedOptimizationPass {
@@ -765,4 +1102,197 @@ mod tests {
         assert!(layout.hot_blocks.contains(&0));
         assert!(layout.cold_blocks.contains(&2));
     }
-}
\ No newline at end of file
+    
+    #[test]
+    fn test_profile_runs_merge() {
+        let run = "FUNC:main:1\nBLOCK:main:0:10\nEDGE:main:0:7\nCALL:main:helper:3\nCALL:main:helper:4\n";
+        let mut pass = ProfileGuidedOptimizationPass::new();
+        pass.parse_profile_data(Cursor::new(run)).unwrap();
+        pass.parse_profile_data(Cursor::new(run)).unwrap();
+        
+        let branch = &pass.profile_data.branch_frequencies["main"][&0];
+        assert_eq!((branch.total_count, branch.taken_count), (20, 14));
+        assert_eq!(pass.profile_data.block_counts["main"][&0], 20);
+        assert_eq!(pass.profile_data.call_frequencies["main"]["helper"], 14);
+        
+        // The merged profile reads back unchanged
+        let mut merged = Vec::new();
+        pass.profile_data.write(&mut merged).unwrap();
+        let reread = ProfileData::parse(Cursor::new(&merged)).unwrap();
+        let mut rewritten = Vec::new();
+        reread.write(&mut rewritten).unwrap();
+        assert_eq!(String::from_utf8(merged).unwrap(), String::from_utf8(rewritten).unwrap());
+    }
+    
+    #[test]
+    fn test_generate_instrumentation() {
+        use crate::ast::PrimitiveType;
+        use crate::mir::{Builder, SwitchTargets};
+        
+        let mut builder = Builder::new();
+        builder.start_function("helper".to_string(), vec![], Type::primitive(PrimitiveType::Void));
+        builder.set_terminator(Terminator::Return);
+        let helper = builder.finish_function();
+        
+        // main: if (flag) { helper() }
+        builder.start_function("main".to_string(), vec![], Type::primitive(PrimitiveType::Void));
+        let flag = builder.new_local(Type::primitive(PrimitiveType::Boolean), false);
+        let result = builder.new_local(Type::primitive(PrimitiveType::Void), false);
+        let then_block = builder.new_block();
+        let exit = builder.new_block();
+        builder.set_terminator(Terminator::SwitchInt {
+            discriminant: Operand::Copy(Place { local: flag, projection: vec![] }),
+            switch_ty: Type::primitive(PrimitiveType::Boolean),
+            targets: SwitchTargets { values: vec![1], targets: vec![then_block], otherwise: exit, weights: vec![] },
+        });
+        builder.switch_to_block(then_block);
+        builder.push_statement(Statement::Assign {
+            place: Place { local: result, projection: vec![] },
+            rvalue: Rvalue::Call {
+                func: Operand::Constant(Constant {
+                    ty: Type::primitive(PrimitiveType::String),
+                    value: ConstantValue::String("helper".to_string()),
+                }),
+                args: vec![],
+            },
+            source_info: SourceInfo { span: SourceLocation::unknown(), scope: 0 },
+        });
+        builder.set_terminator(Terminator::Goto { target: exit });
+        builder.switch_to_block(exit);
+        builder.set_terminator(Terminator::Return);
+        let main = builder.finish_function();
+        
+        let mut program = Program {
+            functions: HashMap::from([("helper".to_string(), helper), ("main".to_string(), main)]),
+            global_constants: HashMap::new(),
+            external_functions: HashMap::new(),
+            type_definitions: HashMap::new(),
+        };
+        let checksums = [cfg_checksum(&program.functions["helper"]), cfg_checksum(&program.functions["main"])];
+        let instrumentation = ProfileGuidedOptimizationPass::new().generate_instrumentation(&mut program).unwrap();
+        let names: Vec<String> = instrumentation.probes.iter().map(ProbePoint::counter_name).collect();
+        assert_eq!(names, vec![
+            "FUNC:helper", "BLOCK:helper:0",
+            "EDGE:main:0", "FUNC:main", "BLOCK:main:0", "BLOCK:main:1", "CALL:main:helper", "BLOCK:main:2",
+        ]);
+        
+        // The taken edge runs through a counting block to the old target
+        let main = &program.functions["main"];
+        let edge = match &main.basic_blocks[main.entry_block].terminator {
+            Terminator::SwitchInt { targets, .. } => targets.targets[0],
+            other => panic!("unexpected terminator {:?}", other),
+        };
+        assert!(matches!(main.basic_blocks[edge].terminator, Terminator::Goto { target } if target == then_block));
+        
+        // main registers the counter names and checksums before counting anything
+        let table = format!("{}\nCFG:helper:{}\nCFG:main:{}", names.join("\n"), checksums[0], checksums[1]);
+        match &main.basic_blocks[main.entry_block].statements[0] {
+            Statement::Assign { rvalue: Rvalue::Call { func, args }, .. } => {
+                assert!(matches!(func, Operand::Constant(Constant { value: ConstantValue::String(name), .. }) if name == "aether_profile_init"));
+                assert!(matches!(&args[0], Operand::Constant(Constant { value: ConstantValue::String(t), .. }) if *t == table));
+            }
+            other => panic!("unexpected statement {:?}", other),
+        }
+    }
+    
+    #[test]
+    fn test_profile_layout_and_branch_weights() {
+        use crate::ast::PrimitiveType;
+        use crate::mir::{Builder, SwitchTargets};
+        
+        // if (flag) { rare } else { common }; both join at exit
+        let mut builder = Builder::new();
+        builder.start_function("f".to_string(), vec![], Type::primitive(PrimitiveType::Void));
+        let flag = builder.new_local(Type::primitive(PrimitiveType::Boolean), false);
+        let rare = builder.new_block();
+        let common = builder.new_block();
+        let exit = builder.new_block();
+        builder.set_terminator(Terminator::SwitchInt {
+            discriminant: Operand::Copy(Place { local: flag, projection: vec![] }),
+            switch_ty: Type::primitive(PrimitiveType::Boolean),
+            targets: SwitchTargets { values: vec![1], targets: vec![rare], otherwise: common, weights: vec![] },
+        });
+        for block in [rare, common] {
+            builder.switch_to_block(block);
+            builder.set_terminator(Terminator::Goto { target: exit });
+        }
+        builder.switch_to_block(exit);
+        builder.set_terminator(Terminator::Return);
+        let function = builder.finish_function();
+        
+        let mut program = Program {
+            functions: HashMap::from([("f".to_string(), function)]),
+            global_constants: HashMap::new(),
+            external_functions: HashMap::new(),
+            type_definitions: HashMap::new(),
+        };
+        let profile = "FUNC:f:1000\nBLOCK:f:0:1000\nBLOCK:f:1:0\nBLOCK:f:2:1000\nBLOCK:f:3:1000\nEDGE:f:0:0\n";
+        let mut pass = ProfileGuidedOptimizationPass::new();
+        pass.parse_profile_data(Cursor::new(profile)).unwrap();
+        assert!(pass.run_on_program(&mut program).unwrap());
+        
+        // The common path falls through and the rare block moves to the end
+        let function = &program.functions["f"];
+        assert_eq!(function.entry_count, Some(1000));
+        match &function.basic_blocks[function.entry_block].terminator {
+            Terminator::SwitchInt { targets, .. } => {
+                assert_eq!(targets.weights, vec![0, 1000]);
+                assert_eq!((targets.targets[0], targets.otherwise), (3, 1));
+            }
+            other => panic!("unexpected terminator {:?}", other),
+        }
+        assert!(matches!(function.basic_blocks[1].terminator, Terminator::Goto { target: 2 }));
+        assert!(matches!(function.basic_blocks[2].terminator, Terminator::Return));
+        
+        // The profile applies once; later runs would see renumbered blocks
+        assert!(!pass.run_on_program(&mut program).unwrap());
+    }
+    
+    #[test]
+    fn test_stale_profile_records_dropped() {
+        use crate::ast::PrimitiveType;
+        use crate::mir::Builder;
+        
+        // f: block 0 -> block 1 -> return
+        let mut builder = Builder::new();
+        builder.start_function("f".to_string(), vec![], Type::primitive(PrimitiveType::Void));
+        let next = builder.new_block();
+        builder.set_terminator(Terminator::Goto { target: next });
+        builder.switch_to_block(next);
+        builder.set_terminator(Terminator::Return);
+        let function = builder.finish_function();
+        let checksum = cfg_checksum(&function);
+        
+        let mut program = Program {
+            functions: HashMap::from([("f".to_string(), function)]),
+            global_constants: HashMap::new(),
+            external_functions: HashMap::new(),
+            type_definitions: HashMap::new(),
+        };
+        
+        // A profile of the same CFG is applied
+        let profile = format!("CFG:f:{}\nFUNC:f:5\nBLOCK:f:0:5\nBLOCK:f:1:5\n", checksum);
+        let mut pass = ProfileGuidedOptimizationPass::new();
+        pass.parse_profile_data(Cursor::new(profile)).unwrap();
+        pass.drop_stale_records(&program);
+        assert!(pass.profile_data.block_counts.contains_key("f"));
+        assert!(pass.remarks().is_empty());
+        
+        // Once the CFG changes, the block records are dropped with a remark;
+        // the entry count still applies
+        let profile = format!("CFG:f:{}\nFUNC:f:5\nBLOCK:f:0:5\nBLOCK:f:1:5\nEDGE:f:0:5\n", checksum ^ 1);
+        let mut pass = ProfileGuidedOptimizationPass::new();
+        pass.parse_profile_data(Cursor::new(profile)).unwrap();
+        pass.run_on_program(&mut program).unwrap();
+        assert!(!pass.profile_data.block_counts.contains_key("f"));
+        assert!(!pass.profile_data.branch_frequencies.contains_key("f"));
+        assert_eq!(program.functions["f"].entry_count, Some(5));
+        assert!(pass.remarks()[0].message.starts_with("profile block counts ignored"));
+        
+        // Merging a run of another build keeps only the counts that fit the first
+        let mut merged = ProfileData::parse(Cursor::new(format!("CFG:f:{}\nBLOCK:f:0:5\n", checksum))).unwrap();
+        merged.merge(ProfileData::parse(Cursor::new(format!("CFG:f:{}\nBLOCK:f:0:7\n", checksum ^ 1))).unwrap());
+        assert_eq!(merged.block_counts["f"][&0], 5);
+        assert_eq!(merged.checksums["f"], checksum);
+    }
+}
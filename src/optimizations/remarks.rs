@@ -0,0 +1,73 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Optimization remarks
+//!
+//! Passes record why they did or did not transform a piece of code, so the
+//! decisions can be reviewed after a build.
+
+use serde::Serialize;
+use std::fmt;
+
+/// Whether a remark records a transformation or a declined one
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize)]
+#[serde(rename_all = "lowercase")]
+pub enum RemarkKind {
+    /// The transformation was made
+    Applied,
+
+    /// The transformation was considered and rejected
+    Missed,
+}
+
+/// One optimizer decision and its reason
+#[derive(Debug, Clone, PartialEq, Serialize)]
+pub struct Remark {
+    /// Name of the pass that made the decision
+    pub pass: &'static str,
+
+    pub kind: RemarkKind,
+
+    /// Function the decision was made in
+    pub function: String,
+
+    pub message: String,
+}
+
+impl Remark {
+    pub fn applied(pass: &'static str, function: &str, message: String) -> Self {
+        Self { pass, kind: RemarkKind::Applied, function: function.to_string(), message }
+    }
+
+    pub fn missed(pass: &'static str, function: &str, message: String) -> Self {
+        Self { pass, kind: RemarkKind::Missed, function: function.to_string(), message }
+    }
+}
+
+/// Record `remark` once, however many times the pipeline reruns a pass
+pub fn record(remarks: &mut Vec<Remark>, remark: Remark) {
+    if !remarks.contains(&remark) {
+        remarks.push(remark);
+    }
+}
+
+impl fmt::Display for Remark {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        let kind = match self.kind {
+            RemarkKind::Applied => "applied",
+            RemarkKind::Missed => "missed",
+        };
+        write!(f, "{} [{}] in {}: {}", self.pass, kind, self.function, self.message)
+    }
+}
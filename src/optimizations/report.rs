@@ -0,0 +1,181 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Optimization reports
+//!
+//! A pipeline run records how long each pass took, how often it ran and
+//! changed code, and the remarks the passes made. `--time-passes` prints the
+//! timings and `--opt-remarks` writes the remarks as YAML or JSON.
+
+use super::remarks::{Remark, RemarkKind};
+use std::collections::BTreeMap;
+use std::fmt::Write;
+use std::path::Path;
+use std::time::Duration;
+
+/// Time spent in one pass of a pipeline
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct PassTiming {
+    pub pass: &'static str,
+
+    /// Times the pass ran
+    pub runs: usize,
+
+    /// Runs that changed the code
+    pub changes: usize,
+
+    pub time: Duration,
+}
+
+impl PassTiming {
+    pub fn new(pass: &'static str) -> Self {
+        Self { pass, runs: 0, changes: 0, time: Duration::ZERO }
+    }
+}
+
+/// What one or more runs of a pipeline did
+#[derive(Debug, Clone, Default)]
+pub struct OptimizationReport {
+    /// Transformations made, by statistic name
+    pub statistics: BTreeMap<&'static str, usize>,
+
+    /// Remarks in pipeline order
+    pub remarks: Vec<Remark>,
+
+    /// One entry per pass, in pipeline order
+    pub timings: Vec<PassTiming>,
+
+    /// Fixed-point iterations, summed over runs
+    pub iterations: usize,
+}
+
+impl OptimizationReport {
+    /// Add a report from another run of the same pipeline
+    ///
+    /// Times are summed, so reports merged from parallel workers give CPU
+    /// time rather than wall-clock time.
+    pub fn merge(&mut self, other: OptimizationReport) {
+        for (name, count) in other.statistics {
+            *self.statistics.entry(name).or_insert(0) += count;
+        }
+        self.remarks.extend(other.remarks);
+        if self.timings.is_empty() {
+            self.timings = other.timings;
+        } else {
+            for (timing, other) in self.timings.iter_mut().zip(other.timings) {
+                timing.runs += other.runs;
+                timing.changes += other.changes;
+                timing.time += other.time;
+            }
+        }
+        self.iterations += other.iterations;
+    }
+
+    /// Add a report from the pipeline stage that ran after this one
+    pub fn append(&mut self, other: OptimizationReport) {
+        for (name, count) in other.statistics {
+            *self.statistics.entry(name).or_insert(0) += count;
+        }
+        self.remarks.extend(other.remarks);
+        self.timings.extend(other.timings);
+        self.iterations += other.iterations;
+    }
+
+    /// Total time spent in passes
+    pub fn total_time(&self) -> Duration {
+        self.timings.iter().map(|timing| timing.time).sum()
+    }
+
+    /// Per-pass microseconds, runs and changing runs, slowest pass first
+    pub fn timing_table(&self) -> String {
+        let mut timings: Vec<&PassTiming> = self.timings.iter().collect();
+        timings.sort_by(|a, b| b.time.cmp(&a.time));
+
+        let mut table = String::new();
+        let _ = writeln!(table, "===== Optimization pass timings =====");
+        let _ = writeln!(table, "  Total: {} us over {} iterations", self.total_time().as_micros(), self.iterations);
+        let _ = writeln!(table, "  {:>12}  {:>6}  {:>7}  Pass", "Time (us)", "Runs", "Changed");
+        for timing in timings {
+            let _ = writeln!(table, "  {:>12}  {:>6}  {:>7}  {}", timing.time.as_micros(), timing.runs, timing.changes, timing.pass);
+        }
+        table
+    }
+
+    /// The remarks as a JSON array
+    pub fn remarks_json(&self) -> String {
+        serde_json::to_string_pretty(&self.remarks).unwrap_or_else(|_| "[]".to_string())
+    }
+
+    /// The remarks as a stream of YAML documents, one per remark
+    pub fn remarks_yaml(&self) -> String {
+        let mut yaml = String::new();
+        for remark in &self.remarks {
+            let tag = match remark.kind {
+                RemarkKind::Applied => "Applied",
+                RemarkKind::Missed => "Missed",
+            };
+            let _ = writeln!(yaml, "--- !{}", tag);
+            let _ = writeln!(yaml, "Pass: {}", quote(remark.pass));
+            let _ = writeln!(yaml, "Function: {}", quote(&remark.function));
+            let _ = writeln!(yaml, "Message: {}", quote(&remark.message));
+            let _ = writeln!(yaml, "...");
+        }
+        yaml
+    }
+
+    /// Write the remarks to `path`: JSON if it ends in `.json`, YAML otherwise
+    pub fn write_remarks(&self, path: &Path) -> std::io::Result<()> {
+        let contents = match path.extension().and_then(|extension| extension.to_str()) {
+            Some("json") => self.remarks_json(),
+            _ => self.remarks_yaml(),
+        };
+        std::fs::write(path, contents)
+    }
+}
+
+/// A single-quoted YAML scalar
+fn quote(value: &str) -> String {
+    format!("'{}'", value.replace('\'', "''"))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_merge_and_render() {
+        let mut report = OptimizationReport::default();
+        for micros in [30, 50] {
+            let mut folding = PassTiming::new("constant-folding");
+            folding.runs = 2;
+            folding.changes = 1;
+            folding.time = Duration::from_micros(micros);
+            report.merge(OptimizationReport {
+                statistics: [("constants folded", 3)].into_iter().collect(),
+                remarks: vec![Remark::missed("inlining", "main", "`fact` not inlined: recursive call".to_string())],
+                timings: vec![folding, PassTiming::new("inlining")],
+                iterations: 2,
+            });
+        }
+
+        assert_eq!(report.statistics["constants folded"], 6);
+        assert_eq!(report.timings[0].runs, 4);
+        assert_eq!(report.total_time(), Duration::from_micros(80));
+        assert!(report.timing_table().contains("  Total: 80 us over 4 iterations"));
+        assert!(report.remarks_yaml().starts_with(
+            "--- !Missed\nPass: 'inlining'\nFunction: 'main'\nMessage: '`fact` not inlined: recursive call'\n...\n"
+        ));
+        assert!(report.remarks_json().contains("\"kind\": \"missed\""));
+    }
+}
@@ -0,0 +1,431 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Scalar replacement of aggregates and stack allocation
+//!
+//! A struct local that is only built, copied whole, and accessed field by
+//! field is split into one local per field, so the backend never
+//! materializes the struct. An `array_create` of a small constant length
+//! whose array does not escape, made outside every loop, becomes
+//! `array_create_stack`, which the backend lowers to an `alloca` instead of
+//! a runtime heap allocation.
+
+use super::interprocedural::EscapeAnalysis;
+use super::loop_optimizations::LoopOptimizationPass;
+use super::OptimizationPass;
+use crate::error::SemanticError;
+use crate::mir::{
+    AggregateKind, Constant, ConstantValue, Function, Local, LocalId, Operand, Place, PlaceElem, Rvalue, Statement,
+};
+use crate::types::{OwnershipKind, Type};
+use std::collections::{HashMap, HashSet};
+
+/// Longest array, in elements, moved to the stack
+pub const MAX_STACK_ARRAY_LENGTH: i128 = 64;
+
+/// Splits struct locals into fields and moves small local arrays to the stack
+#[derive(Debug)]
+pub struct ScalarReplacementPass {
+    loop_analysis: LoopOptimizationPass,
+    stack_allocations: usize,
+    scalarized_aggregates: usize,
+}
+
+impl ScalarReplacementPass {
+    pub fn new() -> Self {
+        Self {
+            loop_analysis: LoopOptimizationPass::new(),
+            stack_allocations: 0,
+            scalarized_aggregates: 0,
+        }
+    }
+
+    /// Heap allocations turned into stack allocations so far
+    pub fn stack_allocations(&self) -> usize {
+        self.stack_allocations
+    }
+
+    /// Struct locals split into per-field locals so far
+    pub fn scalarized_aggregates(&self) -> usize {
+        self.scalarized_aggregates
+    }
+
+    /// Rename `array_create` calls whose array can live in the frame
+    fn allocate_arrays_on_stack(&mut self, function: &mut Function) -> Result<usize, SemanticError> {
+        self.loop_analysis.analyze_function(function)?;
+        let escaping = EscapeAnalysis::escaping_locals(function);
+        let classes = EscapeAnalysis::copy_classes(function);
+
+        // The backend drops owned arrays through the runtime, which must not
+        // see a stack address
+        let owned: HashSet<LocalId> = classes.iter()
+            .filter(|class| class.iter().any(|&local| matches!(
+                function.locals.get(local).map(|local| &local.ty),
+                Some(Type::Owned { ownership: OwnershipKind::Owned, .. })
+            )))
+            .flatten()
+            .copied()
+            .collect();
+
+        let mut converted = 0;
+        for (block_id, block) in function.basic_blocks.iter_mut() {
+            if self.loop_analysis.loops().iter().any(|loop_info| loop_info.blocks.contains(&(block_id as usize))) {
+                continue;
+            }
+            for statement in &mut block.statements {
+                if let Statement::Assign { place, rvalue: Rvalue::Call { func: Operand::Constant(constant), args }, .. } = statement {
+                    let small = matches!(
+                        args.as_slice(),
+                        [Operand::Constant(Constant { value: ConstantValue::Integer(length), .. })]
+                            if (1..=MAX_STACK_ARRAY_LENGTH).contains(length)
+                    );
+                    let local = place.local;
+                    if let ConstantValue::String(name) = &mut constant.value {
+                        if name == "array_create" && small && place.projection.is_empty()
+                            && !escaping.contains(&local) && !owned.contains(&local)
+                        {
+                            *name = "array_create_stack".to_string();
+                            converted += 1;
+                        }
+                    }
+                }
+            }
+        }
+        Ok(converted)
+    }
+
+    /// Field types of a copy class that can be split, or `None`
+    ///
+    /// Every mention of a member must be a struct aggregate assigned to it,
+    /// a whole copy between members, a single field projection, or a storage
+    /// marker.
+    fn splittable_fields(&self, function: &Function, class: &[LocalId]) -> Option<Vec<Type>> {
+        let members: HashSet<LocalId> = class.iter().copied().collect();
+        if function.parameters.iter().any(|parameter| members.contains(&parameter.local_id))
+            || function.return_local.is_some_and(|local| members.contains(&local))
+        {
+            return None;
+        }
+
+        // Aggregates fix the width, which projections are checked against
+        let mut width = None;
+        for block in function.basic_blocks.values() {
+            for statement in &block.statements {
+                if let Statement::Assign { place, rvalue: Rvalue::Aggregate { kind: AggregateKind::Struct(..), operands }, .. } = statement {
+                    if members.contains(&place.local) && place.projection.is_empty() {
+                        if width.is_some_and(|width| width != operands.len()) {
+                            return None;
+                        }
+                        width = Some(operands.len());
+                    }
+                }
+            }
+        }
+        let mut fields: Vec<Option<Type>> = vec![None; width?];
+        let mut record = |index: u32, ty: &Type| -> bool {
+            match fields.get_mut(index as usize) {
+                Some(field) => {
+                    field.get_or_insert_with(|| ty.clone());
+                    true
+                }
+                None => false,
+            }
+        };
+        let mut mentions = 0;
+        let mut accounted = 0;
+
+        for block in function.basic_blocks.values() {
+            for statement in &block.statements {
+                statement.visit_locals(|local| mentions += members.contains(&local) as usize);
+                match statement {
+                    Statement::Assign { place, rvalue, .. } => {
+                        let mut operands = rvalue.operands();
+                        if members.contains(&place.local) {
+                            match (place.projection.as_slice(), rvalue) {
+                                ([], Rvalue::Aggregate { kind: AggregateKind::Struct(..), operands }) => {
+                                    for (index, operand) in operands.iter().enumerate() {
+                                        if let Some(ty) = operand_type(function, operand) {
+                                            record(index as u32, &ty);
+                                        }
+                                    }
+                                    accounted += 1;
+                                }
+                                ([], Rvalue::Use(Operand::Copy(source) | Operand::Move(source)))
+                                    if source.projection.is_empty() && members.contains(&source.local) =>
+                                {
+                                    accounted += 2;
+                                    operands.clear();
+                                }
+                                ([PlaceElem::Field { field: index, ty }], _) => {
+                                    if !record(*index, ty) {
+                                        return None;
+                                    }
+                                    accounted += 1;
+                                }
+                                _ => return None,
+                            }
+                        }
+                        for operand in operands {
+                            if let Operand::Copy(source) | Operand::Move(source) = operand {
+                                if let (true, [PlaceElem::Field { field: index, ty }]) =
+                                    (members.contains(&source.local), source.projection.as_slice())
+                                {
+                                    if !record(*index, ty) {
+                                        return None;
+                                    }
+                                    accounted += 1;
+                                }
+                            }
+                        }
+                    }
+                    Statement::StorageLive(local) | Statement::StorageDead(local) if members.contains(local) => accounted += 1,
+                    _ => {}
+                }
+            }
+            block.terminator.visit_locals(|local| mentions += members.contains(&local) as usize);
+        }
+
+        if mentions != accounted {
+            return None;
+        }
+        fields.into_iter().collect()
+    }
+
+    /// Replace every member of the split classes with its field locals
+    fn scalarize(&mut self, function: &mut Function, split: Vec<(Vec<LocalId>, Vec<Type>)>) {
+        let mut replacements: HashMap<LocalId, Vec<LocalId>> = HashMap::new();
+        for (class, types) in split {
+            for member in class {
+                let source_info = function.locals.get(member).and_then(|local| local.source_info.clone());
+                let locals = types.iter()
+                    .map(|ty| function.locals.push(Local { ty: ty.clone(), is_mutable: true, source_info: source_info.clone() }))
+                    .collect();
+                replacements.insert(member, locals);
+                function.locals.remove(member);
+                self.scalarized_aggregates += 1;
+            }
+        }
+
+        let field_place = |place: &Place| -> Option<Place> {
+            match place.projection.as_slice() {
+                [PlaceElem::Field { field, .. }] => replacements.get(&place.local)
+                    .map(|locals| Place { local: locals[*field as usize], projection: vec![] }),
+                _ => None,
+            }
+        };
+
+        for block in function.basic_blocks.values_mut() {
+            let mut statements = Vec::with_capacity(block.statements.len());
+            for mut statement in std::mem::take(&mut block.statements) {
+                if let Statement::Assign { rvalue, .. } = &mut statement {
+                    for operand in rvalue.operands_mut() {
+                        if let Operand::Copy(place) | Operand::Move(place) = operand {
+                            if let Some(field) = field_place(place) {
+                                *place = field;
+                            }
+                        }
+                    }
+                }
+
+                match statement {
+                    Statement::Assign { place, rvalue, source_info } if replacements.contains_key(&place.local) => {
+                        if let Some(field) = field_place(&place) {
+                            statements.push(Statement::Assign { place: field, rvalue, source_info });
+                            continue;
+                        }
+                        let locals = &replacements[&place.local];
+                        let values: Vec<Operand> = match rvalue {
+                            Rvalue::Aggregate { operands, .. } => operands,
+                            Rvalue::Use(Operand::Copy(source) | Operand::Move(source)) => replacements[&source.local].iter()
+                                .map(|&local| Operand::Copy(Place { local, projection: vec![] }))
+                                .collect(),
+                            _ => unreachable!("split locals are only built or copied whole"),
+                        };
+                        for (&local, value) in locals.iter().zip(values) {
+                            statements.push(Statement::Assign {
+                                place: Place { local, projection: vec![] },
+                                rvalue: Rvalue::Use(value),
+                                source_info: source_info.clone(),
+                            });
+                        }
+                    }
+                    Statement::StorageLive(local) if replacements.contains_key(&local) => {
+                        statements.extend(replacements[&local].iter().map(|&field| Statement::StorageLive(field)));
+                    }
+                    Statement::StorageDead(local) if replacements.contains_key(&local) => {
+                        statements.extend(replacements[&local].iter().map(|&field| Statement::StorageDead(field)));
+                    }
+                    statement => statements.push(statement),
+                }
+            }
+            block.statements = statements;
+        }
+    }
+}
+
+impl OptimizationPass for ScalarReplacementPass {
+    fn name(&self) -> &'static str {
+        "scalar-replacement"
+    }
+
+    fn is_function_local(&self) -> bool {
+        true
+    }
+
+    fn run_on_function(&mut self, function: &mut Function) -> Result<bool, SemanticError> {
+        let split: Vec<(Vec<LocalId>, Vec<Type>)> = EscapeAnalysis::copy_classes(function).iter()
+            .filter_map(|class| self.splittable_fields(function, class).map(|types| (class.clone(), types)))
+            .collect();
+        let scalarized = !split.is_empty();
+        if scalarized {
+            self.scalarize(function, split);
+        }
+
+        let converted = self.allocate_arrays_on_stack(function)?;
+        self.stack_allocations += converted;
+
+        Ok(scalarized || converted > 0)
+    }
+
+    fn statistics(&self) -> Vec<(&'static str, usize)> {
+        vec![
+            ("allocations moved to the stack", self.stack_allocations),
+            ("struct locals scalarized", self.scalarized_aggregates),
+        ]
+    }
+}
+
+impl Default for ScalarReplacementPass {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Type of the value `operand` produces, when the MIR records it
+fn operand_type(function: &Function, operand: &Operand) -> Option<Type> {
+    match operand {
+        Operand::Constant(constant) => Some(constant.ty.clone()),
+        Operand::Copy(place) | Operand::Move(place) => match place.projection.last() {
+            None => function.locals.get(place.local).map(|local| local.ty.clone()),
+            Some(PlaceElem::Field { ty, .. }) => Some(ty.clone()),
+            Some(_) => None,
+        },
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::mir::Program;
+
+    fn lower(source: &str) -> Program {
+        let tokens = crate::lexer::Lexer::new(source, "test.aether".to_string()).tokenize().unwrap();
+        let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+        let mut analyzer = crate::semantic::SemanticAnalyzer::new();
+        analyzer.analyze_program(&program).unwrap();
+        crate::mir::lowering::lower_ast_to_mir_with_symbols(&program, analyzer.get_symbol_table()).unwrap()
+    }
+
+    fn calls(function: &Function, name: &str) -> usize {
+        function.basic_blocks.values()
+            .flat_map(|block| block.statements.iter())
+            .filter(|statement| matches!(
+                statement,
+                Statement::Assign { rvalue: Rvalue::Call { func: Operand::Constant(Constant { value: ConstantValue::String(callee), .. }), .. }, .. }
+                    if callee == name
+            ))
+            .count()
+    }
+
+    #[test]
+    fn test_local_struct_and_array_are_replaced() {
+        let mut program = lower(r#"
+(DEFINE_MODULE
+  (NAME sroa)
+  (CONTENT
+    (DEFINE_STRUCTURED_TYPE
+      (NAME Point)
+      (FIELD x INTEGER)
+      (FIELD y INTEGER))
+    (DEFINE_FUNCTION
+      (NAME manhattan)
+      (ACCEPTS_PARAMETER (NAME "a") (TYPE INTEGER))
+      (ACCEPTS_PARAMETER (NAME "b") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (DECLARE_VARIABLE (NAME p) (TYPE Point))
+        (ASSIGN (TARGET_VARIABLE p) (SOURCE_EXPRESSION (CONSTRUCT Point (FIELD_VALUE x a) (FIELD_VALUE y b))))
+        (DECLARE_VARIABLE (NAME squares) (TYPE (ARRAY_OF_TYPE INTEGER)) (VALUE (ARRAY_LITERAL 1 4 9 16)))
+        (RETURN_VALUE (EXPRESSION_ADD (EXPRESSION_ADD (GET_FIELD_VALUE p x) (GET_FIELD_VALUE p y)) (GET_ARRAY_ELEMENT squares 2)))))))
+"#);
+        let mut pass = ScalarReplacementPass::new();
+        assert!(pass.run_on_program(&mut program).unwrap());
+
+        let function = &program.functions["manhattan"];
+        assert!(function.locals.values().all(|local| !matches!(local.ty, Type::Named { .. })));
+        let mut projected = false;
+        for block in function.basic_blocks.values() {
+            for statement in &block.statements {
+                if let Statement::Assign { place, rvalue, .. } = statement {
+                    projected |= !place.projection.is_empty();
+                    projected |= rvalue.operands().iter().any(|operand| matches!(
+                        operand, Operand::Copy(place) | Operand::Move(place) if !place.projection.is_empty()
+                    ));
+                }
+            }
+        }
+        assert!(!projected);
+        assert_eq!(calls(function, "array_create"), 0);
+        assert_eq!(calls(function, "array_create_stack"), 1);
+        assert_eq!(pass.stack_allocations(), 1);
+        assert!(pass.statistics().contains(&("allocations moved to the stack", 1)));
+        assert!(crate::mir::validation::Validator::new().validate_function(function).is_ok());
+
+        // Nothing left to replace on a second run
+        assert!(!pass.run_on_program(&mut program).unwrap());
+    }
+
+    #[test]
+    fn test_escaping_values_stay_in_memory() {
+        let mut program = lower(r#"
+(DEFINE_MODULE
+  (NAME escapes)
+  (CONTENT
+    (DEFINE_STRUCTURED_TYPE
+      (NAME Point)
+      (FIELD x INTEGER)
+      (FIELD y INTEGER))
+    (DEFINE_FUNCTION
+      (NAME origin)
+      (RETURNS Point)
+      (BODY
+        (RETURN_VALUE (CONSTRUCT Point (FIELD_VALUE x 0) (FIELD_VALUE y 0)))))
+    (DEFINE_FUNCTION
+      (NAME make)
+      (RETURNS (ARRAY_OF_TYPE INTEGER))
+      (BODY
+        (DECLARE_VARIABLE (NAME values) (TYPE (ARRAY_OF_TYPE INTEGER)) (VALUE (ARRAY_LITERAL 1 2 3)))
+        (RETURN_VALUE values)))))
+"#);
+        let mut pass = ScalarReplacementPass::new();
+        pass.run_on_program(&mut program).unwrap();
+
+        assert_eq!(calls(&program.functions["make"], "array_create"), 1);
+        assert_eq!(pass.stack_allocations(), 0);
+        let origin = &program.functions["origin"];
+        assert!(origin.basic_blocks.values().flat_map(|block| block.statements.iter()).any(|statement| matches!(
+            statement, Statement::Assign { rvalue: Rvalue::Aggregate { kind: AggregateKind::Struct(..), .. }, .. }
+        )));
+    }
+}
@@ -258,6 +258,7 @@ impl WholeProgramOptimizationPass {
                     _ => false,
                 }
             }
+            Statement::VectorStore { .. } => true,
             Statement::StorageLive(_) => false,
             Statement::StorageDead(_) => false,
             Statement::Nop => false,
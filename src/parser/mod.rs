@@ -17,18 +17,26 @@
 //! Converts token stream to Abstract Syntax Tree
 
 use crate::ast::*;
+use crate::ast::arena::{AstArena, FunctionId};
 use crate::ast::CastFailureBehavior;
-use crate::error::{ParserError, SourceLocation};
-use crate::lexer::{Token, TokenType};
+use crate::error::{LexerError, ParserError, SourceLocation};
+use crate::lexer::{Lexer, Token, TokenStream, TokenType};
 use std::collections::HashMap;
 
+/// Tokens the parser may look ahead of its current position
+const LOOKAHEAD: usize = 8;
+/// Tokens kept behind the current position for backtracking
+const HISTORY: usize = 8;
+
 /// Parser for AetherScript source code
 pub struct Parser {
-    tokens: Vec<Token>,
+    tokens: TokenStream,
     position: usize,
     keywords: HashMap<String, KeywordType>,
     errors: Vec<ParserError>,
     recovery_mode: bool,
+    /// Flattened copy of every function and module parsed so far, when requested
+    arena: Option<AstArena>,
 }
 
 /// Keyword types for parsing
@@ -70,6 +78,7 @@ pub enum KeywordType {
     MapFromTypeToType,
     PointerTo,
     FunctionType,
+    VectorOfType,
     
     // Calling convention alias
     Convention,
@@ -81,6 +90,7 @@ pub enum KeywordType {
     AlgorithmHint,
     PerformanceExpectation,
     ComplexityExpectation,
+    ContractChecks,
     
     // Performance metric keywords
     LatencyMs,
@@ -209,6 +219,15 @@ pub enum KeywordType {
     ArrayLength,
     MapLiteral,
     
+    // SIMD vector operations
+    VectorLiteral,
+    VectorSplat,
+    VectorLoad,
+    VectorStore,
+    VectorShuffle,
+    VectorExtract,
+    VectorSelect,
+    
     // Misc keywords
     Name,
     Type,
@@ -252,14 +271,25 @@ pub enum KeywordType {
 impl Parser {
     /// Create a new parser with the given tokens
     pub fn new(tokens: Vec<Token>) -> Self {
+        Self::with_stream(TokenStream::from_tokens(tokens))
+    }
+
+    /// Create a parser that pulls tokens lazily from the lexer
+    pub fn from_lexer(lexer: Lexer) -> Self {
+        Self::with_stream(TokenStream::from_lexer(lexer))
+    }
+
+    fn with_stream(tokens: TokenStream) -> Self {
         let mut parser = Self {
             tokens,
             position: 0,
             keywords: HashMap::new(),
             errors: Vec::new(),
             recovery_mode: false,
+            arena: None,
         };
         parser.initialize_keywords();
+        parser.tokens.fill(LOOKAHEAD);
         // Skip any initial comments
         parser.skip_comments();
         parser
@@ -295,6 +325,7 @@ impl Parser {
             ("MAP_FROM_TYPE_TO_TYPE", KeywordType::MapFromTypeToType),
             ("POINTER_TO", KeywordType::PointerTo),
             ("FUNCTION_TYPE", KeywordType::FunctionType),
+            ("VECTOR_OF_TYPE", KeywordType::VectorOfType),
             ("ACCEPTS_PARAMETER", KeywordType::AcceptsParameter),
             ("RETURNS", KeywordType::Returns),
             ("BODY", KeywordType::Body),
@@ -367,6 +398,7 @@ impl Parser {
             ("ALGORITHM_HINT", KeywordType::AlgorithmHint),
             ("PERFORMANCE_EXPECTATION", KeywordType::PerformanceExpectation),
             ("COMPLEXITY_EXPECTATION", KeywordType::ComplexityExpectation),
+            ("CONTRACT_CHECKS", KeywordType::ContractChecks),
             ("LIBRARY", KeywordType::Library),
             ("SYMBOL", KeywordType::Symbol),
             ("CALLING_CONVENTION", KeywordType::CallingConvention),
@@ -379,6 +411,13 @@ impl Parser {
             ("ARRAY_LITERAL", KeywordType::ArrayLiteral),
             ("ARRAY_LENGTH", KeywordType::ArrayLength),
             ("MAP_LITERAL", KeywordType::MapLiteral),
+            ("VECTOR_LITERAL", KeywordType::VectorLiteral),
+            ("VECTOR_SPLAT", KeywordType::VectorSplat),
+            ("VECTOR_LOAD", KeywordType::VectorLoad),
+            ("VECTOR_STORE", KeywordType::VectorStore),
+            ("VECTOR_SHUFFLE", KeywordType::VectorShuffle),
+            ("VECTOR_EXTRACT", KeywordType::VectorExtract),
+            ("VECTOR_SELECT", KeywordType::VectorSelect),
             ("NAME", KeywordType::Name),
             ("TYPE", KeywordType::Type),
             ("VALUE", KeywordType::Value),
@@ -452,27 +491,65 @@ impl Parser {
 
     /// Advance to the next token
     fn advance(&mut self) {
-        if self.position < self.tokens.len() {
+        if self.current_token().is_some() {
             self.position += 1;
+            self.slide_window();
             // Skip comments
             self.skip_comments();
         }
     }
+
+    /// Keep the token window positioned around the current token
+    fn slide_window(&mut self) {
+        self.tokens.release_before(self.position.saturating_sub(HISTORY));
+        self.tokens.fill(self.position + LOOKAHEAD);
+    }
     
     /// Skip comment tokens
     fn skip_comments(&mut self) {
         while let Some(token) = self.current_token() {
             match &token.token_type {
                 TokenType::Comment(_) => {
-                    if self.position < self.tokens.len() {
-                        self.position += 1;
-                    }
+                    self.position += 1;
+                    self.slide_window();
                 }
                 _ => break,
             }
         }
     }
 
+    /// Take the lexer error that cut the token stream short, if any.
+    ///
+    /// When streaming from a lexer, a lexical error ends the stream early and
+    /// the parser reports whatever it sees at that point; callers should
+    /// prefer this error over the parse result.
+    pub fn take_lexer_error(&mut self) -> Option<LexerError> {
+        self.tokens.take_error()
+    }
+
+    /// Also build an arena AST of everything parsed
+    ///
+    /// Off by default, since the boxed AST stays resident alongside it.
+    pub fn with_arena(mut self) -> Self {
+        self.arena = Some(AstArena::new());
+        self
+    }
+
+    /// The arena AST of the modules parsed so far, if `with_arena` asked for one
+    pub fn arena(&self) -> Option<&AstArena> {
+        self.arena.as_ref()
+    }
+
+    /// Take the arena AST, leaving none
+    pub fn take_arena(&mut self) -> Option<AstArena> {
+        self.arena.take()
+    }
+
+    /// Largest number of tokens resident in the lookahead window
+    pub fn peak_buffered_tokens(&self) -> usize {
+        self.tokens.peak_buffered()
+    }
+
     /// Check if we're at the end of tokens
     fn is_at_end(&self) -> bool {
         match self.current_token() {
@@ -635,6 +712,27 @@ impl Parser {
         }
     }
     
+    /// Consume a non-negative integer literal such as a lane count or lane index
+    fn consume_lane_literal(&mut self, expected: &str) -> Result<u32, ParserError> {
+        match self.current_token() {
+            Some(token) => match &token.token_type {
+                TokenType::Integer(value) if *value >= 0 && *value <= u32::MAX as i64 => {
+                    let lane_value = *value as u32;
+                    self.advance();
+                    Ok(lane_value)
+                }
+                _ => Err(ParserError::UnexpectedToken {
+                    found: format!("{:?}", token.token_type),
+                    expected: expected.to_string(),
+                    location: token.location.clone(),
+                }),
+            },
+            None => Err(ParserError::UnexpectedEof {
+                expected: expected.to_string(),
+            }),
+        }
+    }
+    
     fn consume_boolean(&mut self) -> Result<bool, ParserError> {
         match self.current_token() {
             Some(token) => match &token.token_type {
@@ -821,6 +919,7 @@ impl Parser {
         let mut type_definitions = Vec::new();
         let mut constant_declarations = Vec::new();
         let mut function_definitions = Vec::new();
+        let mut function_ids: Vec<FunctionId> = Vec::new();
         let mut external_functions = Vec::new();
 
         // Parse module fields
@@ -875,6 +974,9 @@ impl Parser {
                             }
                                                     ModuleContent::ConstantDeclaration(const_decl) => constant_declarations.push(const_decl),
                                                     ModuleContent::FunctionDefinition(func_def) => {
+                                                        if let Some(arena) = &mut self.arena {
+                                                            function_ids.push(arena.alloc_function(&func_def));
+                                                        }
                                                         function_definitions.push(*func_def);
                                                     }
                                                     ModuleContent::ExternalFunction(ext_func) => {
@@ -932,7 +1034,7 @@ impl Parser {
             location: start_location.clone(),
         })?;
 
-        Ok(Module {
+        let module = Module {
             name,
             intent,
             imports,
@@ -942,7 +1044,11 @@ impl Parser {
             function_definitions,
             external_functions,
             source_location: start_location,
-        })
+        };
+        if let Some(arena) = &mut self.arena {
+            arena.alloc_module_with_functions(&module, function_ids);
+        }
+        Ok(module)
     }
 
     /// Parse a module content item
@@ -1764,6 +1870,7 @@ impl Parser {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         };
         
         // Parse function fields
@@ -1844,6 +1951,10 @@ impl Parser {
                             self.advance(); // consume MAY_BLOCK
                             metadata.may_block = Some(self.consume_boolean()?);
                         }
+                        Some(KeywordType::ContractChecks) => {
+                            self.advance(); // consume CONTRACT_CHECKS
+                            metadata.contract_checks = Some(self.consume_string()?);
+                        }
                         _ => {
                             return Err(ParserError::UnexpectedToken {
                                 found: keyword.clone(),
@@ -2090,6 +2201,18 @@ impl Parser {
                             source_location: start_location,
                         })
                     }
+                    Some(KeywordType::VectorOfType) => {
+                        self.advance(); // consume VECTOR_OF_TYPE
+                        let element_type = Box::new(self.parse_type_specifier()?);
+                        let lanes = self.consume_lane_literal("vector lane count")?;
+                        
+                        self.consume_right_paren()?;
+                        Ok(TypeSpecifier::Vector {
+                            element_type,
+                            lanes,
+                            source_location: start_location,
+                        })
+                    }
                     Some(KeywordType::MapFromTypeToType) => {
                         self.advance(); // consume MAP_FROM_TYPE_TO_TYPE
                         let key_type = Box::new(self.parse_type_specifier()?);
@@ -2548,6 +2671,88 @@ impl Parser {
                             source_location: start_location,
                         })
                     }
+                    Some(KeywordType::VectorLiteral) => {
+                        self.advance(); // consume VECTOR_LITERAL
+                        let mut elements = Vec::new();
+                        while let Some(token) = self.current_token() {
+                            if matches!(token.token_type, TokenType::RightParen) {
+                                break;
+                            }
+                            elements.push(Box::new(self.parse_expression()?));
+                        }
+                        self.consume_right_paren()?;
+                        Ok(Expression::VectorLiteral {
+                            elements,
+                            source_location: start_location,
+                        })
+                    }
+                    Some(KeywordType::VectorSplat) => {
+                        self.advance(); // consume VECTOR_SPLAT
+                        let value = Box::new(self.parse_expression()?);
+                        let lanes = self.consume_lane_literal("vector lane count")?;
+                        self.consume_right_paren()?;
+                        Ok(Expression::VectorSplat {
+                            value,
+                            lanes,
+                            source_location: start_location,
+                        })
+                    }
+                    Some(KeywordType::VectorLoad) => {
+                        self.advance(); // consume VECTOR_LOAD
+                        let array = Box::new(self.parse_expression()?);
+                        let index = Box::new(self.parse_expression()?);
+                        let lanes = self.consume_lane_literal("vector lane count")?;
+                        self.consume_right_paren()?;
+                        Ok(Expression::VectorLoad {
+                            array,
+                            index,
+                            lanes,
+                            source_location: start_location,
+                        })
+                    }
+                    Some(KeywordType::VectorShuffle) => {
+                        self.advance(); // consume VECTOR_SHUFFLE
+                        let left = Box::new(self.parse_expression()?);
+                        let right = Box::new(self.parse_expression()?);
+                        let mut mask = Vec::new();
+                        while let Some(token) = self.current_token() {
+                            if matches!(token.token_type, TokenType::RightParen) {
+                                break;
+                            }
+                            mask.push(self.consume_lane_literal("shuffle lane index")?);
+                        }
+                        self.consume_right_paren()?;
+                        Ok(Expression::VectorShuffle {
+                            left,
+                            right,
+                            mask,
+                            source_location: start_location,
+                        })
+                    }
+                    Some(KeywordType::VectorExtract) => {
+                        self.advance(); // consume VECTOR_EXTRACT
+                        let vector = Box::new(self.parse_expression()?);
+                        let lane = Box::new(self.parse_expression()?);
+                        self.consume_right_paren()?;
+                        Ok(Expression::VectorExtract {
+                            vector,
+                            lane,
+                            source_location: start_location,
+                        })
+                    }
+                    Some(KeywordType::VectorSelect) => {
+                        self.advance(); // consume VECTOR_SELECT
+                        let mask = Box::new(self.parse_expression()?);
+                        let if_true = Box::new(self.parse_expression()?);
+                        let if_false = Box::new(self.parse_expression()?);
+                        self.consume_right_paren()?;
+                        Ok(Expression::VectorSelect {
+                            mask,
+                            if_true,
+                            if_false,
+                            source_location: start_location,
+                        })
+                    }
                     Some(KeywordType::MapLiteral) => {
                         self.advance(); // consume MAP_LITERAL
                         
@@ -2886,8 +3091,8 @@ impl Parser {
         if let Some(token) = self.current_token() {
             if matches!(token.token_type, TokenType::LeftParen) {
                 let next_pos = self.position + 1;
-                if next_pos < self.tokens.len() {
-                    if let TokenType::Keyword(keyword) = &self.tokens[next_pos].token_type {
+                if let Some(next_token) = self.tokens.get(next_pos) {
+                    if let TokenType::Keyword(keyword) = &next_token.token_type {
                         if self.keywords.get(keyword) == Some(&KeywordType::Arguments) {
                             self.consume_left_paren()?;
                             self.consume_keyword(KeywordType::Arguments)?;
@@ -2925,7 +3130,7 @@ impl Parser {
                                 source_location: start_location,
                             });
                         }
-                    } else if let TokenType::Identifier(ident) = &self.tokens[next_pos].token_type {
+                    } else if let TokenType::Identifier(ident) = &next_token.token_type {
                         if ident == "ARGUMENTS" {
                             self.consume_left_paren()?;
                             self.advance(); // consume ARGUMENTS identifier
@@ -3171,6 +3376,32 @@ impl Parser {
                             source_location: location,
                         })
                     }
+                    Some(KeywordType::SetArrayElement) => {
+                        self.advance(); // consume SET_ARRAY_ELEMENT
+                        let array = Box::new(self.parse_expression()?);
+                        let index = Box::new(self.parse_expression()?);
+                        let value = Box::new(self.parse_expression()?);
+                        self.consume_right_paren()?;
+                        Ok(Statement::Assignment {
+                            target: AssignmentTarget::ArrayElement { array, index },
+                            value,
+                            source_location: location,
+                        })
+                    }
+                    Some(KeywordType::VectorStore) => {
+                        self.advance(); // consume VECTOR_STORE
+                        let array = Box::new(self.parse_expression()?);
+                        let index = Box::new(self.parse_expression()?);
+                        let value = Box::new(self.parse_expression()?);
+                        self.consume_right_paren()?;
+                        let expr = Box::new(Expression::VectorStore {
+                            array,
+                            index,
+                            value,
+                            source_location: location.clone(),
+                        });
+                        Ok(Statement::Expression { expr, source_location: location })
+                    }
                     _ => Err(ParserError::UnexpectedToken {
                         found: keyword.clone(),
                         expected: "statement keyword".to_string(),
@@ -3399,9 +3630,10 @@ impl Parser {
         while let Some(token) = self.current_token() {
             if matches!(token.token_type, TokenType::LeftParen) {
                 let next_pos = self.position + 1;
-                if next_pos < self.tokens.len() {
-                    if let TokenType::Keyword(keyword) = &self.tokens[next_pos].token_type {
+                if let Some(next_token) = self.tokens.get(next_pos) {
+                    if let TokenType::Keyword(keyword) = &next_token.token_type {
                         if self.keywords.get(keyword) == Some(&KeywordType::ElseIfCondition) {
+                            let else_if_location = next_token.location.clone();
                             self.consume_left_paren()?;
                             self.consume_keyword(KeywordType::ElseIfCondition)?;
                             let else_if_condition = Box::new(self.parse_expression()?);
@@ -3414,7 +3646,7 @@ impl Parser {
                             else_ifs.push(ElseIf {
                                 condition: else_if_condition,
                                 block: else_if_block,
-                                source_location: self.tokens[next_pos].location.clone(),
+                                source_location: else_if_location,
                             });
                             
                             self.consume_right_paren()?;
@@ -3430,8 +3662,8 @@ impl Parser {
         let else_block = if let Some(token) = self.current_token() {
             if matches!(token.token_type, TokenType::LeftParen) {
                 let next_pos = self.position + 1;
-                if next_pos < self.tokens.len() {
-                    if let TokenType::Keyword(keyword) = &self.tokens[next_pos].token_type {
+                if let Some(next_token) = self.tokens.get(next_pos) {
+                    if let TokenType::Keyword(keyword) = &next_token.token_type {
                         if self.keywords.get(keyword) == Some(&KeywordType::ElseExecute) {
                             self.consume_left_paren()?;
                             self.consume_keyword(KeywordType::ElseExecute)?;
@@ -3728,9 +3960,10 @@ impl Parser {
         while let Some(token) = self.current_token() {
             if matches!(token.token_type, TokenType::LeftParen) {
                 let next_pos = self.position + 1;
-                if next_pos < self.tokens.len() {
-                    if let TokenType::Keyword(keyword) = &self.tokens[next_pos].token_type {
+                if let Some(next_token) = self.tokens.get(next_pos) {
+                    if let TokenType::Keyword(keyword) = &next_token.token_type {
                         if self.keywords.get(keyword) == Some(&KeywordType::CatchException) {
+                            let catch_location = next_token.location.clone();
                             self.consume_left_paren()?;
                             self.consume_keyword(KeywordType::CatchException)?;
                             
@@ -3749,7 +3982,7 @@ impl Parser {
                                 exception_type,
                                 binding_variable,
                                 handler_block,
-                                source_location: self.tokens[next_pos].location.clone(),
+                                source_location: catch_location,
                             });
                             
                             self.consume_right_paren()?;
@@ -3765,8 +3998,8 @@ impl Parser {
         let finally_block = if let Some(token) = self.current_token() {
             if matches!(token.token_type, TokenType::LeftParen) {
                 let next_pos = self.position + 1;
-                if next_pos < self.tokens.len() {
-                    if let TokenType::Keyword(keyword) = &self.tokens[next_pos].token_type {
+                if let Some(next_token) = self.tokens.get(next_pos) {
+                    if let TokenType::Keyword(keyword) = &next_token.token_type {
                         if self.keywords.get(keyword) == Some(&KeywordType::FinallyExecute) {
                             self.consume_left_paren()?;
                             self.consume_keyword(KeywordType::FinallyExecute)?;
@@ -4008,6 +4241,60 @@ mod tests {
         assert_eq!(program.modules[0].intent, Some("A test module".to_string()));
     }
 
+    #[test]
+    fn test_streaming_parser_window() {
+        let mut source = String::from("(DEFINE_MODULE (NAME 'streamed') (INTENT \"Streaming\") (CONTENT\n");
+        for i in 0..200 {
+            source.push_str(&format!("  (DECLARE_CONSTANT (NAME 'C_{}') (TYPE INTEGER) (VALUE {}))\n", i, i));
+        }
+        source.push_str("))");
+
+        let mut parser = Parser::from_lexer(Lexer::new(&source, "test.aether".to_string()));
+        let program = parser.parse_program().unwrap();
+        assert!(parser.take_lexer_error().is_none());
+        assert_eq!(program.modules[0].constant_declarations.len(), 200);
+        assert!(parser.peak_buffered_tokens() <= LOOKAHEAD + HISTORY + 1);
+    }
+
+    #[test]
+    fn test_streaming_parser_reports_lexer_error() {
+        let source = "(DEFINE_MODULE (NAME 'bad') @)";
+        let mut parser = Parser::from_lexer(Lexer::new(source, "test.aether".to_string()));
+        assert!(parser.parse_program().is_err());
+        assert!(parser.take_lexer_error().is_some());
+    }
+
+    #[test]
+    fn test_parser_fills_arena() {
+        let source = r#"
+        (DEFINE_MODULE
+          (NAME 'counter')
+          (CONTENT
+            (DEFINE_FUNCTION
+              (NAME 'count')
+              (RETURNS INTEGER)
+              (BODY
+                (RETURN_VALUE 1)))))
+        "#;
+        let mut parser = Parser::from_lexer(Lexer::new(source, "test.aether".to_string())).with_arena();
+        parser.parse_program().unwrap();
+
+        let arena = parser.take_arena().unwrap();
+        assert_eq!(arena.modules.len(), 1);
+        let module = arena.modules[0];
+        assert_eq!(arena.name(module.name), "counter");
+        let functions = arena.function_list(module.functions);
+        assert_eq!(functions.len(), 1);
+        let function = arena.function(functions[0]);
+        assert_eq!(arena.name(function.name), "count");
+        assert_eq!(arena.stmt_list(function.body).len(), 1);
+        assert!(parser.arena().is_none());
+
+        let mut parser = Parser::from_lexer(Lexer::new(source, "test.aether".to_string()));
+        parser.parse_program().unwrap();
+        assert!(parser.arena().is_none());
+    }
+
     #[test]
     fn test_module_with_constant_parsing() {
         let source = r#"
@@ -4070,6 +4357,54 @@ mod tests {
         }
     }
 
+    #[test]
+    fn test_vector_parsing() {
+        let source = r#"
+        (DEFINE_MODULE
+          (NAME simd)
+          (CONTENT
+            (DEFINE_FUNCTION
+              (NAME reverse)
+              (ACCEPTS_PARAMETER (NAME "data") (TYPE (ARRAY_OF_TYPE INTEGER)))
+              (RETURNS INTEGER)
+              (BODY
+                (DECLARE_VARIABLE (NAME v) (TYPE (VECTOR_OF_TYPE INTEGER 4))
+                  (VALUE (VECTOR_SHUFFLE (VECTOR_LOAD data 0 4) (VECTOR_SPLAT 0 4) 3 2 1 0)))
+                (VECTOR_STORE data 0 v)
+                (RETURN_VALUE (VECTOR_EXTRACT v 0))
+              )
+            )
+          )
+        )
+        "#;
+
+        let mut lexer = Lexer::new(source, "test.aether".to_string());
+        let tokens = lexer.tokenize().unwrap();
+        let mut parser = Parser::new(tokens);
+
+        let program = parser.parse_program().unwrap();
+        let statements = &program.modules[0].function_definitions[0].body.statements;
+        assert_eq!(statements.len(), 3);
+
+        match &statements[0] {
+            Statement::VariableDeclaration { type_spec, initial_value: Some(value), .. } => {
+                assert!(matches!(type_spec.as_ref(), TypeSpecifier::Vector { lanes: 4, .. }));
+                match value.as_ref() {
+                    Expression::VectorShuffle { left, mask, .. } => {
+                        assert!(matches!(left.as_ref(), Expression::VectorLoad { lanes: 4, .. }));
+                        assert_eq!(mask, &vec![3, 2, 1, 0]);
+                    }
+                    other => panic!("Expected VectorShuffle, got {:?}", other),
+                }
+            }
+            other => panic!("Expected vector declaration, got {:?}", other),
+        }
+        assert!(matches!(
+            &statements[1],
+            Statement::Expression { expr, .. } if matches!(expr.as_ref(), Expression::VectorStore { .. })
+        ));
+    }
+
     #[test]
     fn test_parser_error_handling() {
         let tokens = vec![
@@ -0,0 +1,440 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Incremental compilation cache
+//!
+//! Artifacts persist between runs under a cache directory
+//! (`target/aether-cache` by default) and are addressed by SHA-256 keys:
+//!
+//! - `parse/<key>.json`: a parsed module and its interface hash, keyed by the
+//!   source path and text
+//! - `check/<key>`: marker that a module's function bodies passed semantic
+//!   analysis, keyed by its source and the interfaces of everything it imports
+//! - `objects/<key>.o`: object code for one codegen unit, keyed by the unit's
+//!   MIR, the declarations visible to it and the code generation options
+//! - `proofs/<key>`: marker that a verification condition was proven, keyed
+//!   by its normalized formula
+//!
+//! Every key also covers the compiler version. The cache is best effort: a
+//! missing or corrupt entry is a miss and failed writes are ignored.
+
+use crate::ast::Module;
+use crate::error::CompilerError;
+use crate::mir;
+use serde::{Deserialize, Serialize};
+use serde_json::Value;
+use sha2::{Digest, Sha256};
+use std::fmt;
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+/// Default cache location, relative to the working directory
+pub const DEFAULT_CACHE_DIR: &str = "target/aether-cache";
+
+/// Bumped whenever the layout or meaning of cached artifacts changes
+const CACHE_FORMAT: &str = "1";
+
+/// A module as stored in the parse cache
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct CachedModule {
+    pub module: Module,
+    /// See [`interface_hash`]
+    pub interface_hash: String,
+}
+
+/// Lookups and hits for one kind of artifact
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct HitRate {
+    pub hits: usize,
+    pub lookups: usize,
+}
+
+impl fmt::Display for HitRate {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        if self.lookups == 0 {
+            write!(f, "0/0 hits")
+        } else {
+            write!(f, "{}/{} hits ({}%)", self.hits, self.lookups, self.hits * 100 / self.lookups)
+        }
+    }
+}
+
+/// Cache effectiveness for one compilation
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct CacheStats {
+    pub parse: HitRate,
+    pub check: HitRate,
+    pub objects: HitRate,
+    pub proofs: HitRate,
+}
+
+impl fmt::Display for CacheStats {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "incremental cache: parse {}, check {}, objects {}, proofs {}",
+            self.parse, self.check, self.objects, self.proofs
+        )
+    }
+}
+
+#[derive(Debug, Default)]
+struct Counter {
+    hits: AtomicUsize,
+    lookups: AtomicUsize,
+}
+
+impl Counter {
+    fn record(&self, hit: bool) -> bool {
+        self.lookups.fetch_add(1, Ordering::Relaxed);
+        if hit {
+            self.hits.fetch_add(1, Ordering::Relaxed);
+        }
+        hit
+    }
+
+    fn snapshot(&self) -> HitRate {
+        HitRate {
+            hits: self.hits.load(Ordering::Relaxed),
+            lookups: self.lookups.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// On-disk artifact store shared by all phases of a compilation
+#[derive(Debug)]
+pub struct IncrementalCache {
+    root: PathBuf,
+    parse: Counter,
+    check: Counter,
+    objects: Counter,
+    proofs: Counter,
+}
+
+impl IncrementalCache {
+    /// Open (creating if needed) the cache rooted at `root`
+    pub fn open(root: impl Into<PathBuf>) -> Result<Self, CompilerError> {
+        let root = root.into();
+        for kind in ["parse", "check", "objects", "proofs"] {
+            fs::create_dir_all(root.join(kind)).map_err(|e| CompilerError::IoError {
+                message: format!("Failed to create cache directory {}: {}", root.join(kind).display(), e),
+            })?;
+        }
+
+        Ok(Self {
+            root,
+            parse: Counter::default(),
+            check: Counter::default(),
+            objects: Counter::default(),
+            proofs: Counter::default(),
+        })
+    }
+
+    pub fn root(&self) -> &Path {
+        &self.root
+    }
+
+    /// Look up a parsed module, running `parse` and storing its result on a miss
+    pub fn parse_with<F>(&self, key: &str, parse: F) -> Result<CachedModule, CompilerError>
+    where
+        F: FnOnce() -> Result<Module, CompilerError>,
+    {
+        let path = self.entry("parse", key, "json");
+        let cached = fs::read(&path)
+            .ok()
+            .and_then(|bytes| serde_json::from_slice::<CachedModule>(&bytes).ok());
+        if let Some(cached) = cached {
+            self.parse.record(true);
+            return Ok(cached);
+        }
+        self.parse.record(false);
+
+        let module = parse()?;
+        let cached = CachedModule {
+            interface_hash: interface_hash(&module),
+            module,
+        };
+        if let Ok(bytes) = serde_json::to_vec(&cached) {
+            write_atomic(&path, &bytes);
+        }
+        Ok(cached)
+    }
+
+    /// Whether a module with this check key already passed semantic analysis
+    pub fn is_checked(&self, key: &str) -> bool {
+        self.check.record(self.entry("check", key, "ok").exists())
+    }
+
+    /// Record that a module with this check key passed semantic analysis
+    pub fn mark_checked(&self, key: &str) {
+        write_atomic(&self.entry("check", key, "ok"), &[]);
+    }
+
+    /// Copy a cached object to `dest`, returning whether it was present
+    pub fn load_object(&self, key: &str, dest: &Path) -> bool {
+        self.objects.record(fs::copy(self.entry("objects", key, "o"), dest).is_ok())
+    }
+
+    /// Store a freshly generated object under `key`
+    pub fn store_object(&self, key: &str, object: &Path) {
+        if let Ok(bytes) = fs::read(object) {
+            write_atomic(&self.entry("objects", key, "o"), &bytes);
+        }
+    }
+
+    /// Whether a verification condition with this proof key was proven before
+    pub fn is_proven(&self, key: &str) -> bool {
+        self.proofs.record(self.entry("proofs", key, "ok").exists())
+    }
+
+    /// Record that a verification condition with this proof key holds
+    pub fn mark_proven(&self, key: &str) {
+        write_atomic(&self.entry("proofs", key, "ok"), &[]);
+    }
+
+    pub fn stats(&self) -> CacheStats {
+        CacheStats {
+            parse: self.parse.snapshot(),
+            check: self.check.snapshot(),
+            objects: self.objects.snapshot(),
+            proofs: self.proofs.snapshot(),
+        }
+    }
+
+    fn entry(&self, kind: &str, key: &str, extension: &str) -> PathBuf {
+        self.root.join(kind).join(format!("{}.{}", key, extension))
+    }
+}
+
+/// Write through a temporary file so readers never observe a partial entry
+fn write_atomic(path: &Path, bytes: &[u8]) {
+    static NEXT_TEMP: AtomicUsize = AtomicUsize::new(0);
+    let temp = path.with_extension(format!(
+        "tmp.{}.{}",
+        std::process::id(),
+        NEXT_TEMP.fetch_add(1, Ordering::Relaxed)
+    ));
+    if fs::write(&temp, bytes).is_ok() && fs::rename(&temp, path).is_err() {
+        let _ = fs::remove_file(&temp);
+    }
+}
+
+/// SHA-256 over length-prefixed fields
+struct KeyHasher(Sha256);
+
+impl KeyHasher {
+    fn new(kind: &str) -> Self {
+        let mut hasher = Self(Sha256::new());
+        hasher.field(env!("CARGO_PKG_VERSION")).field(CACHE_FORMAT).field(kind);
+        hasher
+    }
+
+    fn field(&mut self, data: impl AsRef<[u8]>) -> &mut Self {
+        let data = data.as_ref();
+        self.0.update((data.len() as u64).to_le_bytes());
+        self.0.update(data);
+        self
+    }
+
+    fn finish(self) -> String {
+        format!("{:x}", self.0.finalize())
+    }
+}
+
+/// Key of a source file's parse
+pub fn source_key(path: &Path, source: &str) -> String {
+    let mut hasher = KeyHasher::new("source");
+    hasher.field(path.to_string_lossy().as_bytes()).field(source);
+    hasher.finish()
+}
+
+/// Hash of everything other modules can observe about `module`
+///
+/// This is the module with its function bodies and all source locations
+/// removed, so editing a body or moving code around leaves it unchanged.
+pub fn interface_hash(module: &Module) -> String {
+    let mut value = serde_json::to_value(module).unwrap_or(Value::Null);
+    if let Some(functions) = value.get_mut("function_definitions").and_then(Value::as_array_mut) {
+        for function in functions {
+            if let Some(function) = function.as_object_mut() {
+                function.remove("body");
+            }
+        }
+    }
+    strip_locations(&mut value);
+
+    let mut hasher = KeyHasher::new("interface");
+    hasher.field(value.to_string());
+    hasher.finish()
+}
+
+fn strip_locations(value: &mut Value) {
+    match value {
+        Value::Object(map) => {
+            map.remove("source_location");
+            map.values_mut().for_each(strip_locations);
+        }
+        Value::Array(items) => items.iter_mut().for_each(strip_locations),
+        _ => {}
+    }
+}
+
+/// Key of a module's semantic check
+///
+/// `imports` fingerprints every module reachable through its imports; the
+/// order does not matter.
+pub fn check_key(source_key: &str, imports: &[String]) -> String {
+    let mut imports = imports.to_vec();
+    imports.sort();
+
+    let mut hasher = KeyHasher::new("check");
+    hasher.field(source_key);
+    for import in &imports {
+        hasher.field(import);
+    }
+    hasher.finish()
+}
+
+/// Key of a verification condition's proof
+///
+/// `normalized` is the formula with variables renamed canonically, so
+/// conditions differing only in names share a proof.
+pub fn proof_key(normalized: &str) -> String {
+    let mut hasher = KeyHasher::new("proof");
+    hasher.field(normalized);
+    hasher.finish()
+}
+
+/// Key of a codegen unit's object file
+///
+/// Covers the MIR of the functions the unit defines and the declarations of
+/// everything else in the program, which every unit emits.
+pub fn unit_key(options: &str, program: &mir::Program, unit: &[String]) -> String {
+    let mut hasher = KeyHasher::new("object");
+    hasher.field(options);
+
+    let mut functions: Vec<&mir::Function> = program.functions.values().collect();
+    functions.sort_by(|a, b| a.name.cmp(&b.name));
+    for function in functions {
+        hasher.field(format!("{}{:?}{:?}", function.name, function.parameters, function.return_type));
+    }
+    for entry in sorted_debug(&program.external_functions) {
+        hasher.field(entry);
+    }
+    for entry in sorted_debug(&program.global_constants) {
+        hasher.field(entry);
+    }
+    for entry in sorted_debug(&program.type_definitions) {
+        hasher.field(entry);
+    }
+
+    for name in unit {
+        if let Some(function) = program.functions.get(name) {
+            hasher.field(function_fingerprint(function));
+        }
+    }
+    hasher.finish()
+}
+
+/// Deterministic rendering of a MIR function; locals and blocks print in ID order
+fn function_fingerprint(function: &mir::Function) -> String {
+    format!(
+        "{}{:?}{:?}{:?}{}{:?}{:?}",
+        function.name,
+        function.parameters,
+        function.return_type,
+        function.return_local,
+        function.entry_block,
+        function.locals,
+        function.basic_blocks
+    )
+}
+
+fn sorted_debug<K: Ord + fmt::Debug, V: fmt::Debug>(map: &std::collections::HashMap<K, V>) -> Vec<String> {
+    let mut entries: Vec<(&K, &V)> = map.iter().collect();
+    entries.sort_by(|a, b| a.0.cmp(b.0));
+    entries.into_iter().map(|(k, v)| format!("{:?}={:?}", k, v)).collect()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::lexer::Lexer;
+    use crate::parser::Parser;
+
+    fn parse(source: &str) -> Module {
+        let tokens = Lexer::new(source, "cache.aether".to_string()).tokenize().unwrap();
+        Parser::new(tokens).parse_module().unwrap()
+    }
+
+    #[test]
+    fn test_interface_ignores_bodies_and_locations() {
+        let original = parse(
+            r#"(DEFINE_MODULE (NAME m) (CONTENT
+  (DEFINE_FUNCTION (NAME f) (RETURNS INTEGER) (BODY (RETURN_VALUE 1)))))"#,
+        );
+        let edited = parse(
+            r#"(DEFINE_MODULE (NAME m) (CONTENT
+
+  (DEFINE_FUNCTION (NAME f) (RETURNS INTEGER) (BODY (RETURN_VALUE 2)))))"#,
+        );
+        let retyped = parse(
+            r#"(DEFINE_MODULE (NAME m) (CONTENT
+  (DEFINE_FUNCTION (NAME f) (RETURNS FLOAT) (BODY (RETURN_VALUE 1.0)))))"#,
+        );
+
+        assert_eq!(interface_hash(&original), interface_hash(&edited));
+        assert_ne!(interface_hash(&original), interface_hash(&retyped));
+    }
+
+    #[test]
+    fn test_cache_round_trip() {
+        let root = std::env::temp_dir().join(format!("aether-cache-test-{}", std::process::id()));
+        let _ = fs::remove_dir_all(&root);
+        let cache = IncrementalCache::open(&root).unwrap();
+        let source = "(DEFINE_MODULE (NAME m) (CONTENT))";
+        let key = source_key(Path::new("m.aether"), source);
+
+        let first = cache.parse_with(&key, || Ok(parse(source))).unwrap();
+        let second = cache
+            .parse_with(&key, || panic!("cached parse should be reused"))
+            .unwrap();
+        assert_eq!(first.interface_hash, second.interface_hash);
+        assert_eq!(second.module.name.name, "m");
+
+        let check = check_key(&key, &["std:math".to_string()]);
+        assert!(!cache.is_checked(&check));
+        cache.mark_checked(&check);
+        assert!(cache.is_checked(&check));
+
+        let object = root.join("unit.o");
+        fs::write(&object, b"object code").unwrap();
+        cache.store_object("unit", &object);
+        let restored = root.join("restored.o");
+        assert!(cache.load_object("unit", &restored));
+        assert_eq!(fs::read(&restored).unwrap(), b"object code");
+
+        let stats = cache.stats();
+        assert_eq!(stats.parse, HitRate { hits: 1, lookups: 2 });
+        assert_eq!(stats.check, HitRate { hits: 1, lookups: 2 });
+        assert_eq!(stats.objects, HitRate { hits: 1, lookups: 1 });
+        assert_eq!(
+            stats.to_string(),
+            "incremental cache: parse 1/2 hits (50%), check 1/2 hits (50%), objects 1/1 hits (100%), proofs 0/0 hits"
+        );
+
+        let _ = fs::remove_dir_all(&root);
+    }
+}
@@ -16,22 +16,33 @@
 //! 
 //! Integrates all compiler phases from source code to executable
 
-use crate::ast::Program;
+pub mod cache;
+
+use crate::ast::{Module, Program};
+use crate::contracts::ContractCheckMode;
 use crate::error::{CompilerError, SemanticError};
 use crate::lexer::Lexer;
-use crate::llvm_backend::LLVMBackend;
+use crate::llvm_backend::{LLVMBackend, OptLevel, TargetOptions};
 use crate::mir;
+use crate::module_loader::{ModuleLoader, ModuleSource};
 use crate::optimizations::OptimizationManager;
+use crate::optimizations::report::{OptimizationReport, PassTiming};
+use crate::optimizations::profile_guided::ProfileGuidedOptimizationPass;
 use crate::parser::Parser;
 use crate::profiling::CompilationProfiler;
 use crate::semantic::SemanticAnalyzer;
 use crate::stdlib::StandardLibrary;
+use crate::verification::VerificationEngine;
+use cache::{CacheStats, IncrementalCache};
 
 use inkwell::context::Context;
 use rayon::prelude::*;
+use std::collections::HashSet;
 use std::fs;
 use std::path::{Path, PathBuf};
 use std::process::Command;
+use std::sync::Arc;
+use std::time::Duration;
 // use std::sync::{Arc, Mutex};
 
 /// Compilation options
@@ -41,10 +52,18 @@ pub struct CompileOptions {
     pub output: Option<PathBuf>,
     /// Optimization level (0-3)
     pub optimization_level: u8,
+    /// Size optimization level (0 none, 1 `-Os`, 2 `-Oz`)
+    pub size_level: u8,
     /// Generate debug information
     pub debug_info: bool,
     /// Target triple (e.g., "x86_64-pc-linux-gnu")
     pub target_triple: Option<String>,
+    /// Target CPU (e.g., "skylake" or "native"); defaults to a generic CPU
+    pub target_cpu: Option<String>,
+    /// Target features (e.g., "+avx2,+fma")
+    pub target_features: Option<String>,
+    /// ThinLTO with the runtime: emit bitcode and link with `-flto=thin`
+    pub lto: bool,
     /// Additional library paths
     pub library_paths: Vec<PathBuf>,
     /// Additional libraries to link
@@ -63,6 +82,22 @@ pub struct CompileOptions {
     pub syntax_only: bool,
     /// Compile as a library (shared object/dylib)
     pub compile_as_library: bool,
+    /// Number of LLVM modules generated and compiled concurrently (`-j`)
+    pub codegen_units: usize,
+    /// Reuse parses, semantic checks and object code from earlier runs
+    pub incremental: bool,
+    /// Incremental cache location (defaults to `target/aether-cache`)
+    pub cache_dir: Option<PathBuf>,
+    /// Insert counters that write an execution profile at exit
+    pub profile_generate: bool,
+    /// Profile from an instrumented build to guide optimization
+    pub profile_use: Option<PathBuf>,
+    /// How runtime contract checks run unless a function overrides it
+    pub contract_checks: ContractCheckMode,
+    /// Print per-pass optimization timings
+    pub time_passes: bool,
+    /// Write optimization remarks here, as JSON for `.json` and YAML otherwise
+    pub opt_remarks: Option<PathBuf>,
 }
 
 impl Default for CompileOptions {
@@ -70,8 +105,12 @@ impl Default for CompileOptions {
         Self {
             output: None,
             optimization_level: 2,
+            size_level: 0,
             debug_info: false,
             target_triple: None,
+            target_cpu: None,
+            target_features: None,
+            lto: false,
             library_paths: vec![],
             link_libraries: vec![],
             verbose: false,
@@ -81,6 +120,14 @@ impl Default for CompileOptions {
             emit_object_only: false,
             syntax_only: false,
             compile_as_library: false,
+            codegen_units: 1,
+            incremental: false,
+            cache_dir: None,
+            profile_generate: false,
+            profile_use: None,
+            contract_checks: ContractCheckMode::default(),
+            time_passes: false,
+            opt_remarks: None,
         }
     }
 }
@@ -109,8 +156,19 @@ pub struct CompilationStats {
     pub total_time_ms: u128,
     /// Time spent in each phase
     pub phase_times: std::collections::HashMap<String, u128>,
+    /// Incremental cache hit rates, when the cache is enabled
+    pub cache: Option<CacheStats>,
+    /// Transformations made by the optimizer, by statistic name
+    pub optimizations: std::collections::BTreeMap<&'static str, usize>,
+    /// Time and runs of each optimization pass
+    pub pass_timings: Vec<PassTiming>,
+    /// Runtime contract checks removed because verification proved them
+    pub runtime_checks_removed: usize,
 }
 
+/// Time the solver may spend on one contract condition before leaving it checked
+const VERIFICATION_TIMEOUT: Duration = Duration::from_millis(100);
+
 /// Main compilation pipeline
 pub struct CompilationPipeline {
     options: CompileOptions,
@@ -132,6 +190,15 @@ impl CompilationPipeline {
         let mut stats = CompilationStats::default();
         let mut intermediate_files = Vec::new();
         
+        let cache = if self.options.incremental {
+            let root = self.options.cache_dir.clone()
+                .unwrap_or_else(|| PathBuf::from(cache::DEFAULT_CACHE_DIR));
+            Some(Arc::new(IncrementalCache::open(root)?))
+        } else {
+            None
+        };
+        let mut source_keys: Vec<Option<String>> = Vec::new();
+        
         // Initialize profiler if enabled
         let mut profiler = CompilationProfiler::new();
         if self.options.enable_profiling {
@@ -147,66 +214,25 @@ impl CompilationPipeline {
             let _timer = if self.options.enable_profiling { Some(profiler.start_phase("parsing")) } else { None };
             
             // Decide whether to use parallel or sequential parsing
-            let modules = if self.options.parallel && input_files.len() > 1 {
-                // Parallel parsing
-                let results: Result<Vec<_>, _> = input_files
+            let parsed: Vec<ParsedInput> = if self.options.parallel && input_files.len() > 1 {
+                input_files
                     .par_iter()
-                    .map(|input_file| {
-                        // Read file
-                        let source = fs::read_to_string(input_file)
-                            .map_err(|e| CompilerError::IoError {
-                                message: format!("Failed to read {}: {}", input_file.display(), e),
-                            })?;
-                        
-                        let lines = source.lines().count();
-                        
-                        // Tokenize
-                        let mut lexer = Lexer::new(&source, input_file.to_string_lossy().to_string());
-                        let tokens = lexer.tokenize()?;
-                        
-                        // Parse module
-                        let mut parser = Parser::new(tokens);
-                        let module = parser.parse_module()?;
-                        
-                        Ok::<(crate::ast::Module, usize), CompilerError>((module, lines))
-                    })
-                    .collect();
-                
-                let parsed_modules = results?;
-                
-                // Update stats
-                for (_, lines) in &parsed_modules {
-                    stats.lines_of_code += lines;
-                }
-                
-                parsed_modules.into_iter().map(|(m, _)| m).collect()
+                    .map(|input_file| parse_input(input_file, cache.as_deref()))
+                    .collect::<Result<_, _>>()?
             } else {
-                // Sequential parsing for single file or when parallel is disabled
-                let mut modules = vec![];
-                
-                for input_file in input_files {
-                    // Read file
-                    let source = fs::read_to_string(input_file)
-                        .map_err(|e| CompilerError::IoError {
-                            message: format!("Failed to read {}: {}", input_file.display(), e),
-                        })?;
-                    
-                    stats.lines_of_code += source.lines().count();
-                    
-                    // Tokenize
-                    let mut lexer = Lexer::new(&source, input_file.to_string_lossy().to_string());
-                    let tokens = lexer.tokenize()?;
-                    
-                    // Parse module
-                    let mut parser = Parser::new(tokens);
-                    let module = parser.parse_module()?;
-                    
-                    modules.push(module);
-                }
-                
-                modules
+                input_files
+                    .iter()
+                    .map(|input_file| parse_input(input_file, cache.as_deref()))
+                    .collect::<Result<_, _>>()?
             };
             
+            let mut modules = Vec::with_capacity(parsed.len());
+            for input in parsed {
+                stats.lines_of_code += input.lines;
+                source_keys.push(input.source_key);
+                modules.push(input.module);
+            }
+            
             Program {
                 modules,
                 source_location: crate::error::SourceLocation::unknown(),
@@ -229,11 +255,46 @@ impl CompilationPipeline {
         let symbol_table = {
             let _timer = if self.options.enable_profiling { Some(profiler.start_phase("semantic_analysis")) } else { None };
             
+            // Modules whose source and imports are unchanged since they
+            // last checked cleanly only need their declarations processed
+            let check_keys: Vec<Option<String>> = match &cache {
+                Some(cache) => {
+                    let loader = ModuleLoader::new();
+                    program.modules.iter()
+                        .zip(&source_keys)
+                        .map(|(module, source_key)| {
+                            source_key.as_ref().and_then(|key| module_check_key(module, key, cache, &loader))
+                        })
+                        .collect()
+                }
+                None => vec![None; program.modules.len()],
+            };
+            let verified: HashSet<String> = program.modules.iter()
+                .zip(&check_keys)
+                .filter(|(_, key)| match (&cache, key) {
+                    (Some(cache), Some(key)) => cache.is_checked(key),
+                    _ => false,
+                })
+                .map(|(module, _)| module.name.name.clone())
+                .collect();
+            
             let mut analyzer = SemanticAnalyzer::new();
+            analyzer.set_parallel(self.options.parallel);
+            analyzer.set_verified_modules(verified.clone());
+            analyzer.set_contract_check_mode(self.options.contract_checks);
             analyzer.analyze_program(&program)?;
             
+            if let Some(cache) = &cache {
+                for key in check_keys.iter().flatten() {
+                    cache.mark_checked(key);
+                }
+            }
+            
             let analysis_stats = analyzer.get_statistics().clone();
-            stats.functions_compiled = analysis_stats.functions_analyzed;
+            stats.functions_compiled = analysis_stats.functions_analyzed + program.modules.iter()
+                .filter(|module| verified.contains(&module.name.name))
+                .map(|module| module.function_definitions.len())
+                .sum::<usize>();
             
             // Extract symbol table for MIR lowering
             analyzer.get_symbol_table()
@@ -252,6 +313,7 @@ impl CompilationPipeline {
             }
             
             stats.total_time_ms = start_time.elapsed().as_millis();
+            stats.cache = cache.as_deref().map(IncrementalCache::stats);
             
             // Return dummy result for syntax check
             return Ok(CompilationResult {
@@ -282,7 +344,13 @@ impl CompilationPipeline {
                 }
             }
             
-            mir::lowering::lower_ast_to_mir_with_symbols(&program, symbol_table)?
+            let mut lowering = mir::lowering::LoweringContext::with_symbol_table(symbol_table);
+            lowering.set_contract_checks(self.options.contract_checks, self.options.optimization_level == 0);
+            if self.options.parallel {
+                lowering.lower_program_parallel(&program)?
+            } else {
+                lowering.lower_program(&program)?
+            }
         };
         
         stats.phase_times.insert("mir_generation".to_string(), mir_start.elapsed().as_millis());
@@ -291,25 +359,93 @@ impl CompilationPipeline {
             profiler.snapshot_memory("after_mir_generation");
         }
 
+        // Counters go in before any pass reshapes the MIR, which is also where
+        // --profile-use applies the profile, so block numbers line up
+        if self.options.profile_generate {
+            let instrumentation = ProfileGuidedOptimizationPass::new().generate_instrumentation(&mut mir_program)?;
+            if self.options.verbose {
+                println!("  Inserted {} profile counters", instrumentation.probes.len());
+            }
+        }
+
+        // Contracts proven against the MIR need no runtime check, and tell
+        // bounds check elimination what holds; -O0 keeps every check
+        if self.options.optimization_level > 0 {
+            let _timer = if self.options.enable_profiling { Some(profiler.start_phase("verification")) } else { None };
+            let verification_start = std::time::Instant::now();
+            
+            // Conditions proven by earlier builds are not checked again
+            let mut engine = match &cache {
+                Some(cache) => VerificationEngine::new().with_cache(Arc::clone(cache)),
+                None => VerificationEngine::new(),
+            };
+            engine.set_timeout(Some(VERIFICATION_TIMEOUT));
+            engine.set_external_callers(self.options.compile_as_library || self.options.emit_object_only);
+            // The facts stay with each function, so renumbering its blocks
+            // keeps their loop headers current
+            for (name, facts) in engine.verify_contracts(&program, &mir_program) {
+                if let Some(function) = mir_program.functions.get_mut(&name) {
+                    stats.runtime_checks_removed += crate::contracts::remove_proven_checks(function, &facts);
+                    function.proven_facts = Some(Box::new(facts));
+                }
+            }
+            if self.options.verbose {
+                println!("  Removed {} proven contract checks", stats.runtime_checks_removed);
+            }
+            
+            stats.phase_times.insert("verification".to_string(), verification_start.elapsed().as_millis());
+        }
+
         // Phase 4: Optimization
         if self.options.verbose {
             println!("Phase 4: Running optimizations...");
         }
         let opt_start = std::time::Instant::now();
+        let mut opt_report = OptimizationReport::default();
         
         if self.options.optimization_level > 0 {
             let _timer = if self.options.enable_profiling { Some(profiler.start_phase("optimization")) } else { None };
             
-            let mut opt_manager = OptimizationManager::new();
             // Set up optimization passes based on level
-            if self.options.optimization_level > 0 {
-                opt_manager = OptimizationManager::create_default_pipeline();
+            let make_pipeline = OptimizationManager::pipeline_for_levels(self.options.optimization_level, self.options.size_level);
+            // The parallel path builds its managers from `make_pipeline`, so
+            // a profile-guided pipeline always runs sequentially
+            opt_report = match &self.options.profile_use {
+                Some(profile) => {
+                    let mut opt_manager = OptimizationManager::create_pgo_pipeline(&profile.to_string_lossy())?;
+                    opt_manager.optimize_program(&mut mir_program)?;
+                    opt_manager.take_report()
+                }
+                None if self.options.parallel && make_pipeline().is_parallelizable() => {
+                    OptimizationManager::optimize_program_parallel(&mut mir_program, make_pipeline)?
+                }
+                None => {
+                    let mut opt_manager = make_pipeline();
+                    opt_manager.optimize_program(&mut mir_program)?;
+                    opt_manager.take_report()
+                }
+            };
+            if self.options.verbose {
+                for remark in &opt_report.remarks {
+                    println!("  remark: {}", remark);
+                }
             }
-            opt_manager.optimize_program(&mut mir_program)?;
         }
         
         stats.phase_times.insert("optimization".to_string(), opt_start.elapsed().as_millis());
         
+        if self.options.time_passes {
+            eprint!("{}", opt_report.timing_table());
+        }
+        if let Some(path) = &self.options.opt_remarks {
+            opt_report.write_remarks(path)
+                .map_err(|e| CompilerError::IoError {
+                    message: format!("Failed to write optimization remarks to {}: {}", path.display(), e),
+                })?;
+        }
+        stats.optimizations = std::mem::take(&mut opt_report.statistics);
+        stats.pass_timings = opt_report.timings;
+        
         if self.options.enable_profiling {
             profiler.snapshot_memory("after_optimization");
         }
@@ -320,62 +456,140 @@ impl CompilationPipeline {
         }
         let codegen_start = std::time::Instant::now();
         
-        let context = Context::create();
         let module_name = input_files.first()
             .and_then(|p| p.file_stem())
             .and_then(|s| s.to_str())
             .unwrap_or("main");
         
-        let mut backend = LLVMBackend::new(&context, module_name);
+        // Initialize LLVM targets
+        LLVMBackend::initialize_targets();
         
-        {
+        // Set target triple - use specified or native
+        let target_triple = self.options.target_triple.clone()
+            .unwrap_or_else(|| {
+                use crate::llvm_backend::TargetArch;
+                TargetArch::native().target_triple().to_string()
+            });
+        
+        // Check if output is object file only
+        let output_is_object = self.options.output.as_ref()
+            .map(|p| p.extension().map(|e| e == "o").unwrap_or(false))
+            .unwrap_or(false);
+        
+        // A single requested object file cannot be split across units
+        let unit_count = if output_is_object || self.options.emit_object_only {
+            1
+        } else {
+            self.options.codegen_units.max(1)
+        };
+        let units = partition_codegen_units(&mir_program, unit_count);
+        
+        let target_options = TargetOptions {
+            opt_level: OptLevel::from_levels(self.options.optimization_level, self.options.size_level),
+            cpu: self.options.target_cpu.clone().unwrap_or_else(|| "generic".to_string()),
+            features: self.options.target_features.clone().unwrap_or_default(),
+            lto: self.options.lto,
+        };
+        
+        // Object cache keys cover everything that affects a unit's object code;
+        // `native` is keyed by the host CPU it resolves to
+        let (resolved_cpu, resolved_features) = target_options.resolve_cpu();
+        let codegen_fingerprint = format!(
+            "{} debug={} target={} cpu={} features={} lto={} library={}",
+            target_options.opt_level,
+            self.options.debug_info,
+            target_triple,
+            resolved_cpu,
+            resolved_features,
+            target_options.lto,
+            self.options.compile_as_library,
+        );
+        let unit_keys: Vec<Option<String>> = units.iter()
+            .map(|unit| cache.as_ref().map(|_| cache::unit_key(&codegen_fingerprint, &mir_program, unit)))
+            .collect();
+        let cached_object = |index: usize, object_path: &Path| match (&cache, &unit_keys[index]) {
+            (Some(cache), Some(key)) => cache.load_object(key, object_path),
+            _ => false,
+        };
+        let store_object = |index: usize, object_path: &Path| {
+            if let (Some(cache), Some(key)) = (&cache, &unit_keys[index]) {
+                cache.store_object(key, object_path);
+            }
+        };
+        
+        let object_files = {
             let _timer = if self.options.enable_profiling { Some(profiler.start_phase("llvm_codegen")) } else { None };
             
-            // Initialize LLVM targets
-            LLVMBackend::initialize_targets();
-            
-            // Set target triple - use specified or native
-            let target_triple = self.options.target_triple.clone()
-                .unwrap_or_else(|| {
-                    use crate::llvm_backend::TargetArch;
-                    TargetArch::native().target_triple().to_string()
-                });
-            backend.set_target_triple(&target_triple)?;
-            
-            // Generate LLVM IR from MIR
-            backend.generate_ir(&mir_program)?;
-        }
+            let single_object = PathBuf::from(format!("{}.o", module_name));
+            if units.len() <= 1 && cached_object(0, &single_object) {
+                if self.options.verbose {
+                    println!("Phase 6: Reusing cached object file...");
+                }
+                vec![single_object]
+            } else if units.len() <= 1 {
+                let context = Context::create();
+                let mut backend = LLVMBackend::new(&context, module_name);
+                backend.configure_target(&target_triple, target_options.clone())?;
+                
+                // Generate LLVM IR from MIR
+                backend.generate_ir(&mir_program)?;
+                backend.run_optimization_passes()?;
+                
+                // Phase 6: Object file generation
+                if self.options.verbose {
+                    println!("Phase 6: Generating object file...");
+                }
+                let object_start = std::time::Instant::now();
+                let object_file = self.generate_object_file(&backend, module_name)?;
+                store_object(0, &object_file);
+                stats.phase_times.insert("object_generation".to_string(), object_start.elapsed().as_millis());
+                vec![object_file]
+            } else {
+                if self.options.verbose {
+                    println!("Phase 6: Generating {} object files in parallel...", units.len());
+                }
+                // Each unit owns its LLVM context, so units compile independently
+                let results: Vec<Result<PathBuf, CompilerError>> = units.par_iter()
+                    .enumerate()
+                    .map(|(index, unit)| {
+                        let unit_name = format!("{}.cgu{}", module_name, index);
+                        let object_path = PathBuf::from(format!("{}.o", unit_name));
+                        if cached_object(index, &object_path) {
+                            return Ok(object_path);
+                        }
+                        
+                        let context = Context::create();
+                        let mut backend = LLVMBackend::new(&context, &unit_name);
+                        backend.configure_target(&target_triple, target_options.clone())?;
+                        backend.set_codegen_unit(unit.iter().cloned().collect());
+                        backend.generate_ir(&mir_program)?;
+                        backend.run_optimization_passes()?;
+                        backend.write_link_input(&object_path)?;
+                        store_object(index, &object_path);
+                        Ok(object_path)
+                    })
+                    .collect();
+                results.into_iter().collect::<Result<Vec<_>, _>>()?
+            }
+        };
         
         stats.phase_times.insert("llvm_codegen".to_string(), codegen_start.elapsed().as_millis());
         
         if self.options.enable_profiling {
             profiler.snapshot_memory("after_llvm_codegen");
         }
-
-        // Phase 6: Object file generation
-        if self.options.verbose {
-            println!("Phase 6: Generating object file...");
-        }
-        let object_start = std::time::Instant::now();
         
-        let object_file = self.generate_object_file(&backend, module_name)?;
         if self.options.keep_intermediates {
-            intermediate_files.push(object_file.clone());
+            intermediate_files.extend(object_files.iter().cloned());
         }
-        
-        stats.phase_times.insert("object_generation".to_string(), object_start.elapsed().as_millis());
 
-        // Check if output is object file only
-        let output_is_object = self.options.output.as_ref()
-            .map(|p| p.extension().map(|e| e == "o").unwrap_or(false))
-            .unwrap_or(false);
-        
         let executable_path = if output_is_object || self.options.emit_object_only {
             // Just copy the object file to the output path
+            let object_file = &object_files[0];
             let output_path = self.options.output.clone()
                 .unwrap_or_else(|| object_file.clone());
-            if object_file != output_path {
-                fs::copy(&object_file, &output_path)
+            if *object_file != output_path {
+                fs::copy(object_file, &output_path)
                     .map_err(|e| CompilerError::IoError {
                         message: format!("Failed to copy object file: {}", e),
                     })?;
@@ -393,9 +607,9 @@ impl CompilationPipeline {
             let link_start = std::time::Instant::now();
             
             let output_path = if self.options.compile_as_library {
-                self.link_library(&object_file, module_name)?
+                self.link_library(&object_files, module_name)?
             } else {
-                self.link_executable(&object_file, module_name)?
+                self.link_executable(&object_files, module_name)?
             };
             
             stats.phase_times.insert("linking".to_string(), link_start.elapsed().as_millis());
@@ -412,6 +626,7 @@ impl CompilationPipeline {
         }
 
         stats.total_time_ms = start_time.elapsed().as_millis();
+        stats.cache = cache.as_deref().map(IncrementalCache::stats);
 
         if self.options.verbose {
             println!("\nCompilation completed successfully!");
@@ -435,26 +650,69 @@ impl CompilationPipeline {
     fn generate_object_file(&self, backend: &LLVMBackend, base_name: &str) -> Result<PathBuf, CompilerError> {
         let object_path = PathBuf::from(format!("{}.o", base_name));
         
-        // Write object file
-        backend.write_object_file(&object_path)?;
+        // Write object file (bitcode under LTO)
+        backend.write_link_input(&object_path)?;
         
         Ok(object_path)
     }
 
+    /// Runtime library linked into every program
+    ///
+    /// LTO links the static archive built with `scripts/build_runtime.sh --lto`,
+    /// whose members are bitcode, so runtime helpers can inline into Aether code.
+    /// The runtime's target directory is `$AETHER_RUNTIME_DIR` when set, and
+    /// otherwise `runtime/target` in this source tree.
+    fn runtime_library(&self) -> Result<PathBuf, CompilerError> {
+        let runtime_target = std::env::var_os("AETHER_RUNTIME_DIR")
+            .map(PathBuf::from)
+            .unwrap_or_else(|| Path::new(env!("CARGO_MANIFEST_DIR")).join("runtime/target"));
+        let (library, build) = if self.options.lto {
+            (runtime_target.join("lto/release/libaether_runtime.a"), "scripts/build_runtime.sh --lto")
+        } else {
+            (runtime_target.join("release/libaether_runtime.dylib"), "cargo build --release in runtime/")
+        };
+        if !library.exists() {
+            return Err(CompilerError::IoError {
+                message: format!("Aether runtime library not found at {}; build it with {} or set AETHER_RUNTIME_DIR",
+                                 library.display(), build),
+            });
+        }
+        Ok(library)
+    }
+    
+    /// Linker flags for ThinLTO
+    fn add_lto_flags(&self, cmd: &mut Command) {
+        if !self.options.lto {
+            return;
+        }
+        cmd.arg("-flto=thin");
+        if !cfg!(target_os = "macos") {
+            cmd.arg("-fuse-ld=lld");
+        }
+        // The link step runs the post-link optimization pipeline at this level
+        let opt_level = OptLevel::from_levels(self.options.optimization_level, self.options.size_level);
+        cmd.arg(match opt_level {
+            OptLevel::Os => "-Os".to_string(),
+            OptLevel::Oz => "-Oz".to_string(),
+            level => format!("-O{}", level.speed_level()),
+        });
+    }
+    
     /// Link object file(s) into executable
-    fn link_executable(&self, object_file: &Path, base_name: &str) -> Result<PathBuf, CompilerError> {
+    fn link_executable(&self, object_files: &[PathBuf], base_name: &str) -> Result<PathBuf, CompilerError> {
         let output_path = self.options.output.clone()
             .unwrap_or_else(|| PathBuf::from(base_name));
         
-        // Use system linker (ld or clang)
-        let mut cmd = if cfg!(target_os = "macos") {
+        // Use system linker (ld or clang); LTO needs clang's linker plugin
+        let mut cmd = if cfg!(target_os = "macos") || self.options.lto {
             Command::new("clang")
         } else {
             Command::new("cc")
         };
+        self.add_lto_flags(&mut cmd);
         
         cmd.arg("-o").arg(&output_path);
-        cmd.arg(object_file);
+        cmd.args(object_files);
         
         // Add library paths
         for lib_path in &self.options.library_paths {
@@ -467,9 +725,11 @@ impl CompilationPipeline {
         }
         
         // Add AetherScript runtime library directly
-        let runtime_lib_path = PathBuf::from("/Users/keithballinger/Desktop/projects/logos/runtime/target/release/libaether_runtime.dylib");
-        
-        cmd.arg(&runtime_lib_path);
+        cmd.arg(self.runtime_library()?);
+        if self.options.lto && cfg!(target_os = "linux") {
+            // System libraries the static Rust runtime depends on
+            cmd.args(["-lpthread", "-ldl"]);
+        }
         
         // Add standard C library
         if !self.options.link_libraries.contains(&"c".to_string()) {
@@ -519,7 +779,7 @@ impl CompilationPipeline {
     }
     
     /// Link object file(s) into a shared library
-    fn link_library(&self, object_file: &Path, base_name: &str) -> Result<PathBuf, CompilerError> {
+    fn link_library(&self, object_files: &[PathBuf], base_name: &str) -> Result<PathBuf, CompilerError> {
         let lib_extension = if cfg!(target_os = "macos") {
             "dylib"
         } else if cfg!(target_os = "windows") {
@@ -544,14 +804,15 @@ impl CompilationPipeline {
             cmd.arg("/LD");
             cmd
         } else {
-            let mut cmd = Command::new("cc");
+            let mut cmd = Command::new(if self.options.lto { "clang" } else { "cc" });
             cmd.arg("-shared");
             cmd.arg("-fPIC");
             cmd
         };
+        self.add_lto_flags(&mut cmd);
         
         cmd.arg("-o").arg(&output_path);
-        cmd.arg(object_file);
+        cmd.args(object_files);
         
         // Add library paths
         for lib_path in &self.options.library_paths {
@@ -564,8 +825,7 @@ impl CompilationPipeline {
         }
         
         // Add AetherScript runtime library
-        let runtime_lib_path = PathBuf::from("/Users/keithballinger/Desktop/projects/logos/runtime/target/release/libaether_runtime.dylib");
-        cmd.arg(&runtime_lib_path);
+        cmd.arg(self.runtime_library()?);
         
         // Add standard C library
         if !self.options.link_libraries.contains(&"c".to_string()) {
@@ -594,6 +854,106 @@ impl CompilationPipeline {
     }
 }
 
+/// A parsed input file
+struct ParsedInput {
+    module: Module,
+    lines: usize,
+    /// Parse cache key, when the cache is enabled
+    source_key: Option<String>,
+}
+
+/// Read and parse one input file, reusing a cached parse when possible
+fn parse_input(input_file: &Path, cache: Option<&IncrementalCache>) -> Result<ParsedInput, CompilerError> {
+    let source = fs::read_to_string(input_file)
+        .map_err(|e| CompilerError::IoError {
+            message: format!("Failed to read {}: {}", input_file.display(), e),
+        })?;
+    let lines = source.lines().count();
+    
+    match cache {
+        Some(cache) => {
+            let key = cache::source_key(input_file, &source);
+            let cached = cache.parse_with(&key, || parse_source(input_file, &source))?;
+            Ok(ParsedInput { module: cached.module, lines, source_key: Some(key) })
+        }
+        None => Ok(ParsedInput { module: parse_source(input_file, &source)?, lines, source_key: None }),
+    }
+}
+
+/// Lex and parse a module in a single streaming pass
+fn parse_source(path: &Path, source: &str) -> Result<Module, CompilerError> {
+    let lexer = Lexer::new(source, path.to_string_lossy().to_string());
+    let mut parser = Parser::from_lexer(lexer);
+    let parsed = parser.parse_module();
+    if let Some(error) = parser.take_lexer_error() {
+        return Err(CompilerError::from(error));
+    }
+    Ok(parsed?)
+}
+
+/// Key under which a clean semantic check of `module` is recorded
+///
+/// Imports are resolved the way the semantic analyzer resolves them and
+/// followed transitively: standard library modules are covered by the
+/// compiler version, file modules by their interface hash. Returns `None`
+/// when an import cannot be fingerprinted, which disables reuse.
+fn module_check_key(module: &Module, source_key: &str, cache: &IncrementalCache, loader: &ModuleLoader) -> Option<String> {
+    let mut imports = Vec::new();
+    let mut pending: Vec<String> = module.imports.iter().map(|i| i.module_name.name.clone()).collect();
+    let mut seen = HashSet::new();
+    
+    while let Some(name) = pending.pop() {
+        if !seen.insert(name.clone()) {
+            continue;
+        }
+        match loader.resolve_module(&name).ok()? {
+            ModuleSource::Stdlib(stdlib_name) => imports.push(format!("std:{}", stdlib_name)),
+            ModuleSource::File(path) => {
+                let source = fs::read_to_string(&path).ok()?;
+                let imported = cache
+                    .parse_with(&cache::source_key(&path, &source), || parse_source(&path, &source))
+                    .ok()?;
+                imports.push(format!("{}:{}", name, imported.interface_hash));
+                pending.extend(imported.module.imports.iter().map(|i| i.module_name.name.clone()));
+            }
+            ModuleSource::Package(..) | ModuleSource::Memory(_) => return None,
+        }
+    }
+    
+    Some(cache::check_key(source_key, &imports))
+}
+
+/// Split a program's functions into at most `units` codegen units
+///
+/// Functions are taken in name order and dealt into contiguous groups of
+/// roughly equal MIR size, so a given program always yields the same
+/// partition and the same set of object files.
+fn partition_codegen_units(program: &mir::Program, units: usize) -> Vec<Vec<String>> {
+    let mut functions: Vec<(&String, usize)> = program.functions.iter()
+        .map(|(name, function)| {
+            let size = function.basic_blocks.values().map(|block| block.statements.len() + 1).sum();
+            (name, size)
+        })
+        .collect();
+    functions.sort_by(|a, b| a.0.cmp(b.0));
+    
+    let units = units.min(functions.len()).max(1);
+    let total: usize = functions.iter().map(|(_, size)| size).sum();
+    let target = (total + units - 1) / units;
+    
+    let mut partition = vec![Vec::new()];
+    let mut current = 0;
+    for (name, size) in functions {
+        if current >= target && partition.len() < units {
+            partition.push(Vec::new());
+            current = 0;
+        }
+        partition.last_mut().unwrap().push(name.clone());
+        current += size;
+    }
+    partition
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -618,6 +978,30 @@ mod tests {
         assert_eq!(stats.functions_compiled, 10);
     }
 
+    #[test]
+    fn test_partition_codegen_units_is_stable() {
+        let source = r#"
+(DEFINE_MODULE
+  (NAME units)
+  (CONTENT
+    (DEFINE_FUNCTION (NAME delta) (RETURNS INTEGER) (BODY (RETURN_VALUE 4)))
+    (DEFINE_FUNCTION (NAME alpha) (RETURNS INTEGER) (BODY (RETURN_VALUE 1)))
+    (DEFINE_FUNCTION (NAME gamma) (RETURNS INTEGER) (BODY (RETURN_VALUE 3)))
+    (DEFINE_FUNCTION (NAME beta) (RETURNS INTEGER) (BODY (RETURN_VALUE 2)))))
+"#;
+        let tokens = Lexer::new(source, "units.aether".to_string()).tokenize().unwrap();
+        let program = Parser::new(tokens).parse_program().unwrap();
+        let mir_program = mir::lowering::lower_ast_to_mir(&program).unwrap();
+        
+        let units = partition_codegen_units(&mir_program, 2);
+        assert_eq!(units, vec![
+            vec!["alpha".to_string(), "beta".to_string()],
+            vec!["delta".to_string(), "gamma".to_string()],
+        ]);
+        assert_eq!(partition_codegen_units(&mir_program, 16).len(), 4);
+        assert_eq!(partition_codegen_units(&mir_program, 1).len(), 1);
+    }
+
     #[test]
     fn test_pipeline_creation() {
         let opts = CompileOptions {
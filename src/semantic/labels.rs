@@ -0,0 +1,95 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Loop label resolution
+//!
+//! Runs on the arena AST `Parser::with_arena` builds: every `BREAK` and `CONTINUE`
+//! must be inside a loop, and a label must name an enclosing loop. Labels
+//! are compared as interned symbols.
+
+use crate::ast::arena::{AstArena, FunctionId, IdList, Span, StmtId, StmtKind, Symbol};
+use crate::error::SemanticError;
+
+/// Check every `BREAK` and `CONTINUE` in a function
+pub fn check_function(arena: &AstArena, function: FunctionId) -> Result<(), SemanticError> {
+    let mut loops = Vec::new();
+    check_body(arena, arena.function(function).body, &mut loops)
+}
+
+/// Check a statement list; `loops` holds the labels of the enclosing loops
+fn check_body(arena: &AstArena, body: IdList<StmtId>, loops: &mut Vec<Option<Symbol>>) -> Result<(), SemanticError> {
+    for &id in arena.stmt_list(body) {
+        let node = arena.stmt(id);
+        match node.kind {
+            StmtKind::If { then_body, else_ifs, else_body, .. } => {
+                check_body(arena, then_body, loops)?;
+                for else_if in arena.else_if_list(else_ifs) {
+                    check_body(arena, else_if.body, loops)?;
+                }
+                if let Some(else_body) = else_body {
+                    check_body(arena, else_body, loops)?;
+                }
+            }
+            StmtKind::While { body, label, .. }
+            | StmtKind::ForEach { body, label, .. }
+            | StmtKind::FixedIteration { body, label, .. } => {
+                loops.push(label);
+                check_body(arena, body, loops)?;
+                loops.pop();
+            }
+            StmtKind::Try { body, catches, finally } => {
+                check_body(arena, body, loops)?;
+                for catch in arena.catch_list(catches) {
+                    check_body(arena, catch.body, loops)?;
+                }
+                if let Some(finally) = finally {
+                    check_body(arena, finally, loops)?;
+                }
+            }
+            StmtKind::ResourceScope { body, .. } => check_body(arena, body, loops)?,
+            StmtKind::Break(label) => check_target(arena, "break", label, node.span, loops)?,
+            StmtKind::Continue(label) => check_target(arena, "continue", label, node.span, loops)?,
+            _ => {}
+        }
+    }
+    Ok(())
+}
+
+fn check_target(
+    arena: &AstArena,
+    statement: &str,
+    label: Option<Symbol>,
+    span: Span,
+    loops: &[Option<Symbol>],
+) -> Result<(), SemanticError> {
+    let found = match label {
+        Some(label) => loops.contains(&Some(label)),
+        None => !loops.is_empty(),
+    };
+    if found {
+        return Ok(());
+    }
+
+    let location = span.to_location(&arena.interner);
+    Err(match label {
+        Some(label) => SemanticError::UndefinedSymbol {
+            symbol: format!("loop label '{}'", arena.name(label)),
+            location,
+        },
+        None => SemanticError::UnsupportedFeature {
+            feature: format!("{} statement outside of loop", statement),
+            location,
+        },
+    })
+}
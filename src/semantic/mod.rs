@@ -16,21 +16,25 @@
 //! 
 //! Performs type checking, symbol resolution, and semantic validation
 
+pub mod labels;
 pub mod metadata;
 // #[cfg(test)]
 // mod ownership_tests;
 
 use crate::ast::*;
-use crate::contracts::{ContractValidator, ContractContext};
+use crate::ast::arena::AstArena;
+use crate::contracts::{ContractCheckMode, ContractStats, ContractValidator, ContractContext};
 use crate::ffi::FFIAnalyzer;
 use crate::memory::MemoryAnalyzer;
-use crate::module_loader::{ModuleLoader, LoadedModule};
+use crate::module_loader::{ModuleLoader, LoadedModule, ModuleSource};
 use crate::types::{Type, TypeChecker, OwnershipKind};
 use crate::symbols::{Symbol, SymbolTable, SymbolKind, ScopeKind, BorrowState};
 use crate::error::{SemanticError, SourceLocation};
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::rc::Rc;
+use std::sync::Arc;
 use std::cell::RefCell;
+use rayon::prelude::*;
 
 /// Semantic analyzer for AetherScript programs
 pub struct SemanticAnalyzer {
@@ -69,6 +73,39 @@ pub struct SemanticAnalyzer {
     
     /// Analyzed modules cache to prevent double-analysis
     analyzed_modules: HashMap<String, LoadedModule>,
+    
+    /// Check function bodies on the rayon pool once signatures are collected
+    parallel: bool,
+    
+    /// Modules whose function bodies are known to check cleanly
+    verified_modules: HashSet<String>,
+    
+    /// Arena ASTs from the parser, for the checks that run on them
+    arenas: Vec<AstArena>,
+}
+
+/// Module-level view captured after signature collection
+///
+/// Holds everything a function body may refer to: the module's scope chain,
+/// its type definitions and the type checker state. It is never mutated
+/// after construction, so body checkers on different threads share it.
+struct SignatureIndex {
+    module_name: Option<String>,
+    symbol_table: Arc<SymbolTable>,
+    
+    /// Its type definitions and type table are behind `Arc`s, so cloning it
+    /// per body shares them
+    type_checker: TypeChecker,
+    
+    contract_mode: ContractCheckMode,
+}
+
+/// Result of checking one function body in isolation
+struct BodyOutcome {
+    result: Result<(), SemanticError>,
+    errors: Vec<SemanticError>,
+    stats: AnalysisStats,
+    contract_stats: ContractStats,
 }
 
 /// Statistics about the semantic analysis
@@ -82,16 +119,33 @@ pub struct AnalysisStats {
     pub errors_found: usize,
 }
 
+impl AnalysisStats {
+    /// Add the counts gathered by another analyzer
+    pub fn merge(&mut self, other: &AnalysisStats) {
+        self.modules_analyzed += other.modules_analyzed;
+        self.functions_analyzed += other.functions_analyzed;
+        self.variables_declared += other.variables_declared;
+        self.types_defined += other.types_defined;
+        self.external_functions_analyzed += other.external_functions_analyzed;
+        self.errors_found += other.errors_found;
+    }
+}
+
 impl SemanticAnalyzer {
     /// Create a new semantic analyzer
     pub fn new() -> Self {
         eprintln!("SemanticAnalyzer: Creating new instance");
-        let type_checker = Rc::new(RefCell::new(TypeChecker::new()));
+        Self::with_parts(SymbolTable::new(), TypeChecker::new())
+    }
+    
+    /// Build an analyzer around existing symbol and type state
+    fn with_parts(symbol_table: SymbolTable, type_checker: TypeChecker) -> Self {
+        let type_checker = Rc::new(RefCell::new(type_checker));
         let ffi_analyzer = FFIAnalyzer::new(type_checker.clone());
         let memory_analyzer = MemoryAnalyzer::new(type_checker.clone());
         
         Self {
-            symbol_table: SymbolTable::new(),
+            symbol_table,
             type_checker,
             contract_validator: ContractValidator::new(),
             ffi_analyzer,
@@ -103,16 +157,59 @@ impl SemanticAnalyzer {
             current_exceptions: Vec::new(),
             in_finally_block: false,
             analyzed_modules: HashMap::new(),
+            parallel: false,
+            verified_modules: HashSet::new(),
+            arenas: Vec::new(),
+        }
+    }
+    
+    /// Check function bodies in parallel after collecting all signatures
+    pub fn set_parallel(&mut self, parallel: bool) {
+        self.parallel = parallel;
+    }
+    
+    /// Skip body checks for modules an earlier compilation already verified
+    ///
+    /// Their declarations, imports and exports are still processed, so the
+    /// symbol table is the same as after a full analysis.
+    pub fn set_verified_modules(&mut self, modules: HashSet<String>) {
+        self.verified_modules = modules;
+    }
+    
+    /// Give `analyze_program` arena ASTs of the program's modules, from `Parser::with_arena`
+    ///
+    /// Loop labels are resolved on them; without arenas that is left to
+    /// MIR lowering.
+    pub fn set_arenas(&mut self, arenas: Vec<AstArena>) {
+        self.arenas = arenas;
+    }
+    
+    /// Set how generated runtime contract checks run
+    pub fn set_contract_check_mode(&mut self, mode: ContractCheckMode) {
+        self.contract_validator.set_mode(mode);
+    }
+    
+    /// Function bodies `analyze_module` checks for a module
+    fn bodies_to_check<'m>(&self, module: &'m Module) -> &'m [Function] {
+        if self.verified_modules.contains(&module.name.name) {
+            &[]
+        } else {
+            &module.function_definitions
         }
     }
     
     /// Analyze a complete program
     pub fn analyze_program(&mut self, program: &Program) -> Result<(), Vec<SemanticError>> {
         self.errors.clear();
+        self.check_loop_labels();
         
-        for module in &program.modules {
-            if let Err(e) = self.analyze_module(module) {
-                self.errors.push(e);
+        if self.parallel {
+            self.analyze_modules_parallel(&program.modules);
+        } else {
+            for module in &program.modules {
+                if let Err(e) = self.analyze_module(module) {
+                    self.errors.push(e);
+                }
             }
         }
         
@@ -123,8 +220,149 @@ impl SemanticAnalyzer {
         }
     }
     
+    /// Resolve `BREAK` and `CONTINUE` targets in every module still to be checked
+    fn check_loop_labels(&mut self) {
+        for arena in &self.arenas {
+            for module in &arena.modules {
+                if self.verified_modules.contains(arena.name(module.name)) {
+                    continue;
+                }
+                for &function in arena.function_list(module.functions) {
+                    if let Err(e) = labels::check_function(arena, function) {
+                        self.errors.push(e);
+                    }
+                }
+            }
+        }
+    }
+    
+    /// Two-phase analysis of a set of modules
+    ///
+    /// Declarations and signatures are collected sequentially, since imports
+    /// and type definitions mutate shared state. Function bodies only read
+    /// that state, so they are then checked in parallel and merged back in
+    /// source order; diagnostics and statistics match a sequential run.
+    fn analyze_modules_parallel(&mut self, modules: &[Module]) {
+        // Phase 1: declarations and signatures
+        let indexes: Vec<Result<SignatureIndex, SemanticError>> = modules.iter()
+            .map(|module| self.collect_module_signatures(module))
+            .collect();
+        
+        // Phase 2: function bodies of every module that declared cleanly
+        let jobs: Vec<(&SignatureIndex, &Function)> = modules.iter()
+            .zip(&indexes)
+            .filter_map(|(module, index)| index.as_ref().ok().map(|index| (self.bodies_to_check(module), index)))
+            .flat_map(|(bodies, index)| bodies.iter().map(move |func_def| (index, func_def)))
+            .collect();
+        let mut outcomes = jobs.par_iter()
+            .map(|(index, func_def)| Self::check_function_body(index, func_def))
+            .collect::<Vec<_>>()
+            .into_iter();
+        
+        // Merge in source order, stopping each module at its first failure
+        for (module, index) in modules.iter().zip(indexes) {
+            let index = match index {
+                Ok(index) => index,
+                Err(e) => {
+                    self.errors.push(e);
+                    continue;
+                }
+            };
+            
+            let mut failure = None;
+            for outcome in outcomes.by_ref().take(self.bodies_to_check(module).len()) {
+                if failure.is_some() {
+                    continue;
+                }
+                self.errors.extend(outcome.errors);
+                self.stats.merge(&outcome.stats);
+                self.contract_validator.merge_stats(&outcome.contract_stats);
+                failure = outcome.result.err();
+            }
+            
+            let failure = failure.or_else(|| {
+                module.exports.iter()
+                    .find_map(|export| Self::check_export(&index.symbol_table, export).err())
+            });
+            match failure {
+                Some(e) => self.errors.push(e),
+                None => self.stats.modules_analyzed += 1,
+            }
+        }
+    }
+    
+    /// First phase of `analyze_module`: everything except bodies and exports
+    fn collect_module_signatures(&mut self, module: &Module) -> Result<SignatureIndex, SemanticError> {
+        self.enter_module(module)?;
+        
+        let index = SignatureIndex {
+            module_name: self.current_module.clone(),
+            symbol_table: Arc::new(self.symbol_table.snapshot_current_scope()),
+            type_checker: self.type_checker.borrow().clone(),
+            contract_mode: self.contract_validator.mode(),
+        };
+        
+        self.exit_module()?;
+        Ok(index)
+    }
+    
+    /// Check one function body against a signature index
+    ///
+    /// The body gets its own symbol layer over the shared module scope;
+    /// bindings it declares or modifies live only in that layer.
+    fn check_function_body(index: &SignatureIndex, func_def: &Function) -> BodyOutcome {
+        let symbol_table = SymbolTable::layered_over(Arc::clone(&index.symbol_table));
+        let mut checker = Self::with_parts(symbol_table, index.type_checker.clone());
+        checker.current_module = index.module_name.clone();
+        checker.contract_validator.set_mode(index.contract_mode);
+        let root_region = checker.memory_analyzer.create_region(None);
+        checker.memory_analyzer.enter_region(root_region);
+        
+        let result = checker.analyze_function_body(func_def);
+        BodyOutcome {
+            result,
+            errors: checker.errors,
+            stats: checker.stats,
+            contract_stats: checker.contract_validator.get_stats().clone(),
+        }
+    }
+    
     /// Analyze a module
     pub fn analyze_module(&mut self, module: &Module) -> Result<(), SemanticError> {
+        self.enter_module(module)?;
+        
+        // Second pass: Analyze function bodies
+        for func_def in self.bodies_to_check(module) {
+            self.analyze_function_body(func_def)?;
+        }
+        
+        // Process exports (validate that exported symbols exist)
+        for export in &module.exports {
+            self.analyze_export(export)?;
+        }
+        
+        self.exit_module()?;
+        self.stats.modules_analyzed += 1;
+        
+        Ok(())
+    }
+    
+    /// Analyze a module's declarations and exports without its function bodies
+    fn analyze_module_interface(&mut self, module: &Module) -> Result<(), SemanticError> {
+        self.enter_module(module)?;
+        
+        for export in &module.exports {
+            self.analyze_export(export)?;
+        }
+        
+        self.exit_module()?;
+        self.stats.modules_analyzed += 1;
+        
+        Ok(())
+    }
+    
+    /// Enter a module's scope and process its declarations and signatures
+    fn enter_module(&mut self, module: &Module) -> Result<(), SemanticError> {
         self.current_module = Some(module.name.name.clone());
         self.symbol_table.set_current_module(self.current_module.clone());
         self.type_checker.borrow_mut().set_current_module(self.current_module.clone());
@@ -162,24 +400,17 @@ impl SemanticAnalyzer {
             self.add_function_signature(func_def)?;
         }
         
-        // Second pass: Analyze function bodies
-        for func_def in &module.function_definitions {
-            self.analyze_function_body(func_def)?;
-        }
-        
-        // Process exports (validate that exported symbols exist)
-        for export in &module.exports {
-            self.analyze_export(export)?;
-        }
-        
+        Ok(())
+    }
+    
+    /// Leave the scope and memory region opened by `enter_module`
+    fn exit_module(&mut self) -> Result<(), SemanticError> {
         // Exit module scope
         self.symbol_table.exit_scope()?;
         
         // Exit the root memory region
         self.memory_analyzer.exit_region()?;
         
-        self.stats.modules_analyzed += 1;
-        
         Ok(())
     }
     
@@ -210,9 +441,14 @@ impl SemanticAnalyzer {
         // Store current module context
         let prev_module = self.current_module.clone();
         
-        // Analyze the imported module
+        // Analyze the imported module; standard library interfaces carry
+        // declarations only
         self.current_module = Some(module_name.clone());
-        if let Err(e) = self.analyze_module(&module_to_analyze) {
+        let analyzed = match loaded_module_clone.source {
+            ModuleSource::Stdlib(_) => self.analyze_module_interface(&module_to_analyze),
+            _ => self.analyze_module(&module_to_analyze),
+        };
+        if let Err(e) = analyzed {
             self.current_module = prev_module;
             return Err(SemanticError::ImportError {
                 module: module_name.clone(),
@@ -546,12 +782,17 @@ impl SemanticAnalyzer {
     
     /// Analyze an export statement
     fn analyze_export(&mut self, export: &ExportStatement) -> Result<(), SemanticError> {
+        Self::check_export(&self.symbol_table, export)
+    }
+    
+    /// Check that an exported symbol exists in `symbol_table`
+    fn check_export(symbol_table: &SymbolTable, export: &ExportStatement) -> Result<(), SemanticError> {
         match export {
             ExportStatement::Function { name, source_location } |
             ExportStatement::Type { name, source_location } |
             ExportStatement::Constant { name, source_location } => {
                 // Check that the exported symbol exists
-                if self.symbol_table.lookup_symbol(&name.name).is_none() {
+                if symbol_table.lookup_symbol(&name.name).is_none() {
                     return Err(SemanticError::UndefinedSymbol {
                         symbol: name.name.clone(),
                         location: source_location.clone(),
@@ -652,7 +893,18 @@ impl SemanticAnalyzer {
                         self.symbol_table.mark_variable_initialized(&name.name)?;
                     }
                     
-                    // TODO: Handle other assignment targets (array elements, struct fields, etc.)
+                    AssignmentTarget::ArrayElement { .. } => {
+                        let element_type = self.analyze_assignment_target(target)?;
+                        if !self.type_checker.borrow().types_compatible(&element_type, &value_type) {
+                            return Err(SemanticError::TypeMismatch {
+                                expected: element_type.to_string(),
+                                found: value_type.to_string(),
+                                location: source_location.clone(),
+                            });
+                        }
+                    }
+                    
+                    // TODO: Handle other assignment targets (struct fields, etc.)
                     _ => {
                         // For now, just analyze the target as an expression to check types
                         self.analyze_assignment_target(target)?;
@@ -708,13 +960,8 @@ impl SemanticAnalyzer {
                 self.analyze_fixed_iteration_loop(counter, from_value, to_value, step_value, body)?;
             }
             
-            Statement::Break { target_label, source_location } => {
-                self.analyze_break_statement(target_label, source_location)?;
-            }
-            
-            Statement::Continue { target_label, source_location } => {
-                self.analyze_continue_statement(target_label, source_location)?;
-            }
+            // Targets are resolved on the arena AST by `check_loop_labels`
+            Statement::Break { .. } | Statement::Continue { .. } => {}
             
             Statement::TryBlock { protected_block, catch_clauses, finally_block, .. } => {
                 self.analyze_try_block(protected_block, catch_clauses, finally_block)?;
@@ -798,6 +1045,19 @@ impl SemanticAnalyzer {
                 let left_type = self.analyze_expression(left)?;
                 let right_type = self.analyze_expression(right)?;
                 
+                // Vector arithmetic is lane-wise on matching vector types
+                if left_type.vector_parts().is_some() || right_type.vector_parts().is_some() {
+                    let (element_type, _) = self.expect_same_vectors(&left_type, &right_type, source_location)?;
+                    if !element_type.is_numeric() {
+                        return Err(SemanticError::TypeMismatch {
+                            expected: "numeric vector".to_string(),
+                            found: left_type.to_string(),
+                            location: source_location.clone(),
+                        });
+                    }
+                    return Ok(left_type);
+                }
+                
                 // Both operands must be numeric
                 if !left_type.is_numeric() || !right_type.is_numeric() {
                     return Err(SemanticError::TypeMismatch {
@@ -1136,6 +1396,10 @@ impl SemanticAnalyzer {
                     });
                 }
                 
+                if let Some((_, lanes)) = left_type.vector_parts() {
+                    return Ok(Type::vector(Type::primitive(PrimitiveType::Boolean), lanes));
+                }
+                
                 // Equality comparison always returns boolean
                 Ok(Type::primitive(PrimitiveType::Boolean))
             }
@@ -1153,6 +1417,10 @@ impl SemanticAnalyzer {
                     });
                 }
                 
+                if let Some((_, lanes)) = left_type.vector_parts() {
+                    return Ok(Type::vector(Type::primitive(PrimitiveType::Boolean), lanes));
+                }
+                
                 // Inequality comparison always returns boolean
                 Ok(Type::primitive(PrimitiveType::Boolean))
             }
@@ -1404,6 +1672,131 @@ impl SemanticAnalyzer {
                 }
             }
             
+            Expression::LessThan { left, right, source_location } |
+            Expression::LessThanOrEqual { left, right, source_location } |
+            Expression::GreaterThan { left, right, source_location } |
+            Expression::GreaterThanOrEqual { left, right, source_location } => {
+                let left_type = self.analyze_expression(left)?;
+                let right_type = self.analyze_expression(right)?;
+                
+                // Vector comparisons produce one Boolean lane per element
+                if left_type.vector_parts().is_some() || right_type.vector_parts().is_some() {
+                    let (_, lanes) = self.expect_same_vectors(&left_type, &right_type, source_location)?;
+                    return Ok(Type::vector(Type::primitive(PrimitiveType::Boolean), lanes));
+                }
+                
+                if !left_type.is_numeric() || !right_type.is_numeric() {
+                    return Err(SemanticError::TypeMismatch {
+                        expected: "numeric type".to_string(),
+                        found: format!("{} and {}", left_type, right_type),
+                        location: source_location.clone(),
+                    });
+                }
+                Ok(Type::primitive(PrimitiveType::Boolean))
+            }
+            
+            Expression::VectorLiteral { elements, source_location } => {
+                let mut element_types = Vec::with_capacity(elements.len());
+                for element in elements {
+                    element_types.push(self.analyze_expression(element)?);
+                }
+                
+                let element_type = element_types.first().cloned()
+                    .unwrap_or(Type::primitive(PrimitiveType::Integer));
+                if let Some(mismatch) = element_types.iter().find(|ty| **ty != element_type) {
+                    return Err(SemanticError::TypeMismatch {
+                        expected: element_type.to_string(),
+                        found: mismatch.to_string(),
+                        location: source_location.clone(),
+                    });
+                }
+                
+                self.vector_type(element_type, elements.len(), source_location)
+            }
+            
+            Expression::VectorSplat { value, lanes, source_location } => {
+                let value_type = self.analyze_expression(value)?;
+                self.vector_type(value_type, *lanes as usize, source_location)
+            }
+            
+            Expression::VectorLoad { array, index, lanes, source_location } => {
+                self.check_vector_array_access(array, index, source_location)?;
+                self.vector_type(Type::primitive(PrimitiveType::Integer), *lanes as usize, source_location)
+            }
+            
+            Expression::VectorStore { array, index, value, source_location } => {
+                self.check_vector_array_access(array, index, source_location)?;
+                let value_type = self.analyze_expression(value)?;
+                let (element_type, _) = self.expect_vector(&value_type, source_location)?;
+                if !matches!(element_type, Type::Primitive(PrimitiveType::Integer)) {
+                    return Err(SemanticError::TypeMismatch {
+                        expected: "Integer vector".to_string(),
+                        found: value_type.to_string(),
+                        location: source_location.clone(),
+                    });
+                }
+                Ok(Type::primitive(PrimitiveType::Void))
+            }
+            
+            Expression::VectorShuffle { left, right, mask, source_location } => {
+                let left_type = self.analyze_expression(left)?;
+                let right_type = self.analyze_expression(right)?;
+                let (element_type, lanes) = self.expect_same_vectors(&left_type, &right_type, source_location)?;
+                
+                // Indices address the lanes of `left` followed by those of `right`
+                if let Some(index) = mask.iter().find(|index| **index as usize >= 2 * lanes) {
+                    return Err(SemanticError::InvalidOperation {
+                        operation: "vector shuffle".to_string(),
+                        reason: format!("lane index {} is out of range for two {}-lane vectors", index, lanes),
+                        location: source_location.clone(),
+                    });
+                }
+                
+                self.vector_type(element_type, mask.len(), source_location)
+            }
+            
+            Expression::VectorExtract { vector, lane, source_location } => {
+                let vector_type = self.analyze_expression(vector)?;
+                let (element_type, lanes) = self.expect_vector(&vector_type, source_location)?;
+                
+                let lane_type = self.analyze_expression(lane)?;
+                if !matches!(lane_type, Type::Primitive(PrimitiveType::Integer)) {
+                    return Err(SemanticError::TypeMismatch {
+                        expected: "Integer".to_string(),
+                        found: lane_type.to_string(),
+                        location: source_location.clone(),
+                    });
+                }
+                if let Expression::IntegerLiteral { value, .. } = lane.as_ref() {
+                    if *value < 0 || *value as usize >= lanes {
+                        return Err(SemanticError::InvalidOperation {
+                            operation: "vector extract".to_string(),
+                            reason: format!("lane {} is out of range for {}", value, vector_type),
+                            location: source_location.clone(),
+                        });
+                    }
+                }
+                
+                Ok(element_type)
+            }
+            
+            Expression::VectorSelect { mask, if_true, if_false, source_location } => {
+                let mask_type = self.analyze_expression(mask)?;
+                let true_type = self.analyze_expression(if_true)?;
+                let false_type = self.analyze_expression(if_false)?;
+                
+                let (_, lanes) = self.expect_same_vectors(&true_type, &false_type, source_location)?;
+                if mask_type != Type::vector(Type::primitive(PrimitiveType::Boolean), lanes) {
+                    return Err(SemanticError::TypeMismatch {
+                        expected: Type::vector(Type::primitive(PrimitiveType::Boolean), lanes).to_string(),
+                        found: mask_type.to_string(),
+                        location: source_location.clone(),
+                    });
+                }
+                
+                Ok(true_type)
+            }
+            
             // TODO: Handle other expression types
             _ => {
                 eprintln!("Warning: Unhandled expression type in semantic analysis");
@@ -1413,6 +1806,67 @@ impl SemanticAnalyzer {
         }
     }
     
+    /// Build a vector type, checking the lane type and width
+    fn vector_type(&self, element_type: Type, lanes: usize, location: &SourceLocation) -> Result<Type, SemanticError> {
+        if !element_type.is_vector_element() || !Type::is_valid_vector_width(lanes) {
+            return Err(SemanticError::InvalidType {
+                type_name: Type::vector(element_type, lanes).to_string(),
+                reason: format!(
+                    "vectors hold 2 to {} (a power of two) INTEGER, FLOAT or BOOLEAN lanes",
+                    crate::types::MAX_VECTOR_LANES
+                ),
+                location: location.clone(),
+            });
+        }
+        Ok(Type::vector(element_type, lanes))
+    }
+    
+    /// Element type and lane count of a vector operand
+    fn expect_vector(&self, ty: &Type, location: &SourceLocation) -> Result<(Type, usize), SemanticError> {
+        ty.vector_parts()
+            .map(|(element_type, lanes)| (element_type.clone(), lanes))
+            .ok_or_else(|| SemanticError::TypeMismatch {
+                expected: "vector".to_string(),
+                found: ty.to_string(),
+                location: location.clone(),
+            })
+    }
+    
+    /// Lane-wise operations need both operands to be the same vector type
+    fn expect_same_vectors(&self, left: &Type, right: &Type, location: &SourceLocation) -> Result<(Type, usize), SemanticError> {
+        let parts = self.expect_vector(left, location)?;
+        if left != right {
+            return Err(SemanticError::TypeMismatch {
+                expected: left.to_string(),
+                found: right.to_string(),
+                location: location.clone(),
+            });
+        }
+        Ok(parts)
+    }
+    
+    /// Vector loads and stores move i32 lanes, so they need an Integer array
+    fn check_vector_array_access(&mut self, array: &Expression, index: &Expression, location: &SourceLocation) -> Result<(), SemanticError> {
+        let array_type = self.analyze_expression(array)?;
+        if !matches!(&array_type, Type::Array { element_type, .. } if **element_type == Type::primitive(PrimitiveType::Integer)) {
+            return Err(SemanticError::TypeMismatch {
+                expected: "Array of Integer".to_string(),
+                found: array_type.to_string(),
+                location: location.clone(),
+            });
+        }
+        
+        let index_type = self.analyze_expression(index)?;
+        if !matches!(index_type, Type::Primitive(PrimitiveType::Integer)) {
+            return Err(SemanticError::TypeMismatch {
+                expected: "Integer".to_string(),
+                found: index_type.to_string(),
+                location: location.clone(),
+            });
+        }
+        Ok(())
+    }
+    
     /// Analyze an assignment target
     fn analyze_assignment_target(&mut self, target: &AssignmentTarget) -> Result<Type, SemanticError> {
         match target {
@@ -1454,6 +1908,34 @@ impl SemanticAnalyzer {
                 }
             }
             
+            AssignmentTarget::ArrayElement { array, index } => {
+                let array_type = self.analyze_expression(array)?;
+                
+                // Check that it's an array
+                match array_type {
+                    Type::Array { element_type, .. } => {
+                        // Index must be integer
+                        let index_type = self.analyze_expression(index)?;
+                        if !matches!(index_type, Type::Primitive(PrimitiveType::Integer)) {
+                            return Err(SemanticError::TypeMismatch {
+                                expected: "Integer".to_string(),
+                                found: index_type.to_string(),
+                                location: SourceLocation::unknown(),
+                            });
+                        }
+                        
+                        Ok((*element_type).clone())
+                    }
+                    _ => {
+                        Err(SemanticError::TypeMismatch {
+                            expected: "Array".to_string(),
+                            found: array_type.to_string(),
+                            location: SourceLocation::unknown(),
+                        })
+                    }
+                }
+            }
+            
             // TODO: Handle other assignment targets
             _ => Ok(Type::Error),
         }
@@ -1813,36 +2295,6 @@ impl SemanticAnalyzer {
         Ok(())
     }
     
-    /// Analyze a break statement
-    fn analyze_break_statement(&mut self, target_label: &Option<Identifier>, source_location: &SourceLocation) -> Result<(), SemanticError> {
-        // TODO: Check that we're inside a loop
-        // TODO: If label is specified, check that it matches a loop label
-        if target_label.is_some() {
-            // Future: Implement labeled loop tracking
-            return Err(SemanticError::UnsupportedFeature {
-                feature: "labeled break".to_string(),
-                location: source_location.clone(),
-            });
-        }
-        
-        Ok(())
-    }
-    
-    /// Analyze a continue statement
-    fn analyze_continue_statement(&mut self, target_label: &Option<Identifier>, source_location: &SourceLocation) -> Result<(), SemanticError> {
-        // TODO: Check that we're inside a loop
-        // TODO: If label is specified, check that it matches a loop label
-        if target_label.is_some() {
-            // Future: Implement labeled loop tracking
-            return Err(SemanticError::UnsupportedFeature {
-                feature: "labeled continue".to_string(),
-                location: source_location.clone(),
-            });
-        }
-        
-        Ok(())
-    }
-    
     /// Analyze a try-catch block
     fn analyze_try_block(&mut self, protected_block: &Block, catch_clauses: &[CatchClause], finally_block: &Option<Block>) -> Result<(), SemanticError> {
         // Track exception flow - save current state
@@ -2128,6 +2580,11 @@ impl SemanticAnalyzer {
         &self.stats
     }
     
+    /// Get contract validation statistics
+    pub fn get_contract_statistics(&self) -> &ContractStats {
+        self.contract_validator.get_stats()
+    }
+    
     /// Get the symbol table (consumes the analyzer)
     pub fn get_symbol_table(self) -> SymbolTable {
         self.symbol_table
@@ -2352,6 +2809,137 @@ mod tests {
         assert_eq!(analyzer.get_statistics().variables_declared, 1);
     }
     
+    fn parse_program(source: &str) -> Program {
+        let mut lexer = crate::lexer::Lexer::new(source, "test.aether".to_string());
+        let tokens = lexer.tokenize().unwrap();
+        crate::parser::Parser::new(tokens).parse_program().unwrap()
+    }
+
+    #[test]
+    fn test_loop_labels_resolved_on_arena() {
+        let analyze = |body: &str| {
+            let source = format!(r#"
+            (DEFINE_MODULE
+              (NAME 'loops')
+              (CONTENT
+                (DEFINE_FUNCTION
+                  (NAME 'spin')
+                  (RETURNS INTEGER)
+                  (BODY
+                    {}
+                    (RETURN_VALUE 0)))))
+            "#, body);
+            let lexer = crate::lexer::Lexer::new(&source, "test.aether".to_string());
+            let mut parser = crate::parser::Parser::from_lexer(lexer).with_arena();
+            let program = parser.parse_program().unwrap();
+            let mut analyzer = SemanticAnalyzer::new();
+            analyzer.set_arenas(parser.take_arena().into_iter().collect());
+            analyzer.analyze_program(&program)
+        };
+        
+        assert!(analyze("(LOOP_WHILE_CONDITION TRUE (ITERATION_BODY (BREAK_LOOP)))").is_ok());
+        
+        let errors = analyze("(BREAK_LOOP)").unwrap_err();
+        assert!(matches!(&errors[0], SemanticError::UnsupportedFeature { feature, .. } if feature == "break statement outside of loop"));
+        
+        let errors = analyze("(LOOP_WHILE_CONDITION TRUE (ITERATION_BODY (CONTINUE_LOOP outer)))").unwrap_err();
+        assert!(matches!(&errors[0], SemanticError::UndefinedSymbol { symbol, .. } if symbol == "loop label 'outer'"));
+    }
+    
+    #[test]
+    fn test_parallel_analysis_matches_sequential() {
+        let source = r#"
+(DEFINE_MODULE
+  (NAME calls)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME square)
+      (ACCEPTS_PARAMETER (NAME "x") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (PRECONDITION (PREDICATE_GREATER_THAN x 0))
+      (BODY (RETURN_VALUE (EXPRESSION_MULTIPLY x x))))
+    (DEFINE_FUNCTION
+      (NAME sum_of_squares)
+      (ACCEPTS_PARAMETER (NAME "a") (TYPE INTEGER))
+      (ACCEPTS_PARAMETER (NAME "b") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY (RETURN_VALUE (EXPRESSION_ADD (CALL_FUNCTION square a) (CALL_FUNCTION square b)))))
+    (DEFINE_FUNCTION
+      (NAME broken)
+      (RETURNS INTEGER)
+      (BODY (RETURN_VALUE missing)))))
+(DEFINE_MODULE
+  (NAME clean)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME one)
+      (RETURNS INTEGER)
+      (BODY (RETURN_VALUE 1)))))
+"#;
+        let program = parse_program(source);
+
+        let mut sequential = SemanticAnalyzer::new();
+        sequential.set_contract_check_mode(ContractCheckMode::Sampled { one_in: 10 });
+        let sequential_result = sequential.analyze_program(&program);
+
+        let mut parallel = SemanticAnalyzer::new();
+        parallel.set_contract_check_mode(ContractCheckMode::Sampled { one_in: 10 });
+        parallel.set_parallel(true);
+        let parallel_result = parallel.analyze_program(&program);
+
+        let sequential_errors = sequential_result.unwrap_err();
+        let parallel_errors = parallel_result.unwrap_err();
+        assert_eq!(sequential_errors.len(), 1);
+        assert_eq!(format!("{:?}", sequential_errors), format!("{:?}", parallel_errors));
+
+        let (s, p) = (sequential.get_statistics(), parallel.get_statistics());
+        assert_eq!(s.modules_analyzed, p.modules_analyzed);
+        assert_eq!(s.functions_analyzed, p.functions_analyzed);
+        assert_eq!(s.variables_declared, p.variables_declared);
+        assert_eq!(p.modules_analyzed, 1);
+        assert_eq!(p.functions_analyzed, 3);
+
+        let contract_stats = parallel.get_contract_statistics();
+        assert_eq!(sequential.get_contract_statistics(), contract_stats);
+        assert_eq!(contract_stats.preconditions_validated, 1);
+    }
+
+    #[test]
+    fn test_stdlib_import_uses_interface() {
+        let program = parse_program(r#"
+(DEFINE_MODULE
+  (NAME user)
+  (CONTENT
+    (IMPORT_MODULE (NAME std_io))
+    (DEFINE_FUNCTION (NAME one) (RETURNS INTEGER) (BODY (RETURN_VALUE 1)))))
+"#);
+
+        let mut analyzer = SemanticAnalyzer::new();
+        assert!(analyzer.analyze_program(&program).is_ok());
+        // The importer's body is checked; the stdlib module's are not
+        assert_eq!(analyzer.get_statistics().modules_analyzed, 2);
+        assert_eq!(analyzer.get_statistics().functions_analyzed, 1);
+    }
+
+    #[test]
+    fn test_verified_modules_skip_body_checks() {
+        let program = parse_program(r#"
+(DEFINE_MODULE
+  (NAME cached)
+  (CONTENT
+    (DEFINE_FUNCTION (NAME broken) (RETURNS INTEGER) (BODY (RETURN_VALUE missing)))))
+"#);
+
+        for parallel in [false, true] {
+            let mut analyzer = SemanticAnalyzer::new();
+            analyzer.set_parallel(parallel);
+            analyzer.set_verified_modules(["cached".to_string()].into_iter().collect());
+            assert!(analyzer.analyze_program(&program).is_ok());
+            assert_eq!(analyzer.get_statistics().modules_analyzed, 1);
+            assert_eq!(analyzer.get_statistics().functions_analyzed, 0);
+        }
+    }
+
     #[test]
     fn test_type_mismatch_detection() {
         let mut analyzer = SemanticAnalyzer::new();
@@ -2394,7 +2982,40 @@ mod tests {
         let add_type = analyzer.analyze_expression(&add_expr).unwrap();
         assert_eq!(add_type, Type::primitive(PrimitiveType::Integer));
     }
-    
+
+    #[test]
+    fn test_vector_expression_types() {
+        let mut analyzer = SemanticAnalyzer::new();
+        let splat = |value: i64, lanes: u32| Expression::VectorSplat {
+            value: Box::new(Expression::IntegerLiteral { value, source_location: SourceLocation::unknown() }),
+            lanes,
+            source_location: SourceLocation::unknown(),
+        };
+
+        // Lane-wise comparison yields a Boolean mask of the same width
+        let compare = Expression::LessThan {
+            left: Box::new(splat(1, 4)),
+            right: Box::new(splat(2, 4)),
+            source_location: SourceLocation::unknown(),
+        };
+        assert_eq!(
+            analyzer.analyze_expression(&compare).unwrap(),
+            Type::vector(Type::primitive(PrimitiveType::Boolean), 4)
+        );
+
+        // Shuffle indices address the concatenation of both operands
+        let shuffle = Expression::VectorShuffle {
+            left: Box::new(splat(1, 4)),
+            right: Box::new(splat(2, 4)),
+            mask: vec![0, 8, 1, 2],
+            source_location: SourceLocation::unknown(),
+        };
+        assert!(analyzer.analyze_expression(&shuffle).is_err());
+
+        // Widths must be powers of two
+        assert!(analyzer.analyze_expression(&splat(1, 3)).is_err());
+    }
+
     #[test]
     fn test_variable_initialization_checking() {
         let mut analyzer = SemanticAnalyzer::new();
@@ -2476,6 +3097,7 @@ mod tests {
             throws_exceptions: Vec::new(),
             thread_safe: Some(true),
             may_block: Some(false),
+            contract_checks: None,
         };
 
         let result = validator.validate_function_metadata(
@@ -2531,6 +3153,7 @@ mod tests {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         };
 
         let result = validator.validate_function_metadata(
@@ -179,6 +179,7 @@ pub(crate) fn create_function_stub(
             throws_exceptions: vec![],
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         },
         body: crate::ast::Block {
             statements: vec![], // Empty body - would be filled in by actual implementation
@@ -19,6 +19,7 @@
 use crate::types::{Type, TypeDefinition};
 use crate::error::{SemanticError, SourceLocation};
 use std::collections::HashMap;
+use std::sync::Arc;
 
 /// Symbol information
 #[derive(Debug, Clone)]
@@ -90,100 +91,196 @@ pub enum ScopeKind {
     Loop,
 }
 
-/// A scope containing symbols
+/// An active scope
+///
+/// Symbols are not stored per scope: every binding lives in the table's
+/// per-name shadow stacks, and a scope only remembers where its entries in
+/// the undo log begin.
 #[derive(Debug, Clone)]
 pub struct Scope {
     pub kind: ScopeKind,
-    pub symbols: HashMap<String, Symbol>,
-    pub parent: Option<usize>, // Index into scope stack
-    pub children: Vec<usize>,  // Indices of child scopes
+    /// Length of the undo log when the scope was entered
+    undo_mark: usize,
 }
 
-impl Scope {
-    /// Create a new scope
-    pub fn new(kind: ScopeKind, parent: Option<usize>) -> Self {
-        Self {
-            kind,
-            symbols: HashMap::new(),
-            parent,
-            children: Vec::new(),
-        }
-    }
-    
-    /// Add a symbol to this scope
-    pub fn add_symbol(&mut self, symbol: Symbol) -> Result<(), SemanticError> {
-        if self.symbols.contains_key(&symbol.name) {
-            let existing = &self.symbols[&symbol.name];
-            return Err(SemanticError::DuplicateDefinition {
-                symbol: symbol.name,
-                location: symbol.declaration_location,
-                previous_location: existing.declaration_location.clone(),
-            });
-        }
-        
-        self.symbols.insert(symbol.name.clone(), symbol);
-        Ok(())
-    }
-    
-    /// Look up a symbol in this scope only
-    pub fn lookup_local(&self, name: &str) -> Option<&Symbol> {
-        self.symbols.get(name)
-    }
-    
-    /// Get all symbols in this scope
-    pub fn all_symbols(&self) -> impl Iterator<Item = &Symbol> {
-        self.symbols.values()
-    }
+/// Interned symbol name
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+struct NameId(u32);
+
+/// A symbol bound in an active scope
+#[derive(Debug, Clone)]
+struct Binding {
+    /// Index of the scope that declared it
+    depth: usize,
+    symbol: Symbol,
+}
+
+/// Everything currently bound to one name
+#[derive(Debug, Clone, Default)]
+struct NameEntry {
+    /// Bindings from outermost to innermost scope; the last one is visible
+    shadow: Vec<Binding>,
+    /// Merged import index: the symbol an imported module contributes,
+    /// visible when no scope binds the name
+    imported: Option<Symbol>,
 }
 
 /// Symbol table with hierarchical scopes
+///
+/// Names are interned once and map to a shadow stack of bindings, so a
+/// lookup is a single hash probe regardless of nesting depth or import
+/// count. Entering a scope records the undo log length; exiting pops the
+/// bindings logged since then.
+///
+/// A table can also be layered over a frozen, shared table (see
+/// `layered_over`): its own scopes nest inside the shared ones, lookups fall
+/// through to the shared table, and a shared binding is copied into the
+/// layer the first time it is written.
 pub struct SymbolTable {
-    /// Stack of scopes (index 0 is global scope)
+    /// Active scopes (index 0 is global scope)
     scopes: Vec<Scope>,
     
     /// Current scope index
     current_scope: usize,
     
-    /// Type definitions
-    type_definitions: HashMap<String, TypeDefinition>,
+    /// Interned names
+    names: HashMap<String, NameId>,
+    
+    /// Bindings per interned name
+    entries: Vec<NameEntry>,
+    
+    /// Names bound by the active scopes, in declaration order
+    undo_log: Vec<NameId>,
+    
+    /// Type definitions, shared with snapshots and layers
+    type_definitions: Arc<HashMap<String, TypeDefinition>>,
     
     /// Module imports mapping module names to their exported symbols
     imports: HashMap<String, HashMap<String, Symbol>>,
     
+    /// Import order; earlier modules win name conflicts
+    import_order: Vec<String>,
+    
     /// Current module name
     current_module: Option<String>,
+    
+    /// Frozen table owning the outermost scopes, if this is a layer
+    base: Option<Arc<SymbolTable>>,
 }
 
 impl SymbolTable {
     /// Create a new symbol table with global scope
     pub fn new() -> Self {
-        let global_scope = Scope::new(ScopeKind::Global, None);
         Self {
-            scopes: vec![global_scope],
+            scopes: vec![Scope { kind: ScopeKind::Global, undo_mark: 0 }],
             current_scope: 0,
-            type_definitions: HashMap::new(),
+            names: HashMap::new(),
+            entries: Vec::new(),
+            undo_log: Vec::new(),
+            type_definitions: Arc::new(HashMap::new()),
             imports: HashMap::new(),
+            import_order: Vec::new(),
             current_module: None,
+            base: None,
+        }
+    }
+    
+    /// Empty layer over a shared table
+    ///
+    /// The layer starts in the shared table's current scope. Scopes entered
+    /// afterwards belong to the layer; the shared scopes cannot be exited.
+    pub fn layered_over(base: Arc<SymbolTable>) -> SymbolTable {
+        Self {
+            scopes: base.scopes.iter().map(|scope| Scope { kind: scope.kind.clone(), undo_mark: 0 }).collect(),
+            current_scope: base.current_scope,
+            names: HashMap::new(),
+            entries: Vec::new(),
+            undo_log: Vec::new(),
+            type_definitions: Arc::clone(&base.type_definitions),
+            imports: HashMap::new(),
+            import_order: Vec::new(),
+            current_module: base.current_module.clone(),
+            base: Some(base),
         }
     }
     
+    /// Number of outer scopes owned by the shared table
+    fn shared_scopes(&self) -> usize {
+        self.base.as_ref().map_or(0, |base| base.scopes.len())
+    }
+    
     /// Set the current module
     pub fn set_current_module(&mut self, module_name: Option<String>) {
         self.current_module = module_name;
     }
     
+    fn intern(&mut self, name: &str) -> NameId {
+        if let Some(&id) = self.names.get(name) {
+            return id;
+        }
+        let id = NameId(self.entries.len() as u32);
+        self.names.insert(name.to_string(), id);
+        self.entries.push(NameEntry::default());
+        id
+    }
+    
+    fn entry(&self, name: &str) -> Option<&NameEntry> {
+        self.names.get(name).map(|id| &self.entries[id.0 as usize])
+    }
+    
+    /// Innermost scoped binding of `name` and its depth, ignoring imports
+    fn scoped_binding(&self, name: &str) -> Option<(usize, &Symbol)> {
+        match self.entry(name).and_then(|entry| entry.shadow.last()) {
+            Some(binding) => Some((binding.depth, &binding.symbol)),
+            None => self.base.as_ref()?.scoped_binding(name),
+        }
+    }
+    
+    /// Innermost scoped binding of `name`, ignoring imports
+    ///
+    /// A binding that lives in the shared table is copied into this layer
+    /// first, so writes never reach the shared table.
+    fn binding_mut(&mut self, name: &str) -> Option<&mut Symbol> {
+        if self.entry(name).map_or(true, |entry| entry.shadow.is_empty()) {
+            let (depth, symbol) = self.base.as_ref()?.scoped_binding(name)
+                .map(|(depth, symbol)| (depth, symbol.clone()))?;
+            let id = self.intern(name);
+            self.entries[id.0 as usize].shadow.push(Binding { depth, symbol });
+        }
+        let id = *self.names.get(name)?;
+        self.entries[id.0 as usize].shadow.last_mut().map(|binding| &mut binding.symbol)
+    }
+    
+    /// Symbols declared directly in the active scope at `depth`
+    fn scope_symbols(&self, depth: usize) -> Vec<&Symbol> {
+        let start = self.scopes[depth].undo_mark;
+        let end = self.scopes.get(depth + 1).map_or(self.undo_log.len(), |scope| scope.undo_mark);
+        let local = self.undo_log[start..end].iter().filter_map(|id| {
+            self.entries[id.0 as usize].shadow.iter().rev()
+                .find(|binding| binding.depth == depth)
+                .map(|binding| &binding.symbol)
+        });
+        
+        // Shared bindings, as modified by this layer
+        let shared = self.base.iter()
+            .filter(|base| depth < base.scopes.len())
+            .flat_map(|base| base.scope_symbols(depth))
+            .map(|symbol| self.lookup_in_scope(&symbol.name, depth).unwrap_or(symbol));
+        shared.chain(local).collect()
+    }
+    
+    /// Imported module exports, in import order
+    fn imports_in_order(&self) -> Vec<(&String, &HashMap<String, Symbol>)> {
+        let mut imports = self.base.as_ref().map_or_else(Vec::new, |base| base.imports_in_order());
+        imports.extend(self.import_order.iter().map(|module_name| (module_name, &self.imports[module_name])));
+        imports
+    }
+    
     /// Enter a new scope
     pub fn enter_scope(&mut self, kind: ScopeKind) -> usize {
-        let new_scope_index = self.scopes.len();
-        let new_scope = Scope::new(kind, Some(self.current_scope));
-        
-        // Add this scope as a child of the current scope
-        self.scopes[self.current_scope].children.push(new_scope_index);
-        
-        self.scopes.push(new_scope);
-        self.current_scope = new_scope_index;
-        
-        new_scope_index
+        self.scopes.push(Scope { kind, undo_mark: self.undo_log.len() });
+        self.current_scope = self.scopes.len() - 1;
+        self.current_scope
     }
     
     /// Exit the current scope, returning to parent
@@ -193,60 +290,83 @@ impl SymbolTable {
                 message: "Cannot exit global scope".to_string() 
             });
         }
+        if self.current_scope < self.shared_scopes() {
+            return Err(SemanticError::Internal {
+                message: "Cannot exit a scope of the shared symbol table".to_string()
+            });
+        }
         
-        let parent = self.scopes[self.current_scope].parent.unwrap();
-        self.current_scope = parent;
+        let scope = self.scopes.pop().unwrap();
+        for id in self.undo_log.drain(scope.undo_mark..) {
+            self.entries[id.0 as usize].shadow.pop();
+        }
+        self.current_scope -= 1;
         Ok(())
     }
     
+    /// Compact copy of this table
+    ///
+    /// Only names that are currently bound or imported are carried over, so
+    /// the copy stays small and can be handed to an independent checker.
+    pub fn snapshot_current_scope(&self) -> SymbolTable {
+        let mut snapshot = SymbolTable::new();
+        for depth in 0..self.scopes.len() {
+            if depth > 0 {
+                snapshot.enter_scope(self.scopes[depth].kind.clone());
+            }
+            for symbol in self.scope_symbols(depth) {
+                let id = snapshot.intern(&symbol.name);
+                snapshot.entries[id.0 as usize].shadow.push(Binding { depth, symbol: symbol.clone() });
+                snapshot.undo_log.push(id);
+            }
+        }
+        for (module_name, symbols) in self.imports_in_order() {
+            snapshot.add_import(module_name.clone(), symbols.clone());
+        }
+        snapshot.type_definitions = Arc::clone(&self.type_definitions);
+        snapshot.current_module = self.current_module.clone();
+        snapshot
+    }
+
     /// Get the current scope
     pub fn current_scope(&self) -> &Scope {
         &self.scopes[self.current_scope]
     }
     
-    /// Get a mutable reference to the current scope
-    pub fn current_scope_mut(&mut self) -> &mut Scope {
-        &mut self.scopes[self.current_scope]
-    }
-    
     /// Add a symbol to the current scope
     pub fn add_symbol(&mut self, symbol: Symbol) -> Result<(), SemanticError> {
-        self.current_scope_mut().add_symbol(symbol)
+        let depth = self.current_scope;
+        if let Some(existing) = self.lookup_in_scope(&symbol.name, depth) {
+            return Err(SemanticError::DuplicateDefinition {
+                previous_location: existing.declaration_location.clone(),
+                symbol: symbol.name,
+                location: symbol.declaration_location,
+            });
+        }
+        
+        let id = self.intern(&symbol.name);
+        self.entries[id.0 as usize].shadow.push(Binding { depth, symbol });
+        self.undo_log.push(id);
+        Ok(())
     }
     
     /// Look up a symbol, searching from current scope up to global
     pub fn lookup_symbol(&self, name: &str) -> Option<&Symbol> {
-        let mut current = self.current_scope;
-        
-        loop {
-            if let Some(symbol) = self.scopes[current].lookup_local(name) {
-                return Some(symbol);
-            }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
-            }
+        let entry = self.entry(name);
+        if let Some(binding) = entry.and_then(|entry| entry.shadow.last()) {
+            return Some(&binding.symbol);
         }
-        
-        // Check imports
-        for imported_symbols in self.imports.values() {
-            if let Some(symbol) = imported_symbols.get(name) {
-                return Some(symbol);
-            }
-        }
-        
-        None
+        self.base.as_ref()
+            .and_then(|base| base.lookup_symbol(name))
+            .or_else(|| entry?.imported.as_ref())
     }
     
-    /// Look up a symbol in a specific scope only
+    /// Look up a symbol in a specific active scope only
     pub fn lookup_in_scope(&self, name: &str, scope_index: usize) -> Option<&Symbol> {
-        if scope_index < self.scopes.len() {
-            self.scopes[scope_index].lookup_local(name)
-        } else {
-            None
-        }
+        self.entry(name)
+            .and_then(|entry| entry.shadow.iter().rev().find(|binding| binding.depth == scope_index))
+            .map(|binding| &binding.symbol)
+            .or_else(|| self.base.as_ref()?.lookup_in_scope(name, scope_index))
     }
     
     /// Add a type definition
@@ -263,7 +383,7 @@ impl SymbolTable {
             });
         }
         
-        self.type_definitions.insert(name, definition);
+        Arc::make_mut(&mut self.type_definitions).insert(name, definition);
         Ok(())
     }
     
@@ -279,7 +399,31 @@ impl SymbolTable {
     
     /// Add module imports
     pub fn add_import(&mut self, module_name: String, exported_symbols: HashMap<String, Symbol>) {
-        self.imports.insert(module_name, exported_symbols);
+        let replaced = self.imports.insert(module_name.clone(), exported_symbols).is_some();
+        if !replaced {
+            self.import_order.push(module_name.clone());
+        }
+        
+        // Rebuild the merged index when a module's exports change, otherwise
+        // only fill in names no earlier import provides
+        let modules = if replaced {
+            for entry in &mut self.entries {
+                entry.imported = None;
+            }
+            self.import_order.clone()
+        } else {
+            vec![module_name]
+        };
+        for module in modules {
+            let mut symbols: Vec<(String, Symbol)> = self.imports[&module].iter()
+                .map(|(name, symbol)| (name.clone(), symbol.clone()))
+                .collect();
+            symbols.sort_by(|a, b| a.0.cmp(&b.0));
+            for (name, symbol) in symbols {
+                let id = self.intern(&name);
+                self.entries[id.0 as usize].imported.get_or_insert(symbol);
+            }
+        }
     }
     
     /// Check if a variable has been initialized
@@ -293,20 +437,9 @@ impl SymbolTable {
     
     /// Mark a variable as initialized
     pub fn mark_variable_initialized(&mut self, name: &str) -> Result<(), SemanticError> {
-        // Search through scopes to find and mark the variable
-        let mut current = self.current_scope;
-        
-        loop {
-            if let Some(symbol) = self.scopes[current].symbols.get_mut(name) {
-                symbol.is_initialized = true;
-                return Ok(());
-            }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
-            }
+        if let Some(symbol) = self.binding_mut(name) {
+            symbol.is_initialized = true;
+            return Ok(());
         }
         
         Err(SemanticError::UndefinedSymbol {
@@ -329,32 +462,21 @@ impl SymbolTable {
     
     /// Get all symbols in the current scope
     pub fn current_scope_symbols(&self) -> impl Iterator<Item = &Symbol> {
-        self.current_scope().all_symbols()
+        self.scope_symbols(self.current_scope).into_iter()
     }
     
     /// Get all symbols visible from the current scope
     pub fn visible_symbols(&self) -> Vec<&Symbol> {
         let mut symbols = Vec::new();
-        let mut current = self.current_scope;
         
         // Collect symbols from current scope up to global
-        loop {
-            for symbol in self.scopes[current].all_symbols() {
-                symbols.push(symbol);
-            }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
-            }
+        for depth in (0..=self.current_scope).rev() {
+            symbols.extend(self.scope_symbols(depth));
         }
         
         // Add imported symbols
-        for imported_symbols in self.imports.values() {
-            for symbol in imported_symbols.values() {
-                symbols.push(symbol);
-            }
+        for (_, exported) in self.imports_in_order() {
+            symbols.extend(exported.values());
         }
         
         symbols
@@ -363,8 +485,7 @@ impl SymbolTable {
     /// Check for unused variables in the current scope
     pub fn find_unused_variables(&self) -> Vec<&Symbol> {
         // This is a simple implementation - a more sophisticated one would track usage
-        self.current_scope()
-            .all_symbols()
+        self.current_scope_symbols()
             .filter(|symbol| {
                 symbol.kind == SymbolKind::Variable && !symbol.name.starts_with('_')
             })
@@ -373,70 +494,24 @@ impl SymbolTable {
     
     /// Get scope depth (0 = global, 1 = module, 2 = function, etc.)
     pub fn scope_depth(&self) -> usize {
-        let mut depth = 0;
-        let mut current = self.current_scope;
-        
-        while let Some(parent) = self.scopes[current].parent {
-            depth += 1;
-            current = parent;
-        }
-        
-        depth
+        self.current_scope
     }
     
     /// Check if we're in a specific scope kind
     pub fn in_scope_kind(&self, kind: ScopeKind) -> bool {
-        let mut current = self.current_scope;
-        
-        loop {
-            if self.scopes[current].kind == kind {
-                return true;
-            }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
-            }
-        }
-        
-        false
+        self.find_nearest_scope(kind).is_some()
     }
     
     /// Find the nearest scope of a specific kind
     pub fn find_nearest_scope(&self, kind: ScopeKind) -> Option<usize> {
-        let mut current = self.current_scope;
-        
-        loop {
-            if self.scopes[current].kind == kind {
-                return Some(current);
-            }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
-            }
-        }
-        
-        None
+        self.scopes.iter().rposition(|scope| scope.kind == kind)
     }
     
     /// Mark a variable as moved (ownership transferred)
     pub fn mark_variable_moved(&mut self, name: &str) -> Result<(), SemanticError> {
-        let mut current = self.current_scope;
-        
-        loop {
-            if let Some(symbol) = self.scopes[current].symbols.get_mut(name) {
-                symbol.is_moved = true;
-                return Ok(());
-            }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
-            }
+        if let Some(symbol) = self.binding_mut(name) {
+            symbol.is_moved = true;
+            return Ok(());
         }
         
         Err(SemanticError::UndefinedSymbol {
@@ -447,130 +522,94 @@ impl SymbolTable {
     
     /// Borrow a variable immutably
     pub fn borrow_variable(&mut self, name: &str) -> Result<(), SemanticError> {
-        let mut current = self.current_scope;
-        
-        loop {
-            if let Some(symbol) = self.scopes[current].symbols.get_mut(name) {
-                match &mut symbol.borrow_state {
-                    BorrowState::None => {
-                        symbol.borrow_state = BorrowState::Borrowed(1);
-                        return Ok(());
-                    }
-                    BorrowState::Borrowed(count) => {
-                        *count += 1;
-                        return Ok(());
-                    }
-                    BorrowState::BorrowedMut => {
-                        return Err(SemanticError::InvalidOperation {
-                            operation: "immutable borrow".to_string(),
-                            reason: "variable is already mutably borrowed".to_string(),
-                            location: SourceLocation::unknown(),
-                        });
-                    }
-                }
+        let symbol = self.binding_mut(name).ok_or_else(|| SemanticError::UndefinedSymbol {
+            symbol: name.to_string(),
+            location: SourceLocation::unknown(),
+        })?;
+        
+        match &mut symbol.borrow_state {
+            BorrowState::None => {
+                symbol.borrow_state = BorrowState::Borrowed(1);
+                Ok(())
+            }
+            BorrowState::Borrowed(count) => {
+                *count += 1;
+                Ok(())
             }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
+            BorrowState::BorrowedMut => {
+                Err(SemanticError::InvalidOperation {
+                    operation: "immutable borrow".to_string(),
+                    reason: "variable is already mutably borrowed".to_string(),
+                    location: SourceLocation::unknown(),
+                })
             }
         }
-        
-        Err(SemanticError::UndefinedSymbol {
-            symbol: name.to_string(),
-            location: SourceLocation::unknown(),
-        })
     }
     
     /// Borrow a variable mutably
     pub fn borrow_variable_mut(&mut self, name: &str) -> Result<(), SemanticError> {
-        let mut current = self.current_scope;
-        
-        loop {
-            if let Some(symbol) = self.scopes[current].symbols.get_mut(name) {
-                if !symbol.is_mutable {
-                    return Err(SemanticError::AssignToImmutable {
-                        variable: name.to_string(),
-                        location: SourceLocation::unknown(),
-                    });
-                }
-                
-                match &symbol.borrow_state {
-                    BorrowState::None => {
-                        symbol.borrow_state = BorrowState::BorrowedMut;
-                        return Ok(());
-                    }
-                    BorrowState::Borrowed(_) => {
-                        return Err(SemanticError::InvalidOperation {
-                            operation: "mutable borrow".to_string(),
-                            reason: "variable is already immutably borrowed".to_string(),
-                            location: SourceLocation::unknown(),
-                        });
-                    }
-                    BorrowState::BorrowedMut => {
-                        return Err(SemanticError::InvalidOperation {
-                            operation: "mutable borrow".to_string(),
-                            reason: "variable is already mutably borrowed".to_string(),
-                            location: SourceLocation::unknown(),
-                        });
-                    }
-                }
+        let symbol = self.binding_mut(name).ok_or_else(|| SemanticError::UndefinedSymbol {
+            symbol: name.to_string(),
+            location: SourceLocation::unknown(),
+        })?;
+        
+        if !symbol.is_mutable {
+            return Err(SemanticError::AssignToImmutable {
+                variable: name.to_string(),
+                location: SourceLocation::unknown(),
+            });
+        }
+        
+        match &symbol.borrow_state {
+            BorrowState::None => {
+                symbol.borrow_state = BorrowState::BorrowedMut;
+                Ok(())
+            }
+            BorrowState::Borrowed(_) => {
+                Err(SemanticError::InvalidOperation {
+                    operation: "mutable borrow".to_string(),
+                    reason: "variable is already immutably borrowed".to_string(),
+                    location: SourceLocation::unknown(),
+                })
             }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
+            BorrowState::BorrowedMut => {
+                Err(SemanticError::InvalidOperation {
+                    operation: "mutable borrow".to_string(),
+                    reason: "variable is already mutably borrowed".to_string(),
+                    location: SourceLocation::unknown(),
+                })
             }
         }
-        
-        Err(SemanticError::UndefinedSymbol {
-            symbol: name.to_string(),
-            location: SourceLocation::unknown(),
-        })
     }
     
     /// Release a borrow
     pub fn release_borrow(&mut self, name: &str) -> Result<(), SemanticError> {
-        let mut current = self.current_scope;
-        
-        loop {
-            if let Some(symbol) = self.scopes[current].symbols.get_mut(name) {
-                match &mut symbol.borrow_state {
-                    BorrowState::None => {
-                        return Err(SemanticError::InvalidOperation {
-                            operation: "release borrow".to_string(),
-                            reason: "variable is not borrowed".to_string(),
-                            location: SourceLocation::unknown(),
-                        });
-                    }
-                    BorrowState::Borrowed(count) => {
-                        if *count > 1 {
-                            *count -= 1;
-                        } else {
-                            symbol.borrow_state = BorrowState::None;
-                        }
-                        return Ok(());
-                    }
-                    BorrowState::BorrowedMut => {
-                        symbol.borrow_state = BorrowState::None;
-                        return Ok(());
-                    }
+        let symbol = self.binding_mut(name).ok_or_else(|| SemanticError::UndefinedSymbol {
+            symbol: name.to_string(),
+            location: SourceLocation::unknown(),
+        })?;
+        
+        match &mut symbol.borrow_state {
+            BorrowState::None => {
+                Err(SemanticError::InvalidOperation {
+                    operation: "release borrow".to_string(),
+                    reason: "variable is not borrowed".to_string(),
+                    location: SourceLocation::unknown(),
+                })
+            }
+            BorrowState::Borrowed(count) => {
+                if *count > 1 {
+                    *count -= 1;
+                } else {
+                    symbol.borrow_state = BorrowState::None;
                 }
+                Ok(())
             }
-            
-            if let Some(parent) = self.scopes[current].parent {
-                current = parent;
-            } else {
-                break;
+            BorrowState::BorrowedMut => {
+                symbol.borrow_state = BorrowState::None;
+                Ok(())
             }
         }
-        
-        Err(SemanticError::UndefinedSymbol {
-            symbol: name.to_string(),
-            location: SourceLocation::unknown(),
-        })
     }
 }
 
@@ -606,6 +645,27 @@ mod tests {
         assert_eq!(table.scopes[0].kind, ScopeKind::Global);
     }
     
+    #[test]
+    fn test_snapshot_keeps_only_scope_chain() {
+        let mut table = SymbolTable::new();
+        table.enter_scope(ScopeKind::Module);
+        table.add_symbol(create_test_symbol("first", Type::primitive(PrimitiveType::Integer))).unwrap();
+        table.exit_scope().unwrap();
+
+        table.enter_scope(ScopeKind::Module);
+        table.add_symbol(create_test_symbol("second", Type::primitive(PrimitiveType::Integer))).unwrap();
+
+        let mut snapshot = table.snapshot_current_scope();
+        assert_eq!(snapshot.scopes.len(), 2);
+        assert!(snapshot.lookup_symbol("second").is_some());
+        assert!(snapshot.lookup_symbol("first").is_none());
+
+        snapshot.enter_scope(ScopeKind::Function);
+        snapshot.add_symbol(create_test_symbol("local", Type::primitive(PrimitiveType::Integer))).unwrap();
+        assert!(snapshot.lookup_symbol("second").is_some());
+        assert!(table.lookup_symbol("local").is_none());
+    }
+
     #[test]
     fn test_scope_management() {
         let mut table = SymbolTable::new();
@@ -684,6 +744,77 @@ mod tests {
         assert_eq!(found.symbol_type, Type::primitive(PrimitiveType::Boolean));
     }
     
+    #[test]
+    fn test_exit_scope_restores_shadowed_binding() {
+        let mut table = SymbolTable::new();
+        table.add_symbol(create_test_symbol("x", Type::primitive(PrimitiveType::Integer))).unwrap();
+        
+        table.enter_scope(ScopeKind::Block);
+        table.add_symbol(create_test_symbol("x", Type::primitive(PrimitiveType::Boolean))).unwrap();
+        table.add_symbol(create_test_symbol("y", Type::primitive(PrimitiveType::Float))).unwrap();
+        table.mark_variable_moved("x").unwrap();
+        assert_eq!(table.current_scope_symbols().count(), 2);
+        assert_eq!(table.lookup_in_scope("x", 0).unwrap().symbol_type, Type::primitive(PrimitiveType::Integer));
+        
+        table.exit_scope().unwrap();
+        let x = table.lookup_symbol("x").unwrap();
+        assert_eq!(x.symbol_type, Type::primitive(PrimitiveType::Integer));
+        assert!(!x.is_moved);
+        assert!(table.lookup_symbol("y").is_none());
+        assert_eq!(table.visible_symbols().len(), 1);
+    }
+    
+    #[test]
+    fn test_imports_are_merged_behind_scopes() {
+        let mut table = SymbolTable::new();
+        let exports = |ty: PrimitiveType| -> HashMap<String, Symbol> {
+            ["shared", "only"].iter()
+                .map(|name| (name.to_string(), create_test_symbol(name, Type::primitive(ty))))
+                .collect()
+        };
+        table.add_import("first".to_string(), exports(PrimitiveType::Integer));
+        table.add_import("second".to_string(), exports(PrimitiveType::Float));
+        
+        // The first import wins a conflict, and any scoped binding hides both
+        assert_eq!(table.lookup_symbol("shared").unwrap().symbol_type, Type::primitive(PrimitiveType::Integer));
+        table.enter_scope(ScopeKind::Function);
+        table.add_symbol(create_test_symbol("shared", Type::primitive(PrimitiveType::Boolean))).unwrap();
+        assert_eq!(table.lookup_symbol("shared").unwrap().symbol_type, Type::primitive(PrimitiveType::Boolean));
+        assert!(table.mark_variable_initialized("only").is_err());
+        
+        // Replacing a module's exports rebuilds the index
+        table.add_import("first".to_string(), HashMap::new());
+        let snapshot = table.snapshot_current_scope();
+        assert_eq!(snapshot.lookup_symbol("only").unwrap().symbol_type, Type::primitive(PrimitiveType::Float));
+        assert_eq!(snapshot.lookup_symbol("shared").unwrap().symbol_type, Type::primitive(PrimitiveType::Boolean));
+    }
+    
+    #[test]
+    fn test_layer_copies_shared_bindings_on_write() {
+        let mut table = SymbolTable::new();
+        table.enter_scope(ScopeKind::Module);
+        let mut counter = create_test_symbol("counter", Type::primitive(PrimitiveType::Integer));
+        counter.is_initialized = false;
+        table.add_symbol(counter).unwrap();
+        let base = Arc::new(table);
+        
+        let mut layer = SymbolTable::layered_over(Arc::clone(&base));
+        layer.enter_scope(ScopeKind::Function);
+        layer.add_symbol(create_test_symbol("local", Type::primitive(PrimitiveType::Float))).unwrap();
+        layer.mark_variable_initialized("counter").unwrap();
+        
+        assert!(layer.is_variable_initialized("counter"));
+        assert!(!base.is_variable_initialized("counter"));
+        assert!(base.lookup_symbol("local").is_none());
+        assert_eq!(layer.visible_symbols().len(), 2);
+        
+        layer.exit_scope().unwrap();
+        assert!(layer.lookup_symbol("local").is_none());
+        assert!(layer.is_variable_initialized("counter"));
+        assert!(layer.add_symbol(create_test_symbol("counter", Type::primitive(PrimitiveType::Integer))).is_err());
+        assert!(layer.exit_scope().is_err());
+    }
+    
     #[test]
     fn test_variable_initialization_tracking() {
         let mut table = SymbolTable::new();
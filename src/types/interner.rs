@@ -0,0 +1,404 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Hash-consed type table
+//!
+//! Every structurally distinct [`Type`] is stored once and named by a `Copy`
+//! [`TypeId`]. Child types are themselves `TypeId`s, so two types are equal
+//! exactly when their IDs are equal, and per-type facts (numeric class,
+//! size, compatibility, backend representation) can be cached by ID.
+
+use super::{OwnershipKind, Type, TypeConstraintInfo, TypeVariable};
+use crate::ast::PrimitiveType;
+use std::collections::HashMap;
+use std::sync::RwLock;
+
+/// Handle to an interned type
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub struct TypeId(pub u32);
+
+impl TypeId {
+    #[inline]
+    pub fn index(self) -> usize {
+        self.0 as usize
+    }
+}
+
+/// Structural node of an interned type; children are `TypeId`s
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+pub enum InternedType {
+    Primitive(PrimitiveType),
+    Named { name: String, module: Option<String> },
+    Array { element: TypeId, size: Option<usize> },
+    Map { key: TypeId, value: TypeId },
+    Vector { element: TypeId, lanes: usize },
+    Pointer { target: TypeId, is_mutable: bool },
+    Function { params: Vec<TypeId>, ret: TypeId },
+    Generic { name: String, constraints: Vec<TypeConstraintInfo> },
+    GenericInstance { base_type: String, args: Vec<TypeId>, module: Option<String> },
+    Variable(TypeVariable),
+    Owned { ownership: OwnershipKind, base: TypeId },
+    Error,
+}
+
+/// Facts computed once per interned type
+#[derive(Debug, Clone, Copy, Default)]
+pub struct TypeFlags {
+    pub is_numeric: bool,
+    pub is_integer: bool,
+    pub is_float: bool,
+    pub requires_ownership: bool,
+    pub size_bytes: Option<usize>,
+}
+
+/// Every primitive type, in the order of their fixed `TypeId`s
+const PRIMITIVES: [PrimitiveType; 12] = [
+    PrimitiveType::Integer,
+    PrimitiveType::Integer32,
+    PrimitiveType::Integer64,
+    PrimitiveType::Float,
+    PrimitiveType::Float32,
+    PrimitiveType::Float64,
+    PrimitiveType::String,
+    PrimitiveType::Char,
+    PrimitiveType::Boolean,
+    PrimitiveType::Void,
+    PrimitiveType::SizeT,
+    PrimitiveType::UIntPtrT,
+];
+
+/// Fixed `TypeId` of a primitive type
+fn primitive_id(prim: PrimitiveType) -> TypeId {
+    TypeId(PRIMITIVES.iter().position(|&p| p == prim).unwrap() as u32)
+}
+
+/// Interning table for types
+///
+/// The table is shared between threads: lookups take a read lock and only
+/// new types and new compatibility answers take the write lock. Primitive
+/// types have fixed IDs and need no lock at all.
+#[derive(Debug)]
+pub struct TypeTable {
+    state: RwLock<TableState>,
+}
+
+#[derive(Debug, Default)]
+struct TableState {
+    nodes: Vec<InternedType>,
+    flags: Vec<TypeFlags>,
+    lookup: HashMap<InternedType, TypeId>,
+    compatible_cache: HashMap<(TypeId, TypeId), bool>,
+}
+
+impl TypeTable {
+    pub fn new() -> Self {
+        let mut state = TableState::default();
+        for prim in PRIMITIVES {
+            state.insert(InternedType::Primitive(prim));
+        }
+        Self { state: RwLock::new(state) }
+    }
+
+    /// Number of distinct types interned so far, counting every primitive
+    pub fn len(&self) -> usize {
+        self.read().nodes.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    fn read(&self) -> std::sync::RwLockReadGuard<'_, TableState> {
+        self.state.read().unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+
+    fn write(&self) -> std::sync::RwLockWriteGuard<'_, TableState> {
+        self.state.write().unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+
+    /// Intern a type tree, returning its canonical ID
+    pub fn intern(&self, ty: &Type) -> TypeId {
+        let node = match ty {
+            Type::Primitive(prim) => return primitive_id(*prim),
+            Type::Named { name, module } => InternedType::Named { name: name.clone(), module: module.clone() },
+            Type::Array { element_type, size } => InternedType::Array {
+                element: self.intern(element_type),
+                size: *size,
+            },
+            Type::Map { key_type, value_type } => InternedType::Map {
+                key: self.intern(key_type),
+                value: self.intern(value_type),
+            },
+            Type::Vector { element_type, lanes } => InternedType::Vector {
+                element: self.intern(element_type),
+                lanes: *lanes,
+            },
+            Type::Pointer { target_type, is_mutable } => InternedType::Pointer {
+                target: self.intern(target_type),
+                is_mutable: *is_mutable,
+            },
+            Type::Function { parameter_types, return_type } => InternedType::Function {
+                params: parameter_types.iter().map(|p| self.intern(p)).collect(),
+                ret: self.intern(return_type),
+            },
+            Type::Generic { name, constraints } => InternedType::Generic {
+                name: name.clone(),
+                constraints: constraints.clone(),
+            },
+            Type::GenericInstance { base_type, type_arguments, module } => InternedType::GenericInstance {
+                base_type: base_type.clone(),
+                args: type_arguments.iter().map(|a| self.intern(a)).collect(),
+                module: module.clone(),
+            },
+            Type::Variable(var) => InternedType::Variable(var.clone()),
+            Type::Owned { ownership, base_type } => InternedType::Owned {
+                ownership: *ownership,
+                base: self.intern(base_type),
+            },
+            Type::Error => InternedType::Error,
+        };
+        self.intern_node(node)
+    }
+
+    /// Intern a node whose children are already interned
+    pub fn intern_node(&self, node: InternedType) -> TypeId {
+        if let InternedType::Primitive(prim) = node {
+            return primitive_id(prim);
+        }
+        if let Some(&id) = self.read().lookup.get(&node) {
+            return id;
+        }
+        self.write().insert(node)
+    }
+
+    pub fn primitive(&self, prim: PrimitiveType) -> TypeId {
+        primitive_id(prim)
+    }
+
+    /// Structural node for an ID
+    pub fn get(&self, id: TypeId) -> InternedType {
+        match PRIMITIVES.get(id.index()) {
+            Some(&prim) => InternedType::Primitive(prim),
+            None => self.read().nodes[id.index()].clone(),
+        }
+    }
+
+    /// Cached facts for an ID
+    pub fn flags(&self, id: TypeId) -> TypeFlags {
+        self.read().flags[id.index()]
+    }
+
+    /// Rebuild the owned `Type` tree for an ID
+    pub fn to_type(&self, id: TypeId) -> Type {
+        match self.get(id) {
+            InternedType::Primitive(prim) => Type::Primitive(prim),
+            InternedType::Named { name, module } => Type::named(name, module),
+            InternedType::Array { element, size } => Type::array(self.to_type(element), size),
+            InternedType::Map { key, value } => Type::map(self.to_type(key), self.to_type(value)),
+            InternedType::Vector { element, lanes } => Type::vector(self.to_type(element), lanes),
+            InternedType::Pointer { target, is_mutable } => Type::pointer(self.to_type(target), is_mutable),
+            InternedType::Function { params, ret } => Type::function(
+                params.iter().map(|p| self.to_type(*p)).collect(),
+                self.to_type(ret),
+            ),
+            InternedType::Generic { name, constraints } => Type::generic(name, constraints),
+            InternedType::GenericInstance { base_type, args, module } => Type::generic_instance(
+                base_type,
+                args.iter().map(|a| self.to_type(*a)).collect(),
+                module,
+            ),
+            InternedType::Variable(var) => Type::Variable(var),
+            InternedType::Owned { ownership, base } => Type::Owned {
+                ownership,
+                base_type: Box::new(self.to_type(base)),
+            },
+            InternedType::Error => Type::Error,
+        }
+    }
+
+    /// Whether a value of type `b` may be used where `a` is expected
+    ///
+    /// Answers are memoized per ID pair; primitive pairs are decided
+    /// without touching the table.
+    pub fn compatible(&self, a: TypeId, b: TypeId) -> bool {
+        if a == b {
+            return true;
+        }
+        if let (Some(&p1), Some(&p2)) = (PRIMITIVES.get(a.index()), PRIMITIVES.get(b.index())) {
+            return primitives_compatible(p1, p2);
+        }
+        if let Some(&cached) = self.read().compatible_cache.get(&(a, b)) {
+            return cached;
+        }
+        let result = self.compute_compatible(a, b);
+        self.write().compatible_cache.insert((a, b), result);
+        result
+    }
+
+    fn compute_compatible(&self, a: TypeId, b: TypeId) -> bool {
+        match (self.get(a), self.get(b)) {
+            (InternedType::Primitive(p1), InternedType::Primitive(p2)) => primitives_compatible(p1, p2),
+            (
+                InternedType::Pointer { target: t1, is_mutable: false },
+                InternedType::Pointer { target: t2, .. },
+            ) if t1 == t2 => true,
+            (
+                InternedType::Array { element: e1, size: s1 },
+                InternedType::Array { element: e2, size: s2 },
+            ) if e1 == e2 && s1.is_some() != s2.is_some() => true,
+            (
+                InternedType::Owned { ownership: o1, base: b1 },
+                InternedType::Owned { ownership: o2, base: b2 },
+            ) => {
+                use OwnershipKind::*;
+                let allowed = o1 == o2
+                    || matches!(
+                        (o1, o2),
+                        (MutableBorrow, Borrowed) | (Owned, Borrowed) | (Owned, MutableBorrow) | (Shared, Borrowed)
+                    );
+                allowed && self.compatible(b1, b2)
+            }
+            (InternedType::Owned { base, .. }, _) => self.compatible(base, b),
+            (_, InternedType::Owned { base, .. }) => self.compatible(a, base),
+            _ => false,
+        }
+    }
+}
+
+impl Default for TypeTable {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Numeric promotions between distinct primitive types
+fn primitives_compatible(p1: PrimitiveType, p2: PrimitiveType) -> bool {
+    use PrimitiveType as P;
+    p1 == p2 || matches!(
+        (p1, p2),
+        (P::Integer, P::Float)
+            | (P::Float, P::Integer)
+            | (P::Integer32, P::Integer64)
+            | (P::Integer, P::Integer32)
+            | (P::Integer, P::Integer64)
+            | (P::Float32, P::Float64)
+            | (P::Float, P::Float32)
+            | (P::Float, P::Float64)
+    )
+}
+
+impl TableState {
+    /// Add a node the table does not hold yet, or return its existing ID
+    fn insert(&mut self, node: InternedType) -> TypeId {
+        if let Some(&id) = self.lookup.get(&node) {
+            return id;
+        }
+        let id = TypeId(self.nodes.len() as u32);
+        let flags = self.compute_flags(&node);
+        self.nodes.push(node.clone());
+        self.flags.push(flags);
+        self.lookup.insert(node, id);
+        id
+    }
+
+    fn compute_flags(&self, node: &InternedType) -> TypeFlags {
+        match node {
+            InternedType::Primitive(prim) => {
+                let ty = Type::Primitive(*prim);
+                TypeFlags {
+                    is_numeric: ty.is_numeric(),
+                    is_integer: ty.is_integer(),
+                    is_float: ty.is_float(),
+                    requires_ownership: ty.requires_ownership(),
+                    size_bytes: ty.size_bytes(),
+                }
+            }
+            InternedType::Array { element, size } => TypeFlags {
+                requires_ownership: true,
+                size_bytes: size.and_then(|n| self.flags[element.index()].size_bytes.map(|e| e * n)),
+                ..TypeFlags::default()
+            },
+            InternedType::Vector { element, lanes } => TypeFlags {
+                size_bytes: self.flags[element.index()].size_bytes.map(|e| e * lanes),
+                ..TypeFlags::default()
+            },
+            InternedType::Pointer { .. } => TypeFlags {
+                requires_ownership: true,
+                size_bytes: Some(8), // Assuming 64-bit target
+                ..TypeFlags::default()
+            },
+            InternedType::Map { .. } | InternedType::Named { .. } | InternedType::Owned { .. } => TypeFlags {
+                requires_ownership: true,
+                ..TypeFlags::default()
+            },
+            _ => TypeFlags::default(),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_structural_types_share_ids() {
+        let table = TypeTable::new();
+        let a = table.intern(&Type::array(Type::named("Point".to_string(), None), None));
+        let b = table.intern(&Type::array(Type::named("Point".to_string(), None), None));
+        let c = table.intern(&Type::array(Type::primitive(PrimitiveType::Integer), None));
+
+        assert_eq!(a, b);
+        assert_ne!(a, c);
+        // Point, [Point] and [Integer] beside the primitives
+        assert_eq!(table.len(), PRIMITIVES.len() + 3);
+        assert_eq!(table.to_type(a), Type::array(Type::named("Point".to_string(), None), None));
+    }
+
+    #[test]
+    fn test_flags_are_cached() {
+        let table = TypeTable::new();
+        let int = table.primitive(PrimitiveType::Integer64);
+        let arr = table.intern(&Type::array(Type::primitive(PrimitiveType::Integer64), Some(4)));
+
+        assert!(table.flags(int).is_integer);
+        assert_eq!(table.flags(arr).size_bytes, Some(32));
+        assert!(table.flags(arr).requires_ownership);
+    }
+
+    #[test]
+    fn test_compatibility_rules() {
+        let table = TypeTable::new();
+        let int = table.primitive(PrimitiveType::Integer);
+        let int64 = table.primitive(PrimitiveType::Integer64);
+        let float = table.primitive(PrimitiveType::Float);
+        let string = table.primitive(PrimitiveType::String);
+        let dynamic = table.intern(&Type::array(Type::primitive(PrimitiveType::Integer), None));
+        let sized = table.intern(&Type::array(Type::primitive(PrimitiveType::Integer), Some(3)));
+        let const_ptr = table.intern(&Type::pointer(Type::primitive(PrimitiveType::Char), false));
+        let mut_ptr = table.intern(&Type::pointer(Type::primitive(PrimitiveType::Char), true));
+        let owned = table.intern(&Type::owned(Type::primitive(PrimitiveType::String)));
+        let borrowed = table.intern(&Type::borrowed(Type::primitive(PrimitiveType::String)));
+
+        assert!(table.compatible(int, float) && table.compatible(float, int));
+        assert!(table.compatible(int, int64) && !table.compatible(int64, int));
+        assert!(!table.compatible(int, string));
+        assert!(table.compatible(dynamic, sized) && table.compatible(sized, dynamic));
+        assert!(table.compatible(const_ptr, mut_ptr) && !table.compatible(mut_ptr, const_ptr));
+        assert!(table.compatible(owned, borrowed) && !table.compatible(borrowed, owned));
+        assert!(table.compatible(owned, string) && table.compatible(string, borrowed));
+
+        // Answers for non-primitive pairs are memoized
+        assert!(table.read().compatible_cache.contains_key(&(owned, borrowed)));
+    }
+}
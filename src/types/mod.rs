@@ -20,6 +20,16 @@ use crate::ast::{TypeSpecifier, PrimitiveType, TypeConstraint, TypeConstraintKin
 use crate::error::{SemanticError, SourceLocation};
 use std::collections::HashMap;
 use std::fmt;
+use std::sync::Arc;
+
+pub mod interner;
+pub use interner::{InternedType, TypeFlags, TypeId, TypeTable};
+
+/// Widest SIMD vector the language accepts
+///
+/// Power-of-two widths up to this lower to legal LLVM vectors on every
+/// target; the backend splits them into native registers as needed.
+pub const MAX_VECTOR_LANES: usize = 64;
 
 /// Ownership kind for AetherScript's ownership system
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
@@ -75,6 +85,12 @@ pub enum Type {
         value_type: Box<Type>,
     },
     
+    /// SIMD vector of a fixed number of primitive lanes
+    Vector {
+        element_type: Box<Type>,
+        lanes: usize,
+    },
+    
     /// Pointer types
     Pointer {
         target_type: Box<Type>,
@@ -132,6 +148,37 @@ impl Type {
         }
     }
     
+    /// Create a new SIMD vector type
+    pub fn vector(element_type: Type, lanes: usize) -> Self {
+        Type::Vector {
+            element_type: Box::new(element_type),
+            lanes,
+        }
+    }
+    
+    /// Check whether `lanes` is a portable vector width
+    pub fn is_valid_vector_width(lanes: usize) -> bool {
+        lanes >= 2 && lanes <= MAX_VECTOR_LANES && lanes.is_power_of_two()
+    }
+    
+    /// Check whether this type can be a vector lane
+    pub fn is_vector_element(&self) -> bool {
+        matches!(
+            self,
+            Type::Primitive(PrimitiveType::Integer) |
+            Type::Primitive(PrimitiveType::Float) |
+            Type::Primitive(PrimitiveType::Boolean)
+        )
+    }
+    
+    /// Element type and lane count of a vector type
+    pub fn vector_parts(&self) -> Option<(&Type, usize)> {
+        match self {
+            Type::Vector { element_type, lanes } => Some((element_type, *lanes)),
+            _ => None,
+        }
+    }
+    
     /// Create a new map type
     pub fn map(key_type: Type, value_type: Type) -> Self {
         Type::Map {
@@ -289,6 +336,9 @@ impl Type {
             Type::Array { element_type, size: Some(size) } => {
                 element_type.size_bytes().map(|elem_size| elem_size * size)
             }
+            Type::Vector { element_type, lanes } => {
+                element_type.size_bytes().map(|elem_size| elem_size * lanes)
+            }
             _ => None, // Dynamic size or unknown
         }
     }
@@ -321,7 +371,7 @@ impl Type {
             Type::Map { .. } |
             Type::Named { .. } |
             Type::Pointer { .. } => true,
-            Type::Function { .. } => false, // Functions are not owned
+            Type::Function { .. } | Type::Vector { .. } => false, // Functions and vectors are not owned
             Type::Owned { .. } => true, // Owned types always require ownership tracking
             Type::Error | Type::Variable(_) | Type::Generic { .. } | Type::GenericInstance { .. } => false,
         }
@@ -343,6 +393,9 @@ impl fmt::Display for Type {
             Type::Map { key_type, value_type } => {
                 write!(f, "Map<{}, {}>", key_type, value_type)
             }
+            Type::Vector { element_type, lanes } => {
+                write!(f, "Vector<{}, {}>", element_type, lanes)
+            }
             Type::Pointer { target_type, is_mutable } => {
                 if *is_mutable {
                     write!(f, "*mut {}", target_type)
@@ -398,8 +451,9 @@ pub struct TypeChecker {
     /// Type environment mapping variable names to types
     type_env: HashMap<String, Type>,
     
-    /// Type definitions mapping type names to their definitions
-    type_definitions: HashMap<String, TypeDefinition>,
+    /// Type definitions mapping type names to their definitions, shared
+    /// between clones until one of them adds a definition
+    type_definitions: Arc<HashMap<String, TypeDefinition>>,
     
     /// Current module name for qualified type lookups
     current_module: Option<String>,
@@ -409,6 +463,9 @@ pub struct TypeChecker {
     
     /// Type variable substitutions
     substitutions: HashMap<usize, Type>,
+    
+    /// Hash-consed table backing `TypeId` handles, shared between clones
+    type_table: Arc<TypeTable>,
 }
 
 /// Enum variant information
@@ -461,10 +518,11 @@ impl TypeChecker {
     pub fn new() -> Self {
         let mut checker = Self {
             type_env: HashMap::new(),
-            type_definitions: HashMap::new(),
+            type_definitions: Arc::new(HashMap::new()),
             current_module: None,
             next_type_var_id: 0,
             substitutions: HashMap::new(),
+            type_table: Arc::new(TypeTable::new()),
         };
         
         // Initialize built-in types
@@ -496,7 +554,7 @@ impl TypeChecker {
     /// Add a type definition
     pub fn add_type_definition(&mut self, name: String, definition: TypeDefinition) {
         eprintln!("TypeChecker: Adding type definition '{}'", name);
-        self.type_definitions.insert(name, definition);
+        Arc::make_mut(&mut self.type_definitions).insert(name, definition);
         eprintln!("TypeChecker: Now have {} type definitions", self.type_definitions.len());
     }
     
@@ -551,7 +609,7 @@ impl TypeChecker {
             TypeSpecifier::Named { name, source_location } => {
                 // Check if this is a known type
                 eprintln!("TypeChecker: Looking for type '{}', have {} types", name.name, self.type_definitions.len());
-                for (key, _) in &self.type_definitions {
+                for key in self.type_definitions.keys() {
                     eprintln!("  - Type: '{}'", key);
                 }
                 if self.type_definitions.contains_key(&name.name) {
@@ -606,6 +664,26 @@ impl TypeChecker {
                 let value = self.ast_type_to_type(value_type)?;
                 Ok(Type::map(key, value))
             }
+            TypeSpecifier::Vector { element_type, lanes, source_location } => {
+                let element = self.ast_type_to_type(element_type)?;
+                let valid_element = element.is_vector_element();
+                let vector = Type::vector(element, *lanes as usize);
+                if !valid_element {
+                    return Err(SemanticError::InvalidType {
+                        type_name: vector.to_string(),
+                        reason: "vector lanes must be INTEGER, FLOAT or BOOLEAN".to_string(),
+                        location: source_location.clone(),
+                    });
+                }
+                if !Type::is_valid_vector_width(*lanes as usize) {
+                    return Err(SemanticError::InvalidType {
+                        type_name: vector.to_string(),
+                        reason: format!("lane count must be a power of two from 2 to {}", MAX_VECTOR_LANES),
+                        location: source_location.clone(),
+                    });
+                }
+                Ok(vector)
+            }
             TypeSpecifier::Pointer { target_type, is_mutable, .. } => {
                 let target = self.ast_type_to_type(target_type)?;
                 Ok(Type::pointer(target, *is_mutable))
@@ -696,6 +774,31 @@ impl TypeChecker {
         }
     }
     
+    /// Intern a type, returning its canonical `TypeId`
+    pub fn intern_type(&self, ty: &Type) -> TypeId {
+        self.type_table.intern(ty)
+    }
+    
+    /// Rebuild the type tree behind a `TypeId`
+    pub fn resolve_type_id(&self, id: TypeId) -> Type {
+        self.type_table.to_type(id)
+    }
+    
+    /// Cached facts (numeric class, size, ownership) for a `TypeId`
+    pub fn type_flags(&self, id: TypeId) -> TypeFlags {
+        self.type_table.flags(id)
+    }
+    
+    /// Memoized compatibility check over interned types
+    pub fn type_ids_compatible(&self, type1: TypeId, type2: TypeId) -> bool {
+        self.type_table.compatible(type1, type2)
+    }
+    
+    /// The interning table, shared by every clone of this checker
+    pub fn type_table(&self) -> &Arc<TypeTable> {
+        &self.type_table
+    }
+    
     /// Generate a fresh type variable
     pub fn fresh_type_var(&mut self) -> Type {
         let id = self.next_type_var_id;
@@ -720,6 +823,9 @@ impl TypeChecker {
             (Type::Array { element_type: e1, size: s1 }, Type::Array { element_type: e2, size: s2 }) => {
                 s1 == s2 && self.are_types_equal(e1, e2)
             }
+            (Type::Vector { element_type: e1, lanes: l1 }, Type::Vector { element_type: e2, lanes: l2 }) => {
+                l1 == l2 && self.are_types_equal(e1, e2)
+            }
             (Type::Function { parameter_types: p1, return_type: r1 }, Type::Function { parameter_types: p2, return_type: r2 }) => {
                 if p1.len() != p2.len() {
                     return false;
@@ -751,7 +857,7 @@ impl TypeChecker {
     
     /// Find an enum type by variant name
     pub fn find_enum_type_by_variant(&self, variant_name: &str, _module: &str) -> Option<EnumTypeInfo> {
-        for (type_name, definition) in &self.type_definitions {
+        for (type_name, definition) in self.type_definitions.iter() {
             if let TypeDefinition::Enum { variants, source_location } = definition {
                 if variants.iter().any(|v| v.name == variant_name) {
                     return Some(EnumTypeInfo {
@@ -199,6 +199,12 @@ impl crate::verification::contracts::SmtSolverInterface for Z3SmtSolver {
                     Ok(crate::verification::solver::CheckResult::Failed(_)) => {
                         Ok(crate::verification::contracts::SatResult::Sat)
                     }
+                    Ok(crate::verification::solver::CheckResult::Timeout) => {
+                        Ok(crate::verification::contracts::SatResult::Timeout)
+                    }
+                    Ok(crate::verification::solver::CheckResult::Unknown) => {
+                        Ok(crate::verification::contracts::SatResult::Unknown)
+                    }
                     Err(e) => Err(e),
                 }
             }
@@ -754,13 +754,79 @@ impl AggregateOp {
     }
 }
 
-/// Parse contracts from AST annotations (original version)
-pub fn parse_contracts(_function: &ast::Function) -> Option<FunctionContract> {
-    // In a real implementation, we would parse contract annotations
-    // from the AST (e.g., from specially formatted comments or attributes)
+/// Parse the preconditions and postconditions of `function`
+///
+/// Conditions are named by position, `1`, `2`, ..., like the runtime checks
+/// lowered for them. An assertion with no contract expression is left out,
+/// so its check is never removed.
+pub fn parse_contracts(function: &ast::Function) -> Option<FunctionContract> {
+    let metadata = &function.metadata;
+    let mut contract = FunctionContract::new(function.name.name.clone());
+    for (index, assertion) in metadata.preconditions.iter().enumerate() {
+        if let Some(expression) = contract_expression(&assertion.condition, false) {
+            contract.add_precondition((index + 1).to_string(), expression, assertion.source_location.clone());
+        }
+    }
+    for (index, assertion) in metadata.postconditions.iter().enumerate() {
+        if let Some(expression) = contract_expression(&assertion.condition, true) {
+            contract.add_postcondition((index + 1).to_string(), expression, assertion.source_location.clone());
+        }
+    }
     
-    // For now, return None as contracts aren't yet part of the AST
-    None
+    if contract.preconditions.is_empty() && contract.postconditions.is_empty() {
+        None
+    } else {
+        Some(contract)
+    }
+}
+
+/// The contract form of an integer or boolean AST expression
+///
+/// In a postcondition the variable `result` is the return value.
+fn contract_expression(expression: &ast::Expression, postcondition: bool) -> Option<Expression> {
+    let binary = |op: BinaryOp, left: &ast::Expression, right: &ast::Expression| -> Option<Expression> {
+        Some(Expression::BinaryOp {
+            op,
+            left: Box::new(contract_expression(left, postcondition)?),
+            right: Box::new(contract_expression(right, postcondition)?),
+        })
+    };
+    let unary = |op: UnaryOp, operand: &ast::Expression| -> Option<Expression> {
+        Some(Expression::UnaryOp { op, operand: Box::new(contract_expression(operand, postcondition)?) })
+    };
+    let chain = |op: BinaryOp, operands: &[ast::Expression]| -> Option<Expression> {
+        let mut operands = operands.iter().map(|operand| contract_expression(operand, postcondition));
+        let first = operands.next()??;
+        operands.try_fold(first, |left, right| Some(Expression::BinaryOp {
+            op,
+            left: Box::new(left),
+            right: Box::new(right?),
+        }))
+    };
+    
+    match expression {
+        ast::Expression::IntegerLiteral { value, .. } => Some(Expression::Constant(ConstantValue::Integer(*value))),
+        ast::Expression::BooleanLiteral { value, .. } => Some(Expression::Constant(ConstantValue::Boolean(*value))),
+        ast::Expression::NullLiteral { .. } => Some(Expression::Constant(ConstantValue::Null)),
+        ast::Expression::Variable { name, .. } if postcondition && name.name == "result" => Some(Expression::Result),
+        ast::Expression::Variable { name, .. } => Some(Expression::Variable(name.name.clone())),
+        ast::Expression::Add { left, right, .. } => binary(BinaryOp::Add, left, right),
+        ast::Expression::Subtract { left, right, .. } => binary(BinaryOp::Sub, left, right),
+        ast::Expression::Multiply { left, right, .. } => binary(BinaryOp::Mul, left, right),
+        ast::Expression::IntegerDivide { left, right, .. } => binary(BinaryOp::Div, left, right),
+        ast::Expression::Modulo { left, right, .. } => binary(BinaryOp::Mod, left, right),
+        ast::Expression::Negate { operand, .. } => unary(UnaryOp::Neg, operand),
+        ast::Expression::Equals { left, right, .. } => binary(BinaryOp::Eq, left, right),
+        ast::Expression::NotEquals { left, right, .. } => binary(BinaryOp::Ne, left, right),
+        ast::Expression::LessThan { left, right, .. } => binary(BinaryOp::Lt, left, right),
+        ast::Expression::LessThanOrEqual { left, right, .. } => binary(BinaryOp::Le, left, right),
+        ast::Expression::GreaterThan { left, right, .. } => binary(BinaryOp::Gt, left, right),
+        ast::Expression::GreaterThanOrEqual { left, right, .. } => binary(BinaryOp::Ge, left, right),
+        ast::Expression::LogicalAnd { operands, .. } => chain(BinaryOp::And, operands),
+        ast::Expression::LogicalOr { operands, .. } => chain(BinaryOp::Or, operands),
+        ast::Expression::LogicalNot { operand, .. } => unary(UnaryOp::Not, operand),
+        _ => None,
+    }
 }
 
 /// Parse enhanced LLM-first contracts from AST
@@ -0,0 +1,296 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Facts established by verification
+//!
+//! A contract condition the solver proved needs no runtime check, and the
+//! optimizer may rely on it. Proven preconditions hold on entry and proven
+//! loop invariants at their loop header; the simple shapes among them are
+//! turned into value ranges, non-null facts and length bounds.
+
+use super::contracts::{BinaryOp, ConstantValue, EnhancedCondition, Expression, FunctionContract};
+use super::invariants::LoopInvariant;
+use super::VerificationResult;
+use crate::mir::BasicBlockId;
+use std::collections::{HashMap, HashSet};
+
+/// A property of one variable that holds wherever the fact applies
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum Fact {
+    /// The variable lies in `[min, max]`; a missing end is unbounded
+    Range { variable: String, min: Option<i64>, max: Option<i64> },
+    
+    /// The variable is never null
+    NonNull { variable: String },
+    
+    /// The variable is at most the length of `array`
+    WithinLength { variable: String, array: String },
+}
+
+/// Proven conditions of one function and the facts drawn from them
+#[derive(Debug, Clone, Default)]
+pub struct ProvenFacts {
+    /// Names of the proven conditions, e.g. `precondition_positive_x`
+    proven: HashSet<String>,
+    
+    /// Facts holding on function entry
+    entry: Vec<Fact>,
+    
+    /// Facts holding at each loop header
+    loops: HashMap<BasicBlockId, Vec<Fact>>,
+}
+
+impl ProvenFacts {
+    /// Collect the conditions `result` proved for `contract` and `loop_invariants`
+    pub fn from_result(
+        result: &VerificationResult,
+        contract: Option<&FunctionContract>,
+        loop_invariants: &[LoopInvariant],
+    ) -> Self {
+        // A condition checked at several points is proven only if every check was
+        let unproven: HashSet<&str> = result.conditions.iter()
+            .filter(|condition| !condition.verified)
+            .map(|condition| condition_name(&condition.name))
+            .collect();
+        let mut facts = Self::default();
+        facts.proven = result.conditions.iter()
+            .map(|condition| condition_name(&condition.name))
+            .filter(|name| !unproven.contains(name))
+            .map(str::to_string)
+            .collect();
+        
+        if let Some(contract) = contract {
+            for precondition in &contract.preconditions {
+                if facts.is_proven(&format!("precondition_{}", precondition.name)) {
+                    extract_facts(&precondition.expression, &mut facts.entry);
+                }
+            }
+        }
+        for invariant in loop_invariants {
+            for condition in &invariant.conditions {
+                if facts.is_proven(&format!("loop_invariant_{}", condition.name)) {
+                    extract_facts(&condition.expression, facts.loops.entry(invariant.loop_header).or_default());
+                }
+            }
+        }
+        
+        facts
+    }
+    
+    /// Whether the condition called `name` was proven
+    pub fn is_proven(&self, name: &str) -> bool {
+        self.proven.contains(name)
+    }
+    
+    /// Number of proven conditions
+    pub fn proven_count(&self) -> usize {
+        self.proven.len()
+    }
+    
+    /// Facts holding on function entry
+    pub fn entry_facts(&self) -> &[Fact] {
+        &self.entry
+    }
+    
+    /// Facts holding at the header of the loop starting at `header`
+    pub fn loop_facts(&self, header: BasicBlockId) -> &[Fact] {
+        self.loops.get(&header).map(Vec::as_slice).unwrap_or(&[])
+    }
+    
+    /// Follow the function's blocks to new IDs; facts of a header that
+    /// `remap` drops are forgotten
+    pub fn remap_loop_headers(&mut self, remap: impl Fn(BasicBlockId) -> Option<BasicBlockId>) {
+        self.loops = std::mem::take(&mut self.loops).into_iter()
+            .filter_map(|(header, facts)| Some((remap(header)?, facts)))
+            .collect();
+    }
+    
+    /// Record a precondition proven to hold on entry, as when every call
+    /// site meets it
+    pub fn add_proven_precondition(&mut self, precondition: &EnhancedCondition) {
+        if self.proven.insert(format!("precondition_{}", precondition.name)) {
+            extract_facts(&precondition.expression, &mut self.entry);
+        }
+    }
+    
+    /// Record a proven condition directly
+    pub fn mark_proven(&mut self, name: impl Into<String>) {
+        self.proven.insert(name.into());
+    }
+    
+    /// Record a fact holding on function entry
+    pub fn add_entry_fact(&mut self, fact: Fact) {
+        self.entry.push(fact);
+    }
+    
+    /// The tightest proven range of `variable` at `header`, or on entry
+    pub fn range_of(&self, variable: &str, header: Option<BasicBlockId>) -> (Option<i64>, Option<i64>) {
+        let scoped = header.map(|header| self.loop_facts(header)).unwrap_or(&[]);
+        let mut range: (Option<i64>, Option<i64>) = (None, None);
+        for fact in self.entry.iter().chain(scoped) {
+            if let Fact::Range { variable: name, min, max } = fact {
+                if name == variable {
+                    range.0 = range.0.max(*min);
+                    range.1 = match (range.1, *max) {
+                        (Some(current), Some(new)) => Some(current.min(new)),
+                        (current, new) => current.or(new),
+                    };
+                }
+            }
+        }
+        range
+    }
+    
+    /// Whether `variable` is proven at most the length of `array` at `header`, or on entry
+    pub fn within_length(&self, variable: &str, array: &str, header: Option<BasicBlockId>) -> bool {
+        let scoped = header.map(|header| self.loop_facts(header)).unwrap_or(&[]);
+        self.entry.iter().chain(scoped).any(|fact| matches!(
+            fact,
+            Fact::WithinLength { variable: name, array: bound } if name == variable && bound == array
+        ))
+    }
+}
+
+/// A condition name without the `(Kind)` suffix the VC generator adds
+fn condition_name(name: &str) -> &str {
+    name.rsplit_once(" (").map_or(name, |(base, _)| base)
+}
+
+/// Push the facts `expression` states about single variables
+///
+/// Conjunctions are split; anything else that is not a comparison of a
+/// variable against a constant, `null` or an array length is ignored.
+fn extract_facts(expression: &Expression, facts: &mut Vec<Fact>) {
+    let (op, left, right) = match expression {
+        Expression::BinaryOp { op: BinaryOp::And, left, right } => {
+            extract_facts(left, facts);
+            extract_facts(right, facts);
+            return;
+        }
+        Expression::BinaryOp { op, left, right } => (*op, left.as_ref(), right.as_ref()),
+        _ => return,
+    };
+    
+    // Put the variable on the left
+    let (op, variable, other) = match (left, right) {
+        (Expression::Variable(variable), other) => (op, variable, other),
+        (other, Expression::Variable(variable)) => match mirror(op) {
+            Some(op) => (op, variable, other),
+            None => return,
+        },
+        _ => return,
+    };
+    
+    let fact = match (op, other) {
+        (BinaryOp::Ne, Expression::Constant(ConstantValue::Null)) => Fact::NonNull { variable: variable.clone() },
+        (BinaryOp::Lt | BinaryOp::Le, Expression::Length(array)) => match array.as_ref() {
+            Expression::Variable(array) => Fact::WithinLength { variable: variable.clone(), array: array.clone() },
+            _ => return,
+        },
+        (op, Expression::Constant(ConstantValue::Integer(value))) => {
+            let value = *value;
+            let (min, max) = match op {
+                BinaryOp::Eq => (Some(value), Some(value)),
+                BinaryOp::Ge => (Some(value), None),
+                BinaryOp::Gt => (value.checked_add(1), None),
+                BinaryOp::Le => (None, Some(value)),
+                BinaryOp::Lt => (None, value.checked_sub(1)),
+                _ => return,
+            };
+            if min.is_none() && max.is_none() {
+                return;
+            }
+            Fact::Range { variable: variable.clone(), min, max }
+        }
+        _ => return,
+    };
+    facts.push(fact);
+}
+
+/// The comparison with its operands swapped
+fn mirror(op: BinaryOp) -> Option<BinaryOp> {
+    match op {
+        BinaryOp::Eq => Some(BinaryOp::Eq),
+        BinaryOp::Ne => Some(BinaryOp::Ne),
+        BinaryOp::Lt => Some(BinaryOp::Gt),
+        BinaryOp::Le => Some(BinaryOp::Ge),
+        BinaryOp::Gt => Some(BinaryOp::Lt),
+        BinaryOp::Ge => Some(BinaryOp::Le),
+        _ => None,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use super::super::ConditionResult;
+    use crate::error::SourceLocation;
+    
+    fn compare(op: BinaryOp, left: Expression, right: Expression) -> Expression {
+        Expression::BinaryOp { op, left: Box::new(left), right: Box::new(right) }
+    }
+    
+    fn var(name: &str) -> Expression {
+        Expression::Variable(name.to_string())
+    }
+    
+    fn condition(name: &str, verified: bool) -> ConditionResult {
+        ConditionResult {
+            name: name.to_string(),
+            condition: String::new(),
+            verified,
+            location: SourceLocation::unknown(),
+            verification_time_ms: 0,
+        }
+    }
+    
+    #[test]
+    fn test_only_proven_conditions_become_facts() {
+        let mut contract = FunctionContract::new("scan".to_string());
+        contract.add_precondition(
+            "in_bounds".to_string(),
+            compare(
+                BinaryOp::And,
+                compare(BinaryOp::Le, Expression::Constant(ConstantValue::Integer(0)), var("n")),
+                compare(BinaryOp::Le, var("n"), Expression::Length(Box::new(var("data")))),
+            ),
+            SourceLocation::unknown(),
+        );
+        contract.add_precondition(
+            "non_null".to_string(),
+            compare(BinaryOp::Ne, var("data"), Expression::Constant(ConstantValue::Null)),
+            SourceLocation::unknown(),
+        );
+        let result = VerificationResult {
+            name: "scan".to_string(),
+            verified: false,
+            conditions: vec![
+                condition("precondition_in_bounds (Precondition)", true),
+                condition("precondition_non_null (Precondition)", false),
+                condition("postcondition_positive (Postcondition)", true),
+                condition("postcondition_positive (Postcondition)", false),
+            ],
+            counterexamples: Vec::new(),
+        };
+        
+        let facts = ProvenFacts::from_result(&result, Some(&contract), &[]);
+        assert!(facts.is_proven("precondition_in_bounds"));
+        assert!(!facts.is_proven("precondition_non_null"));
+        assert!(!facts.is_proven("postcondition_positive"));
+        assert_eq!(facts.proven_count(), 1);
+        assert_eq!(facts.range_of("n", None), (Some(0), None));
+        assert!(facts.within_length("n", "data", None));
+        assert!(!facts.entry_facts().contains(&Fact::NonNull { variable: "data".to_string() }));
+    }
+}
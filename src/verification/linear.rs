@@ -0,0 +1,434 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Decision procedure for simple linear integer conditions
+//!
+//! Most verification conditions are range facts: bounds checks,
+//! non-negativity, and comparisons between a few integer variables. A
+//! condition is valid when its assumptions together with its negated goal are
+//! unsatisfiable. That conjunction is put in disjunctive normal form, and each
+//! disjunct's constraints of the form `±x ± y <= c` are checked for a negative
+//! cycle in an octagon constraint graph. A satisfiable disjunct yields a
+//! counterexample, which is checked against every constraint before it is
+//! reported. Anything else is left undecided for a full SMT solver.
+
+use super::solver::Formula;
+use std::collections::{BTreeMap, HashMap};
+
+/// Most disjuncts explored before giving up
+const MAX_DISJUNCTS: usize = 256;
+
+/// Verdict on a condition
+#[derive(Debug, Clone, PartialEq)]
+pub enum Decision {
+    /// The condition holds for every assignment
+    Valid,
+    
+    /// The condition fails for these integer and boolean values
+    Invalid(HashMap<String, i64>, HashMap<String, bool>),
+    
+    /// The condition is outside what this procedure decides
+    Unknown,
+}
+
+/// Decide whether `goal` holds whenever every formula in `assumptions` does
+pub fn decide(assumptions: &[Formula], goal: &Formula) -> Decision {
+    let mut disjuncts = vec![Vec::new()];
+    for assumption in assumptions {
+        disjuncts = match dnf(assumption, true).and_then(|other| product(disjuncts, other)) {
+            Some(disjuncts) => disjuncts,
+            None => return Decision::Unknown,
+        };
+    }
+    let disjuncts = match dnf(goal, false).and_then(|negated| product(disjuncts, negated)) {
+        Some(disjuncts) => disjuncts,
+        None => return Decision::Unknown,
+    };
+    
+    let mut undecided = false;
+    for conjunct in &disjuncts {
+        match satisfy(conjunct) {
+            Outcome::Unsatisfiable => {}
+            Outcome::Satisfiable(integers, booleans) => return Decision::Invalid(integers, booleans),
+            Outcome::Unknown => undecided = true,
+        }
+    }
+    if undecided {
+        Decision::Unknown
+    } else {
+        Decision::Valid
+    }
+}
+
+/// `sum(coefficient * variable) + constant`
+#[derive(Debug, Clone, PartialEq)]
+struct Linear {
+    terms: BTreeMap<String, i64>,
+    constant: i64,
+}
+
+impl Linear {
+    fn constant(value: i64) -> Self {
+        Self { terms: BTreeMap::new(), constant: value }
+    }
+    
+    fn variable(name: &str) -> Self {
+        Self { terms: BTreeMap::from([(name.to_string(), 1)]), constant: 0 }
+    }
+    
+    fn add(mut self, other: &Linear) -> Option<Self> {
+        for (name, coefficient) in &other.terms {
+            let sum = self.terms.get(name).copied().unwrap_or(0).checked_add(*coefficient)?;
+            if sum == 0 {
+                self.terms.remove(name);
+            } else {
+                self.terms.insert(name.clone(), sum);
+            }
+        }
+        self.constant = self.constant.checked_add(other.constant)?;
+        Some(self)
+    }
+    
+    fn scale(mut self, factor: i64) -> Option<Self> {
+        if factor == 0 {
+            return Some(Self::constant(0));
+        }
+        for coefficient in self.terms.values_mut() {
+            *coefficient = coefficient.checked_mul(factor)?;
+        }
+        self.constant = self.constant.checked_mul(factor)?;
+        Some(self)
+    }
+    
+    fn sub(self, other: &Linear) -> Option<Self> {
+        self.add(&other.clone().scale(-1)?)
+    }
+    
+    fn evaluate(&self, values: &HashMap<String, i64>) -> Option<i64> {
+        self.terms.iter().try_fold(self.constant, |sum, (name, coefficient)| {
+            sum.checked_add(coefficient.checked_mul(values.get(name).copied().unwrap_or(0))?)
+        })
+    }
+}
+
+/// One literal of a disjunct
+#[derive(Debug, Clone, PartialEq)]
+enum Literal {
+    /// `linear <= 0`
+    AtMostZero(Linear),
+    
+    /// A boolean variable and the value it must take
+    Boolean(String, bool),
+    
+    /// A subformula outside the theory
+    Opaque,
+}
+
+type Disjuncts = Vec<Vec<Literal>>;
+
+/// Disjunctive normal form of `formula`, or of its negation when `positive` is false
+fn dnf(formula: &Formula, positive: bool) -> Option<Disjuncts> {
+    match formula {
+        Formula::Bool(value) => Some(if *value == positive { vec![Vec::new()] } else { Vec::new() }),
+        Formula::Var(name) => Some(vec![vec![Literal::Boolean(name.clone(), positive)]]),
+        Formula::Not(inner) => dnf(inner, !positive),
+        Formula::And(parts) if positive => parts.iter().try_fold(vec![Vec::new()], |acc, part| product(acc, dnf(part, true)?)),
+        Formula::Or(parts) if !positive => parts.iter().try_fold(vec![Vec::new()], |acc, part| product(acc, dnf(part, false)?)),
+        Formula::And(parts) | Formula::Or(parts) => parts.iter().try_fold(Vec::new(), |acc, part| union(acc, dnf(part, positive)?)),
+        Formula::Implies(premise, conclusion) => {
+            if positive {
+                union(dnf(premise, false)?, dnf(conclusion, true)?)
+            } else {
+                product(dnf(premise, true)?, dnf(conclusion, false)?)
+            }
+        }
+        Formula::Ite(condition, then, otherwise) => union(
+            product(dnf(condition, true)?, dnf(then, positive)?)?,
+            product(dnf(condition, false)?, dnf(otherwise, positive)?)?,
+        ),
+        Formula::Eq(left, right) | Formula::Ne(left, right) => {
+            let positive = positive == matches!(formula, Formula::Eq(..));
+            match (left.as_ref(), right.as_ref()) {
+                (Formula::Bool(value), other) | (other, Formula::Bool(value)) => dnf(other, positive == *value),
+                _ => Some(match (linearize(left), linearize(right)) {
+                    (Some(left), Some(right)) if positive => vec![vec![
+                        at_most(&left, &right, 0)?,
+                        at_most(&right, &left, 0)?,
+                    ]],
+                    (Some(left), Some(right)) => vec![
+                        vec![at_most(&left, &right, 1)?],
+                        vec![at_most(&right, &left, 1)?],
+                    ],
+                    _ => vec![vec![Literal::Opaque]],
+                }),
+            }
+        }
+        Formula::Lt(left, right) | Formula::Le(left, right) | Formula::Gt(left, right) | Formula::Ge(left, right) => {
+            // `left < right` is `left - right + 1 <= 0`, and its negation `right - left <= 0`
+            let (smaller, larger, strict) = match formula {
+                Formula::Lt(..) => (left, right, true),
+                Formula::Le(..) => (left, right, false),
+                Formula::Gt(..) => (right, left, true),
+                _ => (right, left, false),
+            };
+            Some(match (linearize(smaller), linearize(larger)) {
+                (Some(smaller), Some(larger)) if positive => vec![vec![at_most(&smaller, &larger, strict as i64)?]],
+                (Some(smaller), Some(larger)) => vec![vec![at_most(&larger, &smaller, !strict as i64)?]],
+                _ => vec![vec![Literal::Opaque]],
+            })
+        }
+        _ => Some(vec![vec![Literal::Opaque]]),
+    }
+}
+
+/// The literal `left - right + slack <= 0`
+fn at_most(left: &Linear, right: &Linear, slack: i64) -> Option<Literal> {
+    Some(Literal::AtMostZero(left.clone().sub(right)?.add(&Linear::constant(slack))?))
+}
+
+fn union(mut left: Disjuncts, right: Disjuncts) -> Option<Disjuncts> {
+    left.extend(right);
+    (left.len() <= MAX_DISJUNCTS).then_some(left)
+}
+
+fn product(left: Disjuncts, right: Disjuncts) -> Option<Disjuncts> {
+    if left.len().checked_mul(right.len())? > MAX_DISJUNCTS {
+        return None;
+    }
+    Some(left.iter()
+        .flat_map(|a| right.iter().map(move |b| a.iter().chain(b).cloned().collect()))
+        .collect())
+}
+
+/// The linear form of an integer term, if it has one
+fn linearize(formula: &Formula) -> Option<Linear> {
+    match formula {
+        Formula::Int(value) => Some(Linear::constant(*value)),
+        Formula::Var(name) => Some(Linear::variable(name)),
+        Formula::Add(left, right) => linearize(left)?.add(&linearize(right)?),
+        Formula::Sub(left, right) => linearize(left)?.sub(&linearize(right)?),
+        Formula::Mul(left, right) => {
+            let (left, right) = (linearize(left)?, linearize(right)?);
+            if left.terms.is_empty() {
+                right.scale(left.constant)
+            } else if right.terms.is_empty() {
+                left.scale(right.constant)
+            } else {
+                None
+            }
+        }
+        _ => None,
+    }
+}
+
+enum Outcome {
+    Unsatisfiable,
+    Satisfiable(HashMap<String, i64>, HashMap<String, bool>),
+    Unknown,
+}
+
+/// Decide one conjunction of literals
+fn satisfy(conjunct: &[Literal]) -> Outcome {
+    let mut booleans = HashMap::new();
+    let mut constraints = Vec::new();
+    let mut opaque = false;
+    for literal in conjunct {
+        match literal {
+            Literal::Boolean(name, value) => {
+                if *booleans.entry(name.clone()).or_insert(*value) != *value {
+                    return Outcome::Unsatisfiable;
+                }
+            }
+            Literal::AtMostZero(linear) if linear.terms.is_empty() => {
+                if linear.constant > 0 {
+                    return Outcome::Unsatisfiable;
+                }
+            }
+            Literal::AtMostZero(linear) => constraints.push(linear),
+            Literal::Opaque => opaque = true,
+        }
+    }
+    
+    let mut graph = Octagon::default();
+    for constraint in &constraints {
+        graph.add(constraint);
+    }
+    let potentials = match graph.potentials() {
+        Some(potentials) => potentials,
+        None => return Outcome::Unsatisfiable,
+    };
+    // A model is only trusted when every literal is in the theory and no
+    // variable is used both as a boolean and as an integer
+    let mixed = constraints.iter().any(|constraint| constraint.terms.keys().any(|name| booleans.contains_key(name)));
+    if opaque || mixed {
+        return Outcome::Unknown;
+    }
+    
+    // Try the two natural readings of the potentials as a model; variables
+    // outside the graph are zero
+    for negative in [false, true] {
+        let mut integers: HashMap<String, i64> = constraints.iter()
+            .flat_map(|constraint| constraint.terms.keys())
+            .map(|name| (name.clone(), 0))
+            .collect();
+        for (name, &index) in &graph.variables {
+            let value = if negative { -potentials[2 * index + 1] } else { potentials[2 * index] };
+            match i64::try_from(value) {
+                Ok(value) => integers.insert(name.clone(), value),
+                Err(_) => return Outcome::Unknown,
+            };
+        }
+        let holds = constraints.iter().all(|constraint| {
+            matches!(constraint.evaluate(&integers), Some(value) if value <= 0)
+        });
+        if holds {
+            return Outcome::Satisfiable(integers, booleans);
+        }
+    }
+    Outcome::Unknown
+}
+
+/// Constraints `±x ± y <= c` as a graph over the values `x` and `-x`
+///
+/// Node `2i` stands for variable `i` and node `2i + 1` for its negation; an
+/// edge `u -> v` of weight `w` says `v - u <= w`.
+#[derive(Default)]
+struct Octagon {
+    variables: BTreeMap<String, usize>,
+    edges: Vec<(usize, usize, i64)>,
+}
+
+impl Octagon {
+    /// Add `linear <= 0` if it has octagon form; other constraints are left
+    /// to the model check
+    fn add(&mut self, linear: &Linear) {
+        let terms: Vec<(&String, i64)> = linear.terms.iter().map(|(name, &c)| (name, c)).collect();
+        let bound = |scale: i64| -> Option<i64> { linear.constant.checked_neg()?.checked_div_euclid(scale) };
+        match terms.as_slice() {
+            [(x, a)] => {
+                // `a*x <= -c`, so `±x <= floor(-c / |a|)`, and `±2x <= 2 * that`
+                let Some(c) = bound(a.abs()).and_then(|c| c.checked_mul(2)) else { return };
+                let x = self.node(x);
+                if *a > 0 {
+                    self.edges.push((x + 1, x, c));
+                } else {
+                    self.edges.push((x, x + 1, c));
+                }
+            }
+            [(x, a), (y, b)] if a.abs() == b.abs() => {
+                let Some(c) = bound(a.abs()) else { return };
+                let (x, y) = (self.node(x), self.node(y));
+                // Node of `+x` or `-x` as the term's sign says, and its opposite
+                let signed = |node: usize, coefficient: i64| if coefficient > 0 { node } else { node + 1 };
+                let (sx, sy) = (signed(x, *a), signed(y, *b));
+                // `sx + sy <= c` is `sx - (-sy) <= c` and `sy - (-sx) <= c`
+                self.edges.push((sy ^ 1, sx, c));
+                self.edges.push((sx ^ 1, sy, c));
+            }
+            _ => {}
+        }
+    }
+    
+    fn node(&mut self, name: &str) -> usize {
+        let next = self.variables.len();
+        2 * *self.variables.entry(name.to_string()).or_insert(next)
+    }
+    
+    /// Node values satisfying every edge, or `None` on a negative cycle
+    fn potentials(&self) -> Option<Vec<i128>> {
+        // Bellman-Ford from a virtual source joined to every node at weight 0
+        let nodes = 2 * self.variables.len();
+        let mut distance = vec![0i128; nodes];
+        for round in 0..=nodes {
+            let mut changed = false;
+            for &(from, to, weight) in &self.edges {
+                let candidate = distance[from] + weight as i128;
+                if candidate < distance[to] {
+                    distance[to] = candidate;
+                    changed = true;
+                }
+            }
+            if !changed {
+                return Some(distance);
+            }
+            if round == nodes {
+                break;
+            }
+        }
+        None
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    
+    fn var(name: &str) -> Box<Formula> {
+        Box::new(Formula::Var(name.to_string()))
+    }
+    
+    fn int(value: i64) -> Box<Formula> {
+        Box::new(Formula::Int(value))
+    }
+    
+    #[test]
+    fn test_bounds_and_differences() {
+        // 0 <= i && i < n && n <= len  =>  i < len
+        let assumptions = vec![
+            Formula::Le(int(0), var("i")),
+            Formula::Lt(var("i"), var("n")),
+            Formula::Le(var("n"), var("len")),
+        ];
+        assert_eq!(decide(&assumptions, &Formula::Lt(var("i"), var("len"))), Decision::Valid);
+        assert_eq!(decide(&assumptions, &Formula::Ge(var("i"), int(0))), Decision::Valid);
+        
+        // x > 0 => x + 1 > 0, and integer tightening: 2x <= 3 => x <= 1
+        let increment = Formula::Implies(
+            Box::new(Formula::Gt(var("x"), int(0))),
+            Box::new(Formula::Gt(Box::new(Formula::Add(var("x"), int(1))), int(0))),
+        );
+        assert_eq!(decide(&[], &increment), Decision::Valid);
+        let doubled = Formula::Le(Box::new(Formula::Mul(int(2), var("x"))), int(3));
+        assert_eq!(decide(&[doubled], &Formula::Le(var("x"), int(1))), Decision::Valid);
+        
+        // x + y <= 4 && x >= 3 => y <= 1, an octagon constraint
+        let sum = Formula::Le(Box::new(Formula::Add(var("x"), var("y"))), int(4));
+        assert_eq!(decide(&[sum, Formula::Ge(var("x"), int(3))], &Formula::Le(var("y"), int(1))), Decision::Valid);
+    }
+    
+    #[test]
+    fn test_counterexamples_and_residue() {
+        // i <= n does not give i < n; the counterexample must violate the goal
+        let assumptions = vec![Formula::Ge(var("i"), int(0)), Formula::Le(var("i"), var("n"))];
+        match decide(&assumptions, &Formula::Lt(var("i"), var("n"))) {
+            Decision::Invalid(values, _) => {
+                assert!(values["i"] >= 0 && values["i"] == values["n"]);
+            }
+            other => panic!("expected a counterexample, got {:?}", other),
+        }
+        
+        // Path conditions on boolean variables
+        let guarded = Formula::Implies(
+            Box::new(Formula::And(vec![Formula::Var("flag".to_string()), Formula::Not(var("flag"))])),
+            Box::new(Formula::Bool(false)),
+        );
+        assert_eq!(decide(&[], &guarded), Decision::Valid);
+        
+        // Products of variables and arrays are left to a full solver
+        let square = Formula::Ge(Box::new(Formula::Mul(var("x"), var("x"))), int(0));
+        assert_eq!(decide(&[], &square), Decision::Unknown);
+        let select = Formula::Ge(Box::new(Formula::Select(var("a"), int(0))), int(0));
+        assert_eq!(decide(&[select.clone()], &select), Decision::Unknown);
+    }
+}
@@ -18,13 +18,20 @@
 
 pub mod contracts;
 pub mod contract_to_smt;
+pub mod facts;
 pub mod invariants;
+pub mod linear;
 pub mod solver;
 pub mod vcgen;
 
+use crate::ast;
 use crate::error::{SemanticError, SourceLocation};
 use crate::mir;
-use std::collections::HashMap;
+use crate::pipeline::cache::{self, IncrementalCache};
+use rayon::prelude::*;
+use std::collections::{HashMap, HashSet};
+use std::sync::Arc;
+use std::time::Duration;
 
 /// Verification result for a function or module
 #[derive(Debug, Clone)]
@@ -86,14 +93,20 @@ pub enum Value {
 
 /// Main verification engine
 pub struct VerificationEngine {
-    /// SMT solver instance
-    solver: solver::SmtSolver,
-    
     /// Verification condition generator
     vcgen: vcgen::VcGenerator,
     
     /// Current verification context
     context: VerificationContext,
+    
+    /// Proofs kept between builds
+    cache: Option<Arc<IncrementalCache>>,
+    
+    /// Longest a single condition may take to check
+    timeout: Option<Duration>,
+    
+    /// Whether code outside the program may call its functions
+    external_callers: bool,
 }
 
 /// Context for verification
@@ -105,8 +118,9 @@ struct VerificationContext {
     /// Known function contracts
     function_contracts: HashMap<String, contracts::FunctionContract>,
     
-    /// Loop invariants
-    loop_invariants: HashMap<mir::BasicBlockId, invariants::LoopInvariant>,
+    /// Loop invariants, by function and loop header; block IDs restart in
+    /// every function
+    loop_invariants: HashMap<(String, mir::BasicBlockId), invariants::LoopInvariant>,
     
     /// Global invariants
     global_invariants: Vec<invariants::GlobalInvariant>,
@@ -116,83 +130,199 @@ impl VerificationEngine {
     /// Create a new verification engine
     pub fn new() -> Self {
         Self {
-            solver: solver::SmtSolver::new(),
             vcgen: vcgen::VcGenerator::new(),
             context: VerificationContext::default(),
+            cache: None,
+            timeout: None,
+            external_callers: false,
         }
     }
     
+    /// Reuse proofs recorded in `cache`, and record new ones there
+    pub fn with_cache(mut self, cache: Arc<IncrementalCache>) -> Self {
+        self.cache = Some(cache);
+        self
+    }
+    
+    /// Give up on a condition, leaving it unverified, after `timeout`
+    pub fn set_timeout(&mut self, timeout: Option<Duration>) {
+        self.timeout = timeout;
+    }
+    
+    /// Whether code outside the program may call any of its functions, as
+    /// in a library or an object linked into something else; preconditions
+    /// are then never proven from their call sites
+    pub fn set_external_callers(&mut self, external: bool) {
+        self.external_callers = external;
+    }
+    
     /// Verify a complete program
+    ///
+    /// Conditions are generated function by function, then solved on the
+    /// thread pool.
     pub fn verify_program(&mut self, program: &mir::Program) -> Result<Vec<VerificationResult>, SemanticError> {
-        let mut results = Vec::new();
+        let mut functions: Vec<(&String, &mir::Function)> = program.functions.iter().collect();
+        functions.sort_by(|a, b| a.0.cmp(b.0));
         
-        // Verify each function
-        for (name, function) in &program.functions {
-            let result = self.verify_function(name, function)?;
-            results.push(result);
+        let mut pending = Vec::new();
+        for (name, function) in functions {
+            pending.push((name.clone(), self.generate_conditions(name, function)?));
         }
         
-        Ok(results)
+        let solver = self.condition_solver();
+        pending.into_par_iter()
+            .map(|(name, conditions)| solver.solve(name, conditions))
+            .collect()
     }
     
     /// Verify a single function
     pub fn verify_function(&mut self, name: &str, function: &mir::Function) -> Result<VerificationResult, SemanticError> {
-        self.context.current_function = Some(name.to_string());
+        let conditions = self.generate_conditions(name, function)?;
+        self.condition_solver().solve(name.to_string(), conditions)
+    }
+    
+    /// Verify the contracts written in `program` against its MIR
+    ///
+    /// Returns facts for each function with contracts. A function whose
+    /// conditions cannot be generated gets none, and a condition the solver
+    /// refuted, could not decide or timed out on is never proven.
+    ///
+    /// A precondition is checked at every call site, under the caller's path
+    /// condition. It is proven when every call site meets it and nothing
+    /// outside the program can call the function: the program has a `main`,
+    /// the function is neither `main` nor exported, and every call names its
+    /// callee.
+    pub fn verify_contracts(&mut self, program: &ast::Program, mir_program: &mir::Program) -> HashMap<String, facts::ProvenFacts> {
+        let mut external: HashSet<String> = HashSet::from(["main".to_string()]);
+        for module in &program.modules {
+            for export in &module.exports {
+                if let ast::ExportStatement::Function { name, .. } = export {
+                    external.insert(name.name.clone());
+                }
+            }
+            for function in &module.function_definitions {
+                if function.export_info.is_some() {
+                    external.insert(function.name.name.clone());
+                }
+                if let Some(contract) = contracts::parse_contracts(function) {
+                    self.add_function_contract(function.name.name.clone(), contract);
+                }
+            }
+        }
         
-        // Get function contract if it exists
-        let contract = self.context.function_contracts.get(name).cloned();
+        let call_contracts: HashMap<String, vcgen::CallContract> = self.context.function_contracts.iter()
+            .filter_map(|(name, contract)| {
+                let function = mir_program.functions.get(name)?;
+                Some((name.clone(), vcgen::CallContract {
+                    parameters: function.parameters.iter().map(|param| param.name.clone()).collect(),
+                    contract: contract.clone(),
+                }))
+            })
+            .collect();
         
-        // Generate verification conditions
-        let conditions = self.vcgen.generate_function_vcs(function, contract.as_ref())?;
+        // Functions with a contract, and callers of one, are verified
+        let mut functions: Vec<(&String, &mir::Function)> = mir_program.functions.iter().collect();
+        functions.sort_by(|a, b| a.0.cmp(b.0));
+        let mut closed = !self.external_callers && mir_program.functions.contains_key("main");
+        let mut pending = Vec::new();
+        let mut unchecked_callees = HashSet::new();
+        self.vcgen.set_call_contracts(call_contracts);
+        for (name, function) in functions {
+            let (callees, indirect) = called_functions(function);
+            closed &= !indirect;
+            let callees: Vec<&str> = callees.into_iter()
+                .filter(|callee| self.context.function_contracts.contains_key(*callee))
+                .collect();
+            if callees.is_empty() && !self.context.function_contracts.contains_key(name) {
+                continue;
+            }
+            match self.generate_conditions(name, function) {
+                Ok(conditions) => pending.push((name.clone(), conditions)),
+                Err(_) => unchecked_callees.extend(callees),
+            }
+        }
+        self.vcgen.set_call_contracts(HashMap::new());
         
-        // Verify each condition
-        let mut condition_results = Vec::new();
-        let mut counterexamples = Vec::new();
-        let mut all_verified = true;
+        let solver = self.condition_solver();
+        let results: Vec<VerificationResult> = pending.into_par_iter()
+            .filter_map(|(name, conditions)| solver.solve(name, conditions).ok())
+            .collect();
         
-        for vc in conditions {
-            let start_time = std::time::Instant::now();
-            
-            match self.solver.check_condition(&vc) {
-                Ok(solver::CheckResult::Verified) => {
-                    condition_results.push(ConditionResult {
-                        name: vc.name.clone(),
-                        condition: vc.formula.to_string(),
-                        verified: true,
-                        location: vc.location.clone(),
-                        verification_time_ms: start_time.elapsed().as_millis() as u64,
-                    });
-                }
-                Ok(solver::CheckResult::Failed(model)) => {
-                    all_verified = false;
-                    
-                    condition_results.push(ConditionResult {
-                        name: vc.name.clone(),
-                        condition: vc.formula.to_string(),
-                        verified: false,
-                        location: vc.location.clone(),
-                        verification_time_ms: start_time.elapsed().as_millis() as u64,
-                    });
-                    
-                    // Extract counterexample
-                    let counterexample = self.extract_counterexample(&vc, model);
-                    counterexamples.push(counterexample);
+        // Preconditions some call site did not meet, as (callee, precondition)
+        let mut unmet = HashSet::new();
+        for result in &results {
+            for condition in result.conditions.iter().filter(|condition| !condition.verified) {
+                if let Some(call) = call_condition(&condition.name) {
+                    unmet.insert(call);
                 }
-                Err(e) => {
-                    return Err(SemanticError::VerificationError {
-                        message: format!("Failed to verify condition '{}': {}", vc.name, e),
-                        location: vc.location,
-                    });
+            }
+        }
+        
+        let mut proven = HashMap::new();
+        for result in &results {
+            let contract = match self.context.function_contracts.get(&result.name) {
+                Some(contract) => contract,
+                None => continue,
+            };
+            let function = &mir_program.functions[&result.name];
+            let mut facts = self.proven_facts(function, result);
+            let internal = closed && !external.contains(&result.name) && !unchecked_callees.contains(result.name.as_str());
+            if internal {
+                for precondition in &contract.preconditions {
+                    if !unmet.contains(&(result.name.as_str(), precondition.name.as_str())) {
+                        facts.add_proven_precondition(precondition);
+                    }
                 }
             }
+            proven.insert(result.name.clone(), facts);
         }
+        proven
+    }
+    
+    fn generate_conditions(&mut self, name: &str, function: &mir::Function) -> Result<Vec<solver::VerificationCondition>, SemanticError> {
+        self.context.current_function = Some(name.to_string());
         
-        Ok(VerificationResult {
-            name: name.to_string(),
-            verified: all_verified,
-            conditions: condition_results,
-            counterexamples,
-        })
+        // Get function contract if it exists
+        let contract = self.context.function_contracts.get(name).cloned();
+        
+        // Generate verification conditions
+        let mut conditions = self.vcgen.generate_function_vcs(function, contract.as_ref())?;
+        for invariant in self.loop_invariants_of(name) {
+            conditions.extend(self.vcgen.generate_loop_invariant_vcs(&invariant)?);
+        }
+        
+        Ok(conditions)
+    }
+    
+    fn condition_solver(&self) -> ConditionSolver<'_> {
+        ConditionSolver {
+            cache: self.cache.as_deref(),
+            timeout: self.timeout,
+        }
+    }
+    
+    /// Facts the optimizer may rely on, from a result of `verify_function`
+    ///
+    /// Proven conditions also need no runtime check.
+    pub fn proven_facts(&self, function: &mir::Function, result: &VerificationResult) -> facts::ProvenFacts {
+        let loop_invariants: Vec<invariants::LoopInvariant> = self.loop_invariants_of(&result.name).into_iter()
+            .filter(|invariant| function.basic_blocks.get(invariant.loop_header).is_some())
+            .collect();
+        facts::ProvenFacts::from_result(
+            result,
+            self.context.function_contracts.get(&result.name),
+            &loop_invariants,
+        )
+    }
+    
+    /// Loop invariants added for function `name`, by header
+    fn loop_invariants_of(&self, name: &str) -> Vec<invariants::LoopInvariant> {
+        let mut loop_invariants: Vec<(&mir::BasicBlockId, &invariants::LoopInvariant)> = self.context.loop_invariants.iter()
+            .filter(|((function, _), _)| function == name)
+            .map(|((_, header), invariant)| (header, invariant))
+            .collect();
+        loop_invariants.sort_by_key(|(header, _)| **header);
+        loop_invariants.into_iter().map(|(_, invariant)| invariant.clone()).collect()
     }
     
     /// Add a function contract
@@ -200,49 +330,188 @@ impl VerificationEngine {
         self.context.function_contracts.insert(name, contract);
     }
     
-    /// Add a loop invariant
-    pub fn add_loop_invariant(&mut self, block_id: mir::BasicBlockId, invariant: invariants::LoopInvariant) {
-        self.context.loop_invariants.insert(block_id, invariant);
+    /// Add a loop invariant of function `function`, holding at `block_id`
+    pub fn add_loop_invariant(&mut self, function: &str, block_id: mir::BasicBlockId, invariant: invariants::LoopInvariant) {
+        self.context.loop_invariants.insert((function.to_string(), block_id), invariant);
     }
     
     /// Add a global invariant
     pub fn add_global_invariant(&mut self, invariant: invariants::GlobalInvariant) {
         self.context.global_invariants.push(invariant);
     }
+}
+
+impl Default for VerificationEngine {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Solves verification conditions, sharing what it can between them
+#[derive(Clone, Copy)]
+struct ConditionSolver<'a> {
+    cache: Option<&'a IncrementalCache>,
+    timeout: Option<Duration>,
+}
+
+/// Conditions sharing a path hypothesis, with each one's goal and position
+type ConditionGroup = (Option<solver::Formula>, Vec<(usize, solver::VerificationCondition, solver::Formula)>);
+
+impl ConditionSolver<'_> {
+    /// Check the conditions of function `name`
+    ///
+    /// Conditions of the form `path => goal` are grouped by `path`; a group
+    /// assumes its path once, in its own solver scope, and groups are checked
+    /// in parallel.
+    fn solve(&self, name: String, conditions: Vec<solver::VerificationCondition>) -> Result<VerificationResult, SemanticError> {
+        let mut groups: Vec<ConditionGroup> = Vec::new();
+        let mut group_of: HashMap<String, usize> = HashMap::new();
+        for (index, vc) in conditions.into_iter().enumerate() {
+            let (hypothesis, goal) = match &vc.formula {
+                solver::Formula::Implies(hypothesis, goal) => (Some((**hypothesis).clone()), (**goal).clone()),
+                formula => (None, formula.clone()),
+            };
+            let key = format!("{:?}", hypothesis);
+            let group = *group_of.entry(key).or_insert_with(|| {
+                groups.push((hypothesis, Vec::new()));
+                groups.len() - 1
+            });
+            groups[group].1.push((index, vc, goal));
+        }
+        
+        let checked: Vec<Vec<(usize, ConditionResult, Option<Counterexample>)>> = groups.into_par_iter()
+            .map(|group| self.solve_group(group))
+            .collect::<Result<_, _>>()?;
+        let mut checked: Vec<_> = checked.into_iter().flatten().collect();
+        checked.sort_by_key(|(index, _, _)| *index);
+        
+        let verified = checked.iter().all(|(_, result, _)| result.verified);
+        let mut conditions = Vec::new();
+        let mut counterexamples = Vec::new();
+        for (_, result, counterexample) in checked {
+            conditions.push(result);
+            counterexamples.extend(counterexample);
+        }
+        
+        Ok(VerificationResult {
+            name,
+            verified,
+            conditions,
+            counterexamples,
+        })
+    }
     
-    /// Extract a counterexample from a failed verification
-    fn extract_counterexample(&self, vc: &solver::VerificationCondition, model: solver::Model) -> Counterexample {
-        let mut assignments = HashMap::new();
+    fn solve_group(&self, (hypothesis, conditions): ConditionGroup) -> Result<Vec<(usize, ConditionResult, Option<Counterexample>)>, SemanticError> {
+        let mut smt = solver::SmtSolver::new();
+        smt.set_timeout(self.timeout);
+        smt.push();
+        if let Some(hypothesis) = hypothesis {
+            smt.assume(hypothesis);
+        }
         
-        // Extract variable values from the model
-        for (var_name, value) in model.assignments {
-            assignments.insert(var_name, self.convert_solver_value(value));
+        let mut results = Vec::new();
+        for (index, vc, goal) in conditions {
+            let start_time = std::time::Instant::now();
+            let key = self.cache.map(|_| cache::proof_key(&vc.formula.normalized()));
+            let cached = matches!((self.cache, &key), (Some(cache), Some(key)) if cache.is_proven(key));
+            
+            let outcome = if cached {
+                solver::CheckResult::Verified
+            } else {
+                let goal = solver::VerificationCondition {
+                    name: vc.name.clone(),
+                    formula: goal,
+                    location: vc.location.clone(),
+                };
+                smt.check_condition(&goal).map_err(|e| SemanticError::VerificationError {
+                    message: format!("Failed to verify condition '{}': {}", vc.name, e),
+                    location: vc.location.clone(),
+                })?
+            };
+            
+            let (verified, counterexample) = match outcome {
+                solver::CheckResult::Verified => {
+                    if let (Some(cache), Some(key), false) = (self.cache, &key, cached) {
+                        cache.mark_proven(key);
+                    }
+                    (true, None)
+                }
+                solver::CheckResult::Failed(model) => (false, Some(extract_counterexample(&vc, model))),
+                solver::CheckResult::Timeout | solver::CheckResult::Unknown => (false, None),
+            };
+            results.push((index, ConditionResult {
+                name: vc.name.clone(),
+                condition: vc.formula.to_string(),
+                verified,
+                location: vc.location.clone(),
+                verification_time_ms: start_time.elapsed().as_millis() as u64,
+            }, counterexample));
         }
         
-        Counterexample {
-            condition_name: vc.name.clone(),
-            assignments,
-            trace: model.execution_trace,
+        smt.pop();
+        Ok(results)
+    }
+}
+
+/// Functions `function` calls by name, and whether it makes a call whose
+/// callee is not a constant
+fn called_functions(function: &mir::Function) -> (Vec<&str>, bool) {
+    let mut funcs = Vec::new();
+    for block in function.basic_blocks.values() {
+        for statement in &block.statements {
+            if let mir::Statement::Assign { rvalue: mir::Rvalue::Call { func, .. }, .. } = statement {
+                funcs.push(func);
+            }
+        }
+        if let mir::Terminator::Call { func, .. } = &block.terminator {
+            funcs.push(func);
         }
     }
     
-    /// Convert solver value to our value representation
-    fn convert_solver_value(&self, value: solver::SolverValue) -> Value {
-        match value {
-            solver::SolverValue::Int(n) => Value::Integer(n),
-            solver::SolverValue::Real(f) => Value::Float(f),
-            solver::SolverValue::Bool(b) => Value::Boolean(b),
-            solver::SolverValue::String(s) => Value::String(s),
-            solver::SolverValue::Array(values) => {
-                Value::Array(values.into_iter().map(|v| self.convert_solver_value(v)).collect())
-            }
+    let mut callees = Vec::new();
+    let mut indirect = false;
+    for func in funcs {
+        match func {
+            mir::Operand::Constant(mir::Constant { value: mir::ConstantValue::String(name), .. }) => callees.push(name.as_str()),
+            _ => indirect = true,
         }
     }
+    (callees, indirect)
 }
 
-impl Default for VerificationEngine {
-    fn default() -> Self {
-        Self::new()
+/// The callee and precondition name of a call-site condition
+fn call_condition(name: &str) -> Option<(&str, &str)> {
+    let name = name.rsplit_once(" (").map_or(name, |(base, _)| base);
+    let (precondition, callee) = name.strip_prefix("precondition_")?.rsplit_once(" of ")?;
+    Some((callee, precondition))
+}
+
+/// Extract a counterexample from a failed verification
+fn extract_counterexample(vc: &solver::VerificationCondition, model: solver::Model) -> Counterexample {
+    let mut assignments = HashMap::new();
+    
+    // Extract variable values from the model
+    for (var_name, value) in model.assignments {
+        assignments.insert(var_name, convert_solver_value(value));
+    }
+    
+    Counterexample {
+        condition_name: vc.name.clone(),
+        assignments,
+        trace: model.execution_trace,
+    }
+}
+
+/// Convert solver value to our value representation
+fn convert_solver_value(value: solver::SolverValue) -> Value {
+    match value {
+        solver::SolverValue::Int(n) => Value::Integer(n),
+        solver::SolverValue::Real(f) => Value::Float(f),
+        solver::SolverValue::Bool(b) => Value::Boolean(b),
+        solver::SolverValue::String(s) => Value::String(s),
+        solver::SolverValue::Array(values) => {
+            Value::Array(values.into_iter().map(convert_solver_value).collect())
+        }
     }
 }
 
@@ -256,4 +525,159 @@ mod tests {
         assert!(engine.context.current_function.is_none());
         assert!(engine.context.function_contracts.is_empty());
     }
+    
+    #[test]
+    fn test_proofs_are_cached_between_runs() {
+        use crate::ast::PrimitiveType;
+        use crate::types::Type;
+        
+        let root = std::env::temp_dir().join(format!("aether-proof-cache-test-{}", std::process::id()));
+        let _ = std::fs::remove_dir_all(&root);
+        let cache = Arc::new(IncrementalCache::open(&root).unwrap());
+        
+        let mut function = mir::Function {
+            name: "positive".to_string(),
+            parameters: vec![],
+            return_type: Type::primitive(PrimitiveType::Integer),
+            locals: Default::default(),
+            basic_blocks: Default::default(),
+            entry_block: 0,
+            return_local: None,
+            entry_count: None,
+            proven_facts: None,
+        };
+        function.basic_blocks.insert(0, mir::BasicBlock {
+            id: 0,
+            statements: vec![],
+            terminator: mir::Terminator::Return,
+        });
+        let mut program = mir::Program {
+            functions: HashMap::new(),
+            global_constants: HashMap::new(),
+            external_functions: HashMap::new(),
+            type_definitions: HashMap::new(),
+        };
+        for name in ["positive", "also_positive"] {
+            program.functions.insert(name.to_string(), mir::Function { name: name.to_string(), ..function.clone() });
+        }
+        
+        let verify = |variable: &str| {
+            let mut engine = VerificationEngine::new().with_cache(Arc::clone(&cache));
+            for name in ["positive", "also_positive"] {
+                let mut contract = contracts::FunctionContract::new(name.to_string());
+                let variable = Box::new(contracts::Expression::Variable(variable.to_string()));
+                contract.add_precondition(
+                    "successor".to_string(),
+                    contracts::Expression::BinaryOp {
+                        op: contracts::BinaryOp::Gt,
+                        left: Box::new(contracts::Expression::BinaryOp {
+                            op: contracts::BinaryOp::Add,
+                            left: variable.clone(),
+                            right: Box::new(contracts::Expression::Constant(contracts::ConstantValue::Integer(1))),
+                        }),
+                        right: variable,
+                    },
+                    SourceLocation::unknown(),
+                );
+                engine.add_function_contract(name.to_string(), contract);
+            }
+            engine.verify_program(&program).unwrap()
+        };
+        
+        let first = verify("x");
+        assert_eq!(first.iter().map(|result| result.name.as_str()).collect::<Vec<_>>(), ["also_positive", "positive"]);
+        assert!(first.iter().all(|result| result.verified));
+        let after_first = cache.stats().proofs;
+        assert_eq!(after_first.lookups, 2);
+        
+        // Renaming the variable leaves the normalized formula, and so the proof, unchanged
+        let second = verify("y");
+        assert!(second.iter().all(|result| result.verified && result.conditions.len() == 1));
+        assert_eq!(cache.stats().proofs.hits - after_first.hits, 2);
+        
+        let _ = std::fs::remove_dir_all(&root);
+    }
+    
+    #[test]
+    fn test_preconditions_proven_at_call_sites() {
+        // `scale` is called with a positive argument on both paths, `shift`
+        // with `n` on the path where `n` is not positive
+        let source = |entry: &str| format!(r#"
+(DEFINE_MODULE
+  (NAME calls)
+  (CONTENT
+    (DEFINE_FUNCTION
+      (NAME scale)
+      (ACCEPTS_PARAMETER (NAME "x") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (PRECONDITION (PREDICATE_GREATER_THAN x 0))
+      (BODY (RETURN_VALUE (EXPRESSION_MULTIPLY x 2))))
+    (DEFINE_FUNCTION
+      (NAME shift)
+      (ACCEPTS_PARAMETER (NAME "x") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (PRECONDITION (PREDICATE_GREATER_THAN x 0))
+      (BODY (RETURN_VALUE (EXPRESSION_ADD x 1))))
+    (DEFINE_FUNCTION
+      (NAME {})
+      (ACCEPTS_PARAMETER (NAME "n") (TYPE INTEGER))
+      (RETURNS INTEGER)
+      (BODY
+        (IF_CONDITION (PREDICATE_GREATER_THAN n 0)
+          (THEN_EXECUTE (RETURN_VALUE (EXPRESSION_ADD (CALL_FUNCTION scale n) (CALL_FUNCTION shift n))))
+          (ELSE_EXECUTE (RETURN_VALUE (EXPRESSION_ADD (CALL_FUNCTION scale 3) (CALL_FUNCTION shift n)))))))))
+"#, entry);
+        let verify = |entry: &str, external_callers: bool| {
+            let tokens = crate::lexer::Lexer::new(&source(entry), "test.aether".to_string()).tokenize().unwrap();
+            let program = crate::parser::Parser::new(tokens).parse_program().unwrap();
+            let mir_program = crate::mir::lowering::lower_ast_to_mir(&program).unwrap();
+            let mut engine = VerificationEngine::new();
+            engine.set_external_callers(external_callers);
+            engine.verify_contracts(&program, &mir_program)
+        };
+        
+        let facts = verify("main", false);
+        assert!(facts["scale"].is_proven("precondition_1"));
+        assert_eq!(facts["scale"].range_of("x", None), (Some(1), None));
+        assert!(!facts["shift"].is_proven("precondition_1"));
+        
+        // Callers outside the program may pass anything
+        assert!(!verify("main", true)["scale"].is_proven("precondition_1"));
+        assert!(!verify("entry", false)["scale"].is_proven("precondition_1"));
+    }
+    
+    #[test]
+    fn test_loop_invariants_stay_with_their_function() {
+        use crate::ast::PrimitiveType;
+        use crate::types::Type;
+        
+        // Both functions have a self-looping block 1
+        let looping = |name: &str| {
+            let mut builder = mir::Builder::new();
+            builder.start_function(name.to_string(), vec![], Type::primitive(PrimitiveType::Void));
+            let header = builder.new_block();
+            builder.set_terminator(mir::Terminator::Goto { target: header });
+            builder.switch_to_block(header);
+            builder.set_terminator(mir::Terminator::Goto { target: header });
+            builder.finish_function()
+        };
+        let (first, second) = (looping("first"), looping("second"));
+        
+        let mut engine = VerificationEngine::new();
+        let mut invariant = invariants::LoopInvariant::new(1);
+        invariant.add_condition(
+            "holds".to_string(),
+            contracts::Expression::Constant(contracts::ConstantValue::Boolean(true)),
+            SourceLocation::unknown(),
+        );
+        engine.add_loop_invariant("first", 1, invariant);
+        
+        let result = engine.verify_function("first", &first).unwrap();
+        assert_eq!(result.conditions.len(), 1);
+        assert!(engine.proven_facts(&first, &result).is_proven("loop_invariant_holds"));
+        
+        let result = engine.verify_function("second", &second).unwrap();
+        assert!(result.conditions.is_empty());
+        assert!(!engine.proven_facts(&second, &result).is_proven("loop_invariant_holds"));
+    }
 }
\ No newline at end of file
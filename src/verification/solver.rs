@@ -12,21 +12,31 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-//! SMT solver interface stub (Z3 not available)
+//! SMT solver interface (Z3 not available)
 //! 
-//! This is a temporary stub implementation until Z3 is properly installed
+//! Conditions are decided by the in-tree linear arithmetic procedure in
+//! `linear`; what it cannot decide is reported as unknown until Z3 is
+//! properly installed
 
 use crate::error::SourceLocation;
 use crate::types::Type;
+use super::linear::{self, Decision};
 use std::collections::HashMap;
+use std::time::{Duration, Instant};
 
 #[derive(Debug)]
 pub struct SmtSolver {
-    /// SMT-LIB assertions
-    assertions: Vec<String>,
+    /// Formulas assumed by every check, innermost scope last
+    assumptions: Vec<Formula>,
+    
+    /// Length of `assumptions` when each open scope was pushed
+    scopes: Vec<usize>,
     
     /// Variables declared in the solver
     variables: HashMap<String, String>,
+    
+    /// Longest a single check may run
+    timeout: Option<Duration>,
 }
 
 /// Solver value types
@@ -46,6 +56,12 @@ pub enum CheckResult {
     
     /// Condition failed with counterexample
     Failed(Model),
+    
+    /// The check ran out of time without an answer
+    Timeout,
+    
+    /// The condition is beyond what the solver decides
+    Unknown,
 }
 
 /// Model (counterexample) from solver
@@ -149,35 +165,112 @@ impl SmtSolver {
     /// Create a new SMT solver
     pub fn new() -> Self {
         Self {
-            assertions: Vec::new(),
+            assumptions: Vec::new(),
+            scopes: Vec::new(),
             variables: HashMap::new(),
+            timeout: None,
         }
     }
     
-    /// Check a verification condition
+    /// Limit how long each later check may run
+    pub fn set_timeout(&mut self, timeout: Option<Duration>) {
+        self.timeout = timeout;
+    }
+    
+    /// Open a scope; assumptions made in it are dropped by the matching `pop`
+    pub fn push(&mut self) {
+        self.scopes.push(self.assumptions.len());
+    }
+    
+    /// Close the innermost scope
+    pub fn pop(&mut self) {
+        if let Some(len) = self.scopes.pop() {
+            self.assumptions.truncate(len);
+        }
+    }
+    
+    /// Assume `formula` in every check until its scope is popped
+    pub fn assume(&mut self, formula: Formula) {
+        self.assumptions.push(formula);
+    }
+    
+    /// Check a verification condition under the current assumptions
     pub fn check_condition(&mut self, vc: &VerificationCondition) -> Result<CheckResult, String> {
-        // Stub implementation - always returns verified for now
-        eprintln!("Warning: Verification is using stub implementation (Z3 not available)");
-        eprintln!("Checking condition: {}", vc.name);
-        
-        // For simple cases, we can do basic checking
-        match &vc.formula {
-            Formula::Bool(true) => Ok(CheckResult::Verified),
-            Formula::Bool(false) => {
+        let start = Instant::now();
+        let result = self.check_formula(vc);
+        match self.timeout {
+            Some(timeout) if start.elapsed() > timeout => Ok(CheckResult::Timeout),
+            _ => result,
+        }
+    }
+    
+    fn check_formula(&mut self, vc: &VerificationCondition) -> Result<CheckResult, String> {
+        match linear::decide(&self.assumptions, &vc.formula) {
+            Decision::Valid => Ok(CheckResult::Verified),
+            Decision::Invalid(integers, booleans) => {
+                let mut assignments: HashMap<String, SolverValue> = integers.into_iter()
+                    .map(|(name, value)| (name, SolverValue::Int(value)))
+                    .collect();
+                assignments.extend(booleans.into_iter().map(|(name, value)| (name, SolverValue::Bool(value))));
                 Ok(CheckResult::Failed(Model {
-                    assignments: HashMap::new(),
-                    execution_trace: vec!["Condition is false".to_string()],
+                    assignments,
+                    execution_trace: vec![format!("Condition {} is false", vc.name)],
                 }))
             }
-            _ => {
-                // For now, assume all other conditions are verified
-                Ok(CheckResult::Verified)
-            }
+            // The hard residue needs a full SMT solver, which this build lacks
+            Decision::Unknown => Ok(CheckResult::Unknown),
         }
     }
 }
 
 impl Formula {
+    /// Rendering that is the same for formulas equal up to variable names
+    ///
+    /// Variables are renamed in order of first appearance, so the result can
+    /// key a cache of proofs.
+    pub fn normalized(&self) -> String {
+        let mut names = HashMap::new();
+        let mut renamed = self.clone();
+        renamed.rename_variables(&mut names);
+        format!("{:?}", renamed)
+    }
+    
+    fn rename_variables(&mut self, names: &mut HashMap<String, String>) {
+        fn rename(name: &mut String, names: &mut HashMap<String, String>) {
+            let next = format!("v{}", names.len());
+            *name = names.entry(name.clone()).or_insert(next).clone();
+        }
+        
+        match self {
+            Formula::Bool(_) | Formula::Int(_) | Formula::Real(_) => {}
+            Formula::Var(name) => rename(name, names),
+            Formula::Eq(l, r) | Formula::Ne(l, r) | Formula::Lt(l, r) | Formula::Le(l, r)
+            | Formula::Gt(l, r) | Formula::Ge(l, r) | Formula::Add(l, r) | Formula::Sub(l, r)
+            | Formula::Mul(l, r) | Formula::Div(l, r) | Formula::Mod(l, r) | Formula::Implies(l, r)
+            | Formula::Select(l, r) => {
+                l.rename_variables(names);
+                r.rename_variables(names);
+            }
+            Formula::And(fs) | Formula::Or(fs) => {
+                for f in fs {
+                    f.rename_variables(names);
+                }
+            }
+            Formula::Not(f) => f.rename_variables(names),
+            Formula::Ite(a, b, c) | Formula::Store(a, b, c) => {
+                a.rename_variables(names);
+                b.rename_variables(names);
+                c.rename_variables(names);
+            }
+            Formula::Forall(bound, body) | Formula::Exists(bound, body) => {
+                for (name, _) in bound.iter_mut() {
+                    rename(name, names);
+                }
+                body.rename_variables(names);
+            }
+        }
+    }
+    
     /// Convert to string for display
     pub fn to_string(&self) -> String {
         match self {
@@ -237,7 +330,7 @@ mod tests {
             Ok(CheckResult::Verified) => {
                 // Expected result
             }
-            Ok(CheckResult::Failed(_)) => {
+            Ok(CheckResult::Failed(_)) | Ok(CheckResult::Timeout) | Ok(CheckResult::Unknown) => {
                 panic!("Verification should have succeeded");
             }
             Err(e) => {
@@ -20,8 +20,10 @@ use crate::error::{SemanticError, SourceLocation};
 use crate::mir::{self, BasicBlockId, Operand, Rvalue, Statement, Terminator};
 use crate::types::Type;
 use crate::ast::PrimitiveType;
-use super::contracts::{FunctionContract, Expression as ContractExpr, BinaryOp as ContractBinOp, ConstantValue};
+use super::contracts::{FunctionContract, Expression as ContractExpr, BinaryOp as ContractBinOp, UnaryOp as ContractUnOp, ConstantValue};
+use super::invariants::LoopInvariant;
 use super::solver::{Formula, VerificationCondition};
+use std::cell::Cell;
 use std::collections::{HashMap, HashSet};
 
 /// Verification condition generator
@@ -34,6 +36,31 @@ pub struct VcGenerator {
     
     /// Current variable state
     state: HashMap<String, Formula>,
+    
+    /// Counter for naming unmodeled values
+    opaque_counter: Cell<usize>,
+    
+    /// Local of each parameter, by source name
+    parameters: HashMap<String, mir::LocalId>,
+    
+    /// Blocks with more than one predecessor
+    join_blocks: HashSet<BasicBlockId>,
+    
+    /// Contracts of the functions calls may go to, by name
+    call_contracts: HashMap<String, CallContract>,
+    
+    /// Values of the callee's parameters while a call's preconditions are
+    /// translated; other names are unknown there
+    call_bindings: Option<HashMap<String, Formula>>,
+}
+
+/// What a call to a function with a contract must establish
+#[derive(Debug, Clone)]
+pub struct CallContract {
+    /// The callee's parameter names, in argument order
+    pub parameters: Vec<String>,
+    
+    pub contract: FunctionContract,
 }
 
 /// Type of verification condition
@@ -71,9 +98,34 @@ impl VcGenerator {
             vc_counter: 0,
             path_condition: Vec::new(),
             state: HashMap::new(),
+            opaque_counter: Cell::new(0),
+            parameters: HashMap::new(),
+            join_blocks: HashSet::new(),
+            call_contracts: HashMap::new(),
+            call_bindings: None,
         }
     }
     
+    /// Check calls to these functions against their preconditions
+    pub fn set_call_contracts(&mut self, contracts: HashMap<String, CallContract>) {
+        self.call_contracts = contracts;
+    }
+    
+    /// Name of the condition a call to `callee` must meet for its precondition `name`
+    pub fn call_condition_name(callee: &str, name: &str) -> String {
+        format!("precondition_{} of {}", name, callee)
+    }
+    
+    /// A fresh variable standing for a value the generator does not model
+    ///
+    /// Each unmodeled value is unconstrained and distinct from every other,
+    /// so no condition can be proven by what was left out of its formula.
+    fn opaque(&self, what: &str) -> Formula {
+        let id = self.opaque_counter.get();
+        self.opaque_counter.set(id + 1);
+        Formula::Var(format!("{}#{}", what, id))
+    }
+    
     /// Generate verification conditions for a function
     pub fn generate_function_vcs(
         &mut self,
@@ -86,16 +138,23 @@ impl VcGenerator {
         self.path_condition.clear();
         self.state.clear();
         
-        // Initialize parameters in state
-        for (idx, _param) in function.parameters.iter().enumerate() {
-            let param_name = format!("param_{}", idx);
-            self.state.insert(param_name.clone(), Formula::Var(param_name));
-        }
+        // Contracts name parameters by their source names
+        self.parameters = function.parameters.iter()
+            .map(|param| (param.name.clone(), param.local_id))
+            .collect();
+        let cfg = function.cfg();
+        self.join_blocks = cfg.blocks().iter()
+            .copied()
+            .filter(|&block| cfg.predecessors(block).len() > 1)
+            .collect();
         
-        // Check preconditions at function entry
+        // Check preconditions at function entry; without hypotheses, only a
+        // tautology is proven here. Each call site checks them again.
         if let Some(contract) = contract {
+            let mut assumed = Vec::new();
             for precond in &contract.preconditions {
                 let formula = self.contract_expr_to_formula(&precond.expression)?;
+                assumed.push(formula.clone());
                 vcs.push(self.create_vc(
                     format!("precondition_{}", precond.name),
                     VcType::Precondition,
@@ -103,6 +162,10 @@ impl VcGenerator {
                     precond.location.clone(),
                 ));
             }
+            
+            // The body may assume them: callers established them, or the
+            // runtime check at entry did
+            self.path_condition = assumed;
         }
         
         // Process each basic block
@@ -113,6 +176,26 @@ impl VcGenerator {
         Ok(vcs)
     }
     
+    /// Generate verification conditions for the conditions of a loop invariant
+    pub fn generate_loop_invariant_vcs(
+        &mut self,
+        invariant: &LoopInvariant,
+    ) -> Result<Vec<VerificationCondition>, SemanticError> {
+        let mut vcs = Vec::new();
+        
+        for condition in &invariant.conditions {
+            let formula = self.contract_expr_to_formula(&condition.expression)?;
+            vcs.push(self.create_vc(
+                format!("loop_invariant_{}", condition.name),
+                VcType::LoopInvariantEntry,
+                formula,
+                condition.location.clone(),
+            ));
+        }
+        
+        Ok(vcs)
+    }
+    
     /// Process a basic block and generate VCs
     fn process_block(
         &mut self,
@@ -128,7 +211,28 @@ impl VcGenerator {
         }
         visited.insert(block_id);
         
-        let block = &function.basic_blocks[&block_id];
+        // A block reached along several paths is visited once, so it may
+        // assume nothing the paths established
+        if self.join_blocks.contains(&block_id) {
+            let path_condition = std::mem::take(&mut self.path_condition);
+            let state = std::mem::take(&mut self.state);
+            let result = self.process_block_body(function, block_id, visited, vcs, contract);
+            self.path_condition = path_condition;
+            self.state = state;
+            return result;
+        }
+        self.process_block_body(function, block_id, visited, vcs, contract)
+    }
+    
+    fn process_block_body(
+        &mut self,
+        function: &mir::Function,
+        block_id: BasicBlockId,
+        visited: &mut HashSet<BasicBlockId>,
+        vcs: &mut Vec<VerificationCondition>,
+        contract: Option<&FunctionContract>,
+    ) -> Result<(), SemanticError> {
+        let block = &function.basic_blocks[block_id];
         
         // Process statements
         for stmt in &block.statements {
@@ -140,9 +244,10 @@ impl VcGenerator {
             Terminator::Return => {
                 // Check postconditions
                 if let Some(contract) = contract {
-                    // Note: In a real implementation, we would track the return value
-                    // through the MIR statements. For now, we assume it's stored in a
-                    // special "return_value" local if there is one.
+                    if let Some(return_local) = function.return_local {
+                        let value = self.operand_to_formula(&Operand::Copy(mir::Place { local: return_local, projection: vec![] }))?;
+                        self.state.insert("result".to_string(), value);
+                    }
                     
                     for postcond in &contract.postconditions {
                         let formula = self.contract_expr_to_formula(&postcond.expression)?;
@@ -160,24 +265,25 @@ impl VcGenerator {
                 let disc_formula = self.operand_to_formula(discriminant)?;
                 
                 // For now, handle only boolean switches (true/false)
-                if targets.values.len() == 1 && targets.targets.len() == 1 {
-                    // Assume value 0 means false, go to otherwise
-                    // Assume value 1 means true, go to targets[0]
-                    if targets.values[0] == 1 {
-                        // True branch
-                        self.path_condition.push(disc_formula.clone());
-                        self.process_block(function, targets.targets[0], visited, vcs, contract)?;
-                        self.path_condition.pop();
-                        
-                        // False branch (otherwise)
-                        self.path_condition.push(Formula::Not(Box::new(disc_formula)));
-                        self.process_block(function, targets.otherwise, visited, vcs, contract)?;
-                        self.path_condition.pop();
-                    }
+                if targets.values.len() == 1 && targets.targets.len() == 1 && targets.values[0] == 1 {
+                    // True branch
+                    let state = self.state.clone();
+                    self.path_condition.push(disc_formula.clone());
+                    self.process_block(function, targets.targets[0], visited, vcs, contract)?;
+                    self.path_condition.pop();
+                    
+                    // False branch (otherwise), without the true branch's assignments
+                    self.state = state;
+                    self.path_condition.push(Formula::Not(Box::new(disc_formula)));
+                    self.process_block(function, targets.otherwise, visited, vcs, contract)?;
+                    self.path_condition.pop();
                 } else {
+                    // Every target is still visited, so no call site goes unchecked
                     // TODO: Handle general switch statements
+                    let state = self.state.clone();
                     for &target in &targets.targets {
                         self.process_block(function, target, visited, vcs, contract)?;
+                        self.state = state.clone();
                     }
                     self.process_block(function, targets.otherwise, visited, vcs, contract)?;
                 }
@@ -185,12 +291,18 @@ impl VcGenerator {
             Terminator::Goto { target } => {
                 self.process_block(function, *target, visited, vcs, contract)?;
             }
-            Terminator::Call { .. } => {
-                // TODO: Handle function calls with contracts
+            Terminator::Call { func, args, destination, target, .. } => {
+                self.check_call(func, args, SourceLocation::unknown(), vcs)?;
+                let result = self.opaque("call_result");
+                self.state.insert(format!("local_{}", destination.local), result);
+                if let Some(target) = target {
+                    self.process_block(function, *target, visited, vcs, contract)?;
+                }
             }
-            Terminator::Drop { .. } => {
+            Terminator::Drop { target, .. } => {
                 // Drop is a memory operation - no verification needed for now
                 // TODO: Could verify drop safety
+                self.process_block(function, *target, visited, vcs, contract)?;
             }
             Terminator::Assert { condition, expected, message: _, target, cleanup: _ } => {
                 // Generate VC for assertion
@@ -228,6 +340,9 @@ impl VcGenerator {
     ) -> Result<(), SemanticError> {
         match stmt {
             Statement::Assign { place, rvalue, source_info } => {
+                if let Rvalue::Call { func, args } = rvalue {
+                    self.check_call(func, args, source_info.span.clone(), vcs)?;
+                }
                 let value_formula = self.rvalue_to_formula(rvalue)?;
                 
                 // Check for division by zero
@@ -250,6 +365,9 @@ impl VcGenerator {
                 let local_name = format!("local_{}", place.local);
                 self.state.insert(local_name, value_formula);
             }
+            Statement::VectorStore { .. } => {
+                // Array contents aren't modeled, same as scalar array_set calls
+            }
             Statement::StorageLive(_) | Statement::StorageDead(_) => {
                 // Storage markers don't affect verification
             }
@@ -261,6 +379,48 @@ impl VcGenerator {
         Ok(())
     }
     
+    /// Generate a VC for each precondition of the function `func` calls,
+    /// with the arguments for its parameters, under the current path condition
+    fn check_call(
+        &mut self,
+        func: &Operand,
+        args: &[Operand],
+        location: SourceLocation,
+        vcs: &mut Vec<VerificationCondition>,
+    ) -> Result<(), SemanticError> {
+        let callee = match func {
+            Operand::Constant(mir::Constant { value: mir::ConstantValue::String(name), .. }) => name,
+            _ => return Ok(()),
+        };
+        let call_contract = match self.call_contracts.get(callee) {
+            Some(call_contract) => call_contract.clone(),
+            None => return Ok(()),
+        };
+        
+        let mut bindings = HashMap::new();
+        for (parameter, arg) in call_contract.parameters.iter().zip(args) {
+            bindings.insert(parameter.clone(), self.operand_to_formula(arg)?);
+        }
+        self.call_bindings = Some(bindings);
+        let formulas: Vec<Result<Formula, SemanticError>> = call_contract.contract.preconditions.iter()
+            .map(|precond| self.contract_expr_to_formula(&precond.expression))
+            .collect();
+        self.call_bindings = None;
+        
+        for (precond, formula) in call_contract.contract.preconditions.iter().zip(formulas) {
+            // A precondition that cannot be translated is never met here
+            let formula = formula.unwrap_or(Formula::Bool(false));
+            let vc_formula = self.apply_path_condition(formula);
+            vcs.push(self.create_vc(
+                Self::call_condition_name(callee, &precond.name),
+                VcType::Precondition,
+                vc_formula,
+                location.clone(),
+            ));
+        }
+        Ok(())
+    }
+    
     /// Convert an rvalue to a formula
     fn rvalue_to_formula(&mut self, rvalue: &Rvalue) -> Result<Formula, SemanticError> {
         match rvalue {
@@ -295,14 +455,8 @@ impl VcGenerator {
                             Formula::And(vec![not_left, right_formula]),
                         ])
                     }
-                    mir::BinOp::Shl | mir::BinOp::Shr => {
-                        // Bit shifts - conservatively return true for verification
-                        Formula::Bool(true)
-                    }
-                    mir::BinOp::Offset => {
-                        // Pointer offset - conservatively return true for verification
-                        Formula::Bool(true)
-                    }
+                    mir::BinOp::Shl | mir::BinOp::Shr => self.opaque("shift_result"),
+                    mir::BinOp::Offset => self.opaque("offset_pointer"),
                 })
             }
             Rvalue::UnaryOp { op, operand } => {
@@ -323,25 +477,38 @@ impl VcGenerator {
             Rvalue::Call { .. } => {
                 // Function calls - conservatively return symbolic value
                 // TODO: Handle function contracts properly
-                Ok(Formula::Var("call_result".to_string()))
+                Ok(self.opaque("call_result"))
             }
             Rvalue::Aggregate { .. } => {
                 // Aggregate construction - return symbolic value
                 // TODO: Model aggregate values properly
-                Ok(Formula::Var("aggregate_value".to_string()))
+                Ok(self.opaque("aggregate_value"))
             }
             Rvalue::Ref { .. } => {
                 // Reference creation - return symbolic value
                 // TODO: Model memory operations
-                Ok(Formula::Var("ref_value".to_string()))
+                Ok(self.opaque("ref_value"))
             }
             Rvalue::Len(_) => {
                 // Array/slice length - return symbolic value
-                Ok(Formula::Var("array_length".to_string()))
+                Ok(self.opaque("array_length"))
             }
             Rvalue::Discriminant(_) => {
                 // Enum discriminant - return symbolic value
-                Ok(Formula::Var("enum_discriminant".to_string()))
+                Ok(self.opaque("enum_discriminant"))
+            }
+            Rvalue::VectorLoad { .. } | Rvalue::VectorSplat { .. } |
+            Rvalue::VectorShuffle { .. } | Rvalue::VectorSelect { .. } => {
+                // Vector lanes - return symbolic value
+                Ok(self.opaque("vector_value"))
+            }
+            Rvalue::VectorReduce { .. } => {
+                // Horizontal reduction - return symbolic value
+                Ok(self.opaque("vector_reduction"))
+            }
+            Rvalue::VectorExtract { .. } => {
+                // Single lane - return symbolic value
+                Ok(self.opaque("vector_lane"))
             }
         }
     }
@@ -361,12 +528,10 @@ impl VcGenerator {
                     mir::ConstantValue::Integer(n) => Formula::Int(*n as i64),
                     mir::ConstantValue::Float(f) => Formula::Real(*f),
                     mir::ConstantValue::Bool(b) => Formula::Bool(*b),
-                    mir::ConstantValue::String(_) => {
-                        // Strings not yet supported in verification
-                        Formula::Bool(true)
-                    }
+                    // Strings not yet supported in verification
+                    mir::ConstantValue::String(_) => self.opaque("string"),
                     mir::ConstantValue::Char(c) => Formula::Int(*c as i64),
-                    mir::ConstantValue::Null => Formula::Bool(false),
+                    mir::ConstantValue::Null => Formula::Int(0),
                 })
             }
         }
@@ -375,6 +540,16 @@ impl VcGenerator {
     /// Convert a contract expression to a formula
     fn contract_expr_to_formula(&self, expr: &ContractExpr) -> Result<Formula, SemanticError> {
         match expr {
+            ContractExpr::Variable(name) if self.call_bindings.is_some() => {
+                Ok(self.call_bindings.as_ref()
+                    .and_then(|bindings| bindings.get(name))
+                    .cloned()
+                    .unwrap_or_else(|| self.opaque(name)))
+            }
+            ContractExpr::Variable(name) if self.parameters.contains_key(name) => {
+                let local = self.parameters[name];
+                self.operand_to_formula(&Operand::Copy(mir::Place { local, projection: vec![] }))
+            }
             ContractExpr::Variable(name) => {
                 // Map to current state or create new variable
                 Ok(self.state.get(name)
@@ -386,8 +561,8 @@ impl VcGenerator {
                     ConstantValue::Integer(n) => Formula::Int(*n),
                     ConstantValue::Float(f) => Formula::Real(*f),
                     ConstantValue::Boolean(b) => Formula::Bool(*b),
-                    ConstantValue::String(_) => Formula::Bool(true),
-                    ConstantValue::Null => Formula::Bool(true),
+                    ConstantValue::String(_) => self.opaque("string"),
+                    ConstantValue::Null => Formula::Int(0),
                 })
             }
             ContractExpr::BinaryOp { op, left, right } => {
@@ -415,6 +590,17 @@ impl VcGenerator {
                     }),
                 })
             }
+            ContractExpr::UnaryOp { op, operand } => {
+                let operand_formula = self.contract_expr_to_formula(operand)?;
+                match op {
+                    ContractUnOp::Neg => Ok(Formula::Sub(Box::new(Formula::Int(0)), Box::new(operand_formula))),
+                    ContractUnOp::Not => Ok(Formula::Not(Box::new(operand_formula))),
+                    _ => Err(SemanticError::NotImplemented {
+                        feature: format!("Contract operator {:?}", op),
+                        location: SourceLocation::unknown(),
+                    }),
+                }
+            }
             ContractExpr::Result => {
                 Ok(self.state.get("result")
                     .cloned()
@@ -481,10 +667,12 @@ mod tests {
             name: "test".to_string(),
             parameters: vec![],
             return_type: Type::primitive(PrimitiveType::Integer),
-            locals: HashMap::new(),
-            basic_blocks: HashMap::new(),
+            locals: Default::default(),
+            basic_blocks: Default::default(),
             entry_block: 0,
             return_local: None,
+            entry_count: None,
+            proven_facts: None,
         };
         
         // Add an empty entry block
@@ -52,6 +52,7 @@ fn create_control_flow_ast() -> Program {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         },
         body: Block {
             statements: vec![
@@ -133,6 +134,7 @@ fn create_control_flow_ast() -> Program {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         },
         body: Block {
             statements: vec![
@@ -258,6 +260,7 @@ fn test_non_boolean_condition_error() {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         },
         body: Block {
             statements: vec![
@@ -335,6 +338,7 @@ fn test_loop_variable_scope() {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         },
         body: Block {
             statements: vec![
@@ -441,6 +445,7 @@ fn test_break_continue_statements() {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         },
         body: Block {
             statements: vec![
@@ -536,6 +541,7 @@ fn test_try_catch_analysis() {
             throws_exceptions: Vec::new(),
             thread_safe: None,
             may_block: None,
+            contract_checks: None,
         },
         body: Block {
             statements: vec![
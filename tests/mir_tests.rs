@@ -80,6 +80,7 @@ fn test_mir_builder() {
             values: vec![1],
             targets: vec![loop_body],
             otherwise: loop_end,
+            weights: vec![],
         },
     });
     
@@ -92,6 +92,7 @@ fn create_test_module_with_struct() -> Module {
                     throws_exceptions: vec![],
                     thread_safe: Some(true),
                     may_block: Some(false),
+                    contract_checks: None,
                 },
                 body: Block {
                     statements: vec![